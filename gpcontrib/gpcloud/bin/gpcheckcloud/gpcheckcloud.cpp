@@ -2,6 +2,8 @@
 
 bool hasHeader;
 
+bool isCsv;
+
 char eolString[EOL_CHARS_MAX_LEN + 1] = "\n";  // LF by default
 
 string s3extErrorMessage;
@@ -148,8 +150,10 @@ static void printTemplate() {
         "version = 1\n"
         "proxy = \"\"\n"
         "autocompress = true\n"
+        "compression = gzip\n"
         "verifycert = true\n"
         "server_side_encryption = \"\"\n"
+        "list_cache = true\n"
         "# gpcheckcloud config\n"
         "gpcheckcloud_newline = \"\\n\"\n");
 }
@@ -196,7 +200,7 @@ static bool downloadS3(const char *urlWithOptions) {
     }
 
     int data_len = BUF_SIZE;
-    char data_buf[BUF_SIZE];
+    const char *data_buf = NULL;
     bool ret = true;
 
     thread_setup();
@@ -212,13 +216,15 @@ static bool downloadS3(const char *urlWithOptions) {
     do {
         data_len = BUF_SIZE;
 
-        if (!reader_transfer_data(reader, data_buf, data_len)) {
+        // write the downloaded data out without copying it first
+        if (!reader_lend_data(reader, &data_buf, data_len)) {
             fprintf(stderr, "Failed to read data from Amazon S3\n");
             ret = false;
             break;
         }
 
         fwrite(data_buf, (size_t)data_len, 1, stdout);
+        reader_release_data(reader, data_len);
     } while (data_len && !S3QueryIsAbortInProgress());
 
     reader_cleanup(&reader);
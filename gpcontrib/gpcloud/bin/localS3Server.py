@@ -0,0 +1,493 @@
+#!/usr/bin/env python
+
+"""
+Local stand-in for the subset of S3 that gpcloud uses, to measure and test it offline.
+Usage::
+    ./localS3Server.py [-p <port>] [-d <directory>] [--latency=<ms>] [--error-rate=<ratio>] ...
+Then use it with a plain http URL and any credentials, for example::
+    s3://127.0.0.1:8555/<bucket>/<prefix> config=<config with encryption = false>
+
+Buckets are the directories of the data directory and keys are the files under them, keys
+uploaded through gpcloud are saved there too. Signatures are not checked.
+
+Supported requests:
+    GET    /<bucket>/?prefix=&marker=         list keys (version 1 listing)
+    GET    /<bucket>/<key>                    download a key, with an optional Range
+    HEAD   /<bucket>/<key>                    check a key exists
+    PUT    /<bucket>/<key>                    upload a key in one request
+    DELETE /<bucket>/<key>                    delete a key
+    POST   /<bucket>/<key>?uploads            start a multipart upload
+    PUT    /<bucket>/<key>?partNumber=&uploadId=
+                                              upload a part
+    POST   /<bucket>/<key>?uploadId=          complete a multipart upload
+    DELETE /<bucket>/<key>?uploadId=          abort a multipart upload
+"""
+
+from __future__ import print_function
+
+import getopt
+import hashlib
+import os
+import random
+import re
+import shutil
+import signal
+import socket
+import struct
+import sys
+import tempfile
+import threading
+import time
+import uuid
+
+try:
+    from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+    from SocketServer import ThreadingMixIn
+    from urllib import unquote
+    from urlparse import urlparse, parse_qs
+except ImportError:
+    from http.server import BaseHTTPRequestHandler, HTTPServer
+    from socketserver import ThreadingMixIn
+    from urllib.parse import unquote, urlparse, parse_qs
+
+help_msg = '''./localS3Server.py
+[-h] | [-p (--port=) <port>][-d (--directory=) <directory>][-v]
+       [--latency=<ms>][--jitter=<ms>][--bandwidth=<MB/s>]
+       [--error-rate=<ratio>][--reset-rate=<ratio>][--max-keys=<n>]
+Options:
+    -h : print this help info
+    -p --port=: http listen port, 8555 by default
+    -d --directory=: data directory, a temporary directory removed at exit by default
+    -v: print every request
+    --latency=: milliseconds to wait before answering every request
+    --jitter=: up to this many more milliseconds, picked at random for every request
+    --bandwidth=: limit of the transfer rate of every connection, in MB/s, both ways
+    --error-rate=: ratio of requests answered with 503 SlowDown, which gpcloud retries
+    --reset-rate=: ratio of requests whose connection is reset without an answer
+    --max-keys=: keys in a page of bucket listing, 1000 by default as in S3
+    '''
+
+TRANSFER_PIECE_SIZE = 64 * 1024
+UPLOADS_DIR = '.uploads'
+
+
+class Options(object):
+    directory = None
+    verbose = False
+    latency = 0.0
+    jitter = 0.0
+    bandwidth = 0.0
+    error_rate = 0.0
+    reset_rate = 0.0
+    max_keys = 1000
+
+
+class Statistics(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.requests = {}
+        self.errors = 0
+        self.resets = 0
+        self.bytes_in = 0
+        self.bytes_out = 0
+
+    def add(self, method, bytes_in=0, bytes_out=0):
+        with self.lock:
+            self.requests[method] = self.requests.get(method, 0) + 1
+            self.bytes_in += bytes_in
+            self.bytes_out += bytes_out
+
+    def report(self):
+        requests = ', '.join('%s %d' % item for item in sorted(self.requests.items()))
+        print('Requests: %s' % (requests or 'none'))
+        print('Injected errors %d, resets %d, received %.1f MB, sent %.1f MB' %
+              (self.errors, self.resets, self.bytes_in / 1048576.0, self.bytes_out / 1048576.0))
+
+
+options = Options()
+statistics = Statistics()
+
+
+def xml_escape(text):
+    return text.replace('&', '&amp;').replace('<', '&lt;').replace('>', '&gt;')
+
+
+class ThreadingHTTPServer(ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+    # The default of 5 drops the connects of many threads at once, they retry a second later.
+    request_queue_size = 128
+
+
+class LocalS3Handler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def log_message(self, format, *args):
+        if options.verbose:
+            BaseHTTPRequestHandler.log_message(self, format, *args)
+
+    # Transfers are done in pieces so that the bandwidth limit can be kept.
+    def _throttle(self, start, transferred):
+        if options.bandwidth > 0:
+            ahead = transferred / (options.bandwidth * 1048576.0) - (time.time() - start)
+            if ahead > 0:
+                time.sleep(ahead)
+
+    def _read_body(self, out=None):
+        length = int(self.headers.get('Content-Length') or 0)
+        chunks = []
+        start = time.time()
+        done = 0
+        while done < length:
+            data = self.rfile.read(min(TRANSFER_PIECE_SIZE, length - done))
+            if not data:
+                raise IOError('connection closed while reading the body')
+            if out is not None:
+                out.write(data)
+            else:
+                chunks.append(data)
+            done += len(data)
+            self._throttle(start, done)
+        return length, b''.join(chunks)
+
+    def _send(self, code, body=b'', headers=None, content_type='application/xml'):
+        self.send_response(code)
+        self.send_header('Content-Type', content_type)
+        self.send_header('Content-Length', str(len(body)))
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.end_headers()
+        if self.command != 'HEAD':
+            self.wfile.write(body)
+        statistics.add(self.command, bytes_out=len(body))
+
+    def _send_error(self, code, s3code, message):
+        body = ('<?xml version="1.0" encoding="UTF-8"?>\n<Error><Code>%s</Code>'
+                '<Message>%s</Message><Resource>%s</Resource></Error>' %
+                (s3code, xml_escape(message), xml_escape(self.path)))
+        self._send(code, body.encode('utf-8'))
+
+    def _reset(self):
+        # An RST instead of a FIN, as a broken connection would do.
+        self.connection.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER,
+                                   struct.pack('ii', 1, 0))
+        self.close_connection = True
+        with statistics.lock:
+            statistics.resets += 1
+
+    # Return False if the request is answered by an injected fault.
+    def _inject(self):
+        delay = options.latency + random.random() * options.jitter
+        if delay > 0:
+            time.sleep(delay / 1000.0)
+
+        chance = random.random()
+        if chance < options.reset_rate:
+            self._reset()
+            return False
+
+        if chance < options.reset_rate + options.error_rate:
+            if self.command in ('PUT', 'POST'):
+                self._read_body()
+            with statistics.lock:
+                statistics.errors += 1
+            self._send_error(503, 'SlowDown', 'Please reduce your request rate.')
+            return False
+
+        return True
+
+    def _parse(self):
+        url = urlparse(self.path)
+        parts = url.path.lstrip('/').split('/', 1)
+        self.bucket = unquote(parts[0])
+        self.key = unquote(parts[1]) if len(parts) > 1 else ''
+        self.query = dict((name, values[0]) for name, values in
+                          parse_qs(url.query, keep_blank_values=True).items())
+
+        if self.bucket in ('', '.', '..', UPLOADS_DIR) or '/../' in '/' + self.key + '/':
+            self.close_connection = True  # the body, if any, is not read
+            self._send_error(400, 'InvalidRequest', 'Invalid bucket or key')
+            return False
+        return True
+
+    def _key_path(self):
+        return os.path.join(options.directory, self.bucket, self.key)
+
+    def _upload_path(self, upload_id=None):
+        upload_id = upload_id or self.query.get('uploadId', '')
+        if not re.match(r'^[0-9a-f]{32}$', upload_id):
+            return None
+        return os.path.join(options.directory, UPLOADS_DIR, upload_id)
+
+    def _handle(self, handler):
+        try:
+            if self._inject() and self._parse():
+                handler()
+        except (IOError, socket.error) as e:
+            if options.verbose:
+                print('Connection of %s broken: %s' % (self.path, e))
+            self.close_connection = True
+
+    def do_GET(self):
+        self._handle(self._get)
+
+    def do_HEAD(self):
+        self._handle(self._head)
+
+    def do_PUT(self):
+        self._handle(self._put)
+
+    def do_POST(self):
+        self._handle(self._post)
+
+    def do_DELETE(self):
+        self._handle(self._delete)
+
+    def _get(self):
+        if self.key == '':
+            return self._list()
+
+        path = self._key_path()
+        if not os.path.isfile(path):
+            return self._send_error(404, 'NoSuchKey', 'The specified key does not exist.')
+
+        size = os.path.getsize(path)
+        first, last = 0, size - 1
+        code = 200
+        range_match = re.match(r'^bytes=(\d+)-(\d*)$', self.headers.get('Range') or '')
+        if range_match:
+            first = int(range_match.group(1))
+            if range_match.group(2):
+                last = min(int(range_match.group(2)), size - 1)
+            if first > last:
+                return self._send_error(416, 'InvalidRange',
+                                        'The requested range is not satisfiable')
+            code = 206
+
+        self.send_response(code)
+        self.send_header('Content-Type', 'application/octet-stream')
+        self.send_header('Content-Length', str(last - first + 1))
+        if code == 206:
+            self.send_header('Content-Range', 'bytes %d-%d/%d' % (first, last, size))
+        self.end_headers()
+
+        start = time.time()
+        done = 0
+        with open(path, 'rb') as f:
+            f.seek(first)
+            while done < last - first + 1:
+                data = f.read(min(TRANSFER_PIECE_SIZE, last - first + 1 - done))
+                if not data:
+                    break
+                self.wfile.write(data)
+                done += len(data)
+                self._throttle(start, done)
+        statistics.add('GET', bytes_out=done)
+
+    def _list(self):
+        bucket_path = os.path.join(options.directory, self.bucket)
+        if not os.path.isdir(bucket_path):
+            return self._send_error(404, 'NoSuchBucket', 'The specified bucket does not exist')
+
+        prefix = self.query.get('prefix', '')
+        marker = self.query.get('marker', '')
+        keys = []
+        for root, dirs, files in os.walk(bucket_path):
+            for name in files:
+                if name.startswith('.tmp.'):
+                    continue
+                key = os.path.relpath(os.path.join(root, name), bucket_path)
+                key = key.replace(os.sep, '/')
+                if key.startswith(prefix) and key > marker:
+                    keys.append(key)
+        keys.sort()
+
+        truncated = len(keys) > options.max_keys
+        contents = []
+        for key in keys[:options.max_keys]:
+            size = os.path.getsize(os.path.join(bucket_path, key))
+            contents.append('<Contents><Key>%s</Key><Size>%d</Size>'
+                            '<StorageClass>STANDARD</StorageClass></Contents>' %
+                            (xml_escape(key), size))
+
+        body = ('<?xml version="1.0" encoding="UTF-8"?>\n'
+                '<ListBucketResult xmlns="http://s3.amazonaws.com/doc/2006-03-01/">'
+                '<Name>%s</Name><Prefix>%s</Prefix><Marker>%s</Marker><MaxKeys>%d</MaxKeys>'
+                '<IsTruncated>%s</IsTruncated>%s</ListBucketResult>' %
+                (xml_escape(self.bucket), xml_escape(prefix), xml_escape(marker),
+                 options.max_keys, 'true' if truncated else 'false', ''.join(contents)))
+        self._send(200, body.encode('utf-8'))
+
+    def _head(self):
+        path = self._key_path()
+        if not os.path.isfile(path):
+            return self._send(404)
+
+        self.send_response(200)
+        self.send_header('Content-Length', str(os.path.getsize(path)))
+        self.end_headers()
+        statistics.add('HEAD')
+
+    # Bodies are written to a temporary file first, so that readers only see complete keys.
+    def _save_body(self, path):
+        directory = os.path.dirname(path)
+        if not os.path.isdir(directory):
+            try:
+                os.makedirs(directory)
+            except OSError:
+                pass  # made by another request
+
+        md5 = hashlib.md5()
+
+        class Digester(object):
+            def __init__(self, f):
+                self.f = f
+
+            def write(self, data):
+                md5.update(data)
+                self.f.write(data)
+
+        fd, tmp_path = tempfile.mkstemp(dir=directory, prefix='.tmp.')
+        try:
+            with os.fdopen(fd, 'wb') as f:
+                length, _ = self._read_body(Digester(f))
+            os.rename(tmp_path, path)
+        except Exception:
+            os.unlink(tmp_path)
+            raise
+
+        statistics.add(self.command, bytes_in=length)
+        return '"%s"' % md5.hexdigest()
+
+    def _put(self):
+        if 'uploadId' in self.query:
+            upload_path = self._upload_path()
+            part = self.query.get('partNumber', '')
+            if upload_path is None or not os.path.isdir(upload_path) or not part.isdigit():
+                self._read_body()
+                return self._send_error(404, 'NoSuchUpload',
+                                        'The specified upload does not exist.')
+            etag = self._save_body(os.path.join(upload_path, '%05d' % int(part)))
+        else:
+            etag = self._save_body(self._key_path())
+
+        self.send_response(200)
+        self.send_header('ETag', etag)
+        self.send_header('Content-Length', '0')
+        self.end_headers()
+
+    def _post(self):
+        _, body = self._read_body()
+
+        if 'uploads' in self.query:
+            upload_id = uuid.uuid4().hex
+            os.makedirs(self._upload_path(upload_id))
+            result = ('<?xml version="1.0" encoding="UTF-8"?>\n'
+                      '<InitiateMultipartUploadResult><Bucket>%s</Bucket><Key>%s</Key>'
+                      '<UploadId>%s</UploadId></InitiateMultipartUploadResult>' %
+                      (xml_escape(self.bucket), xml_escape(self.key), upload_id))
+            return self._send(200, result.encode('utf-8'))
+
+        upload_path = self._upload_path()
+        if upload_path is None or not os.path.isdir(upload_path):
+            return self._send_error(404, 'NoSuchUpload', 'The specified upload does not exist.')
+
+        parts = re.findall(r'<PartNumber>\s*(\d+)\s*</PartNumber>', body.decode('utf-8'))
+        part_paths = [os.path.join(upload_path, '%05d' % int(part)) for part in parts]
+        if not part_paths or not all(os.path.isfile(path) for path in part_paths):
+            return self._send_error(400, 'InvalidPart', 'One or more parts could not be found.')
+
+        path = self._key_path()
+        directory = os.path.dirname(path)
+        if not os.path.isdir(directory):
+            try:
+                os.makedirs(directory)
+            except OSError:
+                pass
+
+        fd, tmp_path = tempfile.mkstemp(dir=directory, prefix='.tmp.')
+        with os.fdopen(fd, 'wb') as out:
+            for part_path in part_paths:
+                with open(part_path, 'rb') as f:
+                    shutil.copyfileobj(f, out, 1024 * 1024)
+        os.rename(tmp_path, path)
+        shutil.rmtree(upload_path, ignore_errors=True)
+
+        result = ('<?xml version="1.0" encoding="UTF-8"?>\n'
+                  '<CompleteMultipartUploadResult><Bucket>%s</Bucket><Key>%s</Key>'
+                  '</CompleteMultipartUploadResult>' %
+                  (xml_escape(self.bucket), xml_escape(self.key)))
+        self._send(200, result.encode('utf-8'))
+
+    def _delete(self):
+        if 'uploadId' in self.query:
+            upload_path = self._upload_path()
+            if upload_path is None or not os.path.isdir(upload_path):
+                return self._send_error(404, 'NoSuchUpload',
+                                        'The specified upload does not exist.')
+            shutil.rmtree(upload_path, ignore_errors=True)
+        elif os.path.isfile(self._key_path()):
+            os.unlink(self._key_path())
+        self._send(204)
+
+
+def run(port):
+    temporary = options.directory is None
+    if temporary:
+        options.directory = tempfile.mkdtemp(prefix='localS3Server.')
+    uploads = os.path.join(options.directory, UPLOADS_DIR)
+    if not os.path.isdir(uploads):
+        os.makedirs(uploads)
+
+    httpd = ThreadingHTTPServer(('', port), LocalS3Handler)
+
+    def stop(signum, frame):
+        raise KeyboardInterrupt()
+    signal.signal(signal.SIGTERM, stop)
+
+    print('Serving %s on port %d' % (options.directory, port))
+    sys.stdout.flush()
+    try:
+        httpd.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        httpd.server_close()
+        statistics.report()
+        if temporary:
+            shutil.rmtree(options.directory, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    from sys import argv
+    port = 8555
+    try:
+        opts, args = getopt.getopt(argv[1:], "hvp:d:",
+                                   ["port=", "directory=", "latency=", "jitter=", "bandwidth=",
+                                    "error-rate=", "reset-rate=", "max-keys="])
+    except getopt.GetoptError:
+        print(help_msg)
+        sys.exit(2)
+    for opt, arg in opts:
+        if opt == '-h':
+            print(help_msg)
+            sys.exit(0)
+        elif opt == '-v':
+            options.verbose = True
+        elif opt in ("-p", "--port"):
+            port = int(arg)
+        elif opt in ("-d", "--directory"):
+            options.directory = os.path.abspath(arg)
+        elif opt == "--latency":
+            options.latency = float(arg)
+        elif opt == "--jitter":
+            options.jitter = float(arg)
+        elif opt == "--bandwidth":
+            options.bandwidth = float(arg)
+        elif opt == "--error-rate":
+            options.error_rate = float(arg)
+        elif opt == "--reset-rate":
+            options.reset_rate = float(arg)
+        elif opt == "--max-keys":
+            options.max_keys = int(arg)
+    run(port)
@@ -40,4 +40,69 @@ class CompressWriter : public Writer {
     bool isClosed;
 };
 
+#ifdef USE_ZSTD
+// ZstdCompressWriter writes one zstd frame. It is compressed by as many worker threads as
+// threadnum, unless the zstd library is built without multithreading.
+class ZstdCompressWriter : public Writer {
+   public:
+    ZstdCompressWriter();
+    virtual ~ZstdCompressWriter();
+
+    virtual void open(const S3Params &params);
+
+    // write() attempts to write up to count bytes from the buffer.
+    // Throw exception if encounters errors.
+    virtual uint64_t write(const char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setWriter(Writer *writer);
+
+   private:
+    // Compress (part of) the input and write out the output, return what zstd has left to flush.
+    size_t compress(ZSTD_inBuffer *in, ZSTD_EndDirective mode);
+
+    Writer *writer;
+
+    ZSTD_CCtx *cctx;
+    char *out;         // Output buffer for compression.
+    uint64_t outSize;  // Size of out buffer.
+
+    // add this flag to make close() reentrant
+    bool isClosed;
+};
+#endif
+
+#ifdef USE_LZ4
+// LZ4CompressWriter writes one LZ4 frame with a content checksum.
+class LZ4CompressWriter : public Writer {
+   public:
+    LZ4CompressWriter();
+    virtual ~LZ4CompressWriter();
+
+    virtual void open(const S3Params &params);
+
+    // write() attempts to write up to count bytes from the buffer.
+    // Throw exception if encounters errors.
+    virtual uint64_t write(const char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setWriter(Writer *writer);
+
+   private:
+    Writer *writer;
+
+    LZ4F_cctx *cctx;
+    LZ4F_preferences_t prefs;
+    char *out;         // Output buffer for compression.
+    uint64_t outSize;  // Size of out buffer.
+
+    // add this flag to make close() reentrant
+    bool isClosed;
+};
+#endif
+
 #endif
@@ -21,6 +21,10 @@ class DecompressReader : public Reader {
     // Return 0 if EOF. Throw exception if encounters errors.
     virtual uint64_t read(char *buf, uint64_t count);
 
+    // lend() points to the decompressed data in the output buffer.
+    virtual uint64_t lend(const char **data, uint64_t count);
+    virtual void release(uint64_t count);
+
     // This should be reentrant, has no side effects when called multiple times.
     virtual void close();
 
@@ -39,11 +43,95 @@ class DecompressReader : public Reader {
 
     // zlib related variables.
     z_stream zstream;
-    char *in;            // Input buffer for decompression.
+    uint64_t inLen;      // Bytes lent by the underlying reader, inflated from in place.
+    char *out;           // Output buffer for decompression.
+    uint64_t outOffset;  // Next position to read in out buffer.
+
+    bool isClosed;
+};
+
+#ifdef USE_ZSTD
+// ZstdDecompressReader decodes one or more concatenated zstd frames.
+class ZstdDecompressReader : public Reader {
+   public:
+    ZstdDecompressReader();
+    virtual ~ZstdDecompressReader();
+
+    virtual void open(const S3Params &params);
+
+    // read() attempts to read up to count bytes into the buffer.
+    // Return 0 if EOF. Throw exception if encounters errors.
+    virtual uint64_t read(char *buf, uint64_t count);
+
+    virtual uint64_t lend(const char **data, uint64_t count);
+    virtual void release(uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setReader(Reader *reader);
+
+   private:
+    void decompress();
+
+    Reader *reader;
+
+    ZSTD_DCtx *dctx;
+    ZSTD_inBuffer in;  // Bytes lent by the underlying reader.
+
     char *out;           // Output buffer for decompression.
+    uint64_t outSize;    // Size of out buffer.
+    uint64_t outLen;     // Decompressed bytes in out buffer.
     uint64_t outOffset;  // Next position to read in out buffer.
 
+    bool outFull;     // out was filled up, the decoder might hold more output.
+    bool frameEnded;  // no frame is partially decoded.
+
+    bool isClosed;
+};
+#endif
+
+#ifdef USE_LZ4
+// LZ4DecompressReader decodes one or more concatenated LZ4 frames.
+class LZ4DecompressReader : public Reader {
+   public:
+    LZ4DecompressReader();
+    virtual ~LZ4DecompressReader();
+
+    virtual void open(const S3Params &params);
+
+    // read() attempts to read up to count bytes into the buffer.
+    // Return 0 if EOF. Throw exception if encounters errors.
+    virtual uint64_t read(char *buf, uint64_t count);
+
+    virtual uint64_t lend(const char **data, uint64_t count);
+    virtual void release(uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setReader(Reader *reader);
+
+   private:
+    void decompress();
+
+    Reader *reader;
+
+    LZ4F_dctx *dctx;
+    const char *in;  // Bytes lent by the underlying reader.
+    uint64_t inLen;
+    uint64_t inOffset;
+
+    char *out;           // Output buffer for decompression.
+    uint64_t outSize;    // Size of out buffer.
+    uint64_t outLen;     // Decompressed bytes in out buffer.
+    uint64_t outOffset;  // Next position to read in out buffer.
+
+    bool outFull;     // out was filled up, the decoder might hold more output.
+    bool frameEnded;  // no frame is partially decoded.
+
     bool isClosed;
 };
+#endif
 
 #endif /* INCLUDE_DECOMPRESS_READER_H_ */
@@ -11,6 +11,7 @@ extern bool S3QueryIsAbortInProgress(void);
 #define EOL_CHARS_MAX_LEN 2   // '\n', '\r', '\r\n'
 extern char eolString[];
 extern bool hasHeader;
+extern bool isCsv;
 
 // TODO change to functions getgpsegmentId() and getgpsegmentCount()
 
@@ -23,6 +23,10 @@ class GPReader : public Reader {
     // Return 0 if EOF. Throw exception if encounters errors.
     virtual uint64_t read(char *buf, uint64_t count);
 
+    // lend() points to the downloaded data instead of copying it, see Reader::lend().
+    virtual uint64_t lend(const char **data, uint64_t count);
+    virtual void release(uint64_t count);
+
     // This should be reentrant, has no side effects when called multiple times.
     virtual void close();
 
@@ -48,8 +52,14 @@ class GPReader : public Reader {
 };
 
 // Following 3 functions are invoked by s3_import(), need to be exception safe
-GPReader *reader_init(const char *url_with_options);
+// scanInfo describes the scan to readers of columnar keys, NULL if unknown.
+GPReader *reader_init(const char *url_with_options, const S3ScanInfo *scanInfo = NULL);
 bool reader_transfer_data(GPReader *reader, char *data_buf, int &data_len);
+
+// Same as reader_transfer_data() without the copy, data_len bytes of data_buf have to be handed
+// back with reader_release_data() before the next call.
+bool reader_lend_data(GPReader *reader, const char **data_buf, int &data_len);
+bool reader_release_data(GPReader *reader, int data_len);
 bool reader_cleanup(GPReader **reader);
 
 // Two thread related functions, called only by gpreader and gpcheckcloud
@@ -0,0 +1,278 @@
+#ifndef INCLUDE_PARQUET_READER_H_
+#define INCLUDE_PARQUET_READER_H_
+
+#include "reader.h"
+#include "s3common_headers.h"
+#include "s3exception.h"
+#include "s3interface.h"
+
+// Bytes of the end of a key fetched to find its footer, they hold the whole metadata of most
+// files, bigger metadata is fetched with a second request.
+#define PARQUET_FOOTER_FETCH_SIZE (64 * 1024)
+
+// Column chunks of a row group separated by less than this are fetched with one request.
+#define PARQUET_MAX_RANGE_GAP (1024 * 1024)
+
+// Rows are converted to about this many bytes of CSV at a time.
+#define PARQUET_OUTPUT_BUFFER_SIZE (1024 * 1024)
+
+// Thrift compact protocol decoder, Parquet metadata and page headers are serialized with it.
+class ThriftCompactReader {
+   public:
+    enum Type {
+        STOP = 0,
+        BOOLEAN_TRUE = 1,
+        BOOLEAN_FALSE = 2,
+        BYTE = 3,
+        I16 = 4,
+        I32 = 5,
+        I64 = 6,
+        DOUBLE = 7,
+        BINARY = 8,
+        LIST = 9,
+        SET = 10,
+        MAP = 11,
+        STRUCT = 12
+    };
+
+    ThriftCompactReader(const uint8_t* data, uint64_t size) : pos(data), end(data + size) {
+    }
+
+    // Call onField(id, type) for every field of a struct, onField reads the value with the
+    // functions below or skips it.
+    template <typename Function>
+    void readStruct(Function onField) {
+        int16_t lastId = 0;
+        while (true) {
+            uint8_t header = this->readByte();
+            if (header == STOP) {
+                return;
+            }
+
+            int16_t delta = header >> 4;
+            int16_t id = delta ? lastId + delta : (int16_t)this->readInt();
+            lastId = id;
+            onField(id, header & 0x0f);
+        }
+    }
+
+    // Read i16, i32 and i64 fields, and return the number of elements of a list.
+    int64_t readInt();
+    string readBinary();
+    uint64_t readListHeader(int& elementType);
+
+    // Boolean fields are stored in their type.
+    bool readBool(int type) {
+        return type == BOOLEAN_TRUE;
+    }
+
+    void skip(int type, bool inList = false, int depth = 0);
+
+    const uint8_t* getPosition() const {
+        return pos;
+    }
+
+   private:
+    uint8_t readByte();
+    uint64_t readVarint();
+
+    const uint8_t* pos;
+    const uint8_t* end;
+};
+
+// Decoder of the RLE/bit-packing hybrid encoding of definition levels, dictionary indices
+// and booleans.
+class RleBitPackedDecoder {
+   public:
+    RleBitPackedDecoder()
+        : pos(NULL),
+          end(NULL),
+          bitWidth(0),
+          repeatCount(0),
+          repeatValue(0),
+          literalCount(0),
+          literals(NULL),
+          literalsEnd(NULL),
+          literalBit(0) {
+    }
+
+    void reset(const uint8_t* data, const uint8_t* end, int bitWidth);
+    uint32_t next();
+
+   private:
+    const uint8_t* pos;
+    const uint8_t* end;
+    int bitWidth;
+
+    uint32_t repeatCount;  // left in the current RLE run
+    uint32_t repeatValue;
+
+    uint32_t literalCount;  // left in the current bit-packed run
+    const uint8_t* literals;
+    const uint8_t* literalsEnd;
+    uint64_t literalBit;  // position of the next value in literals
+};
+
+// How values of a column are presented, from its logical or converted type.
+enum ParquetValueKind {
+    PARQUET_VALUE_PLAIN,
+    PARQUET_VALUE_STRING,
+    PARQUET_VALUE_UNSIGNED,
+    PARQUET_VALUE_DATE,
+    PARQUET_VALUE_TIME,
+    PARQUET_VALUE_TIMESTAMP,
+    PARQUET_VALUE_DECIMAL
+};
+
+// Leaf column of the schema of a Parquet file.
+struct ParquetColumn {
+    string name;  // of the top-level field the leaf belongs to
+    int32_t type;
+    int32_t typeLength;
+    bool optional;
+    bool nested;  // in a group or repeated, which are not supported
+
+    ParquetValueKind kind;
+    int32_t scale;            // of decimals
+    int64_t unitsPerSecond;   // of times and timestamps
+    bool adjustedToUTC;       // timestamps are instants, not local times
+};
+
+struct ParquetColumnChunk {
+    ParquetColumnChunk()
+        : codec(0), numValues(0), offset(0), size(0), hasMinMax(false), hasNullCount(false),
+          nullCount(0), inOtherFile(false) {
+    }
+
+    int32_t codec;
+    int64_t numValues;
+    uint64_t offset;  // of the first page
+    uint64_t size;
+
+    // statistics, min and max are only taken from min_value and max_value, which are ordered
+    // by the type of the column
+    bool hasMinMax;
+    string minValue;
+    string maxValue;
+    bool hasNullCount;
+    int64_t nullCount;
+
+    bool inOtherFile;
+};
+
+struct ParquetRowGroup {
+    int64_t numRows;
+    vector<ParquetColumnChunk> columns;
+};
+
+// ParquetColumnDecoder converts the values of a column chunk to CSV fields, a page at a time.
+class ParquetColumnDecoder {
+   public:
+    ParquetColumnDecoder();
+
+    void reset(const ParquetColumn* column, const ParquetColumnChunk* chunk, const uint8_t* data);
+
+    // Append the next value to out, nothing if it is NULL.
+    void appendNext(string& out);
+
+   private:
+    void readPage();
+    const uint8_t* decompress(const uint8_t* data, uint64_t size, uint64_t uncompressedSize);
+    const uint8_t* nextPlainValue(uint64_t& length);
+    void appendValue(const uint8_t* value, uint64_t length, string& out);
+    void appendPlain(string& out);
+
+    const ParquetColumn* column;
+    int32_t codec;
+
+    const uint8_t* pos;  // next page of the column chunk
+    const uint8_t* end;
+
+    vector<uint8_t> pageBuffer;  // decompressed page
+    int64_t valuesLeft;          // in the page, NULLs included
+    int32_t encoding;
+    const uint8_t* values;
+    const uint8_t* valuesEnd;
+    uint64_t booleanBit;  // position of the next PLAIN boolean in values
+
+    RleBitPackedDecoder definitionLevels;
+    RleBitPackedDecoder encodedValues;  // dictionary indices, or RLE booleans
+
+    vector<string> dictionary;  // formatted
+};
+
+// ParquetReader reads a Parquet key as CSV lines, one per row and one field per column of
+// the table.
+//
+// Only the column chunks of the columns the query needs are fetched, with range requests,
+// other columns are left NULL. Row groups whose statistics show none of their rows meets a
+// filter of the scan are not fetched at all. Table columns are matched with the top-level
+// fields of the file by name, exactly first, then ignoring case, columns missing in the file
+// are NULL. Nested fields are not supported.
+//
+// Without a scan description, e.g. in gpcheckcloud, all the top-level fields are read.
+class ParquetReader : public Reader {
+   public:
+    ParquetReader();
+    virtual ~ParquetReader();
+
+    virtual void open(const S3Params& params);
+
+    // read() attempts to read up to count bytes into the buffer.
+    // Return 0 if EOF. Throw exception if encounters errors.
+    virtual uint64_t read(char* buf, uint64_t count);
+
+    // lend() points to the converted rows in the output buffer.
+    virtual uint64_t lend(const char** data, uint64_t count);
+    virtual void release(uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setS3InterfaceService(S3Interface* s3Interface) {
+        this->s3Interface = s3Interface;
+    }
+
+    uint64_t getNumOfSkippedRowGroups() const {
+        return numOfSkippedRowGroups;
+    }
+
+    uint64_t getFetchedBytes() const {
+        return fetchedBytes;
+    }
+
+   private:
+    void readMetadata();
+    void parseMetadata(const uint8_t* data, uint64_t size);
+    void mapColumns();
+    bool isRowGroupSkipped(const ParquetRowGroup& rowGroup);
+    bool nextRowGroup();
+    void fetchRowGroup(const ParquetRowGroup& rowGroup);
+    bool convertRows();
+
+    S3Interface* s3Interface;
+    S3Url s3Url;
+    uint64_t keySize;
+    S3ScanInfo scanInfo;
+
+    vector<ParquetColumn> columns;
+    vector<ParquetRowGroup> rowGroups;
+
+    vector<string> outputNames;
+    vector<int64_t> matchedColumns;  // leaf column of every output column, -1 if none
+    vector<int64_t> outputColumns;   // leaf column read for every output column, -1 for NULL
+
+    uint64_t rowGroupIndex;  // next row group
+    int64_t rowsLeft;        // in the current row group
+    vector<S3VectorUInt8> fetchedRanges;
+    vector<ParquetColumnDecoder> decoders;  // of every output column, used if not NULL
+
+    string out;  // converted rows
+    uint64_t outOffset;
+    bool headerDone;
+
+    uint64_t numOfSkippedRowGroups;
+    uint64_t fetchedBytes;
+};
+
+#endif /* INCLUDE_PARQUET_READER_H_ */
@@ -6,6 +6,9 @@
 
 class Reader {
    public:
+    Reader() : lentBegin(0), lentEnd(0) {
+    }
+
     virtual ~Reader() {
     }
 
@@ -16,8 +19,36 @@ class Reader {
     // errors.
     virtual uint64_t read(char *buf, uint64_t count) = 0;
 
+    // lend() is read() without the copy: it points data to up to count bytes held by the reader
+    // and returns their number, 0 if EOF. The bytes stay valid until release() consumes them,
+    // the ones not released are lent again by the next lend(). Don't call read() in between.
+    //
+    // Readers that have no buffer of their own lend a copy made by read().
+    virtual uint64_t lend(const char **data, uint64_t count) {
+        if (this->lentBegin == this->lentEnd) {
+            if (this->lendBuffer.size() < count) {
+                this->lendBuffer.resize(count);
+            }
+            this->lentBegin = 0;
+            this->lentEnd = this->read(this->lendBuffer.data(), count);
+        }
+
+        *data = this->lendBuffer.data() + this->lentBegin;
+        return std::min(count, this->lentEnd - this->lentBegin);
+    }
+
+    // release() consumes the first count bytes of the last lend().
+    virtual void release(uint64_t count) {
+        this->lentBegin += count;
+    }
+
     // This should be reentrant, has no side effects when called multiple times.
     virtual void close() = 0;
+
+   private:
+    vector<char> lendBuffer;
+    uint64_t lentBegin;
+    uint64_t lentEnd;
 };
 
 #endif
@@ -5,8 +5,29 @@
 #include "s3common_headers.h"
 #include "s3exception.h"
 #include "s3interface.h"
+#include "s3list_cache.h"
+
+// Keys are only split into byte ranges of at least this size.
+#define S3_MIN_KEY_SPLIT_SIZE (64 * 1024 * 1024)
+
+// Chunk size used to read past the end of a range, to the end of its last line.
+#define S3_LINE_REST_CHUNK_SIZE (64 * 1024)
+
+// A byte range of a key, read by one segment.
+struct KeySplit {
+    uint64_t keyIndex;  // BucketContent index of keyList.contents.
+    uint64_t offset;
+    uint64_t length;
+};
 
 // S3BucketReader read multiple files in a bucket.
+//
+// The keys are assigned to segments by size: every segment computes the same
+// assignment from the key list, packing the keys greedily, largest first, on the
+// least loaded segment. A plain text key much bigger than the average load of a
+// segment is split into byte ranges first. A range starting in the middle of a
+// line leaves that line to the previous range, which reads past its own end to
+// finish it.
 class S3BucketReader : public Reader {
    public:
     S3BucketReader();
@@ -14,6 +35,8 @@ class S3BucketReader : public Reader {
 
     void open(const S3Params &params);
     uint64_t read(char *buf, uint64_t count);
+    uint64_t lend(const char **data, uint64_t count);
+    void release(uint64_t count);
     void close();
 
     void setS3InterfaceService(S3Interface *s3) {
@@ -28,6 +51,10 @@ class S3BucketReader : public Reader {
         return keyList;
     }
 
+    const vector<KeySplit> &getKeySplits() {
+        return keySplits;
+    }
+
    private:
     S3Params params;
 
@@ -41,14 +68,34 @@ class S3BucketReader : public Reader {
     // we should read header line only for the 1st file and ignore remainings.
     bool isFirstFile;
 
-    // Skip the header line (terminated with eol) if necessary.
-    // copy valid data into buf and return its size.
-    uint64_t readWithoutHeaderLine(char *buf, uint64_t count);
+    // Skip the header line (terminated with eol), or the end of a line started before the range.
+    void skipFirstLine(uint64_t count);
 
     ListBucketResult keyList;  // List of matched keys/files.
-    uint64_t keyIndex;         // BucketContent index of keylist->contents.
 
-    BucketContent &getNextKey();
+    vector<KeySplit> keySplits;  // Ranges of keys read by this segment, in key order.
+    uint64_t splitIndex;         // Index of the next range in keySplits.
+    KeySplit curSplit;
+
+    // True when reading past the end of curSplit to the end of its last line.
+    bool readingRestOfLine;
+
+    // Last bytes returned for curSplit, to know if its last line is finished.
+    string lastBytes;
+
+    // Bytes returned by the last lend().
+    const char *lentData;
+
+    void assignKeySplits();
+    bool isSplittable(BucketContent &key);
+
+    void trackLastBytes(const char *buf, uint64_t count);
+    bool lastBytesEndLine();
+
+    // Lend the bytes after the end of curSplit until the end of the line it ends in.
+    uint64_t lendRestOfLine(const char **data, uint64_t count);
+
+    KeySplit &getNextSplit();
     S3Params constructReaderParams(BucketContent &key);
 };
 
@@ -9,12 +9,21 @@
 #include <openssl/md5.h>
 #include <openssl/sha.h>
 #include <pthread.h>
+#include <sys/time.h>
 #include <zlib.h>
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef USE_LZ4
+#include <lz4frame.h>
+#endif
 #include <algorithm>
 #include <csignal>
 #include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
+#include <queue>
 #include <set>
 #include <sstream>
 #include <stdexcept>
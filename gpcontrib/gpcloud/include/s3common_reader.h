@@ -2,6 +2,7 @@
 #define INCLUDE_S3COMMON_READER_H_
 
 #include "decompress_reader.h"
+#include "parquet_reader.h"
 #include "s3common_headers.h"
 #include "s3exception.h"
 #include "s3key_reader.h"
@@ -21,6 +22,9 @@ class S3CommonReader : public Reader {
     // Return 0 if EOF. Throw exception if encounters errors.
     virtual uint64_t read(char* buf, uint64_t count);
 
+    virtual uint64_t lend(const char** data, uint64_t count);
+    virtual void release(uint64_t count);
+
     // This should be reentrant, has no side effects when called multiple times.
     virtual void close();
 
@@ -34,6 +38,13 @@ class S3CommonReader : public Reader {
     S3Interface* s3InterfaceService;
     S3KeyReader keyReader;
     DecompressReader decompressReader;
+#ifdef USE_ZSTD
+    ZstdDecompressReader zstdDecompressReader;
+#endif
+#ifdef USE_LZ4
+    LZ4DecompressReader lz4DecompressReader;
+#endif
+    ParquetReader parquetReader;
 };
 
 #endif /* INCLUDE_S3COMMON_READER_H_ */
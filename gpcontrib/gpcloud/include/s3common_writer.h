@@ -35,6 +35,12 @@ class S3CommonWriter : public Writer {
     S3Interface* s3InterfaceService;
     S3KeyWriter keyWriter;
     CompressWriter compressWriter;
+#ifdef USE_ZSTD
+    ZstdCompressWriter zstdCompressWriter;
+#endif
+#ifdef USE_LZ4
+    LZ4CompressWriter lz4CompressWriter;
+#endif
 };
 
 #endif
@@ -31,4 +31,10 @@ class S3Params;
 void CheckEssentialConfig(const S3Params& params);
 void GetAwsProfileInfo(const string configSection, string& accessId, string& secret);
 
+#ifndef S3_STANDALONE
+// Where, and under which session name, the bucket listings of the session are kept.
+string GetListCacheDir();
+string GetListCacheSession();
+#endif
+
 #endif
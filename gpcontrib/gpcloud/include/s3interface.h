@@ -15,12 +15,6 @@
 
 #define S3_RANGE_HEADER_STRING_LEN 128
 
-enum S3CompressionType {
-    S3_COMPRESSION_GZIP,
-    S3_COMPRESSION_PLAIN,
-    S3_COMPRESSION_DEFLATE,
-};
-
 struct BucketContent {
     BucketContent() : name(""), size(0) {
     }
@@ -6,6 +6,16 @@
 #include "s3exception.h"
 #include "s3interface.h"
 
+// A configured chunk size bigger than this is adapted to the measured download
+// speed: chunks start at S3_INITIAL_CHUNK_SIZE, and are resized between this and
+// the configured size so that fetching one takes between S3_CHUNK_MIN_FETCH_SECONDS
+// and S3_CHUNK_MAX_FETCH_SECONDS. Shorter requests are dominated by their latency,
+// longer ones hold memory and delay the first bytes for nothing.
+#define S3_MIN_CHUNK_SIZE (1024 * 1024)
+#define S3_INITIAL_CHUNK_SIZE (8 * 1024 * 1024)
+#define S3_CHUNK_MIN_FETCH_SECONDS 1.0
+#define S3_CHUNK_MAX_FETCH_SECONDS 4.0
+
 struct Range {
     uint64_t offset;
     uint64_t length;
@@ -26,7 +36,9 @@ class OffsetMgr {
         return chunkSize;
     }
 
+    // May be called while chunks are handed out, it applies to the next ones.
     void setChunkSize(uint64_t chunkSize) {
+        UniqueLock lock(&this->offsetLock);
         this->chunkSize = chunkSize;
     }
 
@@ -54,7 +66,7 @@ class OffsetMgr {
 
    private:
     pthread_mutex_t offsetLock;
-    uint64_t keySize;  // size of S3 key(file)
+    uint64_t keySize;  // size of S3 key(file), or end of the range to read
     uint64_t chunkSize;
     uint64_t curPos;
 };
@@ -66,6 +78,20 @@ enum ChunkStatus {
 
 class ChunkBuffer;
 
+// Download statistics of all keys read by a S3KeyReader.
+struct S3ReadStats {
+    S3ReadStats() : numOfKeys(0), numOfRequests(0), bytes(0), fetchSeconds(0) {
+        startTime.tv_sec = 0;
+        startTime.tv_usec = 0;
+    }
+
+    uint64_t numOfKeys;
+    uint64_t numOfRequests;
+    uint64_t bytes;
+    double fetchSeconds;      // sum of the durations of the requests
+    struct timeval startTime;  // when the first key was opened
+};
+
 class S3KeyReader : public Reader {
    public:
     S3KeyReader()
@@ -73,24 +99,40 @@ class S3KeyReader : public Reader {
           numOfChunks(0),
           curReadingChunk(0),
           transferredKeyLen(0),
+          keyRangeLength(0),
+          maxChunkSize(0),
+          adaptedChunkSize(0),
+          adaptingChunkSize(false),
           s3Interface(NULL),
+          lentData(NULL),
           hasEol(false),
-          eolAppended(false) {
+          eolAppended(false),
+          appendEol(true) {
         pthread_mutex_init(&this->mutexErrorMessage, NULL);
+        pthread_mutex_init(&this->mutexStats, NULL);
     }
     virtual ~S3KeyReader() {
         this->close();
+        this->logStats();
         pthread_mutex_destroy(&this->mutexErrorMessage);
+        pthread_mutex_destroy(&this->mutexStats);
     }
 
     void open(const S3Params& params);
     uint64_t read(char* buf, uint64_t count);
+    uint64_t lend(const char** data, uint64_t count);
+    void release(uint64_t count);
     void close();
 
     void setS3InterfaceService(S3Interface* s3) {
         this->s3Interface = s3;
     }
 
+    // Whether an EOL is appended to a key not ending with one, only keys of text need it.
+    void setAppendEol(bool appendEol) {
+        this->appendEol = appendEol;
+    }
+
     const vector<ChunkBuffer>& getChunkBuffers() const {
         return chunkBuffers;
     }
@@ -140,6 +182,13 @@ class S3KeyReader : public Reader {
         return region;
     }
 
+    const S3ReadStats& getStats() const {
+        return stats;
+    }
+
+    // Account a finished chunk request, and adapt the size of the next chunks to it.
+    void recordFetch(uint64_t requestedLen, uint64_t fetchedLen, double seconds);
+
    private:
     pthread_mutex_t mutexErrorMessage;
 
@@ -152,9 +201,24 @@ class S3KeyReader : public Reader {
     uint64_t numOfChunks;
     uint64_t curReadingChunk;
     uint64_t transferredKeyLen;
+    uint64_t keyRangeLength;  // number of bytes of the key to read
     string region;
     OffsetMgr offsetMgr;
 
+    pthread_mutex_t mutexStats;
+    S3ReadStats stats;
+
+    // Configured chunk size, the upper bound of the adapted one.
+    uint64_t maxChunkSize;
+
+    // Chunk size reached by the previous key, to start the next one with.
+    uint64_t adaptedChunkSize;
+
+    // Whether the chunk size of the current key follows the download speed.
+    bool adaptingChunkSize;
+
+    void logStats();
+
     vector<ChunkBuffer> chunkBuffers;
     vector<pthread_t> threads;
 
@@ -162,8 +226,12 @@ class S3KeyReader : public Reader {
 
     void reset();
 
+    // Bytes returned by the last lend().
+    const char* lentData;
+
     bool hasEol;
     bool eolAppended;
+    bool appendEol;
 };
 
 class ChunkBuffer {
@@ -186,7 +254,13 @@ class ChunkBuffer {
         return this->sharedKeyReader.isSharedError();
     }
 
-    uint64_t read(char* buf, uint64_t len);
+    // Point data to up to len unread bytes of the chunk, once it is downloaded.
+    uint64_t lend(const char** data, uint64_t len);
+
+    // Consume count lent bytes. Return true if the chunk is used up, it is then handed back to
+    // the download thread for the next range.
+    bool release(uint64_t count);
+
     uint64_t fill();
 
     void setS3InterfaceService(S3Interface* s3) {
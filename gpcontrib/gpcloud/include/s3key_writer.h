@@ -8,21 +8,57 @@
 
 class WriterBuffer : public vector<uint8_t> {};
 
+// A full buffer queued for an upload thread.
+struct UploadPart {
+    UploadPart() : partNumber(0), data(NULL) {
+    }
+    UploadPart(uint64_t partNumber, S3VectorUInt8* data) : partNumber(partNumber), data(data) {
+    }
+
+    uint64_t partNumber;
+    S3VectorUInt8* data;
+};
+
+// Upload statistics of the key written by a S3KeyWriter.
+struct S3WriteStats {
+    S3WriteStats()
+        : numOfParts(0),
+          bytes(0),
+          uploadSeconds(0),
+          maxPartSeconds(0),
+          inflightBytes(0),
+          maxInflightBytes(0) {
+    }
+
+    uint64_t numOfParts;
+    uint64_t bytes;
+    double uploadSeconds;       // sum of the latencies of the parts
+    double maxPartSeconds;      // latency of the slowest part
+    uint64_t inflightBytes;     // bytes queued or being uploaded
+    uint64_t maxInflightBytes;  // peak of inflightBytes
+};
+
+// S3KeyWriter uploads parts of the key with threadnum upload threads started by open(). There
+// are threadnum part buffers besides the one write() fills, a full buffer is swapped with a free
+// one and queued for the upload threads. write() blocks while all of them are queued or being
+// uploaded, which bounds the memory to (threadnum + 1) * chunksize. A part is retried by its own
+// upload thread, the others go on with the next parts meanwhile.
 class S3KeyWriter : public Writer {
    public:
-    S3KeyWriter() : sharedError(false), s3Interface(NULL), partNumber(0), activeThreads(0) {
+    S3KeyWriter() : sharedError(false), s3Interface(NULL), partNumber(0), stopUploading(false) {
         pthread_mutex_init(&this->mutex, NULL);
         pthread_cond_init(&this->cv, NULL);
-        pthread_mutex_init(&this->exceptionMutex, NULL);
+        pthread_cond_init(&this->queueCv, NULL);
     }
     virtual ~S3KeyWriter() {
         try {
             this->close();
         } catch (...) {
         }
+        this->logStats();
         pthread_mutex_destroy(&this->mutex);
         pthread_cond_destroy(&this->cv);
-        pthread_mutex_destroy(&this->exceptionMutex);
+        pthread_cond_destroy(&this->queueCv);
     }
     virtual void open(const S3Params& params);
 
@@ -38,16 +74,23 @@ class S3KeyWriter : public Writer {
         this->s3Interface = s3;
     }
 
+    const S3WriteStats& getStats() const {
+        return stats;
+    }
+
    protected:
     static void* UploadThreadFunc(void* p);
 
+    void uploadPart(const UploadPart& part);
     void flushBuffer();
     void completeKeyWriting();
     void checkQueryCancelSignal();
+    void stopUploadThreads();
+    void logStats();
 
+    // Both are protected by mutex.
     bool sharedError;
     std::exception_ptr sharedException;
-    pthread_mutex_t exceptionMutex;
 
     S3VectorUInt8 buffer;
     S3Interface* s3Interface;
@@ -57,9 +100,17 @@ class S3KeyWriter : public Writer {
 
     vector<pthread_t> threadList;
     pthread_mutex_t mutex;
-    pthread_cond_t cv;
+    pthread_cond_t cv;       // a part buffer is freed, or an upload failed
+    pthread_cond_t queueCv;  // a part is queued, or the upload threads are to stop
     uint64_t partNumber;
-    uint64_t activeThreads;
+
+    // Part buffers and their states, protected by mutex.
+    vector<S3VectorUInt8> partBuffers;
+    vector<S3VectorUInt8*> freeParts;
+    std::queue<UploadPart> queuedParts;
+    bool stopUploading;
+
+    S3WriteStats stats;
 
     S3Params params;
 };
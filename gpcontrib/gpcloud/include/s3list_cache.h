@@ -0,0 +1,52 @@
+#ifndef INCLUDE_S3LIST_CACHE_H_
+#define INCLUDE_S3LIST_CACHE_H_
+
+#include "s3common_headers.h"
+#include "s3exception.h"
+#include "s3interface.h"
+
+// Directory of the listing files, under the data directory of the segment. Only the server
+// can write to it, and it is emptied of leftover listings when the server restarts.
+#define S3_LIST_CACHE_DIR "base/pgsql_tmp"
+
+// A lock file older than this is left behind by a crashed segment, and is taken over.
+#define S3_LIST_CACHE_LOCK_TIMEOUT_SECONDS 600
+
+// Interval at which waiting segments check for the listing.
+#define S3_LIST_CACHE_POLL_MICROSECONDS 50000
+
+// ListBucketCache shares the listing of a bucket prefix among the processes of a segment.
+//
+// The first process to ask for a listing takes a lock file, lists the bucket and saves the
+// result into a file, the others wait for that file and read it. Files are named after the
+// session, the scope and the URL: scans of the same scope (the distributed transaction) reuse
+// the listing, and the files of the previous scopes of the session are removed when a new
+// listing is saved. The files of a session are removed when it ends, see removeSession().
+class ListBucketCache {
+   public:
+    ListBucketCache(const string& dir, const string& session, const string& scope);
+
+    // Return the listing of s3Url, listed with s3Interface if no process did it yet.
+    ListBucketResult get(S3Url& s3Url, S3Interface* s3Interface);
+
+    // Remove the listings of the session from dir.
+    static void removeSession(const string& dir, const string& session);
+
+    const string& getPath() const {
+        return path;
+    }
+
+   private:
+    bool load(ListBucketResult& result);
+    void save(const ListBucketResult& result);
+    void removeOtherScopes();
+
+    string dir;
+    string session;
+    string scope;
+
+    string path;      // the listing
+    string lockPath;  // exists while a segment is listing
+};
+
+#endif /* INCLUDE_S3LIST_CACHE_H_ */
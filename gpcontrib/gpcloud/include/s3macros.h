@@ -35,4 +35,7 @@ extern uint64_t S3_ZIP_COMPRESS_CHUNKSIZE;
 // to enable zlib and gzip decoding with automatic header detection.
 #define S3_INFLATE_WINDOWSBITS (MAX_WBITS + 16 + 16)
 
+// Input given to the LZ4 frame compressor at a time, its output buffer is sized after it.
+#define S3_LZ4_COMPRESS_INPUT_SIZE (64 * 1024)
+
 #endif
@@ -7,12 +7,41 @@
 
 enum S3SSEType { SSE_NONE, SSE_S3 };
 
+enum S3CompressionType {
+    S3_COMPRESSION_GZIP,
+    S3_COMPRESSION_PLAIN,
+    S3_COMPRESSION_DEFLATE,
+    S3_COMPRESSION_ZSTD,
+    S3_COMPRESSION_LZ4,
+    S3_COMPRESSION_PARQUET,  // columnar, compressed per column chunk
+};
+
+enum S3FilterOp { S3_FILTER_LT, S3_FILTER_LE, S3_FILTER_EQ, S3_FILTER_GE, S3_FILTER_GT };
+
+// A "column op value" condition of a scan, rows not meeting it are dropped by the query. Values
+// are numbers, or strings if isString. Dates are numbers of days since 1970-01-01.
+struct S3ColumnFilter {
+    uint64_t column;  // index in S3ScanInfo::columnNames
+    S3FilterOp op;
+    string value;
+    bool isString;
+};
+
+// What a scan needs of the table, readers of columnar keys use it to read less of them.
+struct S3ScanInfo {
+    vector<string> columnNames;  // of the table, in order
+    vector<bool> projected;      // whether the scan uses each column
+    vector<S3ColumnFilter> filters;
+};
+
 class S3Params {
    public:
     S3Params(const string& sourceUrl = "", bool useHttps = true, const string& version = "",
              const string& region = "")
         : s3Url(sourceUrl, useHttps, version, region),
           keySize(0),
+          keyRangeOffset(0),
+          keyRangeLength(0),
           chunkSize(0),
           numOfChunks(0),
           lowSpeedLimit(0),
@@ -20,6 +49,7 @@ class S3Params {
           proxy(""),
           debugCurl(false),
           autoCompress(false),
+          compressionType(S3_COMPRESSION_GZIP),
           verifyCert(false),
           sseType(SSE_NONE),
           gpcheckcloud_newline("") {
@@ -72,6 +102,20 @@ class S3Params {
         this->keySize = size;
     }
 
+    uint64_t getKeyRangeOffset() const {
+        return keyRangeOffset;
+    }
+
+    uint64_t getKeyRangeLength() const {
+        return keyRangeLength;
+    }
+
+    // Read only 'length' bytes of the key starting at 'offset', length 0 means up to the end.
+    void setKeyRange(uint64_t offset, uint64_t length) {
+        this->keyRangeOffset = offset;
+        this->keyRangeLength = length;
+    }
+
     uint64_t getLowSpeedLimit() const {
         return lowSpeedLimit;
     }
@@ -111,6 +155,14 @@ class S3Params {
         this->autoCompress = autoCompress;
     }
 
+    S3CompressionType getCompressionType() const {
+        return compressionType;
+    }
+
+    void setCompressionType(S3CompressionType compressionType) {
+        this->compressionType = compressionType;
+    }
+
     const S3MemoryContext& getMemoryContext() const {
         return memoryContext;
     }
@@ -147,11 +199,40 @@ class S3Params {
         this->gpcheckcloud_newline = gpcheckcloud_newline;
     }
 
+    const string& getListCacheDir() const {
+        return listCacheDir;
+    }
+
+    const string& getListCacheSession() const {
+        return listCacheSession;
+    }
+
+    const string& getListCacheScope() const {
+        return listCacheScope;
+    }
+
+    void setListCache(const string& dir, const string& session, const string& scope) {
+        this->listCacheDir = dir;
+        this->listCacheSession = session;
+        this->listCacheScope = scope;
+    }
+
+    const S3ScanInfo& getScanInfo() const {
+        return scanInfo;
+    }
+
+    void setScanInfo(const S3ScanInfo& scanInfo) {
+        this->scanInfo = scanInfo;
+    }
+
    private:
     S3Url s3Url;  // original url to read/write.
 
     uint64_t keySize;  // key/file size.
 
+    uint64_t keyRangeOffset;  // start of the byte range to read.
+    uint64_t keyRangeLength;  // length of the byte range, 0 for the rest of the key.
+
     S3Credential cred;  // S3 credential.
 
     uint64_t chunkSize;    // chunk size
@@ -164,6 +245,7 @@ class S3Params {
 
     bool debugCurl;     // debug curl or not
     bool autoCompress;  // whether to compress data before uploading
+    S3CompressionType compressionType;  // codec used to compress uploaded data
     bool verifyCert;  // This option determines whether curl verifies the authenticity of the peer's
                       // certificate.
 
@@ -172,6 +254,14 @@ class S3Params {
     S3MemoryContext memoryContext;
 
     string gpcheckcloud_newline;  // newline LF, CRLF, CR
+
+    // Bucket listings are shared by the processes of a segment within a scope of a session, see
+    // ListBucketCache. Empty if every process lists the bucket itself.
+    string listCacheDir;
+    string listCacheSession;
+    string listCacheScope;
+
+    S3ScanInfo scanInfo;  // empty if the scan is not described
 };
 
 inline void PrepareS3MemContext(const S3Params& params) {
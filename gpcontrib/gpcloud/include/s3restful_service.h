@@ -10,6 +10,47 @@
 #include "s3macros.h"
 #include "s3params.h"
 
+// CURLHandlePool keeps idle curl easy handles, so that the connection cached
+// by each handle is reused by the next request instead of opening (and
+// TLS-handshaking) a new one for every chunk. It is shared by all threads of a
+// reader or writer; a handle is owned by one request at a time.
+class CURLHandlePool {
+   public:
+    CURLHandlePool();
+    ~CURLHandlePool();
+
+    // Return an idle handle with its options reset, or a new handle.
+    CURL* acquire();
+
+    // Return a handle whose last transfer succeeded, its connection is kept.
+    void release(CURL* curl);
+
+    // Close a handle whose last transfer failed, the connection may be in an
+    // unknown state and must not be reused by a retry.
+    void discard(CURL* curl);
+
+    // Close all idle handles.
+    void clear();
+
+    uint64_t getRequestCount();
+    uint64_t getConnectionCount();
+
+   private:
+    vector<CURL*> idleHandles;
+    pthread_mutex_t mutex;
+
+    // statistics of the transfers done with handles of this pool
+    uint64_t requestCount;
+    uint64_t connectionCount;
+
+    void countTransfer(CURL* curl);
+
+    CURLHandlePool(const CURLHandlePool&);
+    CURLHandlePool& operator=(const CURLHandlePool&);
+};
+
+struct CURLWrapper;
+
 class S3RESTfulService : public RESTfulService {
    public:
     S3RESTfulService();
@@ -27,6 +68,14 @@ class S3RESTfulService : public RESTfulService {
 
     Response deleteRequest(const string& url, HTTPHeaders& headers);
 
+    // number of requests sent, and of connections opened for them
+    uint64_t getRequestCount() {
+        return this->handlePool.getRequestCount();
+    }
+    uint64_t getConnectionCount() {
+        return this->handlePool.getConnectionCount();
+    }
+
    private:
     uint64_t lowSpeedLimit;
     uint64_t lowSpeedTime;
@@ -39,7 +88,9 @@ class S3RESTfulService : public RESTfulService {
     uint64_t chunkBufferSize;
     S3MemoryContext s3MemContext;
 
-    void performCurl(CURL* curl, Response& response);
+    CURLHandlePool handlePool;
+
+    void performCurl(CURLWrapper& wrapper, Response& response);
 };
 
 class S3MessageParser {
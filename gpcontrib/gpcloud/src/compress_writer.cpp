@@ -123,3 +123,179 @@ void CompressWriter::flush() {
         this->zstream.avail_out = S3_ZIP_COMPRESS_CHUNKSIZE;
     }
 }
+
+#ifdef USE_ZSTD
+ZstdCompressWriter::ZstdCompressWriter() : writer(NULL), cctx(NULL), isClosed(true) {
+    this->outSize = S3_ZIP_COMPRESS_CHUNKSIZE;
+    this->out = new char[this->outSize];
+}
+
+ZstdCompressWriter::~ZstdCompressWriter() {
+    try {
+        this->close();
+    } catch (...) {
+    }
+    delete[] this->out;
+}
+
+void ZstdCompressWriter::open(const S3Params& params) {
+    this->cctx = ZSTD_createCCtx();
+    S3_CHECK_OR_DIE(this->cctx != NULL, S3RuntimeError, "Failed to initialize zstd library");
+
+    this->isClosed = false;
+
+    ZSTD_CCtx_setParameter(this->cctx, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+
+    size_t ret = ZSTD_CCtx_setParameter(this->cctx, ZSTD_c_nbWorkers, params.getNumOfChunks());
+    if (ZSTD_isError(ret)) {
+        S3DEBUG("zstd compresses in a single thread: %s", ZSTD_getErrorName(ret));
+    }
+
+    this->writer->open(params);
+}
+
+size_t ZstdCompressWriter::compress(ZSTD_inBuffer* in, ZSTD_EndDirective mode) {
+    ZSTD_outBuffer output = {this->out, this->outSize, 0};
+
+    size_t ret = ZSTD_compressStream2(this->cctx, &output, in, mode);
+    S3_CHECK_OR_DIE(!ZSTD_isError(ret), S3RuntimeError,
+                    string("Failed to compress data: ") + ZSTD_getErrorName(ret));
+
+    if (output.pos != 0) {
+        this->writer->write(this->out, output.pos);
+    }
+
+    return ret;
+}
+
+uint64_t ZstdCompressWriter::write(const char* buf, uint64_t count) {
+    // Defensive code
+    if (buf == NULL || count == 0) {
+        return 0;
+    }
+
+    // The workers might not take all of the input at once.
+    ZSTD_inBuffer in = {buf, count, 0};
+    while (in.pos < in.size) {
+        this->compress(&in, ZSTD_e_continue);
+    }
+
+    return count;
+}
+
+void ZstdCompressWriter::close() {
+    if (this->isClosed) {
+        return;
+    }
+
+    // the frame can't be finished after an error, and won't be tried again
+    this->isClosed = true;
+
+    ZSTD_inBuffer in = {NULL, 0, 0};
+    try {
+        while (this->compress(&in, ZSTD_e_end) != 0) {
+        }
+    } catch (...) {
+        ZSTD_freeCCtx(this->cctx);
+        this->cctx = NULL;
+        throw;
+    }
+
+    ZSTD_freeCCtx(this->cctx);
+    this->cctx = NULL;
+
+    S3DEBUG("Compression finished: end of zstd frame.");
+
+    this->writer->close();
+}
+
+void ZstdCompressWriter::setWriter(Writer* writer) {
+    this->writer = writer;
+}
+#endif
+
+#ifdef USE_LZ4
+LZ4CompressWriter::LZ4CompressWriter() : writer(NULL), cctx(NULL), isClosed(true) {
+    memset(&this->prefs, 0, sizeof(this->prefs));
+    this->prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+    // big enough for the frame header, any input piece, and the frame end
+    this->outSize = LZ4F_compressBound(S3_LZ4_COMPRESS_INPUT_SIZE, &this->prefs) +
+                    LZ4F_HEADER_SIZE_MAX;
+    this->out = new char[this->outSize];
+}
+
+LZ4CompressWriter::~LZ4CompressWriter() {
+    try {
+        this->close();
+    } catch (...) {
+    }
+    delete[] this->out;
+}
+
+void LZ4CompressWriter::open(const S3Params& params) {
+    LZ4F_errorCode_t err = LZ4F_createCompressionContext(&this->cctx, LZ4F_VERSION);
+    S3_CHECK_OR_DIE(!LZ4F_isError(err), S3RuntimeError,
+                    string("Failed to initialize lz4 library: ") + LZ4F_getErrorName(err));
+
+    this->isClosed = false;
+
+    this->writer->open(params);
+
+    size_t ret = LZ4F_compressBegin(this->cctx, this->out, this->outSize, &this->prefs);
+    S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                    string("Failed to compress data: ") + LZ4F_getErrorName(ret));
+    this->writer->write(this->out, ret);
+}
+
+uint64_t LZ4CompressWriter::write(const char* buf, uint64_t count) {
+    // Defensive code
+    if (buf == NULL || count == 0) {
+        return 0;
+    }
+
+    // out is sized for S3_LZ4_COMPRESS_INPUT_SIZE bytes of input.
+    uint64_t writtenLen = 0;
+    while (writtenLen < count) {
+        uint64_t len = std::min(count - writtenLen, (uint64_t)S3_LZ4_COMPRESS_INPUT_SIZE);
+
+        size_t ret =
+            LZ4F_compressUpdate(this->cctx, this->out, this->outSize, buf + writtenLen, len, NULL);
+        S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                        string("Failed to compress data: ") + LZ4F_getErrorName(ret));
+
+        if (ret != 0) {
+            this->writer->write(this->out, ret);
+        }
+
+        writtenLen += len;
+    }
+
+    return writtenLen;
+}
+
+void LZ4CompressWriter::close() {
+    if (this->isClosed) {
+        return;
+    }
+
+    // the frame can't be finished after an error, and won't be tried again
+    this->isClosed = true;
+
+    size_t ret = LZ4F_compressEnd(this->cctx, this->out, this->outSize, NULL);
+    LZ4F_freeCompressionContext(this->cctx);
+    this->cctx = NULL;
+
+    S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                    string("Failed to compress data: ") + LZ4F_getErrorName(ret));
+    this->writer->write(this->out, ret);
+
+    S3DEBUG("Compression finished: end of lz4 frame.");
+
+    this->writer->close();
+}
+
+void LZ4CompressWriter::setWriter(Writer* writer) {
+    this->writer = writer;
+}
+#endif
@@ -4,7 +4,7 @@ uint64_t S3_ZIP_DECOMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
 
 DecompressReader::DecompressReader() : isClosed(true) {
     this->reader = NULL;
-    this->in = new char[S3_ZIP_DECOMPRESS_CHUNKSIZE];
+    this->inLen = 0;
     this->out = new char[S3_ZIP_DECOMPRESS_CHUNKSIZE];
     this->outOffset = 0;
 }
@@ -12,15 +12,12 @@ DecompressReader::DecompressReader() : isClosed(true) {
 DecompressReader::~DecompressReader() {
     this->close();
 
-    delete this->in;
     delete this->out;
 }
 
 // Used for unit test to adjust buffer size
 void DecompressReader::resizeDecompressReaderBuffer(uint64_t size) {
-    delete this->in;
     delete this->out;
-    this->in = new char[size];
     this->out = new char[size];
     this->outOffset = 0;
     this->zstream.avail_out = size;
@@ -41,6 +38,7 @@ void DecompressReader::open(const S3Params &params) {
     zstream.avail_in = 0;
     zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
 
+    this->inLen = 0;
     this->outOffset = 0;
 
     // with S3_INFLATE_WINDOWSBITS, it could recognize and decode both zlib and gzip stream.
@@ -53,6 +51,18 @@ void DecompressReader::open(const S3Params &params) {
 }
 
 uint64_t DecompressReader::read(char *buf, uint64_t bufSize) {
+    const char *data = NULL;
+    uint64_t count = this->lend(&data, bufSize);
+
+    if (count != 0) {
+        memcpy(buf, data, count);
+        this->release(count);
+    }
+
+    return count;
+}
+
+uint64_t DecompressReader::lend(const char **data, uint64_t count) {
     uint64_t remainingOutLen = this->getDecompressedBytesNum() - this->outOffset;
 
     if (remainingOutLen == 0) {
@@ -61,72 +71,302 @@ uint64_t DecompressReader::read(char *buf, uint64_t bufSize) {
         remainingOutLen = this->getDecompressedBytesNum();
     }
 
-    uint64_t count = std::min(remainingOutLen, bufSize);
-    memcpy(buf, this->out + outOffset, count);
+    *data = this->out + this->outOffset;
+    return std::min(remainingOutLen, count);
+}
 
+void DecompressReader::release(uint64_t count) {
     this->outOffset += count;
-
-    return count;
 }
 
-// Read compressed data from underlying reader and decompress to this->out buffer.
+// Decompress data lent by the underlying reader to this->out buffer.
 // If no more data to consume, this->zstream.avail_out == S3_ZIP_DECOMPRESS_CHUNKSIZE;
 void DecompressReader::decompress() {
-    if (this->zstream.avail_in == 0) {
+    int status = Z_OK;
+
+    // The underlying reader lends what it has at hand, which might be too little to inflate
+    // anything, go on until there is output.
+    do {
         this->zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
         this->zstream.next_out = (Byte *)this->out;
 
-        // read S3_ZIP_DECOMPRESS_CHUNKSIZE data from underlying reader and put into this->in
-        // buffer. read() might happen more than once when reaching EOF, make sure every time read()
-        // will return 0.
-        uint64_t hasRead = this->reader->read(this->in, S3_ZIP_DECOMPRESS_CHUNKSIZE);
-
-        // EOF, no more data to decompress.
-        if (hasRead == 0) {
-            S3DEBUG(
-                "No more data to decompress: avail_in = %u, avail_out = %u, total_in = %u, "
-                "total_out = %u",
-                zstream.avail_in, zstream.avail_out,
-		(unsigned int) zstream.total_in, (unsigned int) zstream.total_out);
-            return;
+        if (this->zstream.avail_in == 0) {
+            // the input is inflated, it can be handed back
+            this->reader->release(this->inLen);
+            this->inLen = 0;
+
+            // read() might happen more than once when reaching EOF, make sure every time lend()
+            // will return 0.
+            const char *in = NULL;
+            uint64_t hasRead = this->reader->lend(&in, S3_ZIP_DECOMPRESS_CHUNKSIZE);
+
+            // EOF, no more data to decompress.
+            if (hasRead == 0) {
+                S3DEBUG(
+                    "No more data to decompress: avail_in = %u, avail_out = %u, total_in = %u, "
+                    "total_out = %u",
+                    zstream.avail_in, zstream.avail_out, (unsigned int)zstream.total_in,
+                    (unsigned int)zstream.total_out);
+                return;
+            }
+
+            this->inLen = hasRead;
+            this->zstream.next_in = (Byte *)in;
+            this->zstream.avail_in = hasRead;
         }
 
-        // Fill this->in as possible as it could, otherwise data in this->in might not be able to be
-        // inflated.
-        while (hasRead < S3_ZIP_DECOMPRESS_CHUNKSIZE) {
-            uint64_t count =
-                this->reader->read(this->in + hasRead, S3_ZIP_DECOMPRESS_CHUNKSIZE - hasRead);
+        status = inflate(&this->zstream, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            S3DEBUG("Decompression finished: Z_STREAM_END.");
+        } else if (status < 0 || status == Z_NEED_DICT) {
+            inflateEnd(&this->zstream);
+            S3_CHECK_OR_DIE(
+                false, S3RuntimeError,
+                string("Failed to decompress data: ") + std::to_string((unsigned long long)status));
+        }
+    } while (this->getDecompressedBytesNum() == 0 && status != Z_STREAM_END);
+}
+
+void DecompressReader::close() {
+    if (!this->isClosed) {
+        inflateEnd(&zstream);
+        this->inLen = 0;
+        this->reader->close();
+        this->isClosed = true;
+    }
+}
+
+#ifdef USE_ZSTD
+ZstdDecompressReader::ZstdDecompressReader() : reader(NULL), dctx(NULL), isClosed(true) {
+    this->outSize = S3_ZIP_DECOMPRESS_CHUNKSIZE;
+    this->out = new char[this->outSize];
+    this->outLen = 0;
+    this->outOffset = 0;
+    this->outFull = false;
+    this->frameEnded = true;
+    this->in.src = NULL;
+    this->in.size = 0;
+    this->in.pos = 0;
+}
+
+ZstdDecompressReader::~ZstdDecompressReader() {
+    this->close();
+
+    delete[] this->out;
+}
+
+void ZstdDecompressReader::setReader(Reader *reader) {
+    this->reader = reader;
+}
+
+void ZstdDecompressReader::open(const S3Params &params) {
+    this->dctx = ZSTD_createDCtx();
+    S3_CHECK_OR_DIE(this->dctx != NULL, S3RuntimeError, "failed to initialize zstd library");
+
+    this->in.src = NULL;
+    this->in.size = 0;
+    this->in.pos = 0;
+    this->outLen = 0;
+    this->outOffset = 0;
+    this->outFull = false;
+    this->frameEnded = true;
+
+    this->isClosed = false;
+
+    this->reader->open(params);
+}
+
+uint64_t ZstdDecompressReader::read(char *buf, uint64_t bufSize) {
+    const char *data = NULL;
+    uint64_t count = this->lend(&data, bufSize);
+
+    if (count != 0) {
+        memcpy(buf, data, count);
+        this->release(count);
+    }
+
+    return count;
+}
+
+uint64_t ZstdDecompressReader::lend(const char **data, uint64_t count) {
+    if (this->outOffset == this->outLen) {
+        this->decompress();
+    }
+
+    *data = this->out + this->outOffset;
+    return std::min(this->outLen - this->outOffset, count);
+}
+
+void ZstdDecompressReader::release(uint64_t count) {
+    this->outOffset += count;
+}
+
+// Decompress data lent by the underlying reader to this->out buffer, outLen is 0 at EOF.
+void ZstdDecompressReader::decompress() {
+    this->outLen = 0;
+    this->outOffset = 0;
+
+    while (this->outLen == 0) {
+        // Output left in the decoder is flushed before more input is taken.
+        if (this->in.pos == this->in.size && !this->outFull) {
+            this->reader->release(this->in.size);
+
+            const char *data = NULL;
+            uint64_t lentLen = this->reader->lend(&data, S3_ZIP_DECOMPRESS_CHUNKSIZE);
 
-            if (count == 0) {
-                break;
+            this->in.src = data;
+            this->in.size = lentLen;
+            this->in.pos = 0;
+
+            if (lentLen == 0) {
+                S3_CHECK_OR_DIE(this->frameEnded, S3RuntimeError,
+                                "Failed to decompress data: zstd frame is truncated");
+                S3DEBUG("Decompression finished: end of zstd stream.");
+                return;
             }
+        }
 
-            hasRead += count;
+        ZSTD_outBuffer output = {this->out, this->outSize, 0};
+        size_t inPos = this->in.pos;
+        size_t ret = ZSTD_decompressStream(this->dctx, &output, &this->in);
+        S3_CHECK_OR_DIE(!ZSTD_isError(ret), S3RuntimeError,
+                        string("Failed to decompress data: ") + ZSTD_getErrorName(ret));
+
+        this->outLen = output.pos;
+        this->outFull = output.pos == output.size;
+
+        // A call that finds nothing left after the end of a frame asks for the next frame.
+        if (output.pos != 0 || this->in.pos != inPos) {
+            this->frameEnded = ret == 0;
         }
+    }
+}
 
-        this->zstream.next_in = (Byte *)this->in;
-        this->zstream.avail_in = hasRead;
-    } else {
-        // Still have more data in 'in' buffer to decode.
-        this->zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
-        this->zstream.next_out = (Byte *)this->out;
+void ZstdDecompressReader::close() {
+    if (!this->isClosed) {
+        ZSTD_freeDCtx(this->dctx);
+        this->dctx = NULL;
+        this->in.size = 0;
+        this->in.pos = 0;
+        this->reader->close();
+        this->isClosed = true;
+    }
+}
+#endif
+
+#ifdef USE_LZ4
+LZ4DecompressReader::LZ4DecompressReader() : reader(NULL), dctx(NULL), isClosed(true) {
+    this->in = NULL;
+    this->inLen = 0;
+    this->inOffset = 0;
+    this->outSize = S3_ZIP_DECOMPRESS_CHUNKSIZE;
+    this->out = new char[this->outSize];
+    this->outLen = 0;
+    this->outOffset = 0;
+    this->outFull = false;
+    this->frameEnded = true;
+}
+
+LZ4DecompressReader::~LZ4DecompressReader() {
+    this->close();
+
+    delete[] this->out;
+}
+
+void LZ4DecompressReader::setReader(Reader *reader) {
+    this->reader = reader;
+}
+
+void LZ4DecompressReader::open(const S3Params &params) {
+    LZ4F_errorCode_t ret = LZ4F_createDecompressionContext(&this->dctx, LZ4F_VERSION);
+    S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                    string("failed to initialize lz4 library: ") + LZ4F_getErrorName(ret));
+
+    this->in = NULL;
+    this->inLen = 0;
+    this->inOffset = 0;
+    this->outLen = 0;
+    this->outOffset = 0;
+    this->outFull = false;
+    this->frameEnded = true;
+
+    this->isClosed = false;
+
+    this->reader->open(params);
+}
+
+uint64_t LZ4DecompressReader::read(char *buf, uint64_t bufSize) {
+    const char *data = NULL;
+    uint64_t count = this->lend(&data, bufSize);
+
+    if (count != 0) {
+        memcpy(buf, data, count);
+        this->release(count);
     }
 
-    int status = inflate(&this->zstream, Z_NO_FLUSH);
-    if (status == Z_STREAM_END) {
-        S3DEBUG("Decompression finished: Z_STREAM_END.");
-    } else if (status < 0 || status == Z_NEED_DICT) {
-        inflateEnd(&this->zstream);
-        S3_CHECK_OR_DIE(
-            false, S3RuntimeError,
-            string("Failed to decompress data: ") + std::to_string((unsigned long long)status));
+    return count;
+}
+
+uint64_t LZ4DecompressReader::lend(const char **data, uint64_t count) {
+    if (this->outOffset == this->outLen) {
+        this->decompress();
     }
+
+    *data = this->out + this->outOffset;
+    return std::min(this->outLen - this->outOffset, count);
 }
 
-void DecompressReader::close() {
+void LZ4DecompressReader::release(uint64_t count) {
+    this->outOffset += count;
+}
+
+// Decompress data lent by the underlying reader to this->out buffer, outLen is 0 at EOF.
+void LZ4DecompressReader::decompress() {
+    this->outLen = 0;
+    this->outOffset = 0;
+
+    while (this->outLen == 0) {
+        // Output left in the decoder is flushed before more input is taken.
+        if (this->inOffset == this->inLen && !this->outFull) {
+            this->reader->release(this->inLen);
+
+            this->inLen = this->reader->lend(&this->in, S3_ZIP_DECOMPRESS_CHUNKSIZE);
+            this->inOffset = 0;
+
+            if (this->inLen == 0) {
+                S3_CHECK_OR_DIE(this->frameEnded, S3RuntimeError,
+                                "Failed to decompress data: lz4 frame is truncated");
+                S3DEBUG("Decompression finished: end of lz4 stream.");
+                return;
+            }
+        }
+
+        size_t dstSize = this->outSize;
+        size_t srcSize = this->inLen - this->inOffset;
+        size_t ret = LZ4F_decompress(this->dctx, this->out, &dstSize, this->in + this->inOffset,
+                                     &srcSize, NULL);
+        S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                        string("Failed to decompress data: ") + LZ4F_getErrorName(ret));
+
+        this->inOffset += srcSize;
+        this->outLen = dstSize;
+        this->outFull = dstSize == this->outSize;
+
+        // A call that finds nothing left after the end of a frame asks for the next frame.
+        if (dstSize != 0 || srcSize != 0) {
+            this->frameEnded = ret == 0;
+        }
+    }
+}
+
+void LZ4DecompressReader::close() {
     if (!this->isClosed) {
-        inflateEnd(&zstream);
+        LZ4F_freeDecompressionContext(this->dctx);
+        this->dctx = NULL;
+        this->inLen = 0;
+        this->inOffset = 0;
         this->reader->close();
         this->isClosed = true;
     }
 }
+#endif
@@ -12,14 +12,24 @@ extern "C" {
 #endif
 
 #include "access/extprotocol.h"
+#include "access/fileam.h"
 #include "access/xact.h"
 #include "catalog/pg_exttable.h"
+#include "catalog/pg_namespace.h"
 #include "catalog/pg_proc.h"
+#include "catalog/pg_type.h"
 #include "fmgr.h"
 #include "funcapi.h"
+#include "nodes/execnodes.h"
+#include "optimizer/var.h"
+#include "storage/ipc.h"
 #include "utils/array.h"
 #include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/guc.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
+#include "utils/pg_locale.h"
 #include "utils/resowner.h"
 
 #ifdef __clang__
@@ -37,6 +47,8 @@ Datum s3_import(PG_FUNCTION_ARGS);
 
 #include "gpreader.h"
 #include "gpwriter.h"
+#include "s3conf.h"
+#include "s3list_cache.h"
 
 string s3extErrorMessage;
 
@@ -121,6 +133,8 @@ static const char *getFormatStr(FunctionCallInfo fcinfo) {
 
 bool hasHeader = false;
 
+bool isCsv = false;
+
 char eolString[EOL_CHARS_MAX_LEN + 1] = "\n";  // LF by default
 
 static void parseFormatOpts(FunctionCallInfo fcinfo) {
@@ -130,6 +144,8 @@ static void parseFormatOpts(FunctionCallInfo fcinfo) {
     const char fmtcode = exttbl->fmtcode;
     const char *fmtopts = exttbl->fmtopts;
 
+    isCsv = fmttype_is_csv(fmtcode);
+
     // only TEXT and CSV have detailed options
     if (fmttype_is_csv(fmtcode) || fmttype_is_text(fmtcode)) {
         if (strstr(fmtopts, "header") != NULL) {
@@ -171,6 +187,204 @@ static void parseFormatOpts(FunctionCallInfo fcinfo) {
     }
 }
 
+enum ScanValueClass { SCAN_VALUE_NONE, SCAN_VALUE_NUMBER, SCAN_VALUE_STRING, SCAN_VALUE_DATE };
+
+// Types of columns and constants whose comparisons can be checked against Parquet statistics.
+static ScanValueClass getScanValueClass(Oid type) {
+    switch (type) {
+        case INT2OID:
+        case INT4OID:
+        case INT8OID:
+        case FLOAT4OID:
+        case FLOAT8OID:
+        case NUMERICOID:
+            return SCAN_VALUE_NUMBER;
+        case TEXTOID:
+        case VARCHAROID:
+            return SCAN_VALUE_STRING;
+        case DATEOID:
+            return SCAN_VALUE_DATE;
+        default:
+            return SCAN_VALUE_NONE;
+    }
+}
+
+static Node *stripRelabel(Node *node) {
+    while (node != NULL && IsA(node, RelabelType)) {
+        node = (Node *)((RelabelType *)node)->arg;
+    }
+    return node;
+}
+
+/*
+ * Convert a "column op constant" qual into a filter, return false if the qual is anything else.
+ * columnIndex maps attribute numbers to indexes in the column names of the scan.
+ */
+static bool getColumnFilter(Expr *qual, const vector<int> &columnIndex, S3ColumnFilter &filter) {
+    if (!IsA(qual, OpExpr) || list_length(((OpExpr *)qual)->args) != 2) return false;
+
+    OpExpr *opExpr = (OpExpr *)qual;
+    Node *left = stripRelabel((Node *)linitial(opExpr->args));
+    Node *right = stripRelabel((Node *)lsecond(opExpr->args));
+    Oid opno = opExpr->opno;
+
+    if (IsA(left, Const) && IsA(right, Var)) {
+        std::swap(left, right);
+        opno = get_commutator(opno);
+    }
+
+    if (!OidIsValid(opno) || !IsA(left, Var) || !IsA(right, Const) ||
+        get_opnamespace(opno) != PG_CATALOG_NAMESPACE)
+        return false;
+
+    Var *var = (Var *)left;
+    Const *value = (Const *)right;
+    if (var->varattno <= 0 || var->varattno >= (int)columnIndex.size() ||
+        columnIndex[var->varattno] < 0 || value->constisnull)
+        return false;
+
+    ScanValueClass valueClass = getScanValueClass(var->vartype);
+    if (valueClass == SCAN_VALUE_NONE || valueClass != getScanValueClass(value->consttype))
+        return false;
+
+    const char *opname = get_opname(opno);
+    if (opname == NULL) return false;
+
+    if (strcmp(opname, "<") == 0)
+        filter.op = S3_FILTER_LT;
+    else if (strcmp(opname, "<=") == 0)
+        filter.op = S3_FILTER_LE;
+    else if (strcmp(opname, "=") == 0)
+        filter.op = S3_FILTER_EQ;
+    else if (strcmp(opname, ">=") == 0)
+        filter.op = S3_FILTER_GE;
+    else if (strcmp(opname, ">") == 0)
+        filter.op = S3_FILTER_GT;
+    else
+        return false;
+
+    // only strings of the C collation are ordered as their bytes
+    if (valueClass == SCAN_VALUE_STRING && filter.op != S3_FILTER_EQ &&
+        !lc_collate_is_c(opExpr->inputcollid))
+        return false;
+
+    char buf[64];
+    switch (value->consttype) {
+        case INT2OID:
+            snprintf(buf, sizeof(buf), "%d", (int)DatumGetInt16(value->constvalue));
+            filter.value = buf;
+            break;
+        case INT4OID:
+            snprintf(buf, sizeof(buf), "%d", (int)DatumGetInt32(value->constvalue));
+            filter.value = buf;
+            break;
+        case INT8OID:
+            snprintf(buf, sizeof(buf), INT64_FORMAT, DatumGetInt64(value->constvalue));
+            filter.value = buf;
+            break;
+        case FLOAT4OID:
+        case FLOAT8OID: {
+            double number = value->consttype == FLOAT4OID ? DatumGetFloat4(value->constvalue)
+                                                          : DatumGetFloat8(value->constvalue);
+            if (isnan(number) || isinf(number)) return false;
+
+            // hexadecimal, to be read back exactly
+            snprintf(buf, sizeof(buf), "%a", number);
+            filter.value = buf;
+            break;
+        }
+        case NUMERICOID:
+            filter.value = DatumGetCString(DirectFunctionCall1(numeric_out, value->constvalue));
+            break;
+        case DATEOID: {
+            DateADT date = DatumGetDateADT(value->constvalue);
+            if (DATE_NOT_FINITE(date)) return false;
+
+            snprintf(buf, sizeof(buf), "%d", (int)(date + POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE));
+            filter.value = buf;
+            break;
+        }
+        default:
+            filter.value = TextDatumGetCString(value->constvalue);
+            break;
+    }
+
+    filter.column = columnIndex[var->varattno];
+    filter.isString = valueClass == SCAN_VALUE_STRING;
+    return true;
+}
+
+static void markProjected(Node *node, const vector<int> &columnIndex, S3ScanInfo &scanInfo) {
+    List *vars = pull_var_clause(node, PVC_RECURSE_AGGREGATES, PVC_RECURSE_PLACEHOLDERS);
+    ListCell *lc;
+
+    foreach (lc, vars) {
+        Var *var = (Var *)lfirst(lc);
+        if (var->varattno == 0) {
+            // whole-row reference
+            scanInfo.projected.assign(scanInfo.projected.size(), true);
+        } else if (var->varattno > 0 && var->varattno < (int)columnIndex.size() &&
+                   columnIndex[var->varattno] >= 0) {
+            scanInfo.projected[columnIndex[var->varattno]] = true;
+        }
+    }
+
+    list_free(vars);
+}
+
+/*
+ * Describe the scan to readers of columnar keys: the columns of the table, the ones the query
+ * uses, and its quals they can skip data with. Quals are needed to know the columns used, so
+ * nothing is left out when they are not passed to the protocol.
+ */
+static S3ScanInfo getScanInfo(FunctionCallInfo fcinfo) {
+    S3ScanInfo scanInfo;
+    Relation rel = EXTPROTOCOL_GET_RELATION(fcinfo);
+    TupleDesc tupdesc = RelationGetDescr(rel);
+    ExternalSelectDesc desc = EXTPROTOCOL_GET_EXTERNAL_SELECT_DESC(fcinfo);
+
+    // dropped columns are not in the data
+    vector<int> columnIndex(tupdesc->natts + 1, -1);
+    for (int i = 0; i < tupdesc->natts; i++) {
+        if (!tupdesc->attrs[i]->attisdropped) {
+            columnIndex[i + 1] = scanInfo.columnNames.size();
+            scanInfo.columnNames.push_back(NameStr(tupdesc->attrs[i]->attname));
+        }
+    }
+
+    bool projecting =
+        desc != NULL && desc->projInfo != NULL && gp_external_enable_filter_pushdown;
+    scanInfo.projected.assign(scanInfo.columnNames.size(), !projecting);
+    if (!projecting) {
+        return scanInfo;
+    }
+
+    ProjectionInfo *projInfo = desc->projInfo;
+    for (int i = 0; i < projInfo->pi_numSimpleVars; i++) {
+        int attnum = projInfo->pi_varNumbers[i];
+        if (attnum > 0 && attnum < (int)columnIndex.size() && columnIndex[attnum] >= 0) {
+            scanInfo.projected[columnIndex[attnum]] = true;
+        }
+    }
+
+    ListCell *lc;
+    foreach (lc, projInfo->pi_targetlist) {
+        GenericExprState *gstate = (GenericExprState *)lfirst(lc);
+        markProjected((Node *)gstate->arg->expr, columnIndex, scanInfo);
+    }
+
+    markProjected((Node *)desc->filter_quals, columnIndex, scanInfo);
+
+    foreach (lc, desc->filter_quals) {
+        S3ColumnFilter filter;
+        if (getColumnFilter((Expr *)lfirst(lc), columnIndex, filter)) {
+            scanInfo.filters.push_back(filter);
+        }
+    }
+
+    return scanInfo;
+}
+
 typedef struct gpcloudResHandle {
     GPReader *gpreader;
     GPWriter *gpwriter;
@@ -187,6 +401,8 @@ static gpcloudResHandle *openedResHandles;
 
 static bool isGpcloudResReleaseCallbackRegistered;
 
+static bool isGpcloudListCacheCleanupRegistered;
+
 static gpcloudResHandle *createGpcloudResHandle(void) {
     gpcloudResHandle *resHandle;
 
@@ -260,6 +476,17 @@ static void gpcloudAbortCallback(ResourceReleasePhase phase, bool isCommit, bool
     }
 }
 
+/*
+ * Remove the bucket listings of the session when its process exits.
+ */
+static void gpcloudListCacheCleanup(int code, Datum arg) {
+    try {
+        ListBucketCache::removeSession(GetListCacheDir(), GetListCacheSession());
+    } catch (...) {
+        elog(LOG, "Failed to remove the bucket listings of the session");
+    }
+}
+
 /*
  * Import data into GPDB.
  * invoked by GPDB, be careful with C++ exceptions.
@@ -286,6 +513,10 @@ Datum s3_import(PG_FUNCTION_ARGS) {
             RegisterResourceReleaseCallback(gpcloudAbortCallback, NULL);
             isGpcloudResReleaseCallbackRegistered = true;
         }
+        if (!isGpcloudListCacheCleanupRegistered) {
+            on_proc_exit(gpcloudListCacheCleanup, 0);
+            isGpcloudListCacheCleanupRegistered = true;
+        }
         resHandle = createGpcloudResHandle();
 
         queryCancelFlag = false;
@@ -296,7 +527,8 @@ Datum s3_import(PG_FUNCTION_ARGS) {
 
         thread_setup();
 
-        resHandle->gpreader = reader_init(url_with_options);
+        S3ScanInfo scanInfo = getScanInfo(fcinfo);
+        resHandle->gpreader = reader_init(url_with_options, &scanInfo);
         if (!resHandle->gpreader) {
             ereport(ERROR, (0, errmsg("Failed to init gpcloud extension (segid = %d, "
                                       "segnum = %d), please check your "
@@ -77,13 +77,21 @@ uint64_t GPReader::read(char* buf, uint64_t count) {
     return this->bucketReader.read(buf, count);
 }
 
+uint64_t GPReader::lend(const char** data, uint64_t count) {
+    return this->bucketReader.lend(data, count);
+}
+
+void GPReader::release(uint64_t count) {
+    this->bucketReader.release(count);
+}
+
 // This should be reentrant, has no side effects when called multiple times.
 void GPReader::close() {
     this->bucketReader.close();
 }
 
 // invoked by s3_import(), need to be exception safe
-GPReader* reader_init(const char* url_with_options) {
+GPReader* reader_init(const char* url_with_options, const S3ScanInfo* scanInfo) {
     GPReader* reader = NULL;
     s3extErrorMessage.clear();
 
@@ -95,6 +103,9 @@ GPReader* reader_init(const char* url_with_options) {
         string urlWithOptions(url_with_options);
 
         S3Params params = InitConfig(urlWithOptions);
+        if (scanInfo != NULL) {
+            params.setScanInfo(*scanInfo);
+        }
 
         InitRemoteLog();
 
@@ -148,6 +159,54 @@ bool reader_transfer_data(GPReader* reader, char* data_buf, int& data_len) {
     return true;
 }
 
+// need to be exception safe
+bool reader_lend_data(GPReader* reader, const char** data_buf, int& data_len) {
+    try {
+        if (!reader || !data_buf || (data_len <= 0)) {
+            return false;
+        }
+
+        uint64_t lent_len = reader->lend(data_buf, data_len);
+
+        // sure lent_len <= data_len here, hence truncation will never happen
+        data_len = (int)lent_len;
+    } catch (S3Exception& e) {
+        s3extErrorMessage =
+            "reader_lend_data caught a " + e.getType() + " exception: " + e.getFullMessage();
+        S3ERROR("reader_lend_data caught %s: %s", e.getType().c_str(), s3extErrorMessage.c_str());
+        return false;
+    } catch (...) {
+        S3ERROR("Caught an unexpected exception.");
+        s3extErrorMessage = "Caught an unexpected exception.";
+        return false;
+    }
+
+    return true;
+}
+
+// need to be exception safe
+bool reader_release_data(GPReader* reader, int data_len) {
+    try {
+        if (!reader || (data_len < 0)) {
+            return false;
+        }
+
+        reader->release(data_len);
+    } catch (S3Exception& e) {
+        s3extErrorMessage =
+            "reader_release_data caught a " + e.getType() + " exception: " + e.getFullMessage();
+        S3ERROR("reader_release_data caught %s: %s", e.getType().c_str(),
+                s3extErrorMessage.c_str());
+        return false;
+    } catch (...) {
+        S3ERROR("Caught an unexpected exception.");
+        s3extErrorMessage = "Caught an unexpected exception.";
+        return false;
+    }
+
+    return true;
+}
+
 // invoked by s3_import(), need to be exception safe
 bool reader_cleanup(GPReader** reader) {
     bool result = true;
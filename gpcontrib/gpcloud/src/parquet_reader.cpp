@@ -0,0 +1,1558 @@
+#include "parquet_reader.h"
+#include "gpcommon.h"
+
+#include <cerrno>
+#include <cmath>
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
+#define PARQUET_MAGIC "PAR1"
+#define PARQUET_MAGIC_LEN 4
+
+// The Parquet format, see parquet.thrift of the parquet-format project.
+enum ParquetType {
+    PARQUET_BOOLEAN = 0,
+    PARQUET_INT32 = 1,
+    PARQUET_INT64 = 2,
+    PARQUET_INT96 = 3,
+    PARQUET_FLOAT = 4,
+    PARQUET_DOUBLE = 5,
+    PARQUET_BYTE_ARRAY = 6,
+    PARQUET_FIXED_LEN_BYTE_ARRAY = 7
+};
+
+enum ParquetConvertedType {
+    PARQUET_CONVERTED_UTF8 = 0,
+    PARQUET_CONVERTED_ENUM = 4,
+    PARQUET_CONVERTED_DECIMAL = 5,
+    PARQUET_CONVERTED_DATE = 6,
+    PARQUET_CONVERTED_TIME_MILLIS = 7,
+    PARQUET_CONVERTED_TIME_MICROS = 8,
+    PARQUET_CONVERTED_TIMESTAMP_MILLIS = 9,
+    PARQUET_CONVERTED_TIMESTAMP_MICROS = 10,
+    PARQUET_CONVERTED_UINT_8 = 11,
+    PARQUET_CONVERTED_UINT_64 = 14,
+    PARQUET_CONVERTED_JSON = 19
+};
+
+// fields of the LogicalType union
+enum ParquetLogicalType {
+    PARQUET_LOGICAL_STRING = 1,
+    PARQUET_LOGICAL_ENUM = 4,
+    PARQUET_LOGICAL_DECIMAL = 5,
+    PARQUET_LOGICAL_DATE = 6,
+    PARQUET_LOGICAL_TIME = 7,
+    PARQUET_LOGICAL_TIMESTAMP = 8,
+    PARQUET_LOGICAL_INTEGER = 10,
+    PARQUET_LOGICAL_JSON = 12
+};
+
+enum ParquetRepetition { PARQUET_REQUIRED = 0, PARQUET_OPTIONAL = 1, PARQUET_REPEATED = 2 };
+
+enum ParquetCodec {
+    PARQUET_UNCOMPRESSED = 0,
+    PARQUET_SNAPPY = 1,
+    PARQUET_GZIP = 2,
+    PARQUET_ZSTD = 6,
+    PARQUET_LZ4_RAW = 7
+};
+
+enum ParquetEncoding {
+    PARQUET_PLAIN = 0,
+    PARQUET_PLAIN_DICTIONARY = 2,
+    PARQUET_RLE = 3,
+    PARQUET_RLE_DICTIONARY = 8
+};
+
+enum ParquetPageType {
+    PARQUET_DATA_PAGE = 0,
+    PARQUET_DICTIONARY_PAGE = 2,
+    PARQUET_DATA_PAGE_V2 = 3
+};
+
+#define PARQUET_CHECK(_condition, _what) \
+    S3_CHECK_OR_DIE(_condition, S3RuntimeError, string("corrupted Parquet file: ") + _what)
+
+static inline uint32_t readLE32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t readLE64(const uint8_t* p) {
+    return (uint64_t)readLE32(p) | ((uint64_t)readLE32(p + 4) << 32);
+}
+
+uint8_t ThriftCompactReader::readByte() {
+    PARQUET_CHECK(this->pos < this->end, "truncated metadata");
+    return *this->pos++;
+}
+
+uint64_t ThriftCompactReader::readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = this->readByte();
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+
+    PARQUET_CHECK(false, "varint is too long");
+    return 0;
+}
+
+// Integers are zigzag varints.
+int64_t ThriftCompactReader::readInt() {
+    uint64_t value = this->readVarint();
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+string ThriftCompactReader::readBinary() {
+    uint64_t length = this->readVarint();
+    PARQUET_CHECK(length <= (uint64_t)(this->end - this->pos), "truncated metadata");
+
+    string value((const char*)this->pos, length);
+    this->pos += length;
+    return value;
+}
+
+uint64_t ThriftCompactReader::readListHeader(int& elementType) {
+    uint8_t header = this->readByte();
+    elementType = header & 0x0f;
+
+    uint64_t size = header >> 4;
+    if (size == 15) {
+        size = this->readVarint();
+    }
+    return size;
+}
+
+void ThriftCompactReader::skip(int type, bool inList, int depth) {
+    PARQUET_CHECK(depth < 64, "metadata is nested too deeply");
+
+    switch (type) {
+        case BOOLEAN_TRUE:
+        case BOOLEAN_FALSE:
+            // booleans are a byte of their own in lists
+            if (inList) {
+                this->readByte();
+            }
+            break;
+        case BYTE:
+            this->readByte();
+            break;
+        case I16:
+        case I32:
+        case I64:
+            this->readVarint();
+            break;
+        case DOUBLE:
+            PARQUET_CHECK(this->end - this->pos >= 8, "truncated metadata");
+            this->pos += 8;
+            break;
+        case BINARY:
+            this->readBinary();
+            break;
+        case LIST:
+        case SET: {
+            int elementType;
+            uint64_t size = this->readListHeader(elementType);
+            for (uint64_t i = 0; i < size; i++) {
+                this->skip(elementType, true, depth + 1);
+            }
+            break;
+        }
+        case MAP: {
+            uint64_t size = this->readVarint();
+            if (size > 0) {
+                uint8_t types = this->readByte();
+                for (uint64_t i = 0; i < size; i++) {
+                    this->skip(types >> 4, true, depth + 1);
+                    this->skip(types & 0x0f, true, depth + 1);
+                }
+            }
+            break;
+        }
+        case STRUCT:
+            this->readStruct(
+                [this, depth](int16_t, int fieldType) { this->skip(fieldType, false, depth + 1); });
+            break;
+        default:
+            PARQUET_CHECK(false, "unknown thrift type " + std::to_string(type));
+    }
+}
+
+void RleBitPackedDecoder::reset(const uint8_t* data, const uint8_t* end, int bitWidth) {
+    PARQUET_CHECK(bitWidth >= 0 && bitWidth <= 32, "invalid bit width");
+
+    this->pos = data;
+    this->end = end;
+    this->bitWidth = bitWidth;
+    this->repeatCount = 0;
+    this->literalCount = 0;
+}
+
+uint32_t RleBitPackedDecoder::next() {
+    while (this->repeatCount == 0 && this->literalCount == 0) {
+        uint64_t header = 0;
+        for (int shift = 0;; shift += 7) {
+            PARQUET_CHECK(this->pos < this->end && shift < 35, "truncated levels or indices");
+            header |= (uint64_t)(*this->pos & 0x7f) << shift;
+            if ((*this->pos++ & 0x80) == 0) {
+                break;
+            }
+        }
+
+        uint64_t width = (this->bitWidth + 7) / 8;
+        if (header & 1) {
+            // groups of 8 bit-packed values, the last group may be cut short
+            uint64_t size = (header >> 1) * this->bitWidth;
+            this->literalCount = (header >> 1) * 8;
+            this->literals = this->pos;
+            this->literalsEnd = this->pos + std::min(size, (uint64_t)(this->end - this->pos));
+            this->literalBit = 0;
+            this->pos = this->literalsEnd;
+        } else {
+            PARQUET_CHECK((uint64_t)(this->end - this->pos) >= width, "truncated RLE run");
+            this->repeatCount = header >> 1;
+            this->repeatValue = 0;
+            for (uint64_t i = 0; i < width; i++) {
+                this->repeatValue |= (uint32_t)this->pos[i] << (8 * i);
+            }
+            this->pos += width;
+        }
+    }
+
+    if (this->repeatCount > 0) {
+        this->repeatCount--;
+        return this->repeatValue;
+    }
+
+    // values are packed from the least significant bit
+    uint64_t byte = this->literalBit / 8;
+    uint64_t window = 0;
+    for (uint64_t i = 0; i < 5 && this->literals + byte + i < this->literalsEnd; i++) {
+        window |= (uint64_t)this->literals[byte + i] << (8 * i);
+    }
+
+    uint32_t value = (window >> (this->literalBit % 8)) & ((1ULL << this->bitWidth) - 1);
+    this->literalBit += this->bitWidth;
+    this->literalCount--;
+    return value;
+}
+
+// Decompress a raw snappy block into out, which is sized to the uncompressed length.
+static void snappyUncompress(const uint8_t* in, uint64_t inSize, uint8_t* out, uint64_t outSize) {
+    const uint8_t* inEnd = in + inSize;
+
+    // preamble: the uncompressed length
+    uint64_t length = 0;
+    for (int shift = 0;; shift += 7) {
+        PARQUET_CHECK(in < inEnd && shift < 35, "truncated snappy block");
+        length |= (uint64_t)(*in & 0x7f) << shift;
+        if ((*in++ & 0x80) == 0) {
+            break;
+        }
+    }
+    PARQUET_CHECK(length == outSize, "wrong snappy block length");
+
+    uint64_t outPos = 0;
+    while (in < inEnd) {
+        uint8_t tag = *in++;
+        uint64_t len, offset = 0;
+
+        if ((tag & 3) == 0) {
+            // literal, long ones have their length in the next 1 to 4 bytes
+            len = (tag >> 2) + 1;
+            if (len > 60) {
+                uint64_t bytes = len - 60;
+                PARQUET_CHECK((uint64_t)(inEnd - in) >= bytes, "truncated snappy block");
+                len = 0;
+                for (uint64_t i = 0; i < bytes; i++) {
+                    len |= (uint64_t)in[i] << (8 * i);
+                }
+                len += 1;
+                in += bytes;
+            }
+            PARQUET_CHECK((uint64_t)(inEnd - in) >= len && outSize - outPos >= len,
+                          "corrupted snappy literal");
+            memcpy(out + outPos, in, len);
+            in += len;
+            outPos += len;
+            continue;
+        }
+
+        // copy of earlier output
+        if ((tag & 3) == 1) {
+            PARQUET_CHECK(in < inEnd, "truncated snappy block");
+            len = ((tag >> 2) & 7) + 4;
+            offset = ((uint64_t)(tag >> 5) << 8) | *in++;
+        } else {
+            uint64_t bytes = (tag & 3) == 2 ? 2 : 4;
+            PARQUET_CHECK((uint64_t)(inEnd - in) >= bytes, "truncated snappy block");
+            len = (tag >> 2) + 1;
+            for (uint64_t i = 0; i < bytes; i++) {
+                offset |= (uint64_t)in[i] << (8 * i);
+            }
+            in += bytes;
+        }
+
+        PARQUET_CHECK(offset > 0 && offset <= outPos && outSize - outPos >= len,
+                      "corrupted snappy copy");
+        // copies may overlap their own output
+        for (uint64_t i = 0; i < len; i++, outPos++) {
+            out[outPos] = out[outPos - offset];
+        }
+    }
+
+    PARQUET_CHECK(outPos == outSize, "truncated snappy block");
+}
+
+// Formatting of values as CSV fields, strings are always quoted to tell empty ones from NULLs.
+
+static void appendQuoted(const uint8_t* value, uint64_t length, string& out) {
+    out += '"';
+    for (uint64_t i = 0; i < length; i++) {
+        if (value[i] == '"') {
+            out += '"';
+        }
+        out += (char)value[i];
+    }
+    out += '"';
+}
+
+static void appendUnsigned(uint64_t value, string& out) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%" PRIu64, value);
+    out += buf;
+}
+
+static void appendSigned(int64_t value, string& out) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%" PRId64, value);
+    out += buf;
+}
+
+// Insert the decimal point of an unscaled decimal given as digits.
+static void appendDecimalDigits(bool negative, string digits, int32_t scale, string& out) {
+    if (negative) {
+        out += '-';
+    }
+
+    if (scale <= 0) {
+        out += digits;
+        out.append(-scale, '0');
+        return;
+    }
+
+    if (digits.length() <= (uint64_t)scale) {
+        digits.insert(0, scale + 1 - digits.length(), '0');
+    }
+    out.append(digits, 0, digits.length() - scale);
+    out += '.';
+    out.append(digits, digits.length() - scale, scale);
+}
+
+static void appendDecimal(int64_t unscaled, int32_t scale, string& out) {
+    uint64_t magnitude = unscaled < 0 ? -(uint64_t)unscaled : unscaled;
+    appendDecimalDigits(unscaled < 0, std::to_string((unsigned long long)magnitude), scale, out);
+}
+
+// Decimals of byte arrays are big-endian two's complement integers of any length.
+static void appendBigDecimal(const uint8_t* value, uint64_t length, int32_t scale, string& out) {
+    bool negative = length > 0 && (value[0] & 0x80);
+
+    // base 10^9 digits, least significant first
+    vector<uint32_t> limbs;
+    uint32_t borrow = 1;
+    for (uint64_t i = 0; i < length; i++) {
+        uint64_t carry = value[i];
+        if (negative) {
+            // the magnitude of the negative integer is its complement plus one, which is
+            // added here as the missing borrow of the last byte
+            carry = (uint8_t)~value[i];
+        }
+
+        for (uint64_t j = 0; j < limbs.size(); j++) {
+            uint64_t limb = (uint64_t)limbs[j] * 256 + carry;
+            limbs[j] = limb % 1000000000;
+            carry = limb / 1000000000;
+        }
+        while (carry > 0) {
+            limbs.push_back(carry % 1000000000);
+            carry /= 1000000000;
+        }
+    }
+
+    if (negative) {
+        for (uint64_t j = 0; borrow > 0; j++) {
+            if (j == limbs.size()) {
+                limbs.push_back(0);
+            }
+            uint64_t limb = (uint64_t)limbs[j] + borrow;
+            limbs[j] = limb % 1000000000;
+            borrow = limb / 1000000000;
+        }
+    }
+
+    if (limbs.empty()) {
+        limbs.push_back(0);
+    }
+
+    string digits = std::to_string((unsigned long long)limbs.back());
+    for (uint64_t j = limbs.size() - 1; j > 0; j--) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%09u", limbs[j - 1]);
+        digits += buf;
+    }
+
+    appendDecimalDigits(negative, digits, scale, out);
+}
+
+static int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - (a % b != 0 && ((a < 0) != (b < 0)));
+}
+
+// Dates are days since 1970-01-01, in the proleptic Gregorian calendar.
+static void appendDate(int64_t days, string& out) {
+    // http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    days += 719468;
+    int64_t era = floorDiv(days, 146097);
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t mp = (5 * dayOfYear + 2) / 153;
+    int64_t day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = yearOfEra + era * 400 + (month <= 2);
+
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%04" PRId64 "-%02" PRId64 "-%02" PRId64, year > 0 ? year : 1 - year,
+             month, day);
+    out += buf;
+}
+
+static void appendTime(int64_t seconds, int64_t fraction, int64_t unitsPerSecond, string& out) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%02" PRId64 ":%02" PRId64 ":%02" PRId64, seconds / 3600,
+             seconds / 60 % 60, seconds % 60);
+    out += buf;
+
+    if (fraction != 0) {
+        int digits = unitsPerSecond == 1000 ? 3 : (unitsPerSecond == 1000000 ? 6 : 9);
+        snprintf(buf, sizeof(buf), ".%0*" PRId64, digits, fraction);
+        out += buf;
+    }
+}
+
+static void appendTimestamp(int64_t days, int64_t units, int64_t unitsPerSecond, bool utc,
+                            string& out) {
+    int64_t seconds = floorDiv(units, unitsPerSecond);
+    days += floorDiv(seconds, 86400);
+
+    appendDate(days, out);
+    out += ' ';
+    appendTime(seconds - floorDiv(seconds, 86400) * 86400, units - seconds * unitsPerSecond,
+               unitsPerSecond, out);
+
+    if (utc) {
+        out += "+00";
+    }
+
+    // year 0 is 1 BC
+    if (days < -719162) {
+        out += " BC";
+    }
+}
+
+static void appendDouble(double value, int precision, string& out) {
+    if (std::isnan(value)) {
+        out += "NaN";
+    } else if (std::isinf(value)) {
+        out += value > 0 ? "Infinity" : "-Infinity";
+    } else {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*g", precision, value);
+        out += buf;
+    }
+}
+
+ParquetColumnDecoder::ParquetColumnDecoder()
+    : column(NULL),
+      codec(PARQUET_UNCOMPRESSED),
+      pos(NULL),
+      end(NULL),
+      valuesLeft(0),
+      encoding(PARQUET_PLAIN),
+      values(NULL),
+      valuesEnd(NULL),
+      booleanBit(0) {
+}
+
+void ParquetColumnDecoder::reset(const ParquetColumn* column, const ParquetColumnChunk* chunk,
+                                 const uint8_t* data) {
+    this->column = column;
+    this->codec = chunk->codec;
+    this->pos = data;
+    this->end = data + chunk->size;
+    this->valuesLeft = 0;
+    this->dictionary.clear();
+}
+
+const uint8_t* ParquetColumnDecoder::decompress(const uint8_t* data, uint64_t size,
+                                                uint64_t uncompressedSize) {
+    if (this->codec == PARQUET_UNCOMPRESSED) {
+        PARQUET_CHECK(size == uncompressedSize, "wrong page size");
+        return data;
+    }
+
+    this->pageBuffer.resize(uncompressedSize);
+    uint8_t* out = this->pageBuffer.data();
+
+    switch (this->codec) {
+        case PARQUET_SNAPPY:
+            snappyUncompress(data, size, out, uncompressedSize);
+            break;
+
+        case PARQUET_GZIP: {
+            z_stream zstream;
+            memset(&zstream, 0, sizeof(zstream));
+            S3_CHECK_OR_DIE(inflateInit2(&zstream, S3_INFLATE_WINDOWSBITS) == Z_OK,
+                            S3RuntimeError, "failed to initialize zlib library");
+
+            zstream.next_in = (Bytef*)data;
+            zstream.avail_in = size;
+            zstream.next_out = out;
+            zstream.avail_out = uncompressedSize;
+            int status = inflate(&zstream, Z_FINISH);
+            inflateEnd(&zstream);
+
+            PARQUET_CHECK(status == Z_STREAM_END && zstream.avail_out == 0, "wrong gzip page");
+            break;
+        }
+
+#ifdef USE_ZSTD
+        case PARQUET_ZSTD: {
+            size_t result = ZSTD_decompress(out, uncompressedSize, data, size);
+            PARQUET_CHECK(!ZSTD_isError(result) && result == uncompressedSize,
+                          "wrong zstd page");
+            break;
+        }
+#endif
+
+#ifdef USE_LZ4
+        case PARQUET_LZ4_RAW: {
+            int result = LZ4_decompress_safe((const char*)data, (char*)out, size, uncompressedSize);
+            PARQUET_CHECK(result >= 0 && (uint64_t)result == uncompressedSize, "wrong LZ4 page");
+            break;
+        }
+#endif
+
+        default:
+            S3_DIE(S3RuntimeError, "Parquet codec " + std::to_string(this->codec) +
+                                       " is not supported, or gpcloud is built without it");
+    }
+
+    return out;
+}
+
+// Read pages up to the next data page, the dictionary page comes first if any.
+void ParquetColumnDecoder::readPage() {
+    while (true) {
+        PARQUET_CHECK(this->pos < this->end, "column chunk has fewer values than rows");
+
+        ThriftCompactReader thrift(this->pos, this->end - this->pos);
+        int32_t pageType = -1;
+        int64_t uncompressedSize = -1, compressedSize = -1;
+        int64_t numValues = 0;
+        int32_t encoding = PARQUET_PLAIN;
+        int64_t definitionLevelsSize = 0, repetitionLevelsSize = 0;
+        bool isCompressed = true;
+
+        // DataPageHeader, DictionaryPageHeader and DataPageHeaderV2
+        auto readDataPageHeader = [&](int16_t id, int type) {
+            if (id == 1 && type == ThriftCompactReader::I32) {
+                numValues = thrift.readInt();
+            } else if (id == 2 && type == ThriftCompactReader::I32 &&
+                       pageType != PARQUET_DATA_PAGE_V2) {
+                encoding = thrift.readInt();
+            } else if (pageType == PARQUET_DATA_PAGE_V2 && id == 4 &&
+                       type == ThriftCompactReader::I32) {
+                encoding = thrift.readInt();
+            } else if (pageType == PARQUET_DATA_PAGE_V2 && id == 5 &&
+                       type == ThriftCompactReader::I32) {
+                definitionLevelsSize = thrift.readInt();
+            } else if (pageType == PARQUET_DATA_PAGE_V2 && id == 6 &&
+                       type == ThriftCompactReader::I32) {
+                repetitionLevelsSize = thrift.readInt();
+            } else if (pageType == PARQUET_DATA_PAGE_V2 && id == 7) {
+                isCompressed = thrift.readBool(type);
+            } else {
+                thrift.skip(type);
+            }
+        };
+
+        thrift.readStruct([&](int16_t id, int type) {
+            if (id == 1 && type == ThriftCompactReader::I32) {
+                pageType = thrift.readInt();
+            } else if (id == 2 && type == ThriftCompactReader::I32) {
+                uncompressedSize = thrift.readInt();
+            } else if (id == 3 && type == ThriftCompactReader::I32) {
+                compressedSize = thrift.readInt();
+            } else if ((id == 5 || id == 7 || id == 8) && type == ThriftCompactReader::STRUCT) {
+                thrift.readStruct(readDataPageHeader);
+            } else {
+                thrift.skip(type);
+            }
+        });
+
+        const uint8_t* page = thrift.getPosition();
+        PARQUET_CHECK(uncompressedSize >= 0 && compressedSize >= 0 &&
+                          compressedSize <= this->end - page,
+                      "wrong page size");
+        this->pos = page + compressedSize;
+
+        if (pageType == PARQUET_DICTIONARY_PAGE) {
+            this->values = this->decompress(page, compressedSize, uncompressedSize);
+            this->valuesEnd = this->values + uncompressedSize;
+            this->booleanBit = 0;
+
+            this->dictionary.clear();
+            this->dictionary.resize(numValues);
+            for (int64_t i = 0; i < numValues; i++) {
+                uint64_t length;
+                const uint8_t* value = this->nextPlainValue(length);
+                this->appendValue(value, length, this->dictionary[i]);
+            }
+            continue;
+        }
+
+        if ((pageType != PARQUET_DATA_PAGE && pageType != PARQUET_DATA_PAGE_V2) ||
+            numValues == 0) {
+            continue;
+        }
+
+        const uint8_t* data;
+        const uint8_t* dataEnd;
+        const uint8_t* levels;
+        const uint8_t* levelsEnd;
+
+        if (pageType == PARQUET_DATA_PAGE) {
+            data = this->decompress(page, compressedSize, uncompressedSize);
+            dataEnd = data + uncompressedSize;
+
+            // definition levels are prefixed with their length
+            levels = data;
+            levelsEnd = data;
+            if (this->column->optional) {
+                PARQUET_CHECK(dataEnd - data >= 4, "truncated data page");
+                uint32_t size = readLE32(data);
+                PARQUET_CHECK(size <= (uint64_t)(dataEnd - data - 4), "truncated data page");
+                levels = data + 4;
+                levelsEnd = levels + size;
+                data = levelsEnd;
+            }
+        } else {
+            // levels of V2 pages are never compressed
+            PARQUET_CHECK(repetitionLevelsSize == 0, "repeated values are not supported");
+            PARQUET_CHECK(definitionLevelsSize >= 0 && definitionLevelsSize <= compressedSize &&
+                              definitionLevelsSize <= uncompressedSize,
+                          "wrong definition levels size");
+            levels = page;
+            levelsEnd = page + definitionLevelsSize;
+
+            uint64_t size = compressedSize - definitionLevelsSize;
+            uint64_t dataSize = uncompressedSize - definitionLevelsSize;
+            if (isCompressed) {
+                data = this->decompress(levelsEnd, size, dataSize);
+            } else {
+                PARQUET_CHECK(size == dataSize, "wrong page size");
+                data = levelsEnd;
+            }
+            dataEnd = data + dataSize;
+        }
+
+        if (this->column->optional) {
+            this->definitionLevels.reset(levels, levelsEnd, 1);
+        }
+
+        this->encoding = encoding;
+        this->values = data;
+        this->valuesEnd = dataEnd;
+        this->booleanBit = 0;
+
+        if (encoding == PARQUET_PLAIN_DICTIONARY || encoding == PARQUET_RLE_DICTIONARY) {
+            PARQUET_CHECK(!this->dictionary.empty() && data < dataEnd, "missing dictionary");
+            this->encodedValues.reset(data + 1, dataEnd, *data);
+        } else if (encoding == PARQUET_RLE && this->column->type == PARQUET_BOOLEAN) {
+            // prefixed with their length
+            PARQUET_CHECK(dataEnd - data >= 4, "truncated data page");
+            this->encodedValues.reset(data + 4, dataEnd, 1);
+        } else {
+            S3_CHECK_OR_DIE(encoding == PARQUET_PLAIN, S3RuntimeError,
+                            "Parquet encoding " + std::to_string(encoding) + " of column " +
+                                this->column->name + " is not supported");
+        }
+
+        this->valuesLeft = numValues;
+        return;
+    }
+}
+
+// Return the next PLAIN value, booleans are returned as a byte.
+const uint8_t* ParquetColumnDecoder::nextPlainValue(uint64_t& length) {
+    static const uint8_t booleans[2] = {0, 1};
+
+    switch (this->column->type) {
+        case PARQUET_BOOLEAN: {
+            uint64_t byte = this->booleanBit / 8;
+            PARQUET_CHECK(byte < (uint64_t)(this->valuesEnd - this->values), "truncated values");
+            length = 1;
+            return &booleans[(this->values[byte] >> (this->booleanBit++ % 8)) & 1];
+        }
+        case PARQUET_INT32:
+        case PARQUET_FLOAT:
+            length = 4;
+            break;
+        case PARQUET_INT64:
+        case PARQUET_DOUBLE:
+            length = 8;
+            break;
+        case PARQUET_INT96:
+            length = 12;
+            break;
+        case PARQUET_FIXED_LEN_BYTE_ARRAY:
+            length = this->column->typeLength;
+            break;
+        case PARQUET_BYTE_ARRAY:
+            PARQUET_CHECK(this->valuesEnd - this->values >= 4, "truncated values");
+            length = readLE32(this->values);
+            this->values += 4;
+            break;
+        default:
+            S3_DIE(S3RuntimeError, "Parquet type " + std::to_string(this->column->type) +
+                                       " is not supported");
+    }
+
+    PARQUET_CHECK(length <= (uint64_t)(this->valuesEnd - this->values), "truncated values");
+    const uint8_t* value = this->values;
+    this->values += length;
+    return value;
+}
+
+void ParquetColumnDecoder::appendValue(const uint8_t* value, uint64_t length, string& out) {
+    const ParquetColumn* column = this->column;
+
+    switch (column->type) {
+        case PARQUET_BOOLEAN:
+            out += *value ? "true" : "false";
+            break;
+
+        case PARQUET_INT32:
+        case PARQUET_INT64: {
+            int64_t number = column->type == PARQUET_INT32 ? (int64_t)(int32_t)readLE32(value)
+                                                           : (int64_t)readLE64(value);
+            switch (column->kind) {
+                case PARQUET_VALUE_UNSIGNED:
+                    appendUnsigned(column->type == PARQUET_INT32 ? (uint32_t)number
+                                                                 : (uint64_t)number,
+                                   out);
+                    break;
+                case PARQUET_VALUE_DATE:
+                    appendDate(number, out);
+                    if (number < -719162) {
+                        out += " BC";
+                    }
+                    break;
+                case PARQUET_VALUE_TIME:
+                    appendTime(number / column->unitsPerSecond, number % column->unitsPerSecond,
+                               column->unitsPerSecond, out);
+                    break;
+                case PARQUET_VALUE_TIMESTAMP:
+                    appendTimestamp(0, number, column->unitsPerSecond, column->adjustedToUTC,
+                                    out);
+                    break;
+                case PARQUET_VALUE_DECIMAL:
+                    appendDecimal(number, column->scale, out);
+                    break;
+                default:
+                    appendSigned(number, out);
+                    break;
+            }
+            break;
+        }
+
+        case PARQUET_INT96:
+            // nanoseconds of the day, then the Julian day, as written by Impala and Spark
+            appendTimestamp((int64_t)readLE32(value + 8) - 2440588, readLE64(value), 1000000000,
+                            column->adjustedToUTC, out);
+            break;
+
+        case PARQUET_FLOAT: {
+            uint32_t bits = readLE32(value);
+            float number;
+            memcpy(&number, &bits, sizeof(number));
+            appendDouble(number, 9, out);
+            break;
+        }
+
+        case PARQUET_DOUBLE: {
+            uint64_t bits = readLE64(value);
+            double number;
+            memcpy(&number, &bits, sizeof(number));
+            appendDouble(number, 17, out);
+            break;
+        }
+
+        default:
+            if (column->kind == PARQUET_VALUE_DECIMAL) {
+                appendBigDecimal(value, length, column->scale, out);
+            } else {
+                appendQuoted(value, length, out);
+            }
+            break;
+    }
+}
+
+void ParquetColumnDecoder::appendPlain(string& out) {
+    if (this->column->type == PARQUET_BOOLEAN && this->encoding == PARQUET_RLE) {
+        out += this->encodedValues.next() ? "true" : "false";
+        return;
+    }
+
+    uint64_t length;
+    const uint8_t* value = this->nextPlainValue(length);
+    this->appendValue(value, length, out);
+}
+
+void ParquetColumnDecoder::appendNext(string& out) {
+    if (this->valuesLeft == 0) {
+        this->readPage();
+    }
+    this->valuesLeft--;
+
+    if (this->column->optional && this->definitionLevels.next() == 0) {
+        return;
+    }
+
+    if (this->encoding == PARQUET_PLAIN_DICTIONARY || this->encoding == PARQUET_RLE_DICTIONARY) {
+        uint32_t index = this->encodedValues.next();
+        PARQUET_CHECK(index < this->dictionary.size(), "dictionary index is out of range");
+        out += this->dictionary[index];
+    } else {
+        this->appendPlain(out);
+    }
+}
+
+ParquetReader::ParquetReader()
+    : s3Interface(NULL),
+      s3Url(""),
+      keySize(0),
+      rowGroupIndex(0),
+      rowsLeft(0),
+      outOffset(0),
+      headerDone(false),
+      numOfSkippedRowGroups(0),
+      fetchedBytes(0) {
+}
+
+ParquetReader::~ParquetReader() {
+    this->close();
+}
+
+void ParquetReader::open(const S3Params& params) {
+    S3_CHECK_OR_DIE(this->s3Interface != NULL, S3RuntimeError, "s3Interface must not be NULL");
+
+    this->s3Url = params.getS3Url();
+    this->keySize = params.getKeySize();
+    this->scanInfo = params.getScanInfo();
+
+    this->columns.clear();
+    this->rowGroups.clear();
+    this->rowGroupIndex = 0;
+    this->rowsLeft = 0;
+    this->out.clear();
+    this->outOffset = 0;
+    this->headerDone = false;
+    this->numOfSkippedRowGroups = 0;
+    this->fetchedBytes = 0;
+
+    this->readMetadata();
+    this->mapColumns();
+}
+
+// The file ends with the metadata, its length and the magic number.
+void ParquetReader::readMetadata() {
+    const string& url = this->s3Url.getFullUrlForCurl();
+    S3_CHECK_OR_DIE(this->keySize >= 2 * PARQUET_MAGIC_LEN + 4, S3RuntimeError,
+                    url + " is too small to be a Parquet file");
+
+    uint64_t tailSize = std::min(this->keySize, (uint64_t)PARQUET_FOOTER_FETCH_SIZE);
+    S3VectorUInt8 tail;
+    this->s3Interface->fetchData(this->keySize - tailSize, tail, tailSize, this->s3Url);
+    this->fetchedBytes += tailSize;
+
+    const uint8_t* footer = tail.data() + tailSize - PARQUET_MAGIC_LEN - 4;
+    S3_CHECK_OR_DIE(memcmp(footer + 4, PARQUET_MAGIC, PARQUET_MAGIC_LEN) == 0, S3RuntimeError,
+                    url + " is not a Parquet file, or it is encrypted");
+
+    uint64_t metadataSize = readLE32(footer);
+    PARQUET_CHECK(metadataSize + 2 * PARQUET_MAGIC_LEN + 4 <= this->keySize,
+                  "wrong metadata length");
+
+    if (metadataSize + PARQUET_MAGIC_LEN + 4 <= tailSize) {
+        this->parseMetadata(footer - metadataSize, metadataSize);
+    } else {
+        S3VectorUInt8 metadata;
+        this->s3Interface->fetchData(this->keySize - PARQUET_MAGIC_LEN - 4 - metadataSize,
+                                     metadata, metadataSize, this->s3Url);
+        this->fetchedBytes += metadataSize;
+        this->parseMetadata(metadata.data(), metadataSize);
+    }
+
+    S3DEBUG("Parquet file %s has %" PRIu64 " row groups of %" PRIu64 " columns", url.c_str(),
+            (uint64_t)this->rowGroups.size(), (uint64_t)this->columns.size());
+}
+
+struct ParquetSchemaElement {
+    ParquetSchemaElement()
+        : type(-1),
+          typeLength(0),
+          repetition(PARQUET_REQUIRED),
+          numChildren(0),
+          convertedType(-1),
+          scale(0),
+          logicalType(-1),
+          isSigned(true),
+          unitsPerSecond(1000000),
+          adjustedToUTC(false) {
+    }
+
+    int32_t type;
+    int32_t typeLength;
+    int32_t repetition;
+    string name;
+    int32_t numChildren;
+    int32_t convertedType;
+    int32_t scale;
+
+    int32_t logicalType;
+    bool isSigned;           // of integers
+    int64_t unitsPerSecond;  // of times and timestamps
+    bool adjustedToUTC;
+};
+
+static void readLogicalType(ThriftCompactReader& thrift, ParquetSchemaElement& element) {
+    thrift.readStruct([&](int16_t id, int type) {
+        if (type != ThriftCompactReader::STRUCT) {
+            thrift.skip(type);
+            return;
+        }
+
+        element.logicalType = id;
+        thrift.readStruct([&](int16_t field, int fieldType) {
+            if (id == PARQUET_LOGICAL_DECIMAL && field == 1 &&
+                fieldType == ThriftCompactReader::I32) {
+                element.scale = thrift.readInt();
+            } else if (id == PARQUET_LOGICAL_INTEGER && field == 2) {
+                element.isSigned = thrift.readBool(fieldType);
+            } else if ((id == PARQUET_LOGICAL_TIME || id == PARQUET_LOGICAL_TIMESTAMP) &&
+                       field == 1) {
+                element.adjustedToUTC = thrift.readBool(fieldType);
+            } else if ((id == PARQUET_LOGICAL_TIME || id == PARQUET_LOGICAL_TIMESTAMP) &&
+                       field == 2 && fieldType == ThriftCompactReader::STRUCT) {
+                // TimeUnit union of MILLIS, MICROS and NANOS
+                thrift.readStruct([&](int16_t unit, int unitType) {
+                    element.unitsPerSecond = unit == 1 ? 1000 : (unit == 2 ? 1000000 : 1000000000);
+                    thrift.skip(unitType);
+                });
+            } else {
+                thrift.skip(fieldType);
+            }
+        });
+    });
+}
+
+static ParquetSchemaElement readSchemaElement(ThriftCompactReader& thrift) {
+    ParquetSchemaElement element;
+
+    thrift.readStruct([&](int16_t id, int type) {
+        if (id == 1 && type == ThriftCompactReader::I32) {
+            element.type = thrift.readInt();
+        } else if (id == 2 && type == ThriftCompactReader::I32) {
+            element.typeLength = thrift.readInt();
+        } else if (id == 3 && type == ThriftCompactReader::I32) {
+            element.repetition = thrift.readInt();
+        } else if (id == 4 && type == ThriftCompactReader::BINARY) {
+            element.name = thrift.readBinary();
+        } else if (id == 5 && type == ThriftCompactReader::I32) {
+            element.numChildren = thrift.readInt();
+        } else if (id == 6 && type == ThriftCompactReader::I32) {
+            element.convertedType = thrift.readInt();
+        } else if (id == 7 && type == ThriftCompactReader::I32) {
+            element.scale = thrift.readInt();
+        } else if (id == 10 && type == ThriftCompactReader::STRUCT) {
+            readLogicalType(thrift, element);
+        } else {
+            thrift.skip(type);
+        }
+    });
+
+    return element;
+}
+
+// The logical type is preferred, the converted type is all older writers write.
+static ParquetColumn makeColumn(const ParquetSchemaElement& element, const string& name,
+                                bool nested) {
+    ParquetColumn column;
+    column.name = name;
+    column.type = element.type;
+    column.typeLength = element.typeLength;
+    column.optional = element.repetition == PARQUET_OPTIONAL;
+    column.nested = nested || element.repetition == PARQUET_REPEATED;
+    column.kind = PARQUET_VALUE_PLAIN;
+    column.scale = element.scale;
+    column.unitsPerSecond = element.unitsPerSecond;
+    column.adjustedToUTC = element.adjustedToUTC;
+
+    switch (element.logicalType) {
+        case PARQUET_LOGICAL_STRING:
+        case PARQUET_LOGICAL_ENUM:
+        case PARQUET_LOGICAL_JSON:
+            column.kind = PARQUET_VALUE_STRING;
+            return column;
+        case PARQUET_LOGICAL_DECIMAL:
+            column.kind = PARQUET_VALUE_DECIMAL;
+            return column;
+        case PARQUET_LOGICAL_DATE:
+            column.kind = PARQUET_VALUE_DATE;
+            return column;
+        case PARQUET_LOGICAL_TIME:
+            column.kind = PARQUET_VALUE_TIME;
+            return column;
+        case PARQUET_LOGICAL_TIMESTAMP:
+            column.kind = PARQUET_VALUE_TIMESTAMP;
+            return column;
+        case PARQUET_LOGICAL_INTEGER:
+            column.kind = element.isSigned ? PARQUET_VALUE_PLAIN : PARQUET_VALUE_UNSIGNED;
+            return column;
+    }
+
+    switch (element.convertedType) {
+        case PARQUET_CONVERTED_UTF8:
+        case PARQUET_CONVERTED_ENUM:
+        case PARQUET_CONVERTED_JSON:
+            column.kind = PARQUET_VALUE_STRING;
+            break;
+        case PARQUET_CONVERTED_DECIMAL:
+            column.kind = PARQUET_VALUE_DECIMAL;
+            break;
+        case PARQUET_CONVERTED_DATE:
+            column.kind = PARQUET_VALUE_DATE;
+            break;
+        case PARQUET_CONVERTED_TIME_MILLIS:
+        case PARQUET_CONVERTED_TIME_MICROS:
+            column.kind = PARQUET_VALUE_TIME;
+            column.unitsPerSecond =
+                element.convertedType == PARQUET_CONVERTED_TIME_MILLIS ? 1000 : 1000000;
+            break;
+        case PARQUET_CONVERTED_TIMESTAMP_MILLIS:
+        case PARQUET_CONVERTED_TIMESTAMP_MICROS:
+            column.kind = PARQUET_VALUE_TIMESTAMP;
+            column.unitsPerSecond =
+                element.convertedType == PARQUET_CONVERTED_TIMESTAMP_MILLIS ? 1000 : 1000000;
+            column.adjustedToUTC = true;
+            break;
+        default:
+            if (element.convertedType >= PARQUET_CONVERTED_UINT_8 &&
+                element.convertedType <= PARQUET_CONVERTED_UINT_64) {
+                column.kind = PARQUET_VALUE_UNSIGNED;
+            }
+            break;
+    }
+
+    // INT96 timestamps are instants
+    if (element.type == PARQUET_INT96) {
+        column.kind = PARQUET_VALUE_TIMESTAMP;
+        column.adjustedToUTC = true;
+    }
+
+    return column;
+}
+
+// Collect the leaves under schema[index], the elements are in depth-first order.
+static void collectLeaves(const vector<ParquetSchemaElement>& schema, uint64_t& index,
+                          const string& name, bool nested, int depth,
+                          vector<ParquetColumn>& columns) {
+    PARQUET_CHECK(index < schema.size() && depth < 64, "wrong schema");
+    const ParquetSchemaElement& element = schema[index++];
+
+    if (element.numChildren == 0) {
+        columns.push_back(makeColumn(element, name, nested));
+        return;
+    }
+
+    for (int32_t i = 0; i < element.numChildren; i++) {
+        collectLeaves(schema, index, name, true, depth + 1, columns);
+    }
+}
+
+static ParquetColumnChunk readColumnChunk(ThriftCompactReader& thrift) {
+    ParquetColumnChunk chunk;
+    int64_t dataPageOffset = -1, dictionaryPageOffset = -1;
+
+    auto readStatistics = [&](int16_t id, int type) {
+        if (id == 3 && type == ThriftCompactReader::I64) {
+            chunk.nullCount = thrift.readInt();
+            chunk.hasNullCount = true;
+        } else if (id == 5 && type == ThriftCompactReader::BINARY) {
+            chunk.maxValue = thrift.readBinary();
+            chunk.hasMinMax = true;
+        } else if (id == 6 && type == ThriftCompactReader::BINARY) {
+            chunk.minValue = thrift.readBinary();
+        } else {
+            thrift.skip(type);
+        }
+    };
+
+    auto readColumnMetaData = [&](int16_t id, int type) {
+        if (id == 4 && type == ThriftCompactReader::I32) {
+            chunk.codec = thrift.readInt();
+        } else if (id == 5 && type == ThriftCompactReader::I64) {
+            chunk.numValues = thrift.readInt();
+        } else if (id == 7 && type == ThriftCompactReader::I64) {
+            chunk.size = thrift.readInt();
+        } else if (id == 9 && type == ThriftCompactReader::I64) {
+            dataPageOffset = thrift.readInt();
+        } else if (id == 11 && type == ThriftCompactReader::I64) {
+            dictionaryPageOffset = thrift.readInt();
+        } else if (id == 12 && type == ThriftCompactReader::STRUCT) {
+            thrift.readStruct(readStatistics);
+        } else {
+            thrift.skip(type);
+        }
+    };
+
+    thrift.readStruct([&](int16_t id, int type) {
+        if (id == 1 && type == ThriftCompactReader::BINARY) {
+            chunk.inOtherFile = !thrift.readBinary().empty();
+        } else if (id == 3 && type == ThriftCompactReader::STRUCT) {
+            thrift.readStruct(readColumnMetaData);
+        } else {
+            thrift.skip(type);
+        }
+    });
+
+    PARQUET_CHECK(dataPageOffset >= 0, "missing column chunk offset");
+    chunk.offset = dataPageOffset;
+    if (dictionaryPageOffset > 0 && dictionaryPageOffset < dataPageOffset) {
+        chunk.offset = dictionaryPageOffset;
+    }
+
+    // both or neither
+    if (chunk.hasMinMax && chunk.minValue.empty() && chunk.maxValue.empty()) {
+        chunk.hasMinMax = false;
+    }
+
+    return chunk;
+}
+
+void ParquetReader::parseMetadata(const uint8_t* data, uint64_t size) {
+    ThriftCompactReader thrift(data, size);
+    vector<ParquetSchemaElement> schema;
+
+    thrift.readStruct([&](int16_t id, int type) {
+        int elementType;
+        if (id == 2 && type == ThriftCompactReader::LIST) {
+            uint64_t numOfElements = thrift.readListHeader(elementType);
+            for (uint64_t i = 0; i < numOfElements; i++) {
+                schema.push_back(readSchemaElement(thrift));
+            }
+        } else if (id == 4 && type == ThriftCompactReader::LIST) {
+            uint64_t numOfRowGroups = thrift.readListHeader(elementType);
+            for (uint64_t i = 0; i < numOfRowGroups; i++) {
+                ParquetRowGroup rowGroup;
+                rowGroup.numRows = 0;
+                thrift.readStruct([&](int16_t field, int fieldType) {
+                    if (field == 1 && fieldType == ThriftCompactReader::LIST) {
+                        uint64_t numOfColumns = thrift.readListHeader(elementType);
+                        for (uint64_t j = 0; j < numOfColumns; j++) {
+                            rowGroup.columns.push_back(readColumnChunk(thrift));
+                        }
+                    } else if (field == 3 && fieldType == ThriftCompactReader::I64) {
+                        rowGroup.numRows = thrift.readInt();
+                    } else {
+                        thrift.skip(fieldType);
+                    }
+                });
+                this->rowGroups.push_back(rowGroup);
+            }
+        } else {
+            thrift.skip(type);
+        }
+    });
+
+    PARQUET_CHECK(!schema.empty(), "missing schema");
+
+    // the first element is the root of the top-level fields
+    uint64_t index = 1;
+    for (int32_t i = 0; i < schema[0].numChildren; i++) {
+        PARQUET_CHECK(index < schema.size(), "wrong schema");
+        const ParquetSchemaElement& field = schema[index];
+        collectLeaves(schema, index, field.name, field.repetition == PARQUET_REPEATED, 1,
+                      this->columns);
+    }
+
+    for (uint64_t i = 0; i < this->rowGroups.size(); i++) {
+        PARQUET_CHECK(this->rowGroups[i].columns.size() == this->columns.size(),
+                      "row group has a wrong number of columns");
+    }
+}
+
+// Match the columns of the table with the top-level fields of the file.
+void ParquetReader::mapColumns() {
+    this->outputNames.clear();
+    this->matchedColumns.clear();
+    this->outputColumns.clear();
+
+    if (this->scanInfo.columnNames.empty()) {
+        for (uint64_t i = 0; i < this->columns.size(); i++) {
+            if (!this->columns[i].nested) {
+                this->outputNames.push_back(this->columns[i].name);
+                this->matchedColumns.push_back(i);
+                this->outputColumns.push_back(i);
+            }
+        }
+    } else {
+        for (uint64_t i = 0; i < this->scanInfo.columnNames.size(); i++) {
+            const string& name = this->scanInfo.columnNames[i];
+            int64_t leaf = -1;
+
+            for (uint64_t j = 0; j < this->columns.size() && leaf < 0; j++) {
+                if (this->columns[j].name == name) {
+                    leaf = j;
+                }
+            }
+
+            for (uint64_t j = 0; j < this->columns.size() && leaf < 0; j++) {
+                if (strcasecmp(this->columns[j].name.c_str(), name.c_str()) == 0) {
+                    leaf = j;
+                }
+            }
+
+            bool projected =
+                this->scanInfo.projected.size() <= i || this->scanInfo.projected[i];
+            if (leaf >= 0 && projected) {
+                S3_CHECK_OR_DIE(!this->columns[leaf].nested, S3RuntimeError,
+                                "column " + name + " is a nested Parquet field, which is not "
+                                                   "supported");
+            }
+
+            this->outputNames.push_back(name);
+            this->matchedColumns.push_back(leaf);
+            this->outputColumns.push_back(projected ? leaf : -1);
+        }
+    }
+
+    this->decoders.clear();
+    this->decoders.resize(this->outputColumns.size());
+}
+
+enum StatisticComparison { STAT_LESS = -1, STAT_EQUAL = 0, STAT_GREATER = 1, STAT_UNKNOWN = 2 };
+
+// Compare a min or max statistic with the value of a filter. Integers are compared exactly,
+// other numbers as long doubles, where rounding may make unequal values equal but never
+// reverses their order.
+static StatisticComparison compareStatistic(const ParquetColumn& column, const string& stat,
+                                            const S3ColumnFilter& filter, bool& exact) {
+    if (filter.isString) {
+        if (column.type != PARQUET_BYTE_ARRAY ||
+            (column.kind != PARQUET_VALUE_STRING && column.kind != PARQUET_VALUE_PLAIN)) {
+            return STAT_UNKNOWN;
+        }
+
+        // statistics of strings are ordered as unsigned bytes, as memcmp() does
+        exact = true;
+        int result = stat.compare(filter.value);
+        return result < 0 ? STAT_LESS : (result > 0 ? STAT_GREATER : STAT_EQUAL);
+    }
+
+    bool isInteger = column.type == PARQUET_INT32 || column.type == PARQUET_INT64;
+    bool isFloat = column.type == PARQUET_FLOAT || column.type == PARQUET_DOUBLE;
+    uint64_t width = (column.type == PARQUET_INT32 || column.type == PARQUET_FLOAT) ? 4 : 8;
+    if ((!isInteger && !isFloat) || stat.length() != width) {
+        return STAT_UNKNOWN;
+    }
+
+    if (isInteger && column.kind != PARQUET_VALUE_PLAIN && column.kind != PARQUET_VALUE_DATE &&
+        column.kind != PARQUET_VALUE_DECIMAL && column.kind != PARQUET_VALUE_UNSIGNED) {
+        return STAT_UNKNOWN;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)stat.data();
+    const char* value = filter.value.c_str();
+    char* valueEnd = NULL;
+
+    if (isInteger && column.kind != PARQUET_VALUE_DECIMAL) {
+        errno = 0;
+        long long number = strtoll(value, &valueEnd, 10);
+        if (column.kind != PARQUET_VALUE_UNSIGNED && errno == 0 && *valueEnd == '\0' &&
+            valueEnd != value) {
+            int64_t statNumber = column.type == PARQUET_INT32 ? (int64_t)(int32_t)readLE32(bytes)
+                                                              : (int64_t)readLE64(bytes);
+            exact = true;
+            return statNumber < number ? STAT_LESS
+                                       : (statNumber > number ? STAT_GREATER : STAT_EQUAL);
+        }
+    }
+
+    long double number = strtold(value, &valueEnd);
+    if (*valueEnd != '\0' || valueEnd == value || std::isnan(number)) {
+        return STAT_UNKNOWN;
+    }
+
+    long double statNumber;
+    if (column.type == PARQUET_INT32) {
+        statNumber = column.kind == PARQUET_VALUE_UNSIGNED ? (long double)readLE32(bytes)
+                                                           : (int32_t)readLE32(bytes);
+    } else if (column.type == PARQUET_INT64) {
+        statNumber = column.kind == PARQUET_VALUE_UNSIGNED ? (long double)readLE64(bytes)
+                                                           : (int64_t)readLE64(bytes);
+    } else if (column.type == PARQUET_FLOAT) {
+        uint32_t bits = readLE32(bytes);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        statNumber = f;
+    } else {
+        uint64_t bits = readLE64(bytes);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        statNumber = d;
+    }
+
+    if (column.kind == PARQUET_VALUE_DECIMAL) {
+        statNumber /= powl(10, column.scale);
+    }
+
+    if (std::isnan(statNumber)) {
+        return STAT_UNKNOWN;
+    }
+
+    exact = false;
+    return statNumber < number ? STAT_LESS : (statNumber > number ? STAT_GREATER : STAT_EQUAL);
+}
+
+// Return true if no row of the row group meets one of the filters.
+bool ParquetReader::isRowGroupSkipped(const ParquetRowGroup& rowGroup) {
+    for (uint64_t i = 0; i < this->scanInfo.filters.size(); i++) {
+        const S3ColumnFilter& filter = this->scanInfo.filters[i];
+        if (filter.column >= this->matchedColumns.size()) {
+            continue;
+        }
+
+        // columns missing in the file are NULL, comparisons with NULL are never true
+        int64_t leaf = this->matchedColumns[filter.column];
+        if (leaf < 0) {
+            return true;
+        }
+
+        const ParquetColumn& column = this->columns[leaf];
+        if (column.nested) {
+            continue;
+        }
+
+        const ParquetColumnChunk& chunk = rowGroup.columns[leaf];
+        if (chunk.hasNullCount && chunk.nullCount == rowGroup.numRows) {
+            return true;
+        }
+
+        if (!chunk.hasMinMax) {
+            continue;
+        }
+
+        bool exactMin = false, exactMax = false;
+        StatisticComparison min = compareStatistic(column, chunk.minValue, filter, exactMin);
+        StatisticComparison max = compareStatistic(column, chunk.maxValue, filter, exactMax);
+        if (min == STAT_UNKNOWN || max == STAT_UNKNOWN) {
+            continue;
+        }
+
+        // NaNs are bigger than any number in the query, but are not in the statistics
+        bool mayHaveNaN = column.type == PARQUET_FLOAT || column.type == PARQUET_DOUBLE;
+
+        bool skipped = false;
+        switch (filter.op) {
+            case S3_FILTER_EQ:
+                skipped = min == STAT_GREATER || max == STAT_LESS;
+                break;
+            case S3_FILTER_LT:
+                skipped = min == STAT_GREATER || (exactMin && min == STAT_EQUAL);
+                break;
+            case S3_FILTER_LE:
+                skipped = min == STAT_GREATER;
+                break;
+            case S3_FILTER_GT:
+                skipped = !mayHaveNaN && (max == STAT_LESS || (exactMax && max == STAT_EQUAL));
+                break;
+            case S3_FILTER_GE:
+                skipped = !mayHaveNaN && max == STAT_LESS;
+                break;
+        }
+
+        if (skipped) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ParquetReader::nextRowGroup() {
+    while (this->rowGroupIndex < this->rowGroups.size()) {
+        const ParquetRowGroup& rowGroup = this->rowGroups[this->rowGroupIndex++];
+        if (rowGroup.numRows == 0) {
+            continue;
+        }
+
+        if (this->isRowGroupSkipped(rowGroup)) {
+            this->numOfSkippedRowGroups++;
+            S3DEBUG("Skipped row group %" PRIu64 " of %s", this->rowGroupIndex - 1,
+                    this->s3Url.getFullUrlForCurl().c_str());
+            continue;
+        }
+
+        this->fetchRowGroup(rowGroup);
+        this->rowsLeft = rowGroup.numRows;
+        return true;
+    }
+
+    return false;
+}
+
+// Fetch the column chunks of the projected columns, close ones with the same request.
+void ParquetReader::fetchRowGroup(const ParquetRowGroup& rowGroup) {
+    vector<std::pair<uint64_t, int64_t> > chunks;  // offset and leaf column
+    for (uint64_t i = 0; i < this->outputColumns.size(); i++) {
+        int64_t leaf = this->outputColumns[i];
+        if (leaf >= 0) {
+            const ParquetColumnChunk& chunk = rowGroup.columns[leaf];
+            S3_CHECK_OR_DIE(!chunk.inOtherFile, S3RuntimeError,
+                            "column chunks in other files are not supported");
+            PARQUET_CHECK(chunk.offset <= this->keySize && chunk.size <= this->keySize &&
+                              chunk.offset + chunk.size <= this->keySize,
+                          "column chunk is out of the file");
+            chunks.push_back(std::make_pair(chunk.offset, leaf));
+        }
+    }
+    std::sort(chunks.begin(), chunks.end());
+
+    this->fetchedRanges.clear();
+    this->fetchedRanges.reserve(chunks.size());
+    map<int64_t, const uint8_t*> chunkData;
+
+    for (uint64_t i = 0; i < chunks.size();) {
+        uint64_t offset = chunks[i].first;
+        uint64_t end = offset + rowGroup.columns[chunks[i].second].size;
+
+        uint64_t j = i + 1;
+        for (; j < chunks.size() && chunks[j].first <= end + PARQUET_MAX_RANGE_GAP; j++) {
+            end = std::max(end, chunks[j].first + rowGroup.columns[chunks[j].second].size);
+        }
+
+        this->fetchedRanges.push_back(S3VectorUInt8());
+        S3VectorUInt8& data = this->fetchedRanges.back();
+        if (end > offset) {
+            this->s3Interface->fetchData(offset, data, end - offset, this->s3Url);
+        }
+        this->fetchedBytes += end - offset;
+
+        for (; i < j; i++) {
+            chunkData[chunks[i].second] = data.data() + (chunks[i].first - offset);
+        }
+    }
+
+    for (uint64_t i = 0; i < this->outputColumns.size(); i++) {
+        int64_t leaf = this->outputColumns[i];
+        if (leaf >= 0) {
+            this->decoders[i].reset(&this->columns[leaf], &rowGroup.columns[leaf],
+                                    chunkData[leaf]);
+        }
+    }
+}
+
+// Convert rows into the output buffer, return false if there are no more rows.
+bool ParquetReader::convertRows() {
+    this->out.clear();
+    this->outOffset = 0;
+
+    // the formatter skips the header of the first key, the bucket reader the ones of the others
+    if (hasHeader && !this->headerDone) {
+        for (uint64_t i = 0; i < this->outputNames.size(); i++) {
+            if (i > 0) {
+                this->out += ',';
+            }
+            appendQuoted((const uint8_t*)this->outputNames[i].data(),
+                         this->outputNames[i].length(), this->out);
+        }
+        this->out += eolString;
+    }
+    this->headerDone = true;
+
+    while (this->out.size() < PARQUET_OUTPUT_BUFFER_SIZE) {
+        if (this->rowsLeft == 0 && !this->nextRowGroup()) {
+            break;
+        }
+
+        for (; this->rowsLeft > 0 && this->out.size() < PARQUET_OUTPUT_BUFFER_SIZE;
+             this->rowsLeft--) {
+            for (uint64_t i = 0; i < this->outputColumns.size(); i++) {
+                if (i > 0) {
+                    this->out += ',';
+                }
+                if (this->outputColumns[i] >= 0) {
+                    this->decoders[i].appendNext(this->out);
+                }
+            }
+            this->out += eolString;
+        }
+    }
+
+    return !this->out.empty();
+}
+
+// read() attempts to read up to count bytes into the buffer.
+// Return 0 if EOF. Throw exception if encounters errors.
+uint64_t ParquetReader::read(char* buf, uint64_t count) {
+    const char* data;
+    uint64_t length = this->lend(&data, count);
+    memcpy(buf, data, length);
+    this->release(length);
+    return length;
+}
+
+uint64_t ParquetReader::lend(const char** data, uint64_t count) {
+    if (this->outOffset == this->out.size() && !this->convertRows()) {
+        return 0;
+    }
+
+    *data = this->out.data() + this->outOffset;
+    return std::min(count, (uint64_t)this->out.size() - this->outOffset);
+}
+
+void ParquetReader::release(uint64_t count) {
+    this->outOffset += count;
+}
+
+// This should be reentrant, has no side effects when called multiple times.
+void ParquetReader::close() {
+    this->fetchedRanges.clear();
+    this->decoders.clear();
+    this->rowGroups.clear();
+    this->columns.clear();
+    this->rowsLeft = 0;
+    this->rowGroupIndex = 0;
+    this->out.clear();
+    this->outOffset = 0;
+}
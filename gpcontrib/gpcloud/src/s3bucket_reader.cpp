@@ -1,7 +1,9 @@
 #include "s3bucket_reader.h"
 
 S3BucketReader::S3BucketReader() : Reader() {
-    this->keyIndex = 0;  // doesn't matter, be set in open()
+    this->splitIndex = 0;  // doesn't matter, be set in open()
+    this->readingRestOfLine = false;
+    this->lentData = NULL;
 
     this->s3Interface = NULL;
     this->upstreamReader = NULL;
@@ -17,8 +19,6 @@ S3BucketReader::~S3BucketReader() {
 void S3BucketReader::open(const S3Params& params) {
     this->params = params;
 
-    this->keyIndex = s3ext_segid;  // we may change it in unit tests
-
     S3_CHECK_OR_DIE(this->s3Interface != NULL, S3RuntimeError, "s3Interface is NULL");
 
     S3Url& s3Url = this->params.getS3Url();
@@ -26,13 +26,135 @@ void S3BucketReader::open(const S3Params& params) {
     S3_CHECK_OR_DIE(s3Url.isValidUrl(), S3ConfigError, s3Url.getFullUrlForCurl() + " is not valid",
                     s3Url.getFullUrlForCurl());
 
-    this->keyList = this->s3Interface->listBucket(s3Url);
+    if (this->params.getListCacheSession().empty()) {
+        this->keyList = this->s3Interface->listBucket(s3Url);
+    } else {
+        ListBucketCache listCache(this->params.getListCacheDir(),
+                                  this->params.getListCacheSession(),
+                                  this->params.getListCacheScope());
+        this->keyList = listCache.get(s3Url, this->s3Interface);
+    }
+
+    this->assignKeySplits();
+    this->splitIndex = 0;
+}
+
+// Bigger splits are placed first, ties are broken by position in the key list so
+// that every segment sorts them the same way.
+static bool largerSplitFirst(const KeySplit& a, const KeySplit& b) {
+    if (a.length != b.length) {
+        return a.length > b.length;
+    }
+    if (a.keyIndex != b.keyIndex) {
+        return a.keyIndex < b.keyIndex;
+    }
+    return a.offset < b.offset;
+}
+
+static bool splitInKeyOrder(const KeySplit& a, const KeySplit& b) {
+    if (a.keyIndex != b.keyIndex) {
+        return a.keyIndex < b.keyIndex;
+    }
+    return a.offset < b.offset;
 }
 
-BucketContent& S3BucketReader::getNextKey() {
-    BucketContent& key = this->keyList.contents[this->keyIndex];
-    this->keyIndex += s3ext_segnum;
-    return key;
+struct SegmentLoad {
+    uint64_t size;
+    uint64_t numOfSplits;
+    int32_t segId;
+
+    bool operator>(const SegmentLoad& other) const {
+        if (this->size != other.size) {
+            return this->size > other.size;
+        }
+        if (this->numOfSplits != other.numOfSplits) {
+            return this->numOfSplits > other.numOfSplits;
+        }
+        return this->segId > other.segId;
+    }
+};
+
+// Compute the ranges of keys this segment reads. The result only depends on the
+// key list and the number of segments, so the segments agree on it without
+// talking to each other.
+void S3BucketReader::assignKeySplits() {
+    vector<BucketContent>& contents = this->keyList.contents;
+    int32_t segNum = std::max(s3ext_segnum, 1);
+
+    uint64_t totalSize = 0;
+    for (uint64_t i = 0; i < contents.size(); i++) {
+        totalSize += contents[i].getSize();
+    }
+
+    // Only a key bigger than the average load of a segment is worth splitting.
+    uint64_t splitSize =
+        std::max((totalSize + segNum - 1) / segNum, (uint64_t)S3_MIN_KEY_SPLIT_SIZE);
+
+    vector<KeySplit> splits;
+    for (uint64_t i = 0; i < contents.size(); i++) {
+        uint64_t keySize = contents[i].getSize();
+
+        uint64_t numOfSplits = 1;
+        if (keySize > splitSize && this->isSplittable(contents[i])) {
+            numOfSplits = (keySize + splitSize - 1) / splitSize;
+        }
+
+        uint64_t splitLength = (keySize + numOfSplits - 1) / numOfSplits;
+        uint64_t offset = 0;
+        do {
+            KeySplit split = {i, offset, std::min(splitLength, keySize - offset)};
+            splits.push_back(split);
+            offset += split.length;
+        } while (offset < keySize);
+    }
+
+    std::sort(splits.begin(), splits.end(), largerSplitFirst);
+
+    std::priority_queue<SegmentLoad, vector<SegmentLoad>, std::greater<SegmentLoad> > loads;
+    for (int32_t segId = 0; segId < segNum; segId++) {
+        SegmentLoad load = {0, 0, segId};
+        loads.push(load);
+    }
+
+    this->keySplits.clear();
+    for (uint64_t i = 0; i < splits.size(); i++) {
+        SegmentLoad load = loads.top();
+        loads.pop();
+
+        if (load.segId == s3ext_segid) {
+            this->keySplits.push_back(splits[i]);
+        }
+
+        load.size += splits[i].length;
+        load.numOfSplits++;
+        loads.push(load);
+    }
+
+    // Read the keys in the order of the key list, as the header line is only kept
+    // for the first of them.
+    std::sort(this->keySplits.begin(), this->keySplits.end(), splitInKeyOrder);
+
+    S3DEBUG("Segment %d reads %" PRIu64 " of %" PRIu64 " key ranges", s3ext_segid,
+            (uint64_t)this->keySplits.size(), (uint64_t)splits.size());
+}
+
+// Ranges of a key are read as lines, which requires plain text. Keys with a header
+// line are never split, as only the first range would start with the header. CSV
+// keys are never split either: a quoted field may hold end of line bytes, and which
+// of them end a row cannot be told without reading the key from its start.
+bool S3BucketReader::isSplittable(BucketContent& key) {
+    if (hasHeader || isCsv) {
+        return false;
+    }
+
+    S3Params keyParams = this->constructReaderParams(key);
+    return this->s3Interface->checkCompressionType(keyParams.getS3Url()) == S3_COMPRESSION_PLAIN;
+}
+
+KeySplit& S3BucketReader::getNextSplit() {
+    KeySplit& split = this->keySplits[this->splitIndex];
+    this->splitIndex++;
+    return split;
 }
 
 S3Params S3BucketReader::constructReaderParams(BucketContent& key) {
@@ -50,75 +172,149 @@ S3Params S3BucketReader::constructReaderParams(BucketContent& key) {
     return readerParams;
 }
 
-uint64_t S3BucketReader::readWithoutHeaderLine(char* buf, uint64_t count) {
-    char* current = NULL;
-    char* end = NULL;
-    char* currentEOL = eolString;
+void S3BucketReader::skipFirstLine(uint64_t count) {
+    const char* data = NULL;
+    const char* currentEOL = eolString;
 
     // check one char at a time
     while (*currentEOL != '\0') {
-        if (current == end) {
-            uint64_t readCount = this->upstreamReader->read(buf, count);
-            // we have reach the end of file but found no matching EOL.
-            if (readCount == 0) {
-                S3WARN("%s", "Reach end of file before matching line terminator");
-                return 0;
-            }
-
-            current = buf;
-            end = buf + readCount;
+        uint64_t lentCount = this->upstreamReader->lend(&data, count);
+        // we have reach the end of file but found no matching EOL.
+        if (lentCount == 0) {
+            S3WARN("%s", "Reach end of file before matching line terminator");
+            return;
         }
 
         // skip until we met next newline char
-        for (; current != end; current++) {
-            if (*current == *currentEOL) {
+        uint64_t skipped = 0;
+        while (skipped < lentCount && *currentEOL != '\0') {
+            if (data[skipped] == *currentEOL) {
                 currentEOL++;
-                current++;
-                break;
             } else {
                 currentEOL = eolString;
             }
+            skipped++;
         }
+
+        this->upstreamReader->release(skipped);
+    }
+}
+
+void S3BucketReader::trackLastBytes(const char* buf, uint64_t count) {
+    uint64_t eolLen = strlen(eolString);
+    uint64_t len = std::min(count, eolLen);
+
+    this->lastBytes.append(buf + count - len, len);
+    if (this->lastBytes.size() > eolLen) {
+        this->lastBytes.erase(0, this->lastBytes.size() - eolLen);
     }
+}
 
-    // move remained data to front.
-    uint64_t remain = end - current;
-    char* p = buf;
-    while (current != end) {
-        *p = *current;
-        p++;
-        current++;
+bool S3BucketReader::lastBytesEndLine() {
+    return this->lastBytes == eolString;
+}
+
+uint64_t S3BucketReader::lendRestOfLine(const char** data, uint64_t count) {
+    if (this->lastBytesEndLine()) {
+        return 0;
+    }
+
+    uint64_t lentCount = this->upstreamReader->lend(data, count);
+
+    // lastBytes is only moved on by release()
+    uint64_t eolLen = strlen(eolString);
+    string last = this->lastBytes;
+    for (uint64_t i = 0; i < lentCount; i++) {
+        last.push_back((*data)[i]);
+        if (last.size() > eolLen) {
+            last.erase(0, 1);
+        }
+        if (last == eolString) {
+            return i + 1;
+        }
     }
 
-    return remain;
+    return lentCount;
 }
 
 uint64_t S3BucketReader::read(char* buf, uint64_t count) {
+    const char* data = NULL;
+    uint64_t readCount = this->lend(&data, count);
+
+    if (readCount != 0) {
+        memcpy(buf, data, readCount);
+        this->release(readCount);
+    }
+
+    return readCount;
+}
+
+uint64_t S3BucketReader::lend(const char** data, uint64_t count) {
     S3_CHECK_OR_DIE(this->upstreamReader != NULL, S3RuntimeError, "upstreamReader is NULL");
-    uint64_t readCount = 0;
+    uint64_t lentCount = 0;
     while (true) {
         if (this->needNewReader) {
-            if (this->keyIndex >= this->keyList.contents.size()) {
+            if (this->splitIndex >= this->keySplits.size()) {
                 S3DEBUG("Read finished for segment: %d", s3ext_segid);
                 return 0;
             }
-            BucketContent& key = this->getNextKey();
+            this->curSplit = this->getNextSplit();
+            this->readingRestOfLine = false;
+            this->lastBytes.clear();
 
-            this->upstreamReader->open(constructReaderParams(key));
+            BucketContent& key = this->keyList.contents[this->curSplit.keyIndex];
+            S3Params readerParams = constructReaderParams(key);
+
+            if (this->curSplit.offset != 0) {
+                // Start right before the range, to know if a line starts at its offset.
+                uint64_t eolLen = strlen(eolString);
+                uint64_t start = this->curSplit.offset - std::min(this->curSplit.offset, eolLen);
+                uint64_t end = this->curSplit.offset + this->curSplit.length;
+                readerParams.setKeyRange(start, end - start);
+            } else if (this->curSplit.length < key.getSize()) {
+                readerParams.setKeyRange(0, this->curSplit.length);
+            }
+
+            this->upstreamReader->open(readerParams);
             this->needNewReader = false;
 
-            // ignore header line if it is not the first file
-            if (hasHeader && !this->isFirstFile) {
-                readCount = readWithoutHeaderLine(buf, count);
-                if (readCount != 0) {
-                    return readCount;
-                }
+            if (this->curSplit.offset != 0) {
+                // the line going on at the start of the range belongs to the previous range
+                this->skipFirstLine(count);
+            } else if (hasHeader && !this->isFirstFile) {
+                // ignore header line if it is not the first file
+                this->skipFirstLine(count);
             }
         }
 
-        readCount = this->upstreamReader->read(buf, count);
-        if (readCount != 0) {
-            return readCount;
+        if (this->readingRestOfLine) {
+            lentCount = this->lendRestOfLine(data, count);
+            if (lentCount != 0) {
+                this->lentData = *data;
+                return lentCount;
+            }
+        } else {
+            lentCount = this->upstreamReader->lend(data, count);
+            if (lentCount != 0) {
+                this->lentData = *data;
+                return lentCount;
+            }
+
+            // The range ends in the middle of a line, read on until the end of it.
+            BucketContent& key = this->keyList.contents[this->curSplit.keyIndex];
+            uint64_t end = this->curSplit.offset + this->curSplit.length;
+            if (end < key.getSize() && !this->lastBytes.empty() && !this->lastBytesEndLine()) {
+                this->upstreamReader->close();
+
+                S3Params readerParams = constructReaderParams(key);
+                readerParams.setKeyRange(end, 0);
+                readerParams.setChunkSize(S3_LINE_REST_CHUNK_SIZE);
+                readerParams.setNumOfChunks(1);
+
+                this->upstreamReader->open(readerParams);
+                this->readingRestOfLine = true;
+                continue;
+            }
         }
 
         // Finished one file, continue to next
@@ -128,6 +324,13 @@ uint64_t S3BucketReader::read(char* buf, uint64_t count) {
     }
 }
 
+void S3BucketReader::release(uint64_t count) {
+    if (count != 0) {
+        this->trackLastBytes(this->lentData, count);
+        this->upstreamReader->release(count);
+    }
+}
+
 void S3BucketReader::close() {
     if (this->upstreamReader != NULL) {
         this->upstreamReader->close();
@@ -137,4 +340,6 @@ void S3BucketReader::close() {
     if (!this->keyList.contents.empty()) {
         this->keyList.contents.clear();
     }
+
+    this->keySplits.clear();
 }
\ No newline at end of file
@@ -5,17 +5,37 @@ void S3CommonReader::open(const S3Params &params) {
 
     S3CompressionType compressionType = s3InterfaceService->checkCompressionType(params.getS3Url());
 
+    // An EOL appended to a compressed key would be garbage after its end.
+    this->keyReader.setAppendEol(compressionType == S3_COMPRESSION_PLAIN);
+
     switch (compressionType) {
         case S3_COMPRESSION_DEFLATE:
         case S3_COMPRESSION_GZIP:
             this->upstreamReader = &this->decompressReader;
             this->decompressReader.setReader(&this->keyReader);
             break;
+#ifdef USE_ZSTD
+        case S3_COMPRESSION_ZSTD:
+            this->upstreamReader = &this->zstdDecompressReader;
+            this->zstdDecompressReader.setReader(&this->keyReader);
+            break;
+#endif
+#ifdef USE_LZ4
+        case S3_COMPRESSION_LZ4:
+            this->upstreamReader = &this->lz4DecompressReader;
+            this->lz4DecompressReader.setReader(&this->keyReader);
+            break;
+#endif
+        case S3_COMPRESSION_PARQUET:
+            this->upstreamReader = &this->parquetReader;
+            this->parquetReader.setS3InterfaceService(this->s3InterfaceService);
+            break;
         case S3_COMPRESSION_PLAIN:
             this->upstreamReader = &this->keyReader;
             break;
         default:
-            S3_CHECK_OR_DIE(false, S3RuntimeError, "unknown file type");
+            S3_CHECK_OR_DIE(false, S3RuntimeError,
+                            "unknown file type, or gpcloud is built without its compression");
     };
 
     this->upstreamReader->open(params);
@@ -27,6 +47,14 @@ uint64_t S3CommonReader::read(char *buf, uint64_t count) {
     return this->upstreamReader->read(buf, count);
 }
 
+uint64_t S3CommonReader::lend(const char **data, uint64_t count) {
+    return this->upstreamReader->lend(data, count);
+}
+
+void S3CommonReader::release(uint64_t count) {
+    this->upstreamReader->release(count);
+}
+
 // This should be reentrant, has no side effects when called multiple times.
 void S3CommonReader::close() {
     if (this->upstreamReader != NULL) {
@@ -1,4 +1,5 @@
 #include "s3conf.h"
+#include "s3list_cache.h"
 #include "s3macros.h"
 #include "s3params.h"
 
@@ -17,6 +18,8 @@ extern "C" {
 #include "cdb/cdbvars.h"
 extern int getgpsegmentCount(void);
 extern char *DataDir;
+extern DistributedTransactionId getDistributedTransactionId(void);
+extern DistributedTransactionTimeStamp getDistributedTransactionTimestamp(void);
 }
 #endif
 
@@ -31,6 +34,38 @@ int32_t s3ext_logserverport = -1;
 int32_t s3ext_logsock_udp = -1;
 struct sockaddr_in s3ext_logserveraddr;
 
+// Codec to compress uploaded data with.
+static S3CompressionType ParseCompressionType(const string& compression) {
+    if (compression == "gzip") {
+        return S3_COMPRESSION_GZIP;
+    }
+#ifdef USE_ZSTD
+    if (compression == "zstd") {
+        return S3_COMPRESSION_ZSTD;
+    }
+#endif
+#ifdef USE_LZ4
+    if (compression == "lz4") {
+        return S3_COMPRESSION_LZ4;
+    }
+#endif
+
+    S3_DIE(S3ConfigError, "\"FATAL: compression '" + compression + "' is not supported\"",
+           "compression");
+}
+
+#ifndef S3_STANDALONE
+string GetListCacheDir() {
+    return string(DataDir) + "/" S3_LIST_CACHE_DIR;
+}
+
+string GetListCacheSession() {
+    stringstream session;
+    session << gp_session_id;
+    return session.str();
+}
+#endif
+
 S3Params InitConfig(const string& urlWithOptions) {
 #ifdef S3_STANDALONE
     s3ext_segid = 0;
@@ -125,6 +160,13 @@ S3Params InitConfig(const string& urlWithOptions) {
 
     params.setAutoCompress(s3Cfg.GetBool(configSection, "autocompress", "true"));
 
+    // the URL option takes precedence over the configuration file
+    string compression = GetOptS3(urlWithOptionsProcessed, "compression");
+    if (compression.empty()) {
+        compression = s3Cfg.Get(configSection, "compression", "gzip");
+    }
+    params.setCompressionType(ParseCompressionType(compression));
+
     params.setVerifyCert(s3Cfg.GetBool(configSection, "verifycert", "true"));
 
     string sse_type = s3Cfg.Get(configSection, "server_side_encryption", "");
@@ -136,6 +178,21 @@ S3Params InitConfig(const string& urlWithOptions) {
 
     params.setGpcheckcloud_newline(s3Cfg.Get(configSection, "gpcheckcloud_newline", "\n"));
 
+#ifndef S3_STANDALONE
+    // The listing is shared within the distributed transaction, or the query if it has none.
+    if (s3Cfg.GetBool(configSection, "list_cache", "true")) {
+        stringstream scope;
+        DistributedTransactionId gxid = getDistributedTransactionId();
+        if (gxid != InvalidDistributedTransactionId) {
+            scope << getDistributedTransactionTimestamp() << "_" << gxid;
+        } else {
+            scope << "q" << gp_command_count;
+        }
+
+        params.setListCache(GetListCacheDir(), GetListCacheSession(), scope.str());
+    }
+#endif
+
     CheckEssentialConfig(params);
 
     return params;
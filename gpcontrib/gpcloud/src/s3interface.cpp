@@ -386,6 +386,21 @@ S3CompressionType S3InterfaceService::checkCompressionType(const S3Url &s3Url) {
         if ((responseData[0] == 0x1f) && (responseData[1] == 0x8b)) {
             return S3_COMPRESSION_GZIP;
         }
+
+        // magic numbers of zstd and LZ4 frames, little-endian
+        if ((responseData[0] == 0x28) && (responseData[1] == 0xb5) &&
+            (responseData[2] == 0x2f) && (responseData[3] == 0xfd)) {
+            return S3_COMPRESSION_ZSTD;
+        }
+
+        if ((responseData[0] == 0x04) && (responseData[1] == 0x22) &&
+            (responseData[2] == 0x4d) && (responseData[3] == 0x18)) {
+            return S3_COMPRESSION_LZ4;
+        }
+
+        if (memcmp(responseData.data(), "PAR1", S3_MAGIC_BYTES_NUM) == 0) {
+            return S3_COMPRESSION_PARQUET;
+        }
     } else if (resp.getStatus() == RESPONSE_ERROR) {
         S3MessageParser s3msg(resp);
         S3_DIE(S3LogicError, s3msg.getCode(), s3msg.getMessage());
@@ -1,5 +1,11 @@
 #include "s3key_reader.h"
 
+static double secondsSince(const struct timeval& start) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (now.tv_sec - start.tv_sec) + (now.tv_usec - start.tv_usec) / 1000000.0;
+}
+
 // Return (offset, length) of next chunk to download,
 // or (fileSize, 0) if reach end of file.
 Range OffsetMgr::getNextOffset() {
@@ -49,10 +55,9 @@ ChunkBuffer& ChunkBuffer::operator=(const ChunkBuffer& other) {
     return *this;
 }
 
-// ret < len means EMPTY
-// that's why it checks if leftLen is larger than *or equal to* len below[1], provides a chance ret
-// is 0, which is smaller than len. Otherwise, other functions won't know when to read next buffer.
-uint64_t ChunkBuffer::read(char* buf, uint64_t len) {
+// The lent bytes stay in chunkData until they are released, the download thread waits for the
+// chunk to become ReadyToFill before it overwrites them.
+uint64_t ChunkBuffer::lend(const char** data, uint64_t len) {
     // GPDB abort signal stops s3_import(), this check is not needed if s3_import() every time calls
     // ChunkBuffer->Read() only once, otherwise(as we did in downstreamReader->read() for
     // decompression feature before), first call sets buffer to ReadyToFill, second call hangs.
@@ -68,33 +73,35 @@ uint64_t ChunkBuffer::read(char* buf, uint64_t len) {
         return 0;
     }
 
-    uint64_t leftLen = this->chunkDataSize - this->curChunkOffset;
-    uint64_t lenToRead = std::min(len, leftLen);
+    *data = (const char*)this->chunkData.data() + this->curChunkOffset;
+    return std::min(len, this->chunkDataSize - this->curChunkOffset);
+}
 
-    if (lenToRead != 0) {
-        memcpy(buf, this->chunkData.data() + this->curChunkOffset, lenToRead);
+bool ChunkBuffer::release(uint64_t count) {
+    UniqueLock statusLock(&this->statusMutex);
+
+    this->curChunkOffset += count;
+    if (this->curChunkOffset < this->chunkDataSize) {
+        return false;
     }
 
-    if (len <= leftLen) {                   // [1]
-        this->curChunkOffset += lenToRead;  // not empty
-    } else {                                // empty, reset everything
-        this->curChunkOffset = 0;
+    // empty, reset everything
+    this->curChunkOffset = 0;
 
-        if (!this->isEOF()) {
-            // Release chunkData memory to reduce consumption.
-            this->chunkData.release();
+    if (!this->isEOF()) {
+        // Release chunkData memory to reduce consumption.
+        this->chunkData.release();
 
-            this->status = ReadyToFill;
+        this->status = ReadyToFill;
 
-            Range range = this->offsetMgr.getNextOffset();
-            this->curFileOffset = range.offset;
-            this->chunkDataSize = range.length;
+        Range range = this->offsetMgr.getNextOffset();
+        this->curFileOffset = range.offset;
+        this->chunkDataSize = range.length;
 
-            pthread_cond_signal(&this->statusCondVar);
-        }
+        pthread_cond_signal(&this->statusCondVar);
     }
 
-    return lenToRead;
+    return true;
 }
 
 // returning uint64_t(-1) means error
@@ -119,7 +126,12 @@ uint64_t ChunkBuffer::fill() {
 
     if (leftLen != 0) {
         try {
+            struct timeval start;
+            gettimeofday(&start, NULL);
+
             readLen = this->s3Interface->fetchData(offset, this->chunkData, leftLen, this->s3Url);
+            this->sharedKeyReader.recordFetch(leftLen, readLen, secondsSince(start));
+
             if (readLen != leftLen) {
                 S3DEBUG("Failed to fetch expected data from S3");
                 this->setSharedError(true, S3PartialResponseError(leftLen, readLen));
@@ -189,8 +201,55 @@ void S3KeyReader::open(const S3Params& params) {
     this->numOfChunks = params.getNumOfChunks();
     S3_CHECK_OR_DIE(this->numOfChunks > 0, S3RuntimeError, "numOfChunks must not be zero");
 
-    this->offsetMgr.setKeySize(params.getKeySize());
-    this->offsetMgr.setChunkSize(params.getChunkSize());
+    // Chunks are only downloaded within the range of the key to read.
+    uint64_t rangeOffset = std::min(params.getKeyRangeOffset(), params.getKeySize());
+    uint64_t rangeEnd = params.getKeySize();
+    if (params.getKeyRangeLength() != 0) {
+        rangeEnd = std::min(rangeOffset + params.getKeyRangeLength(), rangeEnd);
+    }
+
+    this->offsetMgr.setKeySize(rangeEnd);
+    this->offsetMgr.setCurPos(rangeOffset);
+    this->keyRangeLength = rangeEnd - rangeOffset;
+
+    // Start where the previous key left the chunk size. A small key is cut into
+    // smaller chunks, so that all threads download a part of it.
+    this->maxChunkSize = params.getChunkSize();
+    this->adaptingChunkSize = this->maxChunkSize > S3_MIN_CHUNK_SIZE;
+
+    uint64_t chunkSize = this->maxChunkSize;
+    if (this->adaptingChunkSize) {
+        chunkSize = this->adaptedChunkSize != 0 ? this->adaptedChunkSize : S3_INITIAL_CHUNK_SIZE;
+        chunkSize = std::min(chunkSize, this->maxChunkSize);
+
+        // Requests for the chunks of a small key are not representative.
+        uint64_t perThread = (this->keyRangeLength + this->numOfChunks - 1) / this->numOfChunks;
+        if (perThread < chunkSize) {
+            chunkSize = std::max(perThread, (uint64_t)S3_MIN_CHUNK_SIZE);
+            this->adaptingChunkSize = false;
+        }
+    }
+    this->offsetMgr.setChunkSize(chunkSize);
+
+    // No more threads than chunks in the key.
+    if (chunkSize != 0) {
+        uint64_t numOfKeyChunks = (this->keyRangeLength + chunkSize - 1) / chunkSize;
+        this->numOfChunks = std::max(std::min(this->numOfChunks, numOfKeyChunks), (uint64_t)1);
+    }
+
+    {
+        UniqueLock lock(&this->mutexStats);
+        if (this->stats.numOfKeys == 0) {
+            gettimeofday(&this->stats.startTime, NULL);
+        }
+        this->stats.numOfKeys++;
+    }
+
+    // The key goes on after the range, its end is not the end of a line. Compressed keys have
+    // their lines ended by the decompressed data.
+    if (rangeEnd < params.getKeySize() || !this->appendEol) {
+        this->eolAppended = true;
+    }
 
     S3_CHECK_OR_DIE(params.getChunkSize() > 0, S3RuntimeError,
                     "chunk size must be greater than zero");
@@ -211,19 +270,26 @@ void S3KeyReader::open(const S3Params& params) {
 }
 
 uint64_t S3KeyReader::read(char* buf, uint64_t count) {
-    uint64_t fileLen = this->offsetMgr.getKeySize();
-    uint64_t readLen = 0;
+    const char* data = NULL;
+    uint64_t readLen = this->lend(&data, count);
 
-    do {
+    if (readLen != 0) {
+        memcpy(buf, data, readLen);
+        this->release(readLen);
+    }
+
+    return readLen;
+}
+
+uint64_t S3KeyReader::lend(const char** data, uint64_t count) {
+    uint64_t fileLen = this->keyRangeLength;
+
+    while (count != 0) {
         // confirm there is no more available data, done with this file
         if (this->transferredKeyLen >= fileLen) {
             if (!this->hasEol && !this->eolAppended) {
-                uint64_t eolLen = strlen(eolString);
-                memcpy(buf, eolString, eolLen);
-
-                this->eolAppended = true;
-
-                return eolLen;
+                *data = eolString;
+                return strlen(eolString);
             }
 
             return 0;
@@ -231,7 +297,7 @@ uint64_t S3KeyReader::read(char* buf, uint64_t count) {
 
         ChunkBuffer& buffer = chunkBuffers[this->curReadingChunk % this->numOfChunks];
 
-        readLen = buffer.read(buf, count);
+        uint64_t lentLen = buffer.lend(data, count);
 
         if (this->isSharedError()) {
             if (this->sharedException != NULL) {
@@ -241,22 +307,87 @@ uint64_t S3KeyReader::read(char* buf, uint64_t count) {
             }
         }
 
-        this->transferredKeyLen += readLen;
-        if (this->transferredKeyLen == fileLen) {
-            if (buf[readLen - 1] == '\r' || buf[readLen - 1] == '\n') {
-                this->hasEol = true;
-            }
+        if (lentLen != 0) {
+            this->lentData = *data;
+            return lentLen;
         }
 
-        if (readLen < count) {
-            this->curReadingChunk++;
+        // nothing left in this chunk, go on with the next one
+        buffer.release(0);
+        this->curReadingChunk++;
+    }
+
+    return 0;
+}
+
+void S3KeyReader::release(uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    // The lent bytes are the appended EOL.
+    if (this->transferredKeyLen >= this->keyRangeLength) {
+        this->eolAppended = true;
+        return;
+    }
+
+    this->transferredKeyLen += count;
+    if (this->transferredKeyLen == this->keyRangeLength) {
+        char last = this->lentData[count - 1];
+        if (last == '\r' || last == '\n') {
+            this->hasEol = true;
         }
+    }
+
+    ChunkBuffer& buffer = chunkBuffers[this->curReadingChunk % this->numOfChunks];
+    if (buffer.release(count)) {
+        this->curReadingChunk++;
+    }
+}
 
-        count -= readLen;
-    } while (readLen == 0);  // retry to confirm whether thread reading is finished or chunk size is
-                             // divisible by get()'s buffer size
+void S3KeyReader::recordFetch(uint64_t requestedLen, uint64_t fetchedLen, double seconds) {
+    UniqueLock lock(&this->mutexStats);
 
-    return readLen;
+    this->stats.numOfRequests++;
+    this->stats.bytes += fetchedLen;
+    this->stats.fetchSeconds += seconds;
+
+    if (!this->adaptingChunkSize || fetchedLen != requestedLen) {
+        return;
+    }
+
+    // Only a full chunk tells how long a chunk of the current size takes.
+    uint64_t chunkSize = this->offsetMgr.getChunkSize();
+    uint64_t newChunkSize = chunkSize;
+    if (requestedLen == chunkSize && seconds < S3_CHUNK_MIN_FETCH_SECONDS) {
+        newChunkSize = std::min(chunkSize * 2, this->maxChunkSize);
+    } else if (seconds > S3_CHUNK_MAX_FETCH_SECONDS) {
+        newChunkSize = std::max(chunkSize / 2, (uint64_t)S3_MIN_CHUNK_SIZE);
+    }
+
+    if (newChunkSize != chunkSize) {
+        S3DEBUG("Fetched %" PRIu64 " bytes in %.3f seconds, chunk size %" PRIu64 " -> %" PRIu64,
+                fetchedLen, seconds, chunkSize, newChunkSize);
+        this->offsetMgr.setChunkSize(newChunkSize);
+        this->adaptedChunkSize = newChunkSize;
+    }
+}
+
+void S3KeyReader::logStats() {
+    UniqueLock lock(&this->mutexStats);
+
+    if (this->stats.numOfRequests == 0) {
+        return;
+    }
+
+    const double mb = 1024 * 1024;
+    double elapsed = secondsSince(this->stats.startTime);
+    S3INFO("Downloaded %" PRIu64 " bytes of %" PRIu64 " keys with %" PRIu64
+           " requests in %.3f seconds, %.2f MB/s, %.2f MB/s per request, chunk size %" PRIu64,
+           this->stats.bytes, this->stats.numOfKeys, this->stats.numOfRequests, elapsed,
+           elapsed > 0 ? this->stats.bytes / mb / elapsed : 0,
+           this->stats.fetchSeconds > 0 ? this->stats.bytes / mb / this->stats.fetchSeconds : 0,
+           this->adaptedChunkSize != 0 ? this->adaptedChunkSize : this->maxChunkSize);
 }
 
 // reset marks before reading next key
@@ -264,12 +395,15 @@ void S3KeyReader::reset() {
     this->sharedError = false;
     this->curReadingChunk = 0;
     this->transferredKeyLen = 0;
+    this->keyRangeLength = 0;
 
     this->offsetMgr.reset();
 
     this->chunkBuffers.clear();
     this->threads.clear();
 
+    this->lentData = NULL;
+
     this->hasEol = false;
     this->eolAppended = false;
 }
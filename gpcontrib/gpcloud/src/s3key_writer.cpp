@@ -1,5 +1,11 @@
 #include "s3key_writer.h"
 
+static double secondsSince(const struct timeval& start) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (now.tv_sec - start.tv_sec) + (now.tv_usec - start.tv_usec) / 1000000.0;
+}
+
 void S3KeyWriter::open(const S3Params& params) {
     this->params = params;
 
@@ -13,6 +19,22 @@ void S3KeyWriter::open(const S3Params& params) {
 
     S3DEBUG("key: %s, upload id: %s", this->params.getS3Url().getFullUrlForCurl().c_str(),
             this->uploadId.c_str());
+
+    uint64_t numOfThreads = std::max(this->params.getNumOfChunks(), (uint64_t)1);
+
+    this->partBuffers.resize(numOfThreads);
+    this->freeParts.clear();
+    for (uint64_t i = 0; i < numOfThreads; i++) {
+        this->partBuffers[i].reserve(this->params.getChunkSize());
+        this->freeParts.push_back(&this->partBuffers[i]);
+    }
+
+    this->stopUploading = false;
+    for (uint64_t i = 0; i < numOfThreads; i++) {
+        pthread_t uploadThread;
+        pthread_create(&uploadThread, NULL, UploadThreadFunc, this);
+        this->threadList.push_back(uploadThread);
+    }
 }
 
 // write() first fills up the data buffer before flush it out
@@ -50,19 +72,24 @@ void S3KeyWriter::close() {
     }
 }
 
+// Upload threads exit once the queued parts are uploaded, or dropped if an upload has failed.
+void S3KeyWriter::stopUploadThreads() {
+    {
+        UniqueLock queueLock(&this->mutex);
+        this->stopUploading = true;
+        pthread_cond_broadcast(&this->queueCv);
+    }
+
+    for (size_t i = 0; i < threadList.size(); i++) {
+        pthread_join(threadList[i], NULL);
+    }
+    this->threadList.clear();
+}
+
 void S3KeyWriter::checkQueryCancelSignal() {
     if (S3QueryIsAbortInProgress() && !this->uploadId.empty()) {
-        // to avoid dead-lock when other upload threads hold the lock
-        pthread_mutex_unlock(&this->mutex);
-
         // wait for all threads to complete
-        for (size_t i = 0; i < threadList.size(); i++) {
-            pthread_join(threadList[i], NULL);
-        }
-        this->threadList.clear();
-
-        // to avoid double unlock as other parts may lock it
-        pthread_mutex_lock(&this->mutex);
+        this->stopUploadThreads();
 
         S3DEBUG("Start aborting multipart uploading (uploadID: %s, %lu parts uploaded)",
                 this->uploadId.c_str(), this->etagList.size());
@@ -76,73 +103,123 @@ void S3KeyWriter::checkQueryCancelSignal() {
     }
 }
 
-struct ThreadParams {
-    S3KeyWriter* keyWriter;
-    S3VectorUInt8 data;
-    uint64_t currentNumber;
-};
-
 void* S3KeyWriter::UploadThreadFunc(void* data) {
     MaskThreadSignals();
 
-    ThreadParams* params = (ThreadParams*)data;
-    S3KeyWriter* writer = params->keyWriter;
+    S3KeyWriter* writer = (S3KeyWriter*)data;
 
-    try {
-        S3DEBUG("Upload thread start: %" PRIX64 ", part number: %" PRIu64 ", data size: %zu",
-                (uint64_t) pthread_self(), params->currentNumber, params->data.size());
-        string etag = writer->s3Interface->uploadPartOfData(
-            params->data, writer->params.getS3Url(), params->currentNumber, writer->uploadId);
+    while (true) {
+        UploadPart part;
+        {
+            UniqueLock queueLock(&writer->mutex);
+            while (writer->queuedParts.empty() && !writer->stopUploading) {
+                pthread_cond_wait(&writer->queueCv, &writer->mutex);
+            }
 
-        // when unique_lock destructs it will automatically unlock the mutex.
-        UniqueLock threadLock(&writer->mutex);
+            if (writer->queuedParts.empty()) {
+                break;
+            }
 
-        // etag is empty if the query is cancelled by user.
-        if (!etag.empty()) {
-            writer->etagList[params->currentNumber] = etag;
+            part = writer->queuedParts.front();
+            writer->queuedParts.pop();
         }
-        writer->activeThreads--;
-        pthread_cond_broadcast(&writer->cv);
-        S3DEBUG("Upload part finish: %" PRIX64 ", eTag: %s, part number: %" PRIu64, (uint64_t) pthread_self(),
-                etag.c_str(), params->currentNumber);
-    } catch (S3Exception& e) {
-        S3ERROR("Upload thread error: %s", e.getMessage().c_str());
-        UniqueLock exceptLock(&writer->exceptionMutex);
-        writer->sharedError = true;
-        writer->sharedException = std::current_exception();
-
-        // notify the flushBuffer, otherwise it will be locked when trying to create a new thread.
-        writer->activeThreads--;
-        pthread_cond_broadcast(&writer->cv);
-    }
-
-    delete params;
+
+        writer->uploadPart(part);
+    }
+
     return NULL;
 }
 
+void S3KeyWriter::uploadPart(const UploadPart& part) {
+    uint64_t partSize = part.data->size();
+
+    // Once an upload failed, the rest would be thrown away.
+    bool skip = false;
+    {
+        UniqueLock queueLock(&this->mutex);
+        skip = this->sharedError;
+    }
+
+    if (!skip) {
+        try {
+            S3DEBUG("Upload thread start: %" PRIX64 ", part number: %" PRIu64
+                    ", data size: %" PRIu64,
+                    (uint64_t)pthread_self(), part.partNumber, partSize);
+
+            struct timeval start;
+            gettimeofday(&start, NULL);
+
+            string etag = this->s3Interface->uploadPartOfData(*part.data, this->params.getS3Url(),
+                                                              part.partNumber, this->uploadId);
+            double seconds = secondsSince(start);
+
+            UniqueLock queueLock(&this->mutex);
+
+            // etag is empty if the query is cancelled by user.
+            if (!etag.empty()) {
+                this->etagList[part.partNumber] = etag;
+            }
+
+            this->stats.numOfParts++;
+            this->stats.bytes += partSize;
+            this->stats.uploadSeconds += seconds;
+            this->stats.maxPartSeconds = std::max(this->stats.maxPartSeconds, seconds);
+
+            S3DEBUG("Upload part finish: %" PRIX64 ", eTag: %s, part number: %" PRIu64
+                    ", %.3f seconds",
+                    (uint64_t)pthread_self(), etag.c_str(), part.partNumber, seconds);
+        } catch (S3Exception& e) {
+            S3ERROR("Upload thread error: %s", e.getMessage().c_str());
+            UniqueLock queueLock(&this->mutex);
+            if (!this->sharedError) {
+                this->sharedError = true;
+                this->sharedException = std::current_exception();
+            }
+        }
+    }
+
+    // hand the buffer back to write(), whether it is uploaded or not.
+    UniqueLock queueLock(&this->mutex);
+    part.data->clear();
+    this->freeParts.push_back(part.data);
+    this->stats.inflightBytes -= partSize;
+    pthread_cond_broadcast(&this->cv);
+}
+
 void S3KeyWriter::flushBuffer() {
-    if (!this->buffer.empty()) {
+    if (this->buffer.empty()) {
+        return;
+    }
+
+    {
+        // Backpressure: wait until an upload thread frees a part buffer.
         UniqueLock queueLock(&this->mutex);
-        while (this->activeThreads >= this->params.getNumOfChunks()) {
+        while (this->freeParts.empty() && !this->sharedError) {
             pthread_cond_wait(&this->cv, &this->mutex);
         }
+    }
 
-        // Most time query is canceled during uploadPartOfData(). This is the first chance to cancel
-        // and clean up upload.
-        this->checkQueryCancelSignal();
-
-        this->activeThreads++;
+    // Most time query is canceled during uploadPartOfData(). This is the first chance to cancel
+    // and clean up upload.
+    this->checkQueryCancelSignal();
 
-        pthread_t writerThread;
-        ThreadParams* params = new ThreadParams();
-        params->keyWriter = this;
-        params->data.swap(this->buffer);
-        params->currentNumber = ++this->partNumber;
-        pthread_create(&writerThread, NULL, UploadThreadFunc, params);
-        threadList.emplace_back(writerThread);
+    UniqueLock queueLock(&this->mutex);
 
-        this->buffer.reserve(this->params.getChunkSize());
+    // write() and completeKeyWriting() report the error, the data would not be uploaded anyway.
+    if (this->sharedError) {
+        return;
     }
+
+    // Only this thread takes free buffers, the one waited for is still there.
+    S3VectorUInt8* data = this->freeParts.back();
+    this->freeParts.pop_back();
+    data->swap(this->buffer);
+
+    this->queuedParts.push(UploadPart(++this->partNumber, data));
+    this->stats.inflightBytes += data->size();
+    this->stats.maxInflightBytes =
+        std::max(this->stats.maxInflightBytes, this->stats.inflightBytes);
+    pthread_cond_signal(&this->queueCv);
 }
 
 void S3KeyWriter::completeKeyWriting() {
@@ -150,13 +227,23 @@ void S3KeyWriter::completeKeyWriting() {
     this->flushBuffer();
 
     // wait for all threads to complete
-    for (size_t i = 0; i < threadList.size(); i++) {
-        pthread_join(threadList[i], NULL);
-    }
-    this->threadList.clear();
+    this->stopUploadThreads();
 
     this->checkQueryCancelSignal();
 
+    // Completing the key would leave out the failed parts.
+    if (this->sharedError) {
+        S3DEBUG("Start aborting multipart uploading (uploadID: %s) for the failed parts",
+                this->uploadId.c_str());
+        this->s3Interface->abortUpload(this->params.getS3Url(), this->uploadId);
+
+        this->buffer.clear();
+        this->etagList.clear();
+        this->uploadId.clear();
+
+        std::rethrow_exception(this->sharedException);
+    }
+
     vector<string> etags;
     // it is equivalent to foreach(e in etagList) push_back(e.second);
     // transform(etagList.begin(), etagList.end(), etags.begin(),
@@ -178,3 +265,20 @@ void S3KeyWriter::completeKeyWriting() {
     this->etagList.clear();
     this->uploadId.clear();
 }
+
+void S3KeyWriter::logStats() {
+    UniqueLock queueLock(&this->mutex);
+
+    if (this->stats.numOfParts == 0) {
+        return;
+    }
+
+    const double mb = 1024 * 1024;
+    S3INFO("Uploaded %" PRIu64 " bytes in %" PRIu64
+           " parts, %.3f seconds per part on average, %.3f seconds at most, at most %" PRIu64
+           " bytes in flight, %.2f MB/s per part",
+           this->stats.bytes, this->stats.numOfParts,
+           this->stats.uploadSeconds / this->stats.numOfParts, this->stats.maxPartSeconds,
+           this->stats.maxInflightBytes,
+           this->stats.uploadSeconds > 0 ? this->stats.bytes / mb / this->stats.uploadSeconds : 0);
+}
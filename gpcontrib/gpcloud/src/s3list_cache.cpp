@@ -0,0 +1,195 @@
+#include "s3list_cache.h"
+#include "s3utils.h"
+
+#include <dirent.h>
+#include <fstream>
+#include <sys/stat.h>
+
+// Names start with the prefix of temporary files, which the server removes when it restarts.
+#define S3_LIST_CACHE_PREFIX "pgsql_tmp_gpcloud_list_"
+#define S3_LIST_CACHE_MAGIC "gpcloud list 1"
+
+ListBucketCache::ListBucketCache(const string& dir, const string& session, const string& scope)
+    : dir(dir), session(session), scope(scope) {
+}
+
+// Strings are saved as "<length>:<bytes>\n", as key names may hold any character.
+static void writeString(std::ostream& out, const string& str) {
+    out << str.length() << ':' << str << '\n';
+}
+
+static bool readString(std::istream& in, string& str) {
+    uint64_t length = 0;
+    char colon = 0;
+    if (!(in >> length) || !in.get(colon) || colon != ':') {
+        return false;
+    }
+
+    str.resize(length);
+    if (length != 0 && !in.read(&str[0], length)) {
+        return false;
+    }
+
+    return in.get() == '\n';
+}
+
+ListBucketResult ListBucketCache::get(S3Url& s3Url, S3Interface* s3Interface) {
+    char urlHash[SHA256_DIGEST_STRING_LENGTH];
+    string url = s3Url.getFullUrlForCurl();
+    sha256_hex(url.c_str(), url.length(), urlHash);
+
+    this->path = this->dir + "/" S3_LIST_CACHE_PREFIX + this->session + "_" + this->scope + "_" +
+                 string(urlHash, 32);
+    this->lockPath = this->path + ".lock";
+
+    // the directory of temporary files is only created once one is needed
+    if (mkdir(this->dir.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+        S3WARN("Failed to create %s: %s, listing the bucket directly", this->dir.c_str(),
+               strerror(errno));
+        return s3Interface->listBucket(s3Url);
+    }
+
+    ListBucketResult result;
+    while (!this->load(result)) {
+        int fd = ::open(this->lockPath.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0600);
+        if (fd >= 0) {
+            ::close(fd);
+
+            // Another segment might have saved the listing and released the lock in between.
+            if (this->load(result)) {
+                unlink(this->lockPath.c_str());
+                break;
+            }
+
+            try {
+                result = s3Interface->listBucket(s3Url);
+                this->save(result);
+            } catch (...) {
+                // let a waiting segment list it, or fail the same way
+                unlink(this->lockPath.c_str());
+                throw;
+            }
+
+            unlink(this->lockPath.c_str());
+            this->removeOtherScopes();
+            break;
+        }
+
+        S3_CHECK_OR_DIE(errno == EEXIST, S3RuntimeError,
+                        "Failed to create " + this->lockPath + ": " + strerror(errno));
+
+        struct stat st;
+        if (stat(this->lockPath.c_str(), &st) == 0 &&
+            time(NULL) - st.st_mtime > S3_LIST_CACHE_LOCK_TIMEOUT_SECONDS) {
+            S3WARN("Removing stale lock file %s", this->lockPath.c_str());
+            unlink(this->lockPath.c_str());
+            continue;
+        }
+
+        if (S3QueryIsAbortInProgress()) {
+            S3_DIE(S3QueryAbort, "Listing bucket is interrupted");
+        }
+
+        usleep(S3_LIST_CACHE_POLL_MICROSECONDS);
+    }
+
+    return result;
+}
+
+// Return false if no segment has saved the listing yet.
+bool ListBucketCache::load(ListBucketResult& result) {
+    // Only trust files of our own, other users can write to the directory too.
+    struct stat st;
+    if (stat(this->path.c_str(), &st) != 0 || st.st_uid != geteuid()) {
+        return false;
+    }
+
+    std::ifstream in(this->path.c_str(), std::ios::binary);
+    string magic;
+    uint64_t numOfKeys = 0;
+    if (!in || !std::getline(in, magic) || magic != S3_LIST_CACHE_MAGIC ||
+        !readString(in, result.Name) || !readString(in, result.Prefix) || !(in >> numOfKeys)) {
+        S3WARN("Ignoring corrupted listing file %s", this->path.c_str());
+        return false;
+    }
+
+    result.contents.clear();
+    result.contents.reserve(numOfKeys);
+    for (uint64_t i = 0; i < numOfKeys; i++) {
+        BucketContent key;
+        if (!(in >> key.size) || !readString(in, key.name)) {
+            S3WARN("Ignoring corrupted listing file %s", this->path.c_str());
+            return false;
+        }
+        result.contents.push_back(key);
+    }
+
+    S3DEBUG("Read listing of %" PRIu64 " keys from %s", numOfKeys, this->path.c_str());
+    return true;
+}
+
+// The listing is written to a temporary file first, readers only see it complete. Key names
+// are not for other users to read.
+void ListBucketCache::save(const ListBucketResult& result) {
+    stringstream out;
+    out << S3_LIST_CACHE_MAGIC << '\n';
+    writeString(out, result.Name);
+    writeString(out, result.Prefix);
+    out << result.contents.size() << '\n';
+    for (uint64_t i = 0; i < result.contents.size(); i++) {
+        out << result.contents[i].size << ' ';
+        writeString(out, result.contents[i].name);
+    }
+    string data = out.str();
+
+    stringstream tmpPath;
+    tmpPath << this->path << ".tmp." << getpid();
+
+    bool saved = false;
+    int fd = ::open(tmpPath.str().c_str(), O_CREAT | O_EXCL | O_WRONLY, 0600);
+    if (fd >= 0) {
+        saved = ::write(fd, data.c_str(), data.length()) == (ssize_t)data.length();
+        saved = (::close(fd) == 0) && saved;
+        saved = saved && rename(tmpPath.str().c_str(), this->path.c_str()) == 0;
+    }
+
+    if (!saved) {
+        unlink(tmpPath.str().c_str());
+        S3WARN("Failed to save listing to %s, other segments will list the bucket",
+               this->path.c_str());
+    } else {
+        S3DEBUG("Saved listing of %" PRIu64 " keys to %s", (uint64_t)result.contents.size(),
+                this->path.c_str());
+    }
+}
+
+// Remove the listings in dir whose names start with prefix, except those that start with
+// keepPrefix. Lock files are removed by the process holding them.
+static void removeListings(const string& dir, const string& prefix, const string& keepPrefix) {
+    DIR* dirp = opendir(dir.c_str());
+    if (dirp == NULL) {
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dirp)) != NULL) {
+        string name = entry->d_name;
+        if (name.compare(0, prefix.length(), prefix) == 0 &&
+            (keepPrefix.empty() || name.compare(0, keepPrefix.length(), keepPrefix) != 0) &&
+            name.find(".lock") == string::npos) {
+            unlink((dir + "/" + name).c_str());
+        }
+    }
+
+    closedir(dirp);
+}
+
+// Remove the listings of the previous scopes of the session, they won't be used again.
+void ListBucketCache::removeOtherScopes() {
+    string sessionPrefix = S3_LIST_CACHE_PREFIX + this->session + "_";
+    removeListings(this->dir, sessionPrefix, sessionPrefix + this->scope + "_");
+}
+
+void ListBucketCache::removeSession(const string& dir, const string& session) {
+    removeListings(dir, S3_LIST_CACHE_PREFIX + session + "_", "");
+}
@@ -33,11 +33,89 @@ S3RESTfulService::S3RESTfulService(const S3Params &params)
 }
 
 S3RESTfulService::~S3RESTfulService() {
+    // Handles must be closed before libcurl is cleaned up.
+    this->handlePool.clear();
+
     // This function is not thread safe, must NOT call it when any other
     // threads are running, that is, do NOT put it in threads.
     curl_global_cleanup();
 }
 
+CURLHandlePool::CURLHandlePool() : requestCount(0), connectionCount(0) {
+    pthread_mutex_init(&this->mutex, NULL);
+}
+
+CURLHandlePool::~CURLHandlePool() {
+    this->clear();
+    pthread_mutex_destroy(&this->mutex);
+}
+
+CURL *CURLHandlePool::acquire() {
+    {
+        UniqueLock lock(&this->mutex);
+
+        if (!this->idleHandles.empty()) {
+            CURL *curl = this->idleHandles.back();
+            this->idleHandles.pop_back();
+            return curl;
+        }
+    }
+
+    CURL *curl = curl_easy_init();
+    if (curl == NULL) {
+        S3_DIE(S3ConnectionError, "Failed to initialize curl handle.");
+    }
+    return curl;
+}
+
+void CURLHandlePool::release(CURL *curl) {
+    UniqueLock lock(&this->mutex);
+    this->countTransfer(curl);
+
+    // Drop the options of the finished request, they point to its buffers.
+    // The connection and DNS caches of the handle are kept.
+    curl_easy_reset(curl);
+    this->idleHandles.push_back(curl);
+}
+
+void CURLHandlePool::discard(CURL *curl) {
+    {
+        UniqueLock lock(&this->mutex);
+        this->countTransfer(curl);
+    }
+
+    curl_easy_cleanup(curl);
+}
+
+void CURLHandlePool::clear() {
+    UniqueLock lock(&this->mutex);
+
+    for (vector<CURL *>::iterator i = this->idleHandles.begin(); i != this->idleHandles.end();
+         i++) {
+        curl_easy_cleanup(*i);
+    }
+    this->idleHandles.clear();
+}
+
+uint64_t CURLHandlePool::getRequestCount() {
+    UniqueLock lock(&this->mutex);
+    return this->requestCount;
+}
+
+uint64_t CURLHandlePool::getConnectionCount() {
+    UniqueLock lock(&this->mutex);
+    return this->connectionCount;
+}
+
+// Must be called with the mutex held.
+void CURLHandlePool::countTransfer(CURL *curl) {
+    long numConnects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &numConnects);
+
+    this->requestCount++;
+    this->connectionCount += numConnects;
+}
+
 // curl's write function callback.
 static size_t RESTfulServiceWriteFuncCallback(char *ptr, size_t size, size_t nmemb, void *userp) {
     if (S3QueryIsAbortInProgress()) {
@@ -94,12 +172,17 @@ static size_t RESTfulServiceReadFuncCallback(char *ptr, size_t size, size_t nmem
     return copiedItemNum;
 }
 
+// CURLWrapper borrows a handle from the pool for one request. The handle goes
+// back to the pool only if the transfer completed, otherwise it is closed so
+// that a retry starts over on a new connection.
 struct CURLWrapper {
-    CURLWrapper(const string &url, curl_slist *headers, uint64_t lowSpeedLimit,
-                uint64_t lowSpeedTime, bool debugCurl, string proxy) {
-        curl = curl_easy_init();
+    CURLWrapper(CURLHandlePool &pool, const string &url, curl_slist *headers,
+                uint64_t lowSpeedLimit, uint64_t lowSpeedTime, bool debugCurl, string proxy)
+        : pool(pool), reusable(false) {
+        curl = pool.acquire();
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
         curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
         curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, lowSpeedLimit);
@@ -114,12 +197,19 @@ struct CURLWrapper {
         }
     }
     ~CURLWrapper() {
-        curl_easy_cleanup(curl);
+        if (reusable) {
+            pool.release(curl);
+        } else {
+            pool.discard(curl);
+        }
     }
+    CURLHandlePool &pool;
     CURL *curl;
+    bool reusable;
 };
 
-void S3RESTfulService::performCurl(CURL *curl, Response &response) {
+void S3RESTfulService::performCurl(CURLWrapper &wrapper, Response &response) {
+    CURL *curl = wrapper.curl;
     CURLcode res = curl_easy_perform(curl);
     if (res != CURLE_OK) {
         if (res == CURLE_COULDNT_RESOLVE_HOST || res == CURLE_COULDNT_RESOLVE_PROXY) {
@@ -135,6 +225,8 @@ void S3RESTfulService::performCurl(CURL *curl, Response &response) {
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
 
         response.FillResponse(responseCode);
+
+        wrapper.reusable = true;
     }
 }
 
@@ -148,15 +240,15 @@ Response S3RESTfulService::get(const string &url, HTTPHeaders &headers) {
     response.getRawData().reserve(this->chunkBufferSize);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+    CURLWrapper wrapper(this->handlePool, url, headers.GetList(), this->lowSpeedLimit,
+                        this->lowSpeedTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, RESTfulServiceWriteFuncCallback);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, this->verifyCert);
 
-    this->performCurl(curl, response);
+    this->performCurl(wrapper, response);
 
     if (response.getStatus() == RESPONSE_OK) {
 	return response;
@@ -181,8 +273,8 @@ Response S3RESTfulService::put(const string &url, HTTPHeaders &headers, const S3
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+    CURLWrapper wrapper(this->handlePool, url, headers.GetList(), this->lowSpeedLimit,
+                        this->lowSpeedTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
@@ -198,7 +290,7 @@ Response S3RESTfulService::put(const string &url, HTTPHeaders &headers, const S3
     curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void *)&response);
     curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, RESTfulServiceHeadersWriteFuncCallback);
 
-    this->performCurl(curl, response);
+    this->performCurl(wrapper, response);
 
     S3MessageParser s3msg(response);
     ResponseCode responseCode = response.getResponseCode();
@@ -224,8 +316,8 @@ Response S3RESTfulService::post(const string &url, HTTPHeaders &headers,
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+    CURLWrapper wrapper(this->handlePool, url, headers.GetList(), this->lowSpeedLimit,
+                        this->lowSpeedTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
@@ -239,7 +331,7 @@ Response S3RESTfulService::post(const string &url, HTTPHeaders &headers,
     curl_easy_setopt(curl, CURLOPT_READFUNCTION, RESTfulServiceReadFuncCallback);
     curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)data.size());
 
-    this->performCurl(curl, response);
+    this->performCurl(wrapper, response);
 
     if (response.getStatus() == RESPONSE_OK) {
 	return response;
@@ -269,15 +361,15 @@ ResponseCode S3RESTfulService::head(const string &url, HTTPHeaders &headers) {
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+    CURLWrapper wrapper(this->handlePool, url, headers.GetList(), this->lowSpeedLimit,
+                        this->lowSpeedTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "HEAD");
     curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, this->verifyCert);
 
-    this->performCurl(curl, response);
+    this->performCurl(wrapper, response);
 
     if (response.getStatus() == RESPONSE_OK) {
 	return response.getResponseCode();
@@ -302,8 +394,8 @@ Response S3RESTfulService::deleteRequest(const string &url, HTTPHeaders &headers
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+    CURLWrapper wrapper(this->handlePool, url, headers.GetList(), this->lowSpeedLimit,
+                        this->lowSpeedTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
@@ -317,7 +409,7 @@ Response S3RESTfulService::deleteRequest(const string &url, HTTPHeaders &headers
     curl_easy_setopt(curl, CURLOPT_READFUNCTION, RESTfulServiceReadFuncCallback);
     curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)data.size());
 
-    this->performCurl(curl, response);
+    this->performCurl(wrapper, response);
 
     if (response.getStatus() == RESPONSE_OK) {
 	return response;
@@ -210,3 +210,134 @@ TEST_F(CompressWriterTest, CompressCompressedData) {
 
     EXPECT_TRUE(memcmp(compressedData.data(), result.get(), compressedData.size()) == 0);
 }
+
+#ifdef USE_ZSTD
+TEST(ZstdCompressWriter, CompressInWorkerThreads) {
+    const char pangram[] = "The quick brown fox jumps over the lazy dog";
+    uint64_t times = 2 * S3_ZIP_COMPRESS_CHUNKSIZE / (sizeof(pangram) - 1) + 1;
+
+    string input;
+    for (uint64_t i = 0; i < times; i++) input.append(pangram);
+
+    S3Params params("s3://abc/def/");
+    params.setNumOfChunks(4);
+
+    MockWriter writer;
+    ZstdCompressWriter zstdWriter;
+    zstdWriter.setWriter(&writer);
+    zstdWriter.open(params);
+
+    zstdWriter.write(input.c_str(), input.length() / 2);
+    zstdWriter.write(input.c_str() + input.length() / 2, input.length() - input.length() / 2);
+    zstdWriter.close();
+    zstdWriter.close();
+
+    vector<char> result(input.length() + 1);
+    size_t ret =
+        ZSTD_decompress(result.data(), result.size(), writer.getRawData(), writer.getDataSize());
+    ASSERT_FALSE(ZSTD_isError(ret)) << ZSTD_getErrorName(ret);
+    EXPECT_EQ(input.length(), ret);
+    EXPECT_TRUE(memcmp(input.c_str(), result.data(), input.length()) == 0);
+}
+#endif
+
+#ifdef USE_LZ4
+TEST(LZ4CompressWriter, CompressFrame) {
+    const char pangram[] = "The quick brown fox jumps over the lazy dog";
+    uint64_t times = S3_LZ4_COMPRESS_INPUT_SIZE / (sizeof(pangram) - 1) * 3;
+
+    string input;
+    for (uint64_t i = 0; i < times; i++) input.append(pangram);
+
+    MockWriter writer;
+    LZ4CompressWriter lz4Writer;
+    lz4Writer.setWriter(&writer);
+    lz4Writer.open(S3Params("s3://abc/def/"));
+
+    lz4Writer.write(input.c_str(), input.length());
+    lz4Writer.close();
+    lz4Writer.close();
+
+    LZ4F_dctx *dctx = NULL;
+    ASSERT_FALSE(LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION)));
+
+    vector<char> result(input.length() + 1);
+    size_t dstSize = result.size();
+    size_t srcSize = writer.getDataSize();
+    size_t ret =
+        LZ4F_decompress(dctx, result.data(), &dstSize, writer.getRawData(), &srcSize, NULL);
+    LZ4F_freeDecompressionContext(dctx);
+
+    EXPECT_EQ((size_t)0, ret);
+    EXPECT_EQ(input.length(), dstSize);
+    EXPECT_TRUE(memcmp(input.c_str(), result.data(), input.length()) == 0);
+}
+#endif
+
+// Throughput per core of each codec writing CSV-like rows, run by 'make benchmark'. CPU time of
+// the whole process is counted, so zstd workers are included.
+class NullWriter : public Writer {
+   public:
+    NullWriter() : size(0) {
+    }
+
+    virtual void open(const S3Params &params) {
+    }
+    virtual uint64_t write(const char *buf, uint64_t count) {
+        this->size += count;
+        return count;
+    }
+    virtual void close() {
+    }
+
+    uint64_t size;
+};
+
+static void benchmarkCompressWriter(const char *codec, Writer &compressWriter, NullWriter &writer,
+                                    const string &input, const S3Params &params) {
+    clock_t begin = clock();
+
+    compressWriter.open(params);
+    for (uint64_t offset = 0; offset < input.length(); offset += S3_ZIP_COMPRESS_CHUNKSIZE) {
+        compressWriter.write(input.c_str() + offset,
+                             std::min(input.length() - offset, S3_ZIP_COMPRESS_CHUNKSIZE));
+    }
+    compressWriter.close();
+
+    double seconds = double(clock() - begin) / CLOCKS_PER_SEC;
+    printf("%-5s compress: %8.1f MB/s per core, ratio %.2f\n", codec,
+           input.length() / seconds / 1024 / 1024, double(input.length()) / writer.size);
+}
+
+TEST(CodecBenchmark, DISABLED_Compress) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1000000);
+
+    string input;
+    while (input.length() < 64 * 1024 * 1024) {
+        input += std::to_string(dist(gen)) + ",customer" + std::to_string(dist(gen) % 1000) +
+                 ",2016-01-01," + std::to_string(dist(gen) / 100.0) + "\n";
+    }
+
+    S3Params params("s3://abc/def/");
+    params.setNumOfChunks(4);
+
+    NullWriter gzipOut;
+    CompressWriter gzipWriter;
+    gzipWriter.setWriter(&gzipOut);
+    benchmarkCompressWriter("gzip", gzipWriter, gzipOut, input, params);
+
+#ifdef USE_ZSTD
+    NullWriter zstdOut;
+    ZstdCompressWriter zstdWriter;
+    zstdWriter.setWriter(&zstdOut);
+    benchmarkCompressWriter("zstd", zstdWriter, zstdOut, input, params);
+#endif
+
+#ifdef USE_LZ4
+    NullWriter lz4Out;
+    LZ4CompressWriter lz4Writer;
+    lz4Writer.setWriter(&lz4Out);
+    benchmarkCompressWriter("lz4", lz4Writer, lz4Out, input, params);
+#endif
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+# Generate the Parquet files read by parquet_reader_test.cpp, requires pyarrow.
+#
+#   python gen_parquet.py
+
+import datetime
+import decimal
+
+import pyarrow as pa
+import pyarrow.parquet as pq
+
+
+def types_table():
+    return pa.table({
+        'b': pa.array([True, False, None, True], pa.bool_()),
+        'i8': pa.array([-128, 0, None, 127], pa.int8()),
+        'i32': pa.array([-2147483648, 1, None, 2147483647], pa.int32()),
+        'i64': pa.array([-9223372036854775808, 2, None, 9223372036854775807], pa.int64()),
+        'u32': pa.array([4294967295, 0, None, 1], pa.uint32()),
+        'f': pa.array([1.5, float('nan'), None, float('-inf')], pa.float32()),
+        'd': pa.array([0.1, -2.5e-300, None, float('inf')], pa.float64()),
+        's': pa.array(['plain', 'comma, "quote"', None, 'line\nbreak'], pa.string()),
+        'dt': pa.array([datetime.date(1970, 1, 1), datetime.date(2017, 2, 28), None,
+                        datetime.date(1900, 3, 1)], pa.date32()),
+        'ts': pa.array([datetime.datetime(2017, 2, 28, 13, 14, 15, 123456), None,
+                        datetime.datetime(1969, 12, 31, 23, 59, 59, 999999),
+                        datetime.datetime(2000, 1, 1)], pa.timestamp('us', tz='UTC')),
+        'ts_ms': pa.array([datetime.datetime(2017, 2, 28, 13, 14, 15, 123000), None, None,
+                           datetime.datetime(2000, 1, 1)], pa.timestamp('ms')),
+        'dec': pa.array([decimal.Decimal('12345678.91'), decimal.Decimal('-0.05'), None,
+                         decimal.Decimal('0')], pa.decimal128(10, 2)),
+        'dec38': pa.array([decimal.Decimal('-12345678901234567890123456789.123456789'),
+                           decimal.Decimal('1E-9'), None, decimal.Decimal('0')],
+                          pa.decimal128(38, 9)),
+        'list': pa.array([[1, 2], [], None, [3]], pa.list_(pa.int32())),
+    })
+
+
+def main():
+    table = types_table()
+    pq.write_table(table, 'types_dict.parquet', compression='snappy', use_dictionary=True,
+                   version='2.6')
+    pq.write_table(table, 'types_plain.parquet', compression='gzip', use_dictionary=False,
+                   data_page_version='2.0', version='2.6')
+
+    ids = list(range(1000))
+    rows = pa.table({
+        'id': pa.array(ids, pa.int64()),
+        'name': pa.array(['name%04d' % i for i in ids], pa.string()),
+        'score': pa.array([i * 0.5 for i in ids], pa.float64()),
+        'payload': pa.array(['x' * 100 for i in ids], pa.string()),
+    })
+    # the tests decoding its pages need gpcloud built with zstd
+    pq.write_table(rows, 'row_groups.parquet', compression='zstd', row_group_size=100,
+                   data_page_size=256)
+
+
+if __name__ == '__main__':
+    main()
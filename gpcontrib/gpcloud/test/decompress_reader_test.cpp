@@ -1,4 +1,5 @@
 #include "decompress_reader.cpp"
+#include <random>
 #include "gtest/gtest.h"
 
 class MockBufferReader : public Reader {
@@ -141,6 +142,25 @@ TEST_F(DecompressReaderTest, AbleToDecompressFragmentalCompressedData) {
     EXPECT_EQ(0, strncmp(hello, buf, count));
 }
 
+TEST_F(DecompressReaderTest, LendDecompressedData) {
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+    setBufReaderByRawData(hello, sizeof(hello));
+
+    const char *first = NULL;
+    EXPECT_EQ((uint64_t)10, decompressReader.lend(&first, 10));
+    EXPECT_EQ(0, strncmp(hello, first, 10));
+    decompressReader.release(4);
+
+    // the lent bytes are in the output buffer, a release moves on in it
+    const char *data = NULL;
+    EXPECT_EQ(sizeof(hello) - 4, decompressReader.lend(&data, sizeof(hello)));
+    EXPECT_EQ(first + 4, data);
+    EXPECT_EQ(0, strncmp(hello + 4, data, sizeof(hello) - 4));
+    decompressReader.release(sizeof(hello) - 4);
+
+    EXPECT_EQ((uint64_t)0, decompressReader.lend(&data, sizeof(hello)));
+}
+
 TEST_F(DecompressReaderTest, AbleToDecompressWithSmallReadBuffer) {
     // Test case for: caller uses buffer smaller than internal chunk.
     //      total compressed data is small (12 bytes),
@@ -311,3 +331,229 @@ TEST_F(DecompressReaderTest, AbleToDecompressWithIncorrectEncodedStream) {
 
     EXPECT_THROW(decompressReader.read(outputBuffer, sizeof(outputBuffer)), S3RuntimeError);
 }
+
+#ifdef USE_ZSTD
+class ZstdDecompressReaderTest : public testing::Test {
+   protected:
+    virtual void SetUp() {
+        this->bufReader.setChunkSize(1024 * 1024 * 64);
+        zstdReader.setReader(&bufReader);
+    }
+
+    virtual void TearDown() {
+        zstdReader.close();
+    }
+
+    // Compress input into one zstd frame, appended to compressed.
+    void appendFrame(const string &input) {
+        size_t offset = this->compressed.size();
+        this->compressed.resize(offset + ZSTD_compressBound(input.length()));
+
+        size_t len = ZSTD_compress(&this->compressed[offset], this->compressed.size() - offset,
+                                   input.c_str(), input.length(), ZSTD_CLEVEL_DEFAULT);
+        ASSERT_FALSE(ZSTD_isError(len));
+        this->compressed.resize(offset + len);
+    }
+
+    string readAll() {
+        string result;
+        char buf[1000];
+        uint64_t count = 0;
+        while ((count = zstdReader.read(buf, sizeof(buf))) != 0) {
+            result.append(buf, count);
+        }
+        return result;
+    }
+
+    ZstdDecompressReader zstdReader;
+    MockBufferReader bufReader;
+    vector<char> compressed;
+};
+
+TEST_F(ZstdDecompressReaderTest, DecompressEmptyData) {
+    bufReader.setData(NULL, 0);
+    zstdReader.open(S3Params("s3://abc/def"));
+
+    EXPECT_EQ("", this->readAll());
+}
+
+TEST_F(ZstdDecompressReaderTest, DecompressConcatenatedFramesInSmallPieces) {
+    string first(3 * S3_ZIP_DECOMPRESS_CHUNKSIZE + 7, 'a');
+    const string second = "The quick brown fox jumps over the lazy dog";
+    this->appendFrame(first);
+    this->appendFrame(second);
+    bufReader.setData(this->compressed.data(), this->compressed.size());
+
+    // a byte at a time, frames are decoded across lent pieces
+    this->bufReader.setChunkSize(1);
+    zstdReader.open(S3Params("s3://abc/def"));
+
+    EXPECT_EQ(first + second, this->readAll());
+}
+
+// The last call to the decoder fills the output buffer and ends the frame, the call after it has
+// no input and must not take the frame for unfinished.
+TEST_F(ZstdDecompressReaderTest, DecompressFrameFillingOutputBuffer) {
+    string input(S3_ZIP_DECOMPRESS_CHUNKSIZE, 'a');
+    this->appendFrame(input);
+    bufReader.setData(this->compressed.data(), this->compressed.size());
+    zstdReader.open(S3Params("s3://abc/def"));
+
+    EXPECT_EQ(input, this->readAll());
+}
+
+TEST_F(ZstdDecompressReaderTest, TruncatedFrameThrows) {
+    this->appendFrame("The quick brown fox jumps over the lazy dog");
+    bufReader.setData(this->compressed.data(), this->compressed.size() - 1);
+    zstdReader.open(S3Params("s3://abc/def"));
+
+    EXPECT_THROW(this->readAll(), S3RuntimeError);
+}
+
+TEST_F(ZstdDecompressReaderTest, IncorrectEncodedStreamThrows) {
+    char hello[] = "abcdefghigklmnopqrstuvwxyz";
+    bufReader.setData(hello, sizeof(hello));
+    zstdReader.open(S3Params("s3://abc/def"));
+
+    EXPECT_THROW(this->readAll(), S3RuntimeError);
+}
+#endif
+
+#ifdef USE_LZ4
+class LZ4DecompressReaderTest : public testing::Test {
+   protected:
+    virtual void SetUp() {
+        this->bufReader.setChunkSize(1024 * 1024 * 64);
+        lz4Reader.setReader(&bufReader);
+    }
+
+    virtual void TearDown() {
+        lz4Reader.close();
+    }
+
+    // Compress input into one LZ4 frame, appended to compressed.
+    void appendFrame(const string &input) {
+        size_t offset = this->compressed.size();
+        this->compressed.resize(offset + LZ4F_compressFrameBound(input.length(), NULL));
+
+        size_t len = LZ4F_compressFrame(&this->compressed[offset], this->compressed.size() - offset,
+                                        input.c_str(), input.length(), NULL);
+        ASSERT_FALSE(LZ4F_isError(len));
+        this->compressed.resize(offset + len);
+    }
+
+    string readAll() {
+        string result;
+        char buf[1000];
+        uint64_t count = 0;
+        while ((count = lz4Reader.read(buf, sizeof(buf))) != 0) {
+            result.append(buf, count);
+        }
+        return result;
+    }
+
+    LZ4DecompressReader lz4Reader;
+    MockBufferReader bufReader;
+    vector<char> compressed;
+};
+
+TEST_F(LZ4DecompressReaderTest, DecompressConcatenatedFramesInSmallPieces) {
+    string first(3 * S3_ZIP_DECOMPRESS_CHUNKSIZE + 7, 'a');
+    const string second = "The quick brown fox jumps over the lazy dog";
+    this->appendFrame(first);
+    this->appendFrame(second);
+    bufReader.setData(this->compressed.data(), this->compressed.size());
+
+    this->bufReader.setChunkSize(3);
+    lz4Reader.open(S3Params("s3://abc/def"));
+
+    EXPECT_EQ(first + second, this->readAll());
+}
+
+// The last call to the decoder fills the output buffer and ends the frame, the call after it has
+// no input and must not take the frame for unfinished.
+TEST_F(LZ4DecompressReaderTest, DecompressFrameFillingOutputBuffer) {
+    string input(S3_ZIP_DECOMPRESS_CHUNKSIZE, 'a');
+    this->appendFrame(input);
+    bufReader.setData(this->compressed.data(), this->compressed.size());
+    lz4Reader.open(S3Params("s3://abc/def"));
+
+    EXPECT_EQ(input, this->readAll());
+}
+
+TEST_F(LZ4DecompressReaderTest, TruncatedFrameThrows) {
+    this->appendFrame("The quick brown fox jumps over the lazy dog");
+    bufReader.setData(this->compressed.data(), this->compressed.size() - 1);
+    lz4Reader.open(S3Params("s3://abc/def"));
+
+    EXPECT_THROW(this->readAll(), S3RuntimeError);
+}
+#endif
+
+// Throughput per core of each codec reading CSV-like rows, run by 'make benchmark'.
+static void benchmarkDecompressReader(const char *codec, Reader &decompressReader,
+                                      MockBufferReader &bufReader, const vector<char> &compressed,
+                                      uint64_t inputLen) {
+    bufReader.setData(compressed.data(), compressed.size());
+    bufReader.setChunkSize(S3_ZIP_DECOMPRESS_CHUNKSIZE);
+
+    clock_t begin = clock();
+
+    decompressReader.open(S3Params("s3://abc/def"));
+    const char *data = NULL;
+    uint64_t count = 0, total = 0;
+    while ((count = decompressReader.lend(&data, S3_ZIP_DECOMPRESS_CHUNKSIZE)) != 0) {
+        decompressReader.release(count);
+        total += count;
+    }
+    decompressReader.close();
+
+    double seconds = double(clock() - begin) / CLOCKS_PER_SEC;
+    EXPECT_EQ(inputLen, total);
+    printf("%-5s decompress: %8.1f MB/s per core\n", codec, total / seconds / 1024 / 1024);
+}
+
+TEST(CodecBenchmark, DISABLED_Decompress) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1000000);
+
+    string input;
+    while (input.length() < 64 * 1024 * 1024) {
+        input += std::to_string(dist(gen)) + ",customer" + std::to_string(dist(gen) % 1000) +
+                 ",2016-01-01," + std::to_string(dist(gen) / 100.0) + "\n";
+    }
+
+    MockBufferReader gzipIn;
+    DecompressReader gzipReader;
+    gzipReader.setReader(&gzipIn);
+    uLongf gzipLen = compressBound(input.length());
+    vector<char> gzipData(gzipLen);
+    ASSERT_EQ(Z_OK, compress((Bytef *)gzipData.data(), &gzipLen, (const Bytef *)input.c_str(),
+                             input.length()));
+    gzipData.resize(gzipLen);
+    benchmarkDecompressReader("gzip", gzipReader, gzipIn, gzipData, input.length());
+
+#ifdef USE_ZSTD
+    MockBufferReader zstdIn;
+    ZstdDecompressReader zstdReader;
+    zstdReader.setReader(&zstdIn);
+    vector<char> zstdData(ZSTD_compressBound(input.length()));
+    size_t zstdLen = ZSTD_compress(zstdData.data(), zstdData.size(), input.c_str(),
+                                   input.length(), ZSTD_CLEVEL_DEFAULT);
+    ASSERT_FALSE(ZSTD_isError(zstdLen));
+    zstdData.resize(zstdLen);
+    benchmarkDecompressReader("zstd", zstdReader, zstdIn, zstdData, input.length());
+#endif
+
+#ifdef USE_LZ4
+    MockBufferReader lz4In;
+    LZ4DecompressReader lz4Reader;
+    lz4Reader.setReader(&lz4In);
+    vector<char> lz4Data(LZ4F_compressFrameBound(input.length(), NULL));
+    size_t lz4Len =
+        LZ4F_compressFrame(lz4Data.data(), lz4Data.size(), input.c_str(), input.length(), NULL);
+    ASSERT_FALSE(LZ4F_isError(lz4Len));
+    lz4Data.resize(lz4Len);
+    benchmarkDecompressReader("lz4", lz4Reader, lz4In, lz4Data, input.length());
+#endif
+}
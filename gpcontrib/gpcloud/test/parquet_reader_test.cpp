@@ -0,0 +1,325 @@
+#include "parquet_reader.cpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mock_classes.h"
+
+#include <fstream>
+
+using ::testing::_;
+using ::testing::Invoke;
+
+// The files are generated by data/gen_parquet.py.
+class ParquetReaderTest : public testing::Test {
+   protected:
+    virtual void SetUp() {
+        this->reader.setS3InterfaceService(&this->mockS3Interface);
+        this->numOfFetches = 0;
+    }
+
+    virtual void TearDown() {
+        this->reader.close();
+        hasHeader = false;
+    }
+
+    S3Params load(const string& name) {
+        std::ifstream in(("data/" + name).c_str(), std::ios::binary);
+        this->file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        EXPECT_FALSE(this->file.empty()) << name;
+
+        EXPECT_CALL(this->mockS3Interface, fetchData(_, _, _, _))
+            .WillRepeatedly(Invoke(this, &ParquetReaderTest::fetchData));
+
+        S3Params params("https://s3-us-west-2.amazonaws.com/bucket/" + name);
+        params.setKeySize(this->file.size());
+        return params;
+    }
+
+    uint64_t fetchData(uint64_t offset, S3VectorUInt8& data, uint64_t len, const S3Url& s3Url) {
+        EXPECT_LE(offset + len, this->file.size());
+        data.assign(this->file.begin() + offset, this->file.begin() + offset + len);
+        this->numOfFetches++;
+        return len;
+    }
+
+    string readAll() {
+        string result;
+        char buf[1000];
+        uint64_t count;
+        while ((count = this->reader.read(buf, sizeof(buf))) > 0) {
+            result.append(buf, count);
+        }
+        return result;
+    }
+
+    static S3ColumnFilter filter(uint64_t column, S3FilterOp op, const string& value,
+                                 bool isString = false) {
+        S3ColumnFilter filter = {column, op, value, isString};
+        return filter;
+    }
+
+    vector<uint8_t> file;
+    uint64_t numOfFetches;
+
+    MockS3Interface mockS3Interface;
+    ParquetReader reader;
+};
+
+static const char* allTypes =
+    "true,-128,-2147483648,-9223372036854775808,4294967295,1.5,0.10000000000000001,\"plain\","
+    "1970-01-01,2017-02-28 13:14:15.123456+00,2017-02-28 13:14:15.123,12345678.91,"
+    "-12345678901234567890123456789.123456789\n"
+    "false,0,1,2,0,NaN,-2.5e-300,\"comma, \"\"quote\"\"\",2017-02-28,,,-0.05,0.000000001\n"
+    ",,,,,,,,,1969-12-31 23:59:59.999999+00,,,\n"
+    "true,127,2147483647,9223372036854775807,1,-Infinity,Infinity,\"line\nbreak\",1900-03-01,"
+    "2000-01-01 00:00:00+00,2000-01-01 00:00:00,0.00,0.000000000\n";
+
+TEST_F(ParquetReaderTest, ReadDictionaryEncodedSnappyFile) {
+    this->reader.open(this->load("types_dict.parquet"));
+    EXPECT_EQ(allTypes, this->readAll());
+    EXPECT_EQ(0, this->reader.read(NULL, 0));
+}
+
+TEST_F(ParquetReaderTest, ReadPlainEncodedGzipFileOfV2Pages) {
+    this->reader.open(this->load("types_plain.parquet"));
+    EXPECT_EQ(allTypes, this->readAll());
+}
+
+TEST_F(ParquetReaderTest, FetchOnlyProjectedColumns) {
+    S3Params params = this->load("types_dict.parquet");
+
+    // nested fields and missing columns are NULL if not projected
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"missing", "S", "list", "i32", "dt"};
+    scanInfo.projected = {true, true, false, false, true};
+    params.setScanInfo(scanInfo);
+
+    this->reader.open(params);
+    EXPECT_EQ(
+        ",\"plain\",,,1970-01-01\n"
+        ",\"comma, \"\"quote\"\"\",,,2017-02-28\n"
+        ",,,,\n"
+        ",\"line\nbreak\",,,1900-03-01\n",
+        this->readAll());
+
+    // the footer, which is the whole small file, then the two close column chunks at once
+    EXPECT_EQ(2, this->numOfFetches);
+    EXPECT_LT(this->reader.getFetchedBytes() - this->file.size(), this->file.size() / 10);
+}
+
+TEST_F(ParquetReaderTest, NestedFieldsAreNotSupported) {
+    S3Params params = this->load("types_dict.parquet");
+
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"b", "list"};
+    scanInfo.projected = {true, true};
+    params.setScanInfo(scanInfo);
+
+    EXPECT_THROW(this->reader.open(params), S3RuntimeError);
+}
+
+TEST_F(ParquetReaderTest, NoColumnProjected) {
+    S3Params params = this->load("row_groups.parquet");
+
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"id", "name"};
+    scanInfo.projected = {false, false};
+    params.setScanInfo(scanInfo);
+
+    this->reader.open(params);
+    string rows = this->readAll();
+    EXPECT_EQ(1000, std::count(rows.begin(), rows.end(), '\n'));
+    EXPECT_EQ(",\n", rows.substr(0, 2));
+    EXPECT_EQ(1, this->numOfFetches);
+}
+
+// the pages of row_groups.parquet are compressed with zstd
+#ifdef USE_ZSTD
+TEST_F(ParquetReaderTest, ReadManyPagesAndRowGroups) {
+    this->reader.open(this->load("row_groups.parquet"));
+
+    string rows = this->readAll();
+    EXPECT_EQ(1000, std::count(rows.begin(), rows.end(), '\n'));
+    EXPECT_EQ(0, rows.find("0,\"name0000\",0,\"" + string(100, 'x') + "\"\n"));
+    EXPECT_NE(string::npos, rows.find("\n999,\"name0999\",499.5,\"" + string(100, 'x') + "\"\n"));
+}
+
+TEST_F(ParquetReaderTest, SkipRowGroupsOfFilters) {
+    S3Params params = this->load("row_groups.parquet");
+
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"id", "name"};
+    scanInfo.projected = {true, true};
+    scanInfo.filters.push_back(filter(0, S3_FILTER_GE, "250"));
+    scanInfo.filters.push_back(filter(0, S3_FILTER_LT, "300"));
+    params.setScanInfo(scanInfo);
+
+    this->reader.open(params);
+    string rows = this->readAll();
+
+    // rows of the row group are all returned, the query drops the other ones
+    EXPECT_EQ(100, std::count(rows.begin(), rows.end(), '\n'));
+    EXPECT_EQ(0, rows.find("200,\"name0200\"\n"));
+    EXPECT_EQ(9, this->reader.getNumOfSkippedRowGroups());
+}
+
+TEST_F(ParquetReaderTest, SkipRowGroupsAtBoundaries) {
+    S3Params params = this->load("row_groups.parquet");
+
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"id"};
+    scanInfo.projected = {true};
+
+    scanInfo.filters = {filter(0, S3_FILTER_LT, "100")};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    this->readAll();
+    EXPECT_EQ(9, this->reader.getNumOfSkippedRowGroups());
+
+    scanInfo.filters = {filter(0, S3_FILTER_LE, "100")};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    this->readAll();
+    EXPECT_EQ(8, this->reader.getNumOfSkippedRowGroups());
+
+    scanInfo.filters = {filter(0, S3_FILTER_GT, "899")};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    this->readAll();
+    EXPECT_EQ(9, this->reader.getNumOfSkippedRowGroups());
+
+    scanInfo.filters = {filter(0, S3_FILTER_EQ, "1000")};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    EXPECT_EQ("", this->readAll());
+    EXPECT_EQ(10, this->reader.getNumOfSkippedRowGroups());
+}
+
+TEST_F(ParquetReaderTest, SkipRowGroupsOfStringAndFloatFilters) {
+    S3Params params = this->load("row_groups.parquet");
+
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"name", "score"};
+    scanInfo.projected = {true, true};
+
+    scanInfo.filters = {filter(0, S3_FILTER_EQ, "name0420", true)};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    EXPECT_EQ(0, this->readAll().find("\"name0400\",200\n"));
+    EXPECT_EQ(9, this->reader.getNumOfSkippedRowGroups());
+
+    // 0x1.4p+3 is 10, the upper bound of scores of the first row group is 49.5
+    scanInfo.filters = {filter(1, S3_FILTER_LE, "0x1.4p+3")};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    this->readAll();
+    EXPECT_EQ(9, this->reader.getNumOfSkippedRowGroups());
+
+    // NaNs are greater than any number but are not in statistics
+    scanInfo.filters = {filter(1, S3_FILTER_GT, "1000")};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    this->readAll();
+    EXPECT_EQ(0, this->reader.getNumOfSkippedRowGroups());
+
+    // strings are not compared with numbers
+    scanInfo.filters = {filter(0, S3_FILTER_EQ, "1")};
+    params.setScanInfo(scanInfo);
+    this->reader.open(params);
+    this->readAll();
+    EXPECT_EQ(0, this->reader.getNumOfSkippedRowGroups());
+}
+
+#endif
+
+TEST_F(ParquetReaderTest, FilterOfMissingColumnSkipsAll) {
+    S3Params params = this->load("row_groups.parquet");
+
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"id", "missing"};
+    scanInfo.projected = {true, true};
+    scanInfo.filters = {filter(1, S3_FILTER_EQ, "1")};
+    params.setScanInfo(scanInfo);
+
+    this->reader.open(params);
+    EXPECT_EQ("", this->readAll());
+    EXPECT_EQ(1, this->numOfFetches);
+}
+
+TEST_F(ParquetReaderTest, HeaderLineOfColumnNames) {
+    hasHeader = true;
+    S3Params params = this->load("types_dict.parquet");
+
+    S3ScanInfo scanInfo;
+    scanInfo.columnNames = {"i32", "s"};
+    scanInfo.projected = {true, false};
+    params.setScanInfo(scanInfo);
+
+    this->reader.open(params);
+    EXPECT_EQ(0, this->readAll().find("\"i32\",\"s\"\n-2147483648,\n1,\n,\n"));
+}
+
+TEST_F(ParquetReaderTest, LendConvertedRows) {
+    this->reader.open(this->load("types_dict.parquet"));
+
+    const char* data;
+    uint64_t count = this->reader.lend(&data, 5);
+    EXPECT_EQ(5, count);
+    EXPECT_EQ("true,", string(data, count));
+
+    this->reader.release(2);
+    count = this->reader.lend(&data, 3);
+    EXPECT_EQ("ue,", string(data, count));
+}
+
+TEST_F(ParquetReaderTest, NotParquetFile) {
+    S3Params params = this->load("s3test.conf");
+    EXPECT_THROW(this->reader.open(params), S3RuntimeError);
+}
+
+TEST_F(ParquetReaderTest, TruncatedFile) {
+    S3Params params = this->load("types_dict.parquet");
+
+    // cut in the middle of the column chunks, the footer is kept
+    this->file.erase(this->file.begin() + 100, this->file.begin() + 1000);
+    params.setKeySize(this->file.size());
+
+    this->reader.open(params);
+    EXPECT_THROW(this->readAll(), S3RuntimeError);
+}
+
+TEST(ParquetDecoding, BigDecimals) {
+    string out;
+    const uint8_t minusOne[] = {0xff, 0xff};
+    appendBigDecimal(minusOne, sizeof(minusOne), 3, out);
+    EXPECT_EQ("-0.001", out);
+
+    out.clear();
+    const uint8_t big[] = {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    appendBigDecimal(big, sizeof(big), 0, out);
+    EXPECT_EQ("18446744073709551616", out);
+
+    out.clear();
+    const uint8_t minusBig[] = {0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    appendBigDecimal(minusBig, sizeof(minusBig), 2, out);
+    EXPECT_EQ("-184467440737095516.16", out);
+}
+
+TEST(ParquetDecoding, DatesBeforeCommonEra) {
+    string out;
+    appendDate(-719162, out);
+    EXPECT_EQ("0001-01-01", out);
+
+    out.clear();
+    appendTimestamp(-719163, 0, 1000, false, out);
+    EXPECT_EQ("0001-12-31 00:00:00 BC", out);
+}
+
+TEST(ParquetDecoding, SnappyCopies) {
+    // literal "ab", then a copy of 6 bytes at offset 2, overlapping its output
+    const uint8_t block[] = {8, 1 << 2, 'a', 'b', ((6 - 4) << 2) | 1, 2};
+    uint8_t out[8];
+    snappyUncompress(block, sizeof(block), out, sizeof(out));
+    EXPECT_EQ("abababab", string((char*)out, sizeof(out)));
+
+    EXPECT_THROW(snappyUncompress(block, sizeof(block) - 1, out, sizeof(out)), S3RuntimeError);
+}
@@ -0,0 +1,89 @@
+#ifndef TEST_S3BENCHMARK_H_
+#define TEST_S3BENCHMARK_H_
+
+#include <random>
+#include <sys/time.h>
+
+#include "s3common_headers.h"
+#include "s3common_writer.h"
+#include "s3interface.h"
+#include "s3params.h"
+#include "s3restful_service.h"
+
+// Helpers of the S3Benchmark tests, which measure the throughput of gpcloud against a real
+// endpoint. They are disabled, 'make s3benchmark' runs them against bin/localS3Server.py.
+// S3_BENCHMARK_URL points them to another endpoint, with S3_BENCHMARK_ACCESS_ID and
+// S3_BENCHMARK_SECRET as credentials, e.g. https://s3-us-west-2.amazonaws.com/bucket/dir/.
+
+#define S3_BENCHMARK_DEFAULT_URL "http://127.0.0.1:8555/gpcloud-benchmark/"
+#define S3_BENCHMARK_DATA_SIZE (64 * 1024 * 1024)
+
+struct S3BenchmarkCodec {
+    const char* name;
+    bool autoCompress;
+    S3CompressionType type;
+};
+
+static const S3BenchmarkCodec benchmarkCodecs[] = {
+    {"plain", false, S3_COMPRESSION_PLAIN},
+    {"gzip", true, S3_COMPRESSION_GZIP},
+#ifdef USE_ZSTD
+    {"zstd", true, S3_COMPRESSION_ZSTD},
+#endif
+#ifdef USE_LZ4
+    {"lz4", true, S3_COMPRESSION_LZ4},
+#endif
+};
+
+static const uint64_t benchmarkThreads[] = {1, 2, 4, 8};
+static const uint64_t benchmarkChunkSizes[] = {8 * 1024 * 1024, 32 * 1024 * 1024};
+
+inline S3Params benchmarkParams(const string& key, uint64_t numOfThreads, uint64_t chunkSize) {
+    const char* url = getenv("S3_BENCHMARK_URL");
+    const char* accessId = getenv("S3_BENCHMARK_ACCESS_ID");
+    const char* secret = getenv("S3_BENCHMARK_SECRET");
+
+    string baseUrl = url ? url : S3_BENCHMARK_DEFAULT_URL;
+    S3Params params(baseUrl + key, baseUrl.compare(0, 7, "http://") != 0);
+    params.setCred(accessId ? accessId : "benchmark", secret ? secret : "benchmark", "");
+    params.setNumOfChunks(numOfThreads);
+    params.setChunkSize(chunkSize);
+    return params;
+}
+
+// CSV lines like the ones of CodecBenchmark, so that the codecs work as on real data.
+inline string benchmarkData(uint64_t size) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1000000);
+
+    string data;
+    data.reserve(size + 64);
+    while (data.length() < size) {
+        data += std::to_string(dist(gen)) + ",customer" + std::to_string(dist(gen) % 1000) +
+                ",2016-01-01," + std::to_string(dist(gen) / 100.0) + "\n";
+    }
+    return data;
+}
+
+// Upload data as one key with S3CommonWriter, compressed as params say.
+inline void benchmarkUpload(const S3Params& params, const string& data,
+                            S3RESTfulService& restfulService) {
+    S3InterfaceService s3Interface(params);
+    s3Interface.setRESTfulService(&restfulService);
+
+    S3CommonWriter writer;
+    writer.setS3InterfaceService(&s3Interface);
+    writer.open(params);
+    for (uint64_t offset = 0; offset < data.length(); offset += 1024 * 1024) {
+        writer.write(data.c_str() + offset, std::min(data.length() - offset, (size_t)1024 * 1024));
+    }
+    writer.close();
+}
+
+inline double benchmarkSecondsSince(const struct timeval& start) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (now.tv_sec - start.tv_sec) + (now.tv_usec - start.tv_usec) / 1000000.0;
+}
+
+#endif /* TEST_S3BENCHMARK_H_ */
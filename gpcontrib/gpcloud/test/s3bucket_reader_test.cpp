@@ -2,6 +2,8 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "mock_classes.h"
+#include "s3benchmark.h"
+#include "s3common_reader.h"
 
 using ::testing::_;
 using ::testing::AtLeast;
@@ -33,6 +35,7 @@ class S3BucketReaderTest : public testing::Test {
     virtual void TearDown() {
         eolString[0] = '\n';
         eolString[1] = '\0';
+        isCsv = false;
 
         delete bucketReader;
 
@@ -41,7 +44,7 @@ class S3BucketReaderTest : public testing::Test {
     }
 
     S3BucketReader* bucketReader;
-    char buf[64];
+    char buf[512];
 
     MockS3Interface s3Interface;
     MockS3Reader s3Reader;
@@ -285,3 +288,261 @@ TEST_F(S3BucketReaderTest, ReadBucketFileWithHeaderAndFuzyMatch) {
     eolString[0] = '\n';
     eolString[1] = '\0';
 }
+
+TEST_F(S3BucketReaderTest, AssignKeysBySize) {
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 100);
+    result.contents.emplace_back("bar", 10);
+    result.contents.emplace_back("baz", 10);
+    result.contents.emplace_back("qux", 10);
+    result.contents.emplace_back("quux", 60);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+
+    s3ext_segid = 1;
+    s3ext_segnum = 2;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+
+    // "foo" alone goes to segment 0, the other keys to segment 1
+    const vector<KeySplit>& splits = bucketReader->getKeySplits();
+    ASSERT_EQ((uint64_t)4, splits.size());
+    EXPECT_EQ((uint64_t)1, splits[0].keyIndex);
+    EXPECT_EQ((uint64_t)2, splits[1].keyIndex);
+    EXPECT_EQ((uint64_t)3, splits[2].keyIndex);
+    EXPECT_EQ((uint64_t)4, splits[3].keyIndex);
+    EXPECT_EQ((uint64_t)60, splits[3].length);
+}
+
+TEST_F(S3BucketReaderTest, SplitLargeKey) {
+    const uint64_t mb = 1024 * 1024;
+
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 512 * mb);
+    result.contents.emplace_back("bar", 1 * mb);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    EXPECT_CALL(s3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_PLAIN));
+
+    s3ext_segid = 3;
+    s3ext_segnum = 4;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+
+    const vector<KeySplit>& splits = bucketReader->getKeySplits();
+    ASSERT_EQ((uint64_t)1, splits.size());
+    EXPECT_EQ((uint64_t)0, splits[0].keyIndex);
+    EXPECT_EQ((uint64_t)384 * mb, splits[0].offset);
+    EXPECT_EQ((uint64_t)128 * mb, splits[0].length);
+}
+
+TEST_F(S3BucketReaderTest, DoNotSplitCompressedKey) {
+    const uint64_t mb = 1024 * 1024;
+
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 512 * mb);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    EXPECT_CALL(s3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_GZIP));
+
+    s3ext_segid = 0;
+    s3ext_segnum = 4;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+
+    const vector<KeySplit>& splits = bucketReader->getKeySplits();
+    ASSERT_EQ((uint64_t)1, splits.size());
+    EXPECT_EQ((uint64_t)0, splits[0].offset);
+    EXPECT_EQ((uint64_t)512 * mb, splits[0].length);
+}
+
+TEST_F(S3BucketReaderTest, DoNotSplitCsvKey) {
+    const uint64_t mb = 1024 * 1024;
+    isCsv = true;
+
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 512 * mb);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    EXPECT_CALL(s3Interface, checkCompressionType(_)).Times(0);
+
+    s3ext_segid = 3;
+    s3ext_segnum = 4;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+
+    // the whole key goes to segment 0
+    EXPECT_EQ((uint64_t)0, bucketReader->getKeySplits().size());
+}
+
+class MockOpen {
+   public:
+    MockOpen(vector<KeySplit>& ranges) : ranges(ranges) {
+    }
+    void operator()(const S3Params& params) {
+        KeySplit range = {0, params.getKeyRangeOffset(), params.getKeyRangeLength()};
+        ranges.push_back(range);
+    }
+
+   private:
+    vector<KeySplit>& ranges;
+};
+
+TEST_F(S3BucketReaderTest, ReadFirstRangeToEndOfLine) {
+    const uint64_t mb = 1024 * 1024;
+
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 256 * mb);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    EXPECT_CALL(s3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_PLAIN));
+
+    vector<KeySplit> ranges;
+    EXPECT_CALL(s3Reader, open(_)).Times(2).WillRepeatedly(Invoke(MockOpen(ranges)));
+
+    EXPECT_CALL(s3Reader, read(_, _))
+        .WillOnce(Invoke(MockRead("abc\nde")))
+        .WillOnce(Return(0))
+        .WillOnce(Invoke(MockRead("f\nghi\n")));
+
+    s3ext_segid = 0;
+    s3ext_segnum = 2;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+    bucketReader->setUpstreamReader(&s3Reader);
+
+    EXPECT_EQ((uint64_t)6, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)2, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ(0, strncmp(buf, "f\n", 2));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+
+    ASSERT_EQ((uint64_t)2, ranges.size());
+    EXPECT_EQ((uint64_t)0, ranges[0].offset);
+    EXPECT_EQ((uint64_t)128 * mb, ranges[0].length);
+    EXPECT_EQ((uint64_t)128 * mb, ranges[1].offset);
+    EXPECT_EQ((uint64_t)0, ranges[1].length);
+}
+
+TEST_F(S3BucketReaderTest, ReadSecondRangeFromStartOfLine) {
+    const uint64_t mb = 1024 * 1024;
+
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 256 * mb);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    EXPECT_CALL(s3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_PLAIN));
+
+    vector<KeySplit> ranges;
+    EXPECT_CALL(s3Reader, open(_)).Times(1).WillRepeatedly(Invoke(MockOpen(ranges)));
+
+    // the range starts with the end of line "abc", which was read by segment 0
+    EXPECT_CALL(s3Reader, read(_, _))
+        .WillOnce(Invoke(MockRead("c\nghi\n")))
+        .WillOnce(Return(0));
+
+    s3ext_segid = 1;
+    s3ext_segnum = 2;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+    bucketReader->setUpstreamReader(&s3Reader);
+
+    EXPECT_EQ((uint64_t)4, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ(0, strncmp(buf, "ghi\n", 4));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+
+    ASSERT_EQ((uint64_t)1, ranges.size());
+    EXPECT_EQ((uint64_t)128 * mb - 1, ranges[0].offset);
+    EXPECT_EQ((uint64_t)128 * mb + 1, ranges[0].length);
+}
+
+TEST_F(S3BucketReaderTest, ReadCsvKeyWithQuotedNewlineInOneRange) {
+    const uint64_t mb = 1024 * 1024;
+    isCsv = true;
+
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 256 * mb);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+
+    vector<KeySplit> ranges;
+    EXPECT_CALL(s3Reader, open(_)).Times(1).WillRepeatedly(Invoke(MockOpen(ranges)));
+
+    // the end of line in the quoted field of the first row is where a split of the key
+    // at 128MB would have started the second range
+    EXPECT_CALL(s3Reader, read(_, _))
+        .WillOnce(Invoke(MockRead("1,\"abc\nde\"\n2,f\n")))
+        .WillOnce(Return(0));
+
+    s3ext_segid = 0;
+    s3ext_segnum = 2;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+    bucketReader->setUpstreamReader(&s3Reader);
+
+    EXPECT_EQ((uint64_t)15, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ(0, strncmp(buf, "1,\"abc\nde\"\n2,f\n", 15));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+
+    // the whole key is read, not a range of it
+    ASSERT_EQ((uint64_t)1, ranges.size());
+    EXPECT_EQ((uint64_t)0, ranges[0].offset);
+    EXPECT_EQ((uint64_t)0, ranges[0].length);
+}
+
+// ================== S3Benchmark ===================
+
+// Download throughput of S3BucketReader, by codec, threads and chunk size. MB/s are of the data
+// after decompression. Retries show as requests beyond the chunks of the key.
+TEST(S3Benchmark, DISABLED_Download) {
+    string data = benchmarkData(S3_BENCHMARK_DATA_SIZE);
+
+    s3ext_segid = 0;
+    s3ext_segnum = 1;
+
+    for (const S3BenchmarkCodec& codec : benchmarkCodecs) {
+        string prefix = string("download/") + codec.name + "/";
+
+        S3Params uploadParams = benchmarkParams(prefix + "data", 4, 8 * 1024 * 1024);
+        uploadParams.setAutoCompress(codec.autoCompress);
+        uploadParams.setCompressionType(codec.type);
+        S3RESTfulService uploadService(uploadParams);
+        benchmarkUpload(uploadParams, data, uploadService);
+
+        for (uint64_t numOfThreads : benchmarkThreads) {
+            for (uint64_t chunkSize : benchmarkChunkSizes) {
+                S3Params params = benchmarkParams(prefix, numOfThreads, chunkSize);
+                S3RESTfulService restfulService(params);
+                S3InterfaceService s3Interface(params);
+                s3Interface.setRESTfulService(&restfulService);
+
+                S3BucketReader bucketReader;
+                S3CommonReader commonReader;
+                bucketReader.setS3InterfaceService(&s3Interface);
+                bucketReader.setUpstreamReader(&commonReader);
+                commonReader.setS3InterfaceService(&s3Interface);
+
+                struct timeval start;
+                gettimeofday(&start, NULL);
+
+                uint64_t size = 0;
+                const char* view;
+                uint64_t length;
+                bucketReader.open(params);
+                while ((length = bucketReader.lend(&view, 1024 * 1024)) > 0) {
+                    bucketReader.release(length);
+                    size += length;
+                }
+                bucketReader.close();
+
+                double seconds = benchmarkSecondsSince(start);
+                EXPECT_EQ(data.length(), size);
+
+                printf("download %-5s %2" PRIu64 " threads %3" PRIu64
+                       " MB chunks: %8.1f MB/s, %" PRIu64 " requests, %" PRIu64 " connections\n",
+                       codec.name, numOfThreads, chunkSize / 1024 / 1024,
+                       size / seconds / 1024 / 1024, restfulService.getRequestCount(),
+                       restfulService.getConnectionCount());
+            }
+        }
+    }
+}
@@ -86,3 +86,33 @@ TEST_F(S3CommonReaderTest, ReadGZip) {
     EXPECT_EQ((uint64_t)0, this->upstreamReader->read(result, sizeof(result)));
     EXPECT_EQ(0, memcmp(result, hello, sizeof(hello)));
 }
+
+#ifdef USE_LZ4
+TEST_F(S3CommonReaderTest, ReadLZ4WithoutAppendedEol) {
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+    Byte compressionBuff[0x100];
+    size_t compressedLen = LZ4F_compressFrame(compressionBuff, sizeof(compressionBuff), hello,
+                                              sizeof(hello), NULL);
+    ASSERT_FALSE(LZ4F_isError(compressedLen));
+
+    // the frame ends with its end mark, not an EOL
+    ASSERT_NE('\n', compressionBuff[compressedLen - 1]);
+    mockS3Interface.setData(compressionBuff, compressedLen);
+
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_LZ4));
+
+    EXPECT_CALL(mockS3Interface, fetchData(_, _, _, _))
+        .WillOnce(Invoke(&mockS3Interface, &MockS3InterfaceForCompressionRead::mockFetchData));
+
+    char result[0x100];
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+    params.setKeySize(compressedLen);
+    this->open(params);
+
+    EXPECT_EQ(sizeof(hello), this->upstreamReader->read(result, sizeof(result)));
+    EXPECT_EQ((uint64_t)0, this->upstreamReader->read(result, sizeof(result)));
+    EXPECT_EQ(0, memcmp(result, hello, sizeof(hello)));
+}
+#endif
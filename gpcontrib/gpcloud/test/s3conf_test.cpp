@@ -34,6 +34,7 @@ TEST(Config, Basic) {
     EXPECT_EQ("", params.getProxy());
 
     EXPECT_TRUE(params.isAutoCompress());
+    EXPECT_EQ(S3_COMPRESSION_GZIP, params.getCompressionType());
     EXPECT_TRUE(params.isVerifyCert());
 
     EXPECT_EQ(SSE_S3, params.getSSEType());
@@ -75,6 +76,20 @@ TEST(Config, SpecialSwitches) {
     EXPECT_FALSE(params.isAutoCompress());
 }
 
+#ifdef USE_ZSTD
+TEST(Config, CompressionFromURL) {
+    S3Params params = InitConfig("s3://abc/a config=data/s3test.conf compression=zstd");
+
+    EXPECT_TRUE(params.isAutoCompress());
+    EXPECT_EQ(S3_COMPRESSION_ZSTD, params.getCompressionType());
+}
+#endif
+
+TEST(Config, UnsupportedCompression) {
+    EXPECT_THROW(InitConfig("s3://abc/a config=data/s3test.conf compression=bzip2"),
+                 S3ConfigError);
+}
+
 TEST(Config, SectionExist) {
     Config s3cfg("data/s3test.conf");
     EXPECT_TRUE(s3cfg.SectionExist("special_switches"));
@@ -12,6 +12,8 @@ using ::testing::Throw;
 
 bool hasHeader = false;
 
+bool isCsv = false;
+
 char eolString[EOL_CHARS_MAX_LEN + 1] = "\n";  // LF by default
 
 string s3extErrorMessage;
@@ -847,3 +849,237 @@ TEST(ChunkBuffer, ChunkBufferOperatorEqual) {
 
     EXPECT_EQ(ReadyToFill, buf1.getStatus());
 }
+
+TEST_F(S3KeyReaderTest, ReadKeyRange) {
+    S3Params params("s3://abc/def");
+
+    params.setNumOfChunks(1);
+
+    params.setKeySize(1024);
+    params.setKeyRange(256, 255);
+    params.setChunkSize(128);
+
+    EXPECT_CALL(s3Interface, fetchData(256, _, 128, _)).WillOnce(Invoke(MockFetchData(128, 128)));
+    EXPECT_CALL(s3Interface, fetchData(384, _, 127, _)).WillOnce(Invoke(MockFetchData(127, 128)));
+
+    this->open(params);
+
+    EXPECT_EQ((uint64_t)128, this->read(buffer, 128));
+    EXPECT_EQ((uint64_t)127, this->read(buffer, 128));
+    // no EOL is appended in the middle of the key
+    EXPECT_EQ((uint64_t)0, this->read(buffer, 128));
+}
+
+TEST_F(S3KeyReaderTest, ReadWithoutAppendedEol) {
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setKeySize(255);
+    params.setChunkSize(8192);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _)).WillOnce(Invoke(MockFetchData(255, 8192)));
+
+    this->setAppendEol(false);
+    this->open(params);
+
+    EXPECT_EQ((uint64_t)255, this->read(buffer, 64 * 1024));
+    EXPECT_EQ((uint64_t)0, this->read(buffer, 64 * 1024));
+}
+
+TEST_F(S3KeyReaderTest, NoMoreThreadsThanChunks) {
+    S3Params params("s3://abc/def");
+
+    params.setNumOfChunks(8);
+
+    params.setKeySize(100);
+    params.setChunkSize(64);
+
+    EXPECT_CALL(s3Interface, fetchData(0, _, 64, _)).WillOnce(Invoke(MockFetchData(64, 64)));
+    EXPECT_CALL(s3Interface, fetchData(64, _, 36, _)).WillOnce(Invoke(MockFetchData(36, 64)));
+
+    this->open(params);
+
+    EXPECT_EQ((uint64_t)2, this->getThreads().size());
+
+    EXPECT_EQ((uint64_t)64, this->read(buffer, 64));
+    EXPECT_EQ((uint64_t)36, this->read(buffer, 64));
+    EXPECT_EQ((uint64_t)1, this->read(buffer, 64));
+    EXPECT_EQ((uint64_t)0, this->read(buffer, 64));
+}
+
+TEST_F(S3KeyReaderTest, SpreadSmallKeyOverThreads) {
+    const uint64_t mb = 1024 * 1024;
+    S3Params params("s3://abc/def");
+
+    params.setNumOfChunks(4);
+
+    params.setKeySize(4 * mb);
+    params.setChunkSize(64 * mb);
+
+    EXPECT_CALL(s3Interface, fetchData(0, _, mb, _)).WillOnce(Invoke(MockFetchData(mb, mb)));
+    EXPECT_CALL(s3Interface, fetchData(mb, _, mb, _)).WillOnce(Invoke(MockFetchData(mb, mb)));
+    EXPECT_CALL(s3Interface, fetchData(2 * mb, _, mb, _))
+        .WillOnce(Invoke(MockFetchData(mb, mb)));
+    EXPECT_CALL(s3Interface, fetchData(3 * mb, _, mb, _))
+        .WillOnce(Invoke(MockFetchData(mb, mb)));
+
+    this->open(params);
+
+    EXPECT_EQ((uint64_t)4, this->getThreads().size());
+
+    vector<char> data(mb);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(mb, this->read(data.data(), mb));
+    }
+    EXPECT_EQ((uint64_t)1, this->read(data.data(), mb));
+    EXPECT_EQ((uint64_t)0, this->read(data.data(), mb));
+}
+
+TEST_F(S3KeyReaderTest, GrowChunkSizeOnFastRequests) {
+    const uint64_t mb = 1024 * 1024;
+    S3Params params("s3://abc/def");
+
+    params.setNumOfChunks(1);
+
+    params.setKeySize(24 * mb);
+    params.setChunkSize(64 * mb);
+
+    // chunks start at 8MB, the mocked requests are fast enough to double it
+    EXPECT_CALL(s3Interface, fetchData(0, _, 8 * mb, _))
+        .WillOnce(Invoke(MockFetchData(8 * mb, 8 * mb)));
+    EXPECT_CALL(s3Interface, fetchData(8 * mb, _, 16 * mb, _))
+        .WillOnce(Invoke(MockFetchData(16 * mb, 16 * mb)));
+
+    this->open(params);
+
+    vector<char> data(16 * mb);
+    EXPECT_EQ(8 * mb, this->read(data.data(), 16 * mb));
+    EXPECT_EQ(16 * mb, this->read(data.data(), 16 * mb));
+    EXPECT_EQ((uint64_t)1, this->read(data.data(), 16 * mb));
+    EXPECT_EQ((uint64_t)0, this->read(data.data(), 16 * mb));
+
+    EXPECT_EQ((uint64_t)1, this->getStats().numOfKeys);
+    EXPECT_EQ((uint64_t)2, this->getStats().numOfRequests);
+    EXPECT_EQ(24 * mb, this->getStats().bytes);
+}
+
+TEST_F(S3KeyReaderTest, ShrinkChunkSizeOnSlowRequests) {
+    const uint64_t mb = 1024 * 1024;
+    S3Params params("s3://abc/def");
+
+    params.setNumOfChunks(1);
+    params.setKeySize(64 * mb);
+    params.setChunkSize(64 * mb);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _)).WillRepeatedly(Return(0));
+
+    this->open(params);
+
+    this->recordFetch(8 * mb, 8 * mb, S3_CHUNK_MAX_FETCH_SECONDS + 1);
+    EXPECT_EQ(4 * mb, this->getOffsetMgr().getChunkSize());
+
+    this->recordFetch(4 * mb, 4 * mb, S3_CHUNK_MIN_FETCH_SECONDS);
+    EXPECT_EQ(4 * mb, this->getOffsetMgr().getChunkSize());
+}
+
+TEST_F(S3KeyReaderTest, LendFromChunk) {
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(2);
+    params.setKeySize(255);
+    params.setChunkSize(128);
+
+    EXPECT_CALL(s3Interface, fetchData(0, _, 128, _)).WillOnce(Invoke(MockFetchData(128, 128)));
+    EXPECT_CALL(s3Interface, fetchData(128, _, 127, _)).WillOnce(Invoke(MockFetchData(127, 128)));
+
+    this->open(params);
+
+    const char *data = NULL;
+    const char *first = NULL;
+    EXPECT_EQ((uint64_t)100, this->lend(&first, 100));
+
+    // bytes not released are lent again
+    EXPECT_EQ((uint64_t)100, this->lend(&data, 100));
+    EXPECT_EQ(first, data);
+
+    this->release(60);
+    EXPECT_EQ((uint64_t)0, this->getCurReadingChunk());
+
+    // the rest of the chunk, without a copy
+    EXPECT_EQ((uint64_t)68, this->lend(&data, 100));
+    EXPECT_EQ(first + 60, data);
+    this->release(68);
+    EXPECT_EQ((uint64_t)1, this->getCurReadingChunk());
+
+    EXPECT_EQ((uint64_t)100, this->lend(&data, 100));
+    this->release(100);
+    EXPECT_EQ((uint64_t)27, this->lend(&data, 100));
+    this->release(27);
+    EXPECT_EQ((uint64_t)255, this->getTransferredKeyLen());
+
+    // EOL is appended once
+    EXPECT_EQ((uint64_t)1, this->lend(&data, 100));
+    EXPECT_EQ('\n', data[0]);
+    this->release(1);
+    EXPECT_EQ((uint64_t)0, this->lend(&data, 100));
+}
+
+// Compare copying reads with lent reads of a key in memory, run with
+// --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+//
+// The mocked downloads take most of the wall time, so the CPU time of the reading thread is
+// reported as well.
+TEST_F(S3KeyReaderTest, DISABLED_BenchmarkLendVersusRead) {
+    const uint64_t mb = 1024 * 1024;
+    const uint64_t keySize = 1024 * mb;
+    const uint64_t bufSize = 64 * 1024;
+
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(4);
+    params.setKeySize(keySize);
+    params.setChunkSize(8 * mb);
+
+    // every chunk is a full 8MB one
+    EXPECT_CALL(s3Interface, fetchData(_, _, 8 * mb, _))
+        .WillRepeatedly(Invoke([](uint64_t offset, S3VectorUInt8 &data, uint64_t len,
+                                  const S3Url &sourceUrl) {
+            data.resize(len);
+            return len;
+        }));
+
+    vector<char> buf(bufSize);
+    for (int lending = 0; lending < 2; lending++) {
+        this->open(params);
+
+        struct timeval start;
+        struct timespec cpuStart, cpuEnd;
+        gettimeofday(&start, NULL);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuStart);
+
+        uint64_t total = 0;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        do {
+            if (lending) {
+                const char *data = NULL;
+                count = this->lend(&data, bufSize);
+                sum += count != 0 ? data[count - 1] : 0;
+                this->release(count);
+            } else {
+                count = this->read(buf.data(), bufSize);
+                sum += count != 0 ? buf[count - 1] : 0;
+            }
+            total += count;
+        } while (count != 0);
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+        double seconds = secondsSince(start);
+        double cpuSeconds =
+            (cpuEnd.tv_sec - cpuStart.tv_sec) + (cpuEnd.tv_nsec - cpuStart.tv_nsec) / 1e9;
+        printf("%s: %" PRIu64 " bytes in %.3f seconds, %.1f MB/s, reader CPU %.3f seconds\n",
+               lending ? "lend" : "read", total, seconds, total / (double)mb / seconds,
+               cpuSeconds);
+
+        EXPECT_EQ(keySize + 1, total);
+        EXPECT_EQ((uint64_t)'\n', sum);
+        this->close();
+    }
+}
@@ -1,7 +1,9 @@
 #include "s3key_writer.cpp"
+#include <atomic>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "mock_classes.h"
+#include "s3benchmark.h"
 
 using ::testing::_;
 using ::testing::AtLeast;
@@ -186,3 +188,114 @@ TEST_F(S3KeyWriterTest, TestWriteAbortInClosing) {
     EXPECT_THROW(this->close(), S3QueryAbort);
     QueryCancelPending = false;
 }
+
+TEST_F(S3KeyWriterTest, TestInflightBytesBoundedByThreads) {
+    testParams.setChunkSize(0x100);
+
+    char data[0x100];
+    EXPECT_CALL(this->mockS3Interface, getUploadId(_)).WillOnce(Return("uploadid1"));
+    EXPECT_CALL(this->mockS3Interface, uploadPartOfData(_, _, _, "uploadid1"))
+        .Times(10)
+        .WillRepeatedly(Invoke(MockUploadPartOfData(0x100)));
+    EXPECT_CALL(this->mockS3Interface, completeMultiPart(_, _, _)).WillOnce(Return(true));
+
+    this->open(testParams);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(sizeof(data), this->write(data, sizeof(data)));
+    }
+    this->close();
+
+    EXPECT_EQ((uint64_t)10, this->getStats().numOfParts);
+    EXPECT_EQ((uint64_t)0xA00, this->getStats().bytes);
+    EXPECT_EQ((uint64_t)0, this->getStats().inflightBytes);
+    EXPECT_LE(this->getStats().maxInflightBytes, (uint64_t)0x300);
+    EXPECT_EQ((size_t)3, this->partBuffers.size());
+}
+
+// Part 1 is slow, the other upload threads go on with parts 2 and 3 meanwhile.
+TEST_F(S3KeyWriterTest, TestSlowPartDoesNotBlockOthers) {
+    testParams.setChunkSize(0x100);
+
+    std::atomic<int> uploadedParts(0);
+    bool othersUploaded = false;
+
+    char data[0x100];
+    EXPECT_CALL(this->mockS3Interface, getUploadId(_)).WillOnce(Return("uploadid1"));
+    EXPECT_CALL(this->mockS3Interface, uploadPartOfData(_, _, 1, "uploadid1"))
+        .WillOnce(Invoke([&](S3VectorUInt8 &, const S3Url &, uint64_t, const string &) {
+            for (int i = 0; i < 500 && uploadedParts < 2; i++) {
+                usleep(10000);
+            }
+            othersUploaded = uploadedParts == 2;
+            return string("\"etag1\"");
+        }));
+    EXPECT_CALL(this->mockS3Interface, uploadPartOfData(_, _, 2, "uploadid1"))
+        .WillOnce(Invoke([&](S3VectorUInt8 &, const S3Url &, uint64_t, const string &) {
+            uploadedParts++;
+            return string("\"etag2\"");
+        }));
+    EXPECT_CALL(this->mockS3Interface, uploadPartOfData(_, _, 3, "uploadid1"))
+        .WillOnce(Invoke([&](S3VectorUInt8 &, const S3Url &, uint64_t, const string &) {
+            uploadedParts++;
+            return string("\"etag3\"");
+        }));
+    EXPECT_CALL(this->mockS3Interface, completeMultiPart(_, _, _)).WillOnce(Return(true));
+
+    this->open(testParams);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(sizeof(data), this->write(data, sizeof(data)));
+    }
+    this->close();
+
+    EXPECT_TRUE(othersUploaded);
+}
+
+TEST_F(S3KeyWriterTest, TestFailedPartAbortsUpload) {
+    testParams.setChunkSize(0x100);
+
+    char data[0x100];
+    EXPECT_CALL(this->mockS3Interface, getUploadId(_)).WillOnce(Return("uploadid1"));
+    EXPECT_CALL(this->mockS3Interface, uploadPartOfData(_, _, _, "uploadid1"))
+        .WillOnce(Throw(S3RuntimeError("failed to upload")));
+    EXPECT_CALL(this->mockS3Interface, completeMultiPart(_, _, _)).Times(0);
+    EXPECT_CALL(this->mockS3Interface, abortUpload(_, "uploadid1")).WillOnce(Return(true));
+
+    this->open(testParams);
+    ASSERT_EQ(sizeof(data), this->write(data, sizeof(data)));
+
+    EXPECT_THROW(this->close(), S3RuntimeError);
+    EXPECT_NO_THROW(this->close());
+}
+
+// ================== S3Benchmark ===================
+
+// Upload throughput of S3KeyWriter through S3CommonWriter, by codec, threads and chunk size. MB/s
+// are of the data before compression. Retries show as requests beyond the parts of the key.
+TEST(S3Benchmark, DISABLED_Upload) {
+    string data = benchmarkData(S3_BENCHMARK_DATA_SIZE);
+
+    for (const S3BenchmarkCodec& codec : benchmarkCodecs) {
+        for (uint64_t numOfThreads : benchmarkThreads) {
+            for (uint64_t chunkSize : benchmarkChunkSizes) {
+                stringstream key;
+                key << "upload/" << codec.name << "_" << numOfThreads << "_" << chunkSize;
+
+                S3Params params = benchmarkParams(key.str(), numOfThreads, chunkSize);
+                params.setAutoCompress(codec.autoCompress);
+                params.setCompressionType(codec.type);
+                S3RESTfulService restfulService(params);
+
+                struct timeval start;
+                gettimeofday(&start, NULL);
+                benchmarkUpload(params, data, restfulService);
+                double seconds = benchmarkSecondsSince(start);
+
+                printf("upload   %-5s %2" PRIu64 " threads %3" PRIu64
+                       " MB chunks: %8.1f MB/s, %" PRIu64 " requests, %" PRIu64 " connections\n",
+                       codec.name, numOfThreads, chunkSize / 1024 / 1024,
+                       data.length() / seconds / 1024 / 1024, restfulService.getRequestCount(),
+                       restfulService.getConnectionCount());
+            }
+        }
+    }
+}
@@ -0,0 +1,197 @@
+#include "s3list_cache.cpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mock_classes.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::Throw;
+
+class ListBucketCacheTest : public testing::Test {
+   protected:
+    virtual void SetUp() {
+        char tmpl[] = "/tmp/gpcloud_list_cache_test_XXXXXX";
+        ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+        this->dir = tmpl;
+
+        this->keyList.Name = "bucket";
+        this->keyList.Prefix = "prefix";
+        this->keyList.contents.push_back(BucketContent("prefix/a", 123));
+        this->keyList.contents.push_back(BucketContent("prefix/line\nbreak:colon", 0));
+        this->keyList.contents.push_back(BucketContent("prefix/c", 1ULL << 40));
+    }
+
+    virtual void TearDown() {
+        DIR *dirp = opendir(this->dir.c_str());
+        struct dirent *entry;
+        while ((entry = readdir(dirp)) != NULL) {
+            unlink((this->dir + "/" + entry->d_name).c_str());
+        }
+        closedir(dirp);
+        rmdir(this->dir.c_str());
+    }
+
+    uint64_t countFiles() {
+        uint64_t count = 0;
+        DIR *dirp = opendir(this->dir.c_str());
+        struct dirent *entry;
+        while ((entry = readdir(dirp)) != NULL) {
+            if (entry->d_name[0] != '.') {
+                count++;
+            }
+        }
+        closedir(dirp);
+        return count;
+    }
+
+    void expectKeyList(const ListBucketResult &result) {
+        EXPECT_EQ(this->keyList.Name, result.Name);
+        EXPECT_EQ(this->keyList.Prefix, result.Prefix);
+        ASSERT_EQ(this->keyList.contents.size(), result.contents.size());
+        for (uint64_t i = 0; i < result.contents.size(); i++) {
+            EXPECT_EQ(this->keyList.contents[i].getName(), result.contents[i].getName());
+            EXPECT_EQ(this->keyList.contents[i].getSize(), result.contents[i].getSize());
+        }
+    }
+
+    string dir;
+    ListBucketResult keyList;
+    MockS3Interface mockS3Interface;
+};
+
+TEST_F(ListBucketCacheTest, ListedOnceInScope) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    EXPECT_CALL(mockS3Interface, listBucket(_)).WillOnce(Return(this->keyList));
+
+    ListBucketCache first(this->dir, "7", "100_8");
+    this->expectKeyList(first.get(s3Url, &mockS3Interface));
+
+    ListBucketCache second(this->dir, "7", "100_8");
+    this->expectKeyList(second.get(s3Url, &mockS3Interface));
+
+    EXPECT_EQ(first.getPath(), second.getPath());
+    EXPECT_EQ((uint64_t)1, this->countFiles());
+}
+
+TEST_F(ListBucketCacheTest, ListedAgainInNewScope) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    EXPECT_CALL(mockS3Interface, listBucket(_)).Times(2).WillRepeatedly(Return(this->keyList));
+
+    ListBucketCache first(this->dir, "7", "100_8");
+    first.get(s3Url, &mockS3Interface);
+
+    // the listing of the previous scope of the session is removed
+    ListBucketCache second(this->dir, "7", "100_9");
+    this->expectKeyList(second.get(s3Url, &mockS3Interface));
+
+    EXPECT_NE(0, access(first.getPath().c_str(), F_OK));
+    EXPECT_EQ(0, access(second.getPath().c_str(), F_OK));
+    EXPECT_EQ((uint64_t)1, this->countFiles());
+}
+
+TEST_F(ListBucketCacheTest, OtherSessionsAreKept) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    EXPECT_CALL(mockS3Interface, listBucket(_)).Times(2).WillRepeatedly(Return(this->keyList));
+
+    ListBucketCache first(this->dir, "7", "100_8");
+    first.get(s3Url, &mockS3Interface);
+
+    ListBucketCache second(this->dir, "71", "100_9");
+    second.get(s3Url, &mockS3Interface);
+
+    EXPECT_EQ((uint64_t)2, this->countFiles());
+}
+
+TEST_F(ListBucketCacheTest, SessionListingsAreRemovedAtItsEnd) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    EXPECT_CALL(mockS3Interface, listBucket(_)).Times(2).WillRepeatedly(Return(this->keyList));
+
+    ListBucketCache first(this->dir, "7", "100_8");
+    first.get(s3Url, &mockS3Interface);
+
+    ListBucketCache second(this->dir, "71", "100_9");
+    second.get(s3Url, &mockS3Interface);
+
+    ListBucketCache::removeSession(this->dir, "7");
+
+    EXPECT_NE(0, access(first.getPath().c_str(), F_OK));
+    EXPECT_EQ(0, access(second.getPath().c_str(), F_OK));
+    EXPECT_EQ((uint64_t)1, this->countFiles());
+}
+
+TEST_F(ListBucketCacheTest, MissingDirectoryIsCreated) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    EXPECT_CALL(mockS3Interface, listBucket(_)).WillOnce(Return(this->keyList));
+
+    string subdir = this->dir + "/pgsql_tmp";
+    ListBucketCache cache(subdir, "7", "q3");
+    this->expectKeyList(cache.get(s3Url, &mockS3Interface));
+
+    struct stat st;
+    ASSERT_EQ(0, stat(subdir.c_str(), &st));
+    EXPECT_EQ((mode_t)S_IRWXU, st.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+    EXPECT_EQ(0, access(cache.getPath().c_str(), F_OK));
+
+    ListBucketCache::removeSession(subdir, "7");
+    EXPECT_EQ(0, rmdir(subdir.c_str()));
+}
+
+static void *getKeyList(void *cache) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    std::pair<ListBucketCache *, S3Interface *> *p =
+        (std::pair<ListBucketCache *, S3Interface *> *)cache;
+    return new ListBucketResult(p->first->get(s3Url, p->second));
+}
+
+TEST_F(ListBucketCacheTest, ConcurrentProcessesListOnce) {
+    EXPECT_CALL(mockS3Interface, listBucket(_)).WillOnce(Invoke([this](S3Url &) {
+        usleep(200000);
+        return this->keyList;
+    }));
+
+    const int numOfProcesses = 4;
+    vector<ListBucketCache> caches(numOfProcesses, ListBucketCache(this->dir, "7", "q3"));
+    vector<std::pair<ListBucketCache *, S3Interface *> > args;
+    for (int i = 0; i < numOfProcesses; i++) {
+        args.push_back(std::make_pair(&caches[i], (S3Interface *)&mockS3Interface));
+    }
+
+    vector<pthread_t> threads(numOfProcesses);
+    for (int i = 0; i < numOfProcesses; i++) {
+        pthread_create(&threads[i], NULL, getKeyList, &args[i]);
+    }
+
+    for (int i = 0; i < numOfProcesses; i++) {
+        void *result = NULL;
+        pthread_join(threads[i], &result);
+        this->expectKeyList(*(ListBucketResult *)result);
+        delete (ListBucketResult *)result;
+    }
+}
+
+TEST_F(ListBucketCacheTest, FailedListingReleasesLock) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    EXPECT_CALL(mockS3Interface, listBucket(_))
+        .WillOnce(Throw(S3RuntimeError("failed to list")))
+        .WillOnce(Return(this->keyList));
+
+    ListBucketCache first(this->dir, "7", "q3");
+    EXPECT_THROW(first.get(s3Url, &mockS3Interface), S3RuntimeError);
+    EXPECT_EQ((uint64_t)0, this->countFiles());
+
+    ListBucketCache second(this->dir, "7", "q3");
+    this->expectKeyList(second.get(s3Url, &mockS3Interface));
+}
+
+TEST_F(ListBucketCacheTest, CorruptedListingIsListedAgain) {
+    S3Url s3Url("https://s3-us-west-2.amazonaws.com/bucket/prefix");
+    EXPECT_CALL(mockS3Interface, listBucket(_)).Times(2).WillRepeatedly(Return(this->keyList));
+
+    ListBucketCache first(this->dir, "7", "q3");
+    first.get(s3Url, &mockS3Interface);
+    ASSERT_EQ(0, truncate(first.getPath().c_str(), 30));
+
+    ListBucketCache second(this->dir, "7", "q3");
+    this->expectKeyList(second.get(s3Url, &mockS3Interface));
+}
@@ -1,4 +1,6 @@
 #include "s3restful_service.cpp"
+#include <sys/time.h>
+
 #include "gtest/gtest.h"
 
 TEST(S3RESTfulService, GetWithWrongHeader) {
@@ -338,3 +340,91 @@ TEST(S3RESTfulService, GetWithWrongProxyUrl) {
 
     EXPECT_THROW(service.get(url, headers), S3ResolveError);
 }
+
+TEST(S3RESTfulService, GetTwiceReusesConnection) {
+    HTTPHeaders headers;
+    S3RESTfulService service;
+
+    string url = "https://www.bing.com/";
+
+    EXPECT_EQ(RESPONSE_OK, service.get(url, headers).getStatus());
+    EXPECT_EQ(RESPONSE_OK, service.get(url, headers).getStatus());
+
+    EXPECT_EQ((uint64_t)2, service.getRequestCount());
+    EXPECT_EQ((uint64_t)1, service.getConnectionCount());
+}
+
+TEST(S3RESTfulService, FailedRequestIsCounted) {
+    HTTPHeaders headers;
+
+    string url;
+    S3RESTfulService service;
+
+    EXPECT_THROW(service.head(url, headers), S3ConnectionError);
+
+    EXPECT_EQ((uint64_t)1, service.getRequestCount());
+    EXPECT_EQ((uint64_t)0, service.getConnectionCount());
+}
+
+TEST(CURLHandlePool, ReleasedHandleIsReused) {
+    CURLHandlePool pool;
+
+    CURL *curl = pool.acquire();
+    ASSERT_TRUE(curl != NULL);
+    pool.release(curl);
+
+    CURL *reused = pool.acquire();
+    EXPECT_EQ(curl, reused);
+
+    pool.release(reused);
+    EXPECT_EQ((uint64_t)2, pool.getRequestCount());
+}
+
+TEST(CURLHandlePool, DiscardedHandleIsNotReused) {
+    CURLHandlePool pool;
+
+    CURL *failed = pool.acquire();
+    CURL *succeeded = pool.acquire();
+    pool.discard(failed);
+    pool.release(succeeded);
+
+    CURL *reused = pool.acquire();
+    EXPECT_EQ(succeeded, reused);
+
+    CURL *curl = pool.acquire();
+    EXPECT_NE(succeeded, curl);
+
+    pool.release(reused);
+    pool.release(curl);
+    EXPECT_EQ((uint64_t)4, pool.getRequestCount());
+}
+
+/* Run './bin/dummyHTTPServer.py -t Common_Server' before enabling this test */
+TEST(S3RESTfulService, DISABLED_BenchmarkGetFromDummyServer) {
+    const int requests = 10000;
+
+    HTTPHeaders headers;
+    S3RESTfulService service;
+
+    string url = "http://localhost:8553";
+
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+
+    uint64_t bytes = 0;
+    for (int i = 0; i < requests; i++) {
+        Response resp = service.get(url, headers);
+        ASSERT_EQ(RESPONSE_OK, resp.getStatus());
+        bytes += resp.getRawData().size();
+    }
+
+    gettimeofday(&end, NULL);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
+
+    printf("%d requests in %.3f s: %.0f requests/s, %.3f MB/s, %" PRIu64 " connections\n",
+           requests, seconds, requests / seconds, bytes / seconds / (1024 * 1024),
+           service.getConnectionCount());
+
+    EXPECT_EQ((uint64_t)requests, service.getRequestCount());
+    EXPECT_EQ((uint64_t)1, service.getConnectionCount());
+}
@@ -28,6 +28,7 @@
 #include "catalog/namespace.h"
 #include "catalog/pg_appendonly_fn.h"
 #include "catalog/pg_attribute_encoding.h"
+#include "catalog/pg_type.h"
 #include "cdb/cdbaocsam.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbappendonlyblockdirectory.h"
@@ -56,6 +57,8 @@ static AOCSScanDesc aocs_beginscan_internal(Relation relation,
 						Snapshot snapshot,
 						Snapshot appendOnlyMetaDataSnapshot,
 						TupleDesc relationTupleDesc, bool *proj);
+static void get_positioned_column(AOCSScanDesc scan, int i, Datum *d,
+					  bool *null);
 
 /*
  * Open the segment file for a specified column associated with the datum
@@ -362,6 +365,27 @@ open_next_scan_seg(AOCSScanDesc scan)
 												  scan->num_proj_atts,
 												  scan->blockDirectory);
 
+				/* the streams of the late columns start before the first row */
+				if (scan->late_seg_row)
+					MemSet(scan->late_seg_row, 0,
+						   scan->num_proj_atts * sizeof(int64));
+
+				if (scan->num_skip_keys > 0)
+				{
+					AOCSVPInfoEntry *e = getAOCSVPEntry(curSegInfo, scan->proj_atts[0]);
+
+					if (scan->summaries)
+						pfree(scan->summaries);
+					scan->summaries =
+						AppendOnlyBlockDirectory_GetSummaries(scan->aos_rel,
+															  scan->appendOnlyMetaDataSnapshot,
+															  curSegInfo->segno,
+															  scan->proj_atts[0],
+															  e->eof,
+															  &scan->num_summaries);
+					scan->cur_summary = 0;
+				}
+
 				return scan->cur_seg;
 			}
 		}
@@ -501,6 +525,13 @@ aocs_beginscan_internal(Relation relation,
 		if (proj[i])
 			scan->proj_atts[scan->num_proj_atts++] = i;
 	}
+	scan->num_filter_atts = scan->num_proj_atts;
+	scan->late_seg_row = NULL;
+	scan->num_seq_atts = scan->num_proj_atts;
+	scan->num_skip_keys = 0;
+	scan->skip_keys = NULL;
+	scan->summaries = NULL;
+	scan->num_summaries = 0;
 
 	scan->ds = (DatumStreamRead **) palloc0(sizeof(DatumStreamRead *) * nvp);
 
@@ -561,6 +592,21 @@ aocs_endscan(AOCSScanDesc scan)
 
 	pfree(scan->proj_atts);
 	scan->proj_atts = NULL;
+	if (scan->late_seg_row)
+	{
+		pfree(scan->late_seg_row);
+		scan->late_seg_row = NULL;
+	}
+	if (scan->skip_keys)
+	{
+		pfree(scan->skip_keys);
+		scan->skip_keys = NULL;
+	}
+	if (scan->summaries)
+	{
+		pfree(scan->summaries);
+		scan->summaries = NULL;
+	}
 	pfree(scan->ds);
 	scan->ds = NULL;
 
@@ -657,6 +703,254 @@ static void upgrade_datum_fetch(AOCSFetchDesc fetch, int attno, Datum values[],
 					   values, isnull, formatversion);
 }
 
+/*
+ * Set up late materialization of a scan that has not returned any rows yet.
+ *
+ * 'filterproj' marks the columns that the filter of the scan needs. Only
+ * those are read by aocs_getnext(); the caller evaluates the filter on the
+ * returned row and calls aocs_getnext_late() for the rows that pass it, to
+ * read the remaining projected columns. The blocks of those columns that
+ * hold no passing rows are neither read nor decompressed.
+ *
+ * Returns false, and leaves the scan reading all columns for every row, if
+ * no projected column is left to read late.
+ */
+bool
+aocs_set_late_materialization(AOCSScanDesc scan, bool *filterproj)
+{
+	int		   *late_atts;
+	int			num_late_atts = 0;
+	int			num_filter_atts = 0;
+	int			i;
+
+	Assert(scan->cur_seg < 0);
+
+	/* the block directory must see every block */
+	if (scan->blockDirectory)
+		return false;
+
+	late_atts = palloc(scan->num_proj_atts * sizeof(int));
+
+	/* keep the filter columns first in proj_atts */
+	for (i = 0; i < scan->num_proj_atts; i++)
+	{
+		int			attno = scan->proj_atts[i];
+
+		if (filterproj[attno])
+			scan->proj_atts[num_filter_atts++] = attno;
+		else
+			late_atts[num_late_atts++] = attno;
+	}
+
+	for (i = 0; i < num_late_atts; i++)
+		scan->proj_atts[num_filter_atts + i] = late_atts[i];
+	pfree(late_atts);
+
+	if (num_filter_atts == 0 || num_late_atts == 0)
+		return false;
+
+	scan->num_filter_atts = num_filter_atts;
+	scan->num_seq_atts = num_filter_atts;
+	scan->late_seg_row = palloc0(scan->num_proj_atts * sizeof(int64));
+
+	return true;
+}
+
+/*
+ * A scan key that blocks are skipped by, on the int64 representation of the
+ * values of the column.
+ */
+typedef struct AOCSSkipKey
+{
+	StrategyNumber strategy;
+	int64		value;
+} AOCSSkipKey;
+
+static bool
+is_integer_type(Oid typid)
+{
+	return typid == INT2OID || typid == INT4OID || typid == INT8OID;
+}
+
+/*
+ * Can blocks of a column of the given type be skipped by the given key?
+ */
+static bool
+skip_key_is_usable(Oid typid, ScanKey key)
+{
+	if (key->sk_flags & SK_ISNULL)
+		return false;
+
+	if (key->sk_strategy < BTLessStrategyNumber ||
+		key->sk_strategy > BTGreaterStrategyNumber)
+		return false;
+
+	if (!AppendOnlyBlockSummary_TypeIsSupported(typid))
+		return false;
+
+	/* integers of different widths compare by their values */
+	return key->sk_subtype == typid ||
+		(is_integer_type(typid) && is_integer_type(key->sk_subtype));
+}
+
+/*
+ * Set up block skipping of a scan that has not returned any rows yet, after
+ * any late materialization is set up.
+ *
+ * 'keys' are btree strategy keys on the filter columns of the scan, whose
+ * argument is of type sk_subtype; all of them must hold for a row to pass
+ * the filter. The blocks of one filter column whose summaries in the block
+ * directory show that no row satisfies its keys are skipped, along with the
+ * rows they hold in the other columns. The caller still evaluates the whole
+ * filter on the returned rows.
+ *
+ * Returns false if the relation has no block directory, or no key can be
+ * used to skip blocks.
+ */
+bool
+aocs_set_block_skipping(AOCSScanDesc scan, int nkeys, ScanKey keys)
+{
+	int			driver = -1;
+	int			attno;
+	Oid			typid;
+	int			i;
+	int			j;
+
+	Assert(scan->cur_seg < 0);
+
+	/* the block directory must see every block */
+	if (scan->blockDirectory)
+		return false;
+
+	/* the summaries are kept in the block directory */
+	if (!OidIsValid(scan->aos_rel->rd_appendonly->blkdirrelid))
+		return false;
+
+	/* the column of the first usable key drives the scan */
+	for (i = 0; i < nkeys && driver < 0; i++)
+	{
+		for (j = 0; j < scan->num_filter_atts; j++)
+		{
+			attno = scan->proj_atts[j];
+			if (attno == keys[i].sk_attno - 1 &&
+				skip_key_is_usable(scan->relationTupleDesc->attrs[attno]->atttypid,
+								   &keys[i]))
+			{
+				driver = j;
+				break;
+			}
+		}
+	}
+
+	if (driver < 0)
+		return false;
+
+	attno = scan->proj_atts[driver];
+	typid = scan->relationTupleDesc->attrs[attno]->atttypid;
+
+	scan->skip_keys = palloc(nkeys * sizeof(AOCSSkipKey));
+	scan->num_skip_keys = 0;
+	for (i = 0; i < nkeys; i++)
+	{
+		if (keys[i].sk_attno - 1 != attno || !skip_key_is_usable(typid, &keys[i]))
+			continue;
+
+		scan->skip_keys[scan->num_skip_keys].strategy = keys[i].sk_strategy;
+		scan->skip_keys[scan->num_skip_keys].value =
+			AppendOnlyBlockSummary_DatumGetInt64(keys[i].sk_subtype,
+												 keys[i].sk_argument);
+		scan->num_skip_keys++;
+	}
+
+	/* read the driving column row by row, and position the others */
+	scan->proj_atts[driver] = scan->proj_atts[0];
+	scan->proj_atts[0] = attno;
+	scan->num_seq_atts = 1;
+	if (scan->late_seg_row == NULL)
+		scan->late_seg_row = palloc0(scan->num_proj_atts * sizeof(int64));
+
+	return true;
+}
+
+/*
+ * Does the summary of the block at the given offset of the driving column
+ * show that no row of the block satisfies the skip keys?
+ */
+static bool
+block_is_excluded(AOCSScanDesc scan, int64 fileOffset)
+{
+	AppendOnlyBlockSummary *summary;
+	int			i;
+
+	/* the blocks are read, and the summaries kept, in file offset order */
+	while (scan->cur_summary < scan->num_summaries &&
+		   scan->summaries[scan->cur_summary].fileOffset < fileOffset)
+		scan->cur_summary++;
+
+	if (scan->cur_summary >= scan->num_summaries ||
+		scan->summaries[scan->cur_summary].fileOffset != fileOffset)
+		return false;
+
+	summary = &scan->summaries[scan->cur_summary];
+	for (i = 0; i < scan->num_skip_keys; i++)
+	{
+		int64		value = scan->skip_keys[i].value;
+
+		switch (scan->skip_keys[i].strategy)
+		{
+			case BTLessStrategyNumber:
+				if (summary->minValue >= value)
+					return true;
+				break;
+			case BTLessEqualStrategyNumber:
+				if (summary->minValue > value)
+					return true;
+				break;
+			case BTEqualStrategyNumber:
+				if (value < summary->minValue || value > summary->maxValue)
+					return true;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				if (summary->maxValue < value)
+					return true;
+				break;
+			case BTGreaterStrategyNumber:
+				if (summary->maxValue <= value)
+					return true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Read the next block of the column that drives block skipping, skipping
+ * over the blocks that block_is_excluded(). The rows of the skipped blocks
+ * count as read, so that the other columns skip them, too.
+ */
+static int
+read_next_unexcluded_block(AOCSScanDesc scan, DatumStreamRead *ds)
+{
+	while (datumstreamread_block_header(ds))
+	{
+		/* the summarized blocks all have a row count we can rely on */
+		if (ds->getBlockInfo.firstRow < 0 ||
+			!block_is_excluded(scan, ds->blockFileOffset))
+		{
+			datumstreamread_block_content(ds);
+			return 0;
+		}
+
+		scan->cur_seg_row += ds->blockRowCount;
+		datumstreamread_block_skip_content(ds);
+	}
+
+	return -1;
+}
+
 bool
 aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 {
@@ -697,7 +991,7 @@ ReadNext:
 		curseginfo = scan->seginfo[scan->cur_seg];
 
 		/* Read from cur_seg */
-		for (i = 0; i < scan->num_proj_atts; i++)
+		for (i = 0; i < scan->num_seq_atts; i++)
 		{
 			int			attno = scan->proj_atts[i];
 
@@ -705,7 +999,10 @@ ReadNext:
 			Assert(err >= 0);
 			if (err == 0)
 			{
-				err = datumstreamread_block(scan->ds[attno], scan->blockDirectory, attno);
+				if (scan->num_skip_keys > 0)
+					err = read_next_unexcluded_block(scan, scan->ds[attno]);
+				else
+					err = datumstreamread_block(scan->ds[attno], scan->blockDirectory, attno);
 				if (err < 0)
 				{
 					/*
@@ -760,6 +1057,14 @@ ReadNext:
 		}
 		scan->cdb_fake_ctid = *((ItemPointer) &aoTupleId);
 
+		/* the rest of the filter columns, for the visible rows only */
+		for (i = scan->num_seq_atts; i < scan->num_filter_atts; i++)
+			get_positioned_column(scan, i, d, null);
+
+		/* the late columns are filled in by aocs_getnext_late() */
+		for (i = scan->num_filter_atts; i < scan->num_proj_atts; i++)
+			null[scan->proj_atts[i]] = true;
+
 		TupSetVirtualTupleNValid(slot, ncol);
 		slot_set_ctid(slot, &(scan->cdb_fake_ctid));
 		return true;
@@ -769,6 +1074,80 @@ ReadNext:
 	return false;
 }
 
+/*
+ * Position the stream of a column that is not read row by row at the
+ * current row of the scan, skipping over the rows in between without
+ * reading them.
+ */
+static void
+position_column(AOCSScanDesc scan, int i)
+{
+	DatumStreamRead *ds = scan->ds[scan->proj_atts[i]];
+	int64		skipRows = scan->cur_seg_row - scan->late_seg_row[i] - 1;
+
+	Assert(skipRows >= 0);
+
+	while (true)
+	{
+		/* pass over the rows left in the current block */
+		while (datumstreamread_advance(ds) > 0)
+		{
+			if (skipRows == 0)
+			{
+				scan->late_seg_row[i] = scan->cur_seg_row;
+				return;
+			}
+			skipRows--;
+		}
+
+		if (datumstreamread_block_skip(ds, &skipRows) < 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_INTERNAL_ERROR),
+					 errmsg("unexpected end of column %d of segment file %d of append-only columnar relation \"%s\"",
+							scan->proj_atts[i] + 1,
+							scan->seginfo[scan->cur_seg]->segno,
+							RelationGetRelationName(scan->aos_rel))));
+	}
+}
+
+/*
+ * Read the value of the column at position i of proj_atts in the current
+ * row of the scan.
+ */
+static void
+get_positioned_column(AOCSScanDesc scan, int i, Datum *d, bool *null)
+{
+	AOCSFileSegInfo *curseginfo = scan->seginfo[scan->cur_seg];
+	int			attno = scan->proj_atts[i];
+
+	position_column(scan, i);
+
+	datumstreamread_get(scan->ds[attno], &d[attno], &null[attno]);
+
+	if (curseginfo->formatversion < AORelationVersion_GetLatest())
+	{
+		upgrade_datum_scan(scan, attno, d, null,
+						   curseginfo->formatversion);
+	}
+}
+
+/*
+ * Read the late columns of the row last returned by aocs_getnext(), see
+ * aocs_set_late_materialization().
+ */
+void
+aocs_getnext_late(AOCSScanDesc scan, TupleTableSlot *slot)
+{
+	Datum	   *d = slot_get_values(slot);
+	bool	   *null = slot_get_isnull(slot);
+	int			i;
+
+	Assert(scan->cur_seg >= 0);
+
+	for (i = scan->num_filter_atts; i < scan->num_proj_atts; i++)
+		get_positioned_column(scan, i, d, null);
+}
+
 
 /* Open next file segment for write.  See SetCurrentFileSegForWrite */
 /* XXX Right now, we put each column to different files */
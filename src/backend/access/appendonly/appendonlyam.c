@@ -1278,7 +1278,8 @@ getNextBlock(AppendOnlyScanDesc scan)
 											 scan->executorReadBlock.blockFirstRowNum,
 											 scan->executorReadBlock.headerOffsetInFile,
 											 scan->executorReadBlock.rowCount,
-											 false);
+											 false,
+											 NULL);
 	}
 
 	AppendOnlyExecutorReadBlock_GetContents(
@@ -1527,7 +1528,8 @@ finishWriteBlock(AppendOnlyInsertDesc aoInsertDesc)
 										 aoInsertDesc->blockFirstRowNum,
 										 AppendOnlyStorageWrite_LogicalBlockStartOffset(&aoInsertDesc->storageWrite),
 										 itemCount,
-										 false);
+										 false,
+										 NULL);
 
 	Assert(aoInsertDesc->nonCompressedData == NULL);
 	Assert(!AppendOnlyStorageWrite_IsBufferAllocated(&aoInsertDesc->storageWrite));
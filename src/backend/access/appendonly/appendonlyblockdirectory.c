@@ -24,6 +24,9 @@
 #include "utils/memutils.h"
 #include "utils/guc.h"
 #include "utils/fmgroids.h"
+#include "utils/date.h"
+#include "utils/timestamp.h"
+#include "catalog/pg_type.h"
 #include "cdb/cdbappendonlyam.h"
 
 int			gp_blockdirectory_entry_min_range = 0;
@@ -36,6 +39,12 @@ minipage_size(uint32 nEntry)
 		sizeof(MinipageEntry) * nEntry;
 }
 
+static inline uint32
+minipage_summary_size(uint32 nEntry)
+{
+	return sizeof(MinipageEntrySummary) * nEntry;
+}
+
 static void load_last_minipage(
 				   AppendOnlyBlockDirectory *blockDirectory,
 				   int64 lastSequence,
@@ -61,7 +70,8 @@ static bool insert_new_entry(AppendOnlyBlockDirectory *blockDirectory,
 				 int64 firstRowNum,
 				 int64 fileOffset,
 				 int64 rowCount,
-				 bool addColAction);
+				 bool addColAction,
+				 const MinipageEntrySummary *summary);
 
 void
 AppendOnlyBlockDirectoryEntry_GetBeginRange(
@@ -159,6 +169,8 @@ init_internal(AppendOnlyBlockDirectory *blockDirectory, bool *proj)
 
 		minipageInfo->minipage =
 			palloc0(minipage_size(NUM_MINIPAGE_ENTRIES));
+		minipageInfo->summaries =
+			palloc0(minipage_summary_size(NUM_MINIPAGE_ENTRIES));
 		minipageInfo->numMinipageEntries = 0;
 	}
 
@@ -667,6 +679,10 @@ AppendOnlyBlockDirectory_GetEntry(
  * If the block directory for the appendonly relation does not exist,
  * this function simply returns.
  *
+ * summary is the summary of the values in the new entry's rows, or NULL if
+ * they are not summarized. When the new entry is merged into the latest
+ * existing entry, so is its summary.
+ *
  * If rowCount is 0, simple return false.
  */
 bool
@@ -676,10 +692,11 @@ AppendOnlyBlockDirectory_InsertEntry(
 									 int64 firstRowNum,
 									 int64 fileOffset,
 									 int64 rowCount,
-									 bool addColAction)
+									 bool addColAction,
+									 const MinipageEntrySummary *summary)
 {
 	return insert_new_entry(blockDirectory, columnGroupNo, firstRowNum,
-							fileOffset, rowCount, addColAction);
+							fileOffset, rowCount, addColAction, summary);
 }
 
 /*
@@ -694,7 +711,8 @@ insert_new_entry(
 				 int64 firstRowNum,
 				 int64 fileOffset,
 				 int64 rowCount,
-				 bool addColAction)
+				 bool addColAction,
+				 const MinipageEntrySummary *summary)
 {
 	MinipageEntry *entry = NULL;
 	MinipagePerColumnGroup *minipageInfo;
@@ -739,7 +757,22 @@ insert_new_entry(
 
 		if (gp_blockdirectory_entry_min_range > 0 &&
 			fileOffset - entry->fileOffset < gp_blockdirectory_entry_min_range)
+		{
+			/* The latest entry now covers the new rows, too. */
+			MinipageEntrySummary *lastSummary =
+			&minipageInfo->summaries[lastEntryNo];
+
+			if (summary == NULL || !summary->isValid)
+				lastSummary->isValid = false;
+			else if (lastSummary->isValid)
+			{
+				lastSummary->minValue = Min(lastSummary->minValue,
+											summary->minValue);
+				lastSummary->maxValue = Max(lastSummary->maxValue,
+											summary->maxValue);
+			}
 			return true;
+		}
 
 		/* Update the rowCount in the latest entry */
 		Assert(entry->rowCount <= firstRowNum - entry->firstRowNum);
@@ -770,6 +803,8 @@ insert_new_entry(
 		 */
 		MemSet(minipageInfo->minipage->entry, 0,
 			   minipageInfo->numMinipageEntries * sizeof(MinipageEntry));
+		MemSet(minipageInfo->summaries, 0,
+			   minipage_summary_size(minipageInfo->numMinipageEntries));
 		minipageInfo->numMinipageEntries = 0;
 	}
 
@@ -780,6 +815,12 @@ insert_new_entry(
 	entry->fileOffset = fileOffset;
 	entry->rowCount = rowCount;
 
+	if (summary != NULL)
+		memcpy(&minipageInfo->summaries[minipageInfo->numMinipageEntries],
+			   summary, sizeof(MinipageEntrySummary));
+	else
+		minipageInfo->summaries[minipageInfo->numMinipageEntries].isValid = false;
+
 	minipageInfo->numMinipageEntries++;
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -904,10 +945,29 @@ init_scankeys(TupleDesc tupleDesc,
 	}
 }
 
+/*
+ * check_minipage_version
+ *
+ * Error out on a minipage written in a layout this server does not know.
+ */
+static inline void
+check_minipage_version(Minipage *minipage)
+{
+	if (minipage->version < 0 || minipage->version > MINIPAGE_VERSION_LATEST)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("unsupported append-only block directory minipage version %d",
+						minipage->version),
+				 errdetail("The latest supported version is %d.",
+						   MINIPAGE_VERSION_LATEST)));
+}
+
 /*
  * copy_out_minipage
  *
- * Copy out the minipage content from a deformed tuple.
+ * Copy out the minipage content from a deformed tuple. The summaries of the
+ * entries are copied out into their own array; the entries of a minipage
+ * written before summaries existed are not summarized.
  */
 static inline void
 copy_out_minipage(MinipagePerColumnGroup *minipageInfo,
@@ -916,21 +976,38 @@ copy_out_minipage(MinipagePerColumnGroup *minipageInfo,
 {
 	struct varlena *value;
 	struct varlena *detoast_value;
+	Minipage   *minipage;
+	uint32		nEntry;
 
 	Assert(!minipage_isnull);
 
 	value = (struct varlena *)
 		DatumGetPointer(minipage_value);
 	detoast_value = pg_detoast_datum(value);
-	Assert(VARSIZE(detoast_value) <= minipage_size(NUM_MINIPAGE_ENTRIES));
+	Assert(VARSIZE(detoast_value) <= minipage_size(NUM_MINIPAGE_ENTRIES) +
+		   minipage_summary_size(NUM_MINIPAGE_ENTRIES));
+
+	minipage = (Minipage *) detoast_value;
+	check_minipage_version(minipage);
+	nEntry = minipage->nEntry;
+	Assert(nEntry <= NUM_MINIPAGE_ENTRIES);
+
+	memcpy(minipageInfo->minipage, detoast_value, minipage_size(nEntry));
+	if (minipage->version >= MINIPAGE_VERSION_SUMMARY)
+	{
+		Assert(VARSIZE(detoast_value) ==
+			   minipage_size(nEntry) + minipage_summary_size(nEntry));
+		memcpy(minipageInfo->summaries,
+			   ((char *) detoast_value) + minipage_size(nEntry),
+			   minipage_summary_size(nEntry));
+	}
+	else
+		MemSet(minipageInfo->summaries, 0, minipage_summary_size(nEntry));
 
-	memcpy(minipageInfo->minipage, detoast_value, VARSIZE(detoast_value));
 	if (detoast_value != value)
 		pfree(detoast_value);
 
-	Assert(minipageInfo->minipage->nEntry <= NUM_MINIPAGE_ENTRIES);
-
-	minipageInfo->numMinipageEntries = minipageInfo->minipage->nEntry;
+	minipageInfo->numMinipageEntries = nEntry;
 }
 
 
@@ -1147,6 +1224,8 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 	bool	   *nulls = blockDirectory->nulls;
 	Relation	blkdirRel = blockDirectory->blkdirRel;
 	TupleDesc	heapTupleDesc = RelationGetDescr(blkdirRel);
+	Minipage   *minipage;
+	uint32		entryNo;
 
 	Assert(minipageInfo->numMinipageEntries > 0);
 
@@ -1166,11 +1245,39 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 		Int64GetDatum(minipageInfo->minipage->entry[0].firstRowNum);
 	nulls[Anum_pg_aoblkdir_firstrownum - 1] = false;
 
-	SET_VARSIZE(minipageInfo->minipage,
-				minipage_size(minipageInfo->numMinipageEntries));
-	minipageInfo->minipage->nEntry = minipageInfo->numMinipageEntries;
-	values[Anum_pg_aoblkdir_minipage - 1] =
-		PointerGetDatum(minipageInfo->minipage);
+	minipage = minipageInfo->minipage;
+	minipage->nEntry = minipageInfo->numMinipageEntries;
+	minipage->version = 0;
+	SET_VARSIZE(minipage, minipage_size(minipage->nEntry));
+
+	/*
+	 * If summaries are enabled and any entry is summarized, append the
+	 * summaries after the entries. Otherwise, keep the layout readable by
+	 * older versions, which drops the summaries of a minipage loaded with
+	 * them.
+	 */
+	entryNo = minipage->nEntry;
+	if (gp_enable_aocs_block_summaries)
+	{
+		for (entryNo = 0; entryNo < minipage->nEntry; entryNo++)
+		{
+			if (minipageInfo->summaries[entryNo].isValid)
+				break;
+		}
+	}
+	if (entryNo < minipage->nEntry)
+	{
+		uint32		size = minipage_size(minipage->nEntry);
+
+		minipage = palloc(size + minipage_summary_size(minipage->nEntry));
+		memcpy(minipage, minipageInfo->minipage, size);
+		memcpy(((char *) minipage) + size, minipageInfo->summaries,
+			   minipage_summary_size(minipage->nEntry));
+		minipage->version = MINIPAGE_VERSION_SUMMARY;
+		SET_VARSIZE(minipage, size + minipage_summary_size(minipage->nEntry));
+	}
+
+	values[Anum_pg_aoblkdir_minipage - 1] = PointerGetDatum(minipage);
 	nulls[Anum_pg_aoblkdir_minipage - 1] = false;
 
 	tuple = heaptuple_form_to(heapTupleDesc,
@@ -1210,6 +1317,8 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 	}
 
 	heap_freetuple(tuple);
+	if (minipage != minipageInfo->minipage)
+		pfree(minipage);
 
 	MemoryContextSwitchTo(oldcxt);
 }
@@ -1322,3 +1431,205 @@ AppendOnlyBlockDirectory_End_addCol(
 
 	MemoryContextDelete(blockDirectory->memoryContext);
 }
+
+/*
+ * AppendOnlyBlockDirectory_GetSummaries
+ *
+ * Return the summaries of the blocks of the given column group in the given
+ * segment file, in file offset order, for a scan to skip blocks with. Only
+ * the blocks below the logical eof of the column group, that have a summary
+ * of their own, are returned. Returns NULL if the relation has no block
+ * directory.
+ */
+AppendOnlyBlockSummary *
+AppendOnlyBlockDirectory_GetSummaries(Relation aoRel,
+									  Snapshot appendOnlyMetaDataSnapshot,
+									  int segno,
+									  int columnGroupNo,
+									  int64 eof,
+									  int *numSummaries)
+{
+	Relation	blkdirRel;
+	Relation	blkdirIdx;
+	TupleDesc	tupleDesc;
+	ScanKeyData scanKeys[2];
+	IndexScanDesc indexScan;
+	HeapTuple	tuple;
+	AppendOnlyBlockSummary *summaries = NULL;
+	int			maxSummaries = 0;
+
+	*numSummaries = 0;
+
+	if (!OidIsValid(aoRel->rd_appendonly->blkdirrelid) ||
+		!OidIsValid(aoRel->rd_appendonly->blkdiridxid))
+		return NULL;
+
+	blkdirRel = heap_open(aoRel->rd_appendonly->blkdirrelid, AccessShareLock);
+	blkdirIdx = index_open(aoRel->rd_appendonly->blkdiridxid, AccessShareLock);
+	tupleDesc = RelationGetDescr(blkdirRel);
+
+	ScanKeyInit(&scanKeys[0],
+				1,				/* segno */
+				BTEqualStrategyNumber,
+				F_INT4EQ,
+				Int32GetDatum(segno));
+	ScanKeyInit(&scanKeys[1],
+				2,				/* columngroupno */
+				BTEqualStrategyNumber,
+				F_INT4EQ,
+				Int32GetDatum(columnGroupNo));
+
+	indexScan = index_beginscan(blkdirRel, blkdirIdx,
+								appendOnlyMetaDataSnapshot, 2, 0);
+	index_rescan(indexScan, scanKeys, 2, NULL, 0);
+
+	while ((tuple = index_getnext(indexScan, ForwardScanDirection)) != NULL)
+	{
+		struct varlena *value;
+		Minipage   *minipage;
+		char	   *summaryArray;
+		bool		isnull;
+		uint32		entryNo;
+
+		value = (struct varlena *)
+			DatumGetPointer(heap_getattr(tuple, Anum_pg_aoblkdir_minipage,
+										 tupleDesc, &isnull));
+		Assert(!isnull);
+		minipage = (Minipage *) pg_detoast_datum(value);
+		check_minipage_version(minipage);
+
+		if (minipage->version < MINIPAGE_VERSION_SUMMARY)
+		{
+			if ((struct varlena *) minipage != value)
+				pfree(minipage);
+			continue;
+		}
+
+		/* The varlena may not be aligned, copy the entries out */
+		summaryArray = ((char *) minipage) + minipage_size(minipage->nEntry);
+		for (entryNo = 0; entryNo < minipage->nEntry; entryNo++)
+		{
+			MinipageEntry entry;
+			MinipageEntrySummary summary;
+
+			memcpy(&entry, &minipage->entry[entryNo], sizeof(MinipageEntry));
+			memcpy(&summary,
+				   summaryArray + entryNo * sizeof(MinipageEntrySummary),
+				   sizeof(MinipageEntrySummary));
+
+			if (!summary.isValid || entry.fileOffset >= eof)
+				continue;
+
+			if (*numSummaries >= maxSummaries)
+			{
+				maxSummaries = Max(maxSummaries * 2, NUM_MINIPAGE_ENTRIES);
+				if (summaries == NULL)
+					summaries = palloc(maxSummaries * sizeof(AppendOnlyBlockSummary));
+				else
+					summaries = repalloc(summaries,
+										 maxSummaries * sizeof(AppendOnlyBlockSummary));
+			}
+
+			summaries[*numSummaries].fileOffset = entry.fileOffset;
+			summaries[*numSummaries].minValue = summary.minValue;
+			summaries[*numSummaries].maxValue = summary.maxValue;
+			(*numSummaries)++;
+		}
+
+		if ((struct varlena *) minipage != value)
+			pfree(minipage);
+	}
+
+	index_endscan(indexScan);
+	index_close(blkdirIdx, AccessShareLock);
+	heap_close(blkdirRel, AccessShareLock);
+
+	return summaries;
+}
+
+/*
+ * AppendOnlyBlockSummary_TypeIsSupported
+ *
+ * Are the values of the given type summarized in the block directory? The
+ * values of these types order like their int64 representation.
+ */
+bool
+AppendOnlyBlockSummary_TypeIsSupported(Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case DATEOID:
+			return true;
+#ifdef HAVE_INT64_TIMESTAMP
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+/*
+ * AppendOnlyBlockSummary_DatumGetInt64
+ *
+ * The int64 representation of a value of a supported type.
+ */
+int64
+AppendOnlyBlockSummary_DatumGetInt64(Oid typid, Datum value)
+{
+	switch (typid)
+	{
+		case INT2OID:
+			return (int64) DatumGetInt16(value);
+		case INT4OID:
+			return (int64) DatumGetInt32(value);
+		case INT8OID:
+			return DatumGetInt64(value);
+		case DATEOID:
+			return (int64) DatumGetDateADT(value);
+#ifdef HAVE_INT64_TIMESTAMP
+		case TIMESTAMPOID:
+			return DatumGetTimestamp(value);
+		case TIMESTAMPTZOID:
+			return DatumGetTimestampTz(value);
+#endif
+		default:
+			elog(ERROR, "type %u is not summarized in the block directory",
+				 typid);
+			return 0;			/* keep compiler quiet */
+	}
+}
+
+/*
+ * AppendOnlyBlockSummary_Reset
+ *
+ * Reset the summary to cover no values.
+ */
+void
+AppendOnlyBlockSummary_Reset(MinipageEntrySummary *summary)
+{
+	summary->minValue = PG_INT64_MAX;
+	summary->maxValue = PG_INT64_MIN;
+	summary->isValid = true;
+}
+
+/*
+ * AppendOnlyBlockSummary_AddValue
+ *
+ * Widen the summary to cover the given non-null value.
+ */
+void
+AppendOnlyBlockSummary_AddValue(MinipageEntrySummary *summary,
+								Oid typid, Datum value)
+{
+	int64		v = AppendOnlyBlockSummary_DatumGetInt64(typid, value);
+
+	if (v < summary->minValue)
+		summary->minValue = v;
+	if (v > summary->maxValue)
+		summary->maxValue = v;
+}
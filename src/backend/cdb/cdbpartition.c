@@ -4455,23 +4455,9 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 		rs->ltfuncs_direct = palloc0(sizeof(FmgrInfo) * natts);
 		rs->lefuncs_inverse = palloc0(sizeof(FmgrInfo) * natts);
 		rs->ltfuncs_inverse = palloc0(sizeof(FmgrInfo) * natts);
-
-		/*
-		 * Unrolling the rules into an array currently works for the top level
-		 * partition only
-		 */
-		if (partnode->part->parlevel == 0)
-		{
-			int			i = 0;
-			ListCell   *lc;
-
-			rs->rules = palloc(sizeof(PartitionRule *) * list_length(rules));
-
-			foreach(lc, rules)
-				rs->rules[i++] = (PartitionRule *) lfirst(lc);
-		}
-		else
-			rs->rules = NULL;
+		rs->rulesnode = NULL;
+		rs->maxrules = 0;
+		rs->rules = NULL;
 	}
 
 	/*
@@ -4489,6 +4475,30 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 	if (accessMethods && accessMethods->part_cxt)
 		oldcxt = MemoryContextSwitchTo(accessMethods->part_cxt);
 
+	/*
+	 * Unroll the rules into an array, so that the searches below don't walk
+	 * the list. The state is shared by all the PartitionNodes of a level, so
+	 * the array is refilled when we're called for a different one.
+	 */
+	if (rs->rulesnode != partnode)
+	{
+		int			i = 0;
+		ListCell   *lc;
+
+		if (list_length(rules) > rs->maxrules)
+		{
+			if (rs->rules)
+				pfree(rs->rules);
+			rs->maxrules = list_length(rules);
+			rs->rules = palloc(sizeof(PartitionRule *) * rs->maxrules);
+		}
+
+		foreach(lc, rules)
+			rs->rules[i++] = (PartitionRule *) lfirst(lc);
+
+		rs->rulesnode = partnode;
+	}
+
 	*foundOid = InvalidOid;
 
 	/*
@@ -4519,10 +4529,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 
 		mid = low + (high - low) / 2;
 
-		if (rs->rules)
-			rule = rs->rules[mid];
-		else
-			rule = (PartitionRule *) list_nth(rules, mid);
+		rule = rs->rules[mid];
 
 		if (isnull[attno - 1])
 		{
@@ -4583,7 +4590,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 				Oid			dTypeOid = tupdesc->attrs[attno - 1]->atttypid;
 
 				if (j != mid)
-					rule = (PartitionRule *) list_nth(rules, j);
+					rule = rs->rules[j];
 
 				if (isnull[attno - 1])
 				{
@@ -4636,7 +4643,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 				int			ret;
 				Oid			dTypeOid = tupdesc->attrs[attno - 1]->atttypid;
 
-				rule = (PartitionRule *) list_nth(rules, j);
+				rule = rs->rules[j];
 
 				if (isnull[attno - 1])
 				{
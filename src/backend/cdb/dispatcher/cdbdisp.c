@@ -350,6 +350,16 @@ cdbdisp_makeDispatchParams(CdbDispatcherState *ds,
 	MemoryContextSwitchTo(oldContext);
 }
 
+void
+cdbdisp_setDispatchQueryText(CdbDispatcherState *ds,
+							 char *queryText,
+							 int queryTextLen)
+{
+	Assert(ds->dispatchParams != NULL);
+
+	(pDispatchFuncs->setDispatchQueryText) (ds, queryText, queryTextLen);
+}
+
 /*
  * Free memory in CdbDispatcherState
  *
@@ -97,6 +97,8 @@ typedef struct CdbDispatchCmdAsync
 
 static void *cdbdisp_makeDispatchParams_async(int maxSlices, int largestGangSize, char *queryText, int len);
 
+static void cdbdisp_setDispatchQueryText_async(struct CdbDispatcherState *ds, char *queryText, int len);
+
 static bool cdbdisp_checkAckMessage_async(struct CdbDispatcherState *ds, const char *message,
 									int timeout_sec);
 
@@ -116,6 +118,7 @@ DispatcherInternalFuncs DispatcherAsyncFuncs =
 	cdbdisp_checkForCancel_async,
 	cdbdisp_getWaitSocketFd_async,
 	cdbdisp_makeDispatchParams_async,
+	cdbdisp_setDispatchQueryText_async,
 	cdbdisp_checkAckMessage_async,
 	cdbdisp_checkDispatchResult_async,
 	cdbdisp_dispatchToGang_async,
@@ -429,6 +432,21 @@ cdbdisp_makeDispatchParams_async(int maxSlices, int largestGangSize, char *query
 	return (void *) pParms;
 }
 
+/*
+ * Replace the text dispatched to the gangs that are dispatched from now on.
+ *
+ * The text is sent with PQsendGpQuery_shared(), which doesn't copy it, so it
+ * must be allocated in a context that outlives the dispatch.
+ */
+static void
+cdbdisp_setDispatchQueryText_async(struct CdbDispatcherState *ds, char *queryText, int len)
+{
+	CdbDispatchCmdAsync *pParms = (CdbDispatchCmdAsync *) ds->dispatchParams;
+
+	pParms->query_text = queryText;
+	pParms->query_text_len = len;
+}
+
 /*
  * Receive and process results from all running QEs.
  * timeout_sec: the second that the dispatcher waits for the ack messages at most.
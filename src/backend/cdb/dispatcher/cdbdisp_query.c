@@ -21,6 +21,7 @@
 #include "libpq-int.h"
 #include "cdb/cdbconn.h"
 #include "cdb/cdbgang.h"
+#include "cdb/cdbllize.h"
 #include "cdb/cdbutil.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbmutate.h"
@@ -28,6 +29,8 @@
 #include "cdb/tupleremap.h"
 #include "catalog/namespace.h" /* for GetTempNamespaceState() */
 #include "nodes/execnodes.h"
+#include "nodes/makefuncs.h"
+#include "optimizer/walkers.h"
 #include "tcop/tcopprot.h"
 #include "utils/datum.h"
 #include "utils/guc.h"
@@ -105,7 +108,12 @@ static int fillSliceVector(SliceTable *sliceTable,
 static char *buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 				   int *finalLen);
 
-static DispatchCommandQueryParms *cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc, bool planRequiresTxn);
+static DispatchCommandQueryParms *cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
+							bool planRequiresTxn, bool serializePlan);
+static void checkPlanSize(int sliceIndex, int splan_len_uncompressed);
+static bool useSlicePlanDispatch(QueryDesc *queryDesc);
+static char *serializeSlicePlan(PlannedStmt *stmt, SliceTable *sliceTbl, int sliceIndex,
+				   int *splan_len, int *splan_len_uncompressed);
 static DispatchCommandQueryParms *cdbdisp_buildUtilityQueryParms(struct Node *stmt, int flags, List *oid_assignments);
 static DispatchCommandQueryParms *cdbdisp_buildCommandQueryParms(const char *strCommand, int flags);
 
@@ -584,9 +592,16 @@ cdbdisp_buildUtilityQueryParms(struct Node *stmt,
 	return pQueryParms;
 }
 
+/*
+ * Build the parameters for dispatching a plan.
+ *
+ * If serializePlan is false, the plan tree is left out, and the caller is
+ * expected to fill in serializedPlantree for each slice it dispatches.
+ */
 static DispatchCommandQueryParms *
 cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
-							bool planRequiresTxn)
+							bool planRequiresTxn,
+							bool serializePlan)
 {
 	char	   *splan,
 			   *sddesc,
@@ -616,25 +631,20 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 	 * (corresponding to an initPlan or the main plan), so the parameters are
 	 * fixed and we can include them in the prefix.
 	 */
-	splan = serializeNode((Node *) queryDesc->plannedstmt, &splan_len, &splan_len_uncompressed);
-
-	uint64		plan_size_in_kb = ((uint64) splan_len_uncompressed) / (uint64) 1024;
+	if (serializePlan)
+	{
+		splan = serializeNode((Node *) queryDesc->plannedstmt, &splan_len, &splan_len_uncompressed);
 
-	elog(((gp_log_gang >= GPVARS_VERBOSITY_TERSE) ? LOG : DEBUG1),
-		 "Query plan size to dispatch: " UINT64_FORMAT "KB", plan_size_in_kb);
+		checkPlanSize(-1, splan_len_uncompressed);
 
-	if (0 < gp_max_plan_size && plan_size_in_kb > gp_max_plan_size)
+		Assert(splan != NULL && splan_len > 0 && splan_len_uncompressed > 0);
+	}
+	else
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_STATEMENT_TOO_COMPLEX),
-				 (errmsg("Query plan size limit exceeded, current size: "
-						 UINT64_FORMAT "KB, max allowed size: %dKB",
-						 plan_size_in_kb, gp_max_plan_size),
-				  errhint("Size controlled by gp_max_plan_size"))));
+		splan = NULL;
+		splan_len = 0;
 	}
 
-	Assert(splan != NULL && splan_len > 0 && splan_len_uncompressed > 0);
-
 	if (queryDesc->params != NULL && queryDesc->params->numParams > 0)
 	{
 		sparams = serializeParamListInfo(queryDesc->params, &sparams_len);
@@ -674,6 +684,398 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 	return pQueryParms;
 }
 
+/*
+ * Log the size of a serialized plan, and error out if it exceeds
+ * gp_max_plan_size. sliceIndex is -1 for the plan of the whole statement.
+ */
+static void
+checkPlanSize(int sliceIndex, int splan_len_uncompressed)
+{
+	uint64		plan_size_in_kb = ((uint64) splan_len_uncompressed) / (uint64) 1024;
+
+	if (sliceIndex < 0)
+		elog(((gp_log_gang >= GPVARS_VERBOSITY_TERSE) ? LOG : DEBUG1),
+			 "Query plan size to dispatch: " UINT64_FORMAT "KB", plan_size_in_kb);
+	else
+		elog(((gp_log_gang >= GPVARS_VERBOSITY_TERSE) ? LOG : DEBUG1),
+			 "Query plan size to dispatch for slice %d: " UINT64_FORMAT "KB",
+			 sliceIndex, plan_size_in_kb);
+
+	if (0 < gp_max_plan_size && plan_size_in_kb > gp_max_plan_size)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_STATEMENT_TOO_COMPLEX),
+				 (errmsg("Query plan size limit exceeded, current size: "
+						 UINT64_FORMAT "KB, max allowed size: %dKB",
+						 plan_size_in_kb, gp_max_plan_size),
+				  errhint("Size controlled by gp_max_plan_size"))));
+	}
+}
+
+/*
+ * Should each gang get only the part of the plan its slice executes?
+ *
+ * That's only safe when the QEs prune the plan themselves
+ * (execute_pruned_plan), because otherwise they would initialize the
+ * executor state of the whole plan tree. Plans without motions consist of
+ * a single slice, so there's nothing to gain for them.
+ */
+static bool
+useSlicePlanDispatch(QueryDesc *queryDesc)
+{
+	return gp_enable_slice_plan_dispatch &&
+		execute_pruned_plan &&
+		queryDesc->plannedstmt->nMotionNodes > 0;
+}
+
+/*
+ * Context for the walkers that cut a plan down to the part executed by
+ * one slice.
+ */
+typedef struct SlicePlanContext
+{
+	plan_tree_base_prefix base; /* Required prefix for plan_tree_walker/mutator */
+
+	/* motions on the path from the slice to its root; those are kept */
+	Bitmapset  *keepMotions;
+
+	/*
+	 * Receiving motions whose subtree was replaced, with their original
+	 * subtrees and the placeholders that replaced them.
+	 */
+	List	   *prunedMotions;
+	List	   *prunedSubtrees;
+	List	   *placeholders;
+
+	/* initPlans found in the subtree being pruned */
+	List	   *initPlans;
+
+	/* plan_ids of the subplans, and range table indexes, still referenced */
+	Bitmapset  *subplanIds;
+	Bitmapset  *rtIndexes;
+	bool		hasPartitionSelector;
+} SlicePlanContext;
+
+/*
+ * Collect the initPlans of a subtree that is about to be pruned.
+ *
+ * The QE looks up the values of initPlan params through the SubPlan nodes in
+ * initPlan lists, so those must survive the pruning. We don't look into
+ * SubPlans, their initPlans belong to subplans that are pruned with the
+ * subtree.
+ */
+static bool
+collect_initplans_walker(Node *node, SlicePlanContext *context)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, SubPlan))
+		return false;
+
+	if (is_plan_node(node))
+	{
+		Plan	   *plan = (Plan *) node;
+
+		if (plan->initPlan != NIL)
+			context->initPlans = list_concat(context->initPlans,
+											 list_copy(plan->initPlan));
+	}
+
+	return plan_tree_walker(node, collect_initplans_walker, context);
+}
+
+/*
+ * Replace the subtree below every receiving motion that doesn't belong to
+ * the slice with a placeholder Result.
+ *
+ * With execute_pruned_plan, the QE never initializes the subtree below a
+ * receiving motion, so all it needs is the motion node itself. The plan is
+ * modified in place; the caller must restore it with restore_pruned_motions().
+ */
+static bool
+prune_alien_slices_walker(Node *node, SlicePlanContext *context)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, Motion))
+	{
+		Motion	   *motion = (Motion *) node;
+		Result	   *placeholder;
+
+		if (!bms_is_member(motion->motionID, context->keepMotions))
+		{
+			/* a subplan can be reached more than once */
+			if (list_member_ptr(context->prunedMotions, motion))
+				return false;
+
+			context->initPlans = NIL;
+			collect_initplans_walker((Node *) outerPlan(motion), context);
+
+			placeholder = makeNode(Result);
+			placeholder->plan.initPlan = context->initPlans;
+			context->initPlans = NIL;
+
+			context->prunedMotions = lappend(context->prunedMotions, motion);
+			context->prunedSubtrees = lappend(context->prunedSubtrees, outerPlan(motion));
+			context->placeholders = lappend(context->placeholders, placeholder);
+
+			outerPlan(motion) = (Plan *) placeholder;
+			return false;
+		}
+	}
+
+	return plan_tree_walker(node, prune_alien_slices_walker, context);
+}
+
+static void
+restore_pruned_motions(SlicePlanContext *context)
+{
+	ListCell   *lcm;
+	ListCell   *lcs;
+
+	forboth(lcm, context->prunedMotions, lcs, context->prunedSubtrees)
+	{
+		Motion	   *motion = (Motion *) lfirst(lcm);
+
+		outerPlan(motion) = (Plan *) lfirst(lcs);
+	}
+}
+
+/*
+ * Collect the subplans and range table entries referenced by the pruned
+ * plan.
+ */
+static bool
+slice_plan_refs_walker(Node *node, SlicePlanContext *context)
+{
+	if (node == NULL)
+		return false;
+
+	/* nothing below the placeholders is executed on the QE */
+	if (list_member_ptr(context->placeholders, node))
+		return false;
+
+	if (IsA(node, SubPlan))
+	{
+		SubPlan    *subplan = (SubPlan *) node;
+
+		if (bms_is_member(subplan->plan_id, context->subplanIds))
+			return false;
+		context->subplanIds = bms_add_member(context->subplanIds, subplan->plan_id);
+	}
+
+	switch (nodeTag(node))
+	{
+		case T_SeqScan:
+		case T_DynamicSeqScan:
+		case T_ExternalScan:
+		case T_IndexScan:
+		case T_DynamicIndexScan:
+		case T_IndexOnlyScan:
+		case T_BitmapIndexScan:
+		case T_DynamicBitmapIndexScan:
+		case T_BitmapHeapScan:
+		case T_DynamicBitmapHeapScan:
+		case T_TidScan:
+		case T_SubqueryScan:
+		case T_FunctionScan:
+		case T_TableFunctionScan:
+		case T_ValuesScan:
+		case T_CteScan:
+		case T_WorkTableScan:
+		case T_ForeignScan:
+		case T_ShareInputScan:
+			context->rtIndexes = bms_add_member(context->rtIndexes,
+												((Scan *) node)->scanrelid);
+			break;
+
+		case T_DML:
+			context->rtIndexes = bms_add_member(context->rtIndexes,
+												((DML *) node)->scanrelid);
+			break;
+
+		case T_ModifyTable:
+			{
+				ListCell   *lc;
+
+				foreach(lc, ((ModifyTable *) node)->resultRelations)
+					context->rtIndexes = bms_add_member(context->rtIndexes,
+														lfirst_int(lc));
+			}
+			break;
+
+		case T_LockRows:
+			{
+				ListCell   *lc;
+
+				foreach(lc, ((LockRows *) node)->rowMarks)
+				{
+					PlanRowMark *rc = (PlanRowMark *) lfirst(lc);
+
+					context->rtIndexes = bms_add_member(context->rtIndexes, rc->rti);
+					context->rtIndexes = bms_add_member(context->rtIndexes, rc->prti);
+				}
+			}
+			break;
+
+		case T_PartitionSelector:
+			context->hasPartitionSelector = true;
+			break;
+
+		default:
+			break;
+	}
+
+	return plan_tree_walker(node, slice_plan_refs_walker, context);
+}
+
+/*
+ * Is the range table entry at the given index needed by the QEs executing
+ * a slice, other than through the plan nodes of the slice?
+ */
+static bool
+rtIndexAlwaysNeeded(PlannedStmt *stmt, RangeTblEntry *rte, int rti)
+{
+	ListCell   *lc;
+
+	/* WHERE CURRENT OF looks for the inheritance parent */
+	if (rte->inh)
+		return true;
+
+	/* writes to non-temp tables are checked on the QE too */
+	if ((rte->requiredPerms & ~ACL_SELECT) != 0)
+		return true;
+
+	if (list_member_int(stmt->resultRelations, rti))
+		return true;
+
+	foreach(lc, stmt->rowMarks)
+	{
+		PlanRowMark *rc = (PlanRowMark *) lfirst(lc);
+
+		if (rc->rti == rti || rc->prti == rti)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Serialize the part of the plan that a QE needs to execute the given slice.
+ *
+ * QEs running with execute_pruned_plan only initialize the plan nodes of
+ * their own slice, the motions leading to it and the subplans reachable from
+ * it, but we used to send all of them the whole plan. For plans with many
+ * slices this makes the dispatched command many times larger than needed,
+ * and every QE spends time deserializing nodes it never looks at.
+ *
+ * The serialized copy differs from the original in that:
+ *
+ * - the subtrees below receiving motions of other slices are replaced with
+ *   empty Results (keeping their initPlans, see collect_initplans_walker),
+ * - unreferenced subplans are replaced with dummy Results, so that the
+ *   plan_id numbering is preserved,
+ * - unreferenced range table entries are replaced with RTE_VOID entries, so
+ *   that range table indexes are preserved,
+ * - relationOids and invalItems are left out, they're only used by the plan
+ *   cache on the QD,
+ * - partitioning metadata is left out if the slice has no PartitionSelector.
+ *
+ * The original plan is not modified.
+ */
+static char *
+serializeSlicePlan(PlannedStmt *stmt, SliceTable *sliceTbl, int sliceIndex,
+				   int *splan_len, int *splan_len_uncompressed)
+{
+	PlannedStmt *sliceStmt;
+	SlicePlanContext context;
+	RangeTblEntry *voidRte;
+	char	   *splan = NULL;
+	ListCell   *lc;
+	int			i;
+
+	sliceStmt = makeNode(PlannedStmt);
+	memcpy(sliceStmt, stmt, sizeof(PlannedStmt));
+	sliceStmt->relationOids = NIL;
+	sliceStmt->invalItems = NIL;
+
+	memset(&context, 0, sizeof(context));
+	exec_init_plan_tree_base(&context.base, stmt);
+
+	/* The slice's own sending motion, and the ones above it */
+	for (i = sliceIndex; i >= 0;)
+	{
+		Slice	   *slice = (Slice *) list_nth(sliceTbl->slices, i);
+
+		context.keepMotions = bms_add_member(context.keepMotions, i);
+		i = slice->parentIndex;
+	}
+
+	prune_alien_slices_walker((Node *) stmt->planTree, &context);
+
+	PG_TRY();
+	{
+		slice_plan_refs_walker((Node *) stmt->planTree, &context);
+
+		/* Replace the subplans that can't be reached anymore */
+		sliceStmt->subplans = NIL;
+		i = 1;
+		foreach(lc, stmt->subplans)
+		{
+			Plan	   *subplan = (Plan *) lfirst(lc);
+
+			if (!bms_is_member(i, context.subplanIds))
+			{
+				Result	   *dummy = makeNode(Result);
+
+				dummy->resconstantqual =
+					(Node *) list_make1(makeBoolConst(false, false));
+				subplan = (Plan *) dummy;
+			}
+			sliceStmt->subplans = lappend(sliceStmt->subplans, subplan);
+			i++;
+		}
+
+		/* Likewise for the range table */
+		voidRte = makeNode(RangeTblEntry);
+		voidRte->rtekind = RTE_VOID;
+		voidRte->eref = makeAlias("*VOID*", NIL);
+
+		sliceStmt->rtable = NIL;
+		i = 1;
+		foreach(lc, stmt->rtable)
+		{
+			RangeTblEntry *rte = (RangeTblEntry *) lfirst(lc);
+
+			if (!bms_is_member(i, context.rtIndexes) &&
+				!rtIndexAlwaysNeeded(stmt, rte, i))
+				rte = voidRte;
+			sliceStmt->rtable = lappend(sliceStmt->rtable, rte);
+			i++;
+		}
+
+		if (!context.hasPartitionSelector)
+		{
+			sliceStmt->queryPartOids = NIL;
+			sliceStmt->queryPartsMetadata = NIL;
+		}
+
+		splan = serializeNode((Node *) sliceStmt, splan_len, splan_len_uncompressed);
+	}
+	PG_CATCH();
+	{
+		restore_pruned_motions(&context);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	restore_pruned_motions(&context);
+
+	return splan;
+}
+
 /*
  * Three Helper functions for cdbdisp_dispatchX:
  *
@@ -1080,6 +1482,9 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	int			rootIdx;
 	char	   *queryText = NULL;
 	int			queryTextLength = 0;
+	char	  **sliceQueryText = NULL;
+	int		   *sliceQueryTextLength = NULL;
+	bool		slicePlanDispatch;
 	struct SliceTable *sliceTbl;
 	struct EState *estate;
 	CdbDispatcherState *ds;
@@ -1122,8 +1527,68 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	/* Each slice table has a unique-id. */
 	sliceTbl->ic_instance_id = ++gp_interconnect_id;
 
-	pQueryParms = cdbdisp_buildPlanQueryParms(queryDesc, planRequiresTxn);
-	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	slicePlanDispatch = useSlicePlanDispatch(queryDesc);
+	pQueryParms = cdbdisp_buildPlanQueryParms(queryDesc, planRequiresTxn,
+											  !slicePlanDispatch);
+
+	if (!slicePlanDispatch)
+		queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	else
+	{
+		MemoryContext slicePlanContext;
+		MemoryContext oldContext;
+
+		/*
+		 * Build the command for every slice we're going to dispatch up
+		 * front, so that an error, e.g. from gp_max_plan_size, is raised
+		 * before anything is dispatched. The serialized plans are only
+		 * needed until the command is built; the commands themselves are
+		 * allocated in DispatcherContext by buildGpQueryString().
+		 */
+		sliceQueryText = palloc0(nSlices * sizeof(char *));
+		sliceQueryTextLength = palloc0(nSlices * sizeof(int));
+
+		slicePlanContext = AllocSetContextCreate(CurrentMemoryContext,
+												 "SlicePlanContext",
+												 ALLOCSET_DEFAULT_MINSIZE,
+												 ALLOCSET_DEFAULT_INITSIZE,
+												 ALLOCSET_DEFAULT_MAXSIZE);
+
+		for (iSlice = 0; iSlice < nSlices; iSlice++)
+		{
+			Slice	   *slice = sliceVector[iSlice].slice;
+			int			splan_len_uncompressed;
+
+			if (slice == NULL || slice->gangType == GANGTYPE_UNALLOCATED)
+				continue;
+
+			oldContext = MemoryContextSwitchTo(slicePlanContext);
+			pQueryParms->serializedPlantree =
+				serializeSlicePlan(queryDesc->plannedstmt, sliceTbl,
+								   slice->sliceIndex,
+								   &pQueryParms->serializedPlantreelen,
+								   &splan_len_uncompressed);
+			MemoryContextSwitchTo(oldContext);
+
+			checkPlanSize(slice->sliceIndex, splan_len_uncompressed);
+			slice->planSize = splan_len_uncompressed;
+			slice->planSizeCompressed = pQueryParms->serializedPlantreelen;
+
+			sliceQueryText[iSlice] = buildGpQueryString(pQueryParms,
+														&sliceQueryTextLength[iSlice]);
+			if (queryText == NULL)
+			{
+				queryText = sliceQueryText[iSlice];
+				queryTextLength = sliceQueryTextLength[iSlice];
+			}
+
+			MemoryContextReset(slicePlanContext);
+		}
+
+		pQueryParms->serializedPlantree = NULL;
+		pQueryParms->serializedPlantreelen = 0;
+		MemoryContextDelete(slicePlanContext);
+	}
 
 	/*
 	 * Allocate result array with enough slots for QEs of primary gangs.
@@ -1205,6 +1670,10 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 		}
 		SIMPLE_FAULT_INJECTOR("before_one_slice_dispatched");
 
+		if (slicePlanDispatch)
+			cdbdisp_setDispatchQueryText(ds, sliceQueryText[iSlice],
+										 sliceQueryTextLength[iSlice]);
+
 		cdbdisp_dispatchToGang(ds, primaryGang, si);
 		if (planRequiresTxn || isDtxExplicitBegin())
 			addToGxactDtxSegments(primaryGang);
@@ -1213,6 +1682,11 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	}
 
 	pfree(sliceVector);
+	if (sliceQueryText)
+	{
+		pfree(sliceQueryText);
+		pfree(sliceQueryTextLength);
+	}
 
 	cdbdisp_waitDispatchFinish(ds);
 
@@ -309,5 +309,8 @@ main(int argc, char *argv[])
 
 	SetSessionUserId(1000, true);
 
+	/* the plan is not a real plan tree, dispatch it as a whole */
+	gp_enable_slice_plan_dispatch = false;
+
 	return run_tests(tests);
 }
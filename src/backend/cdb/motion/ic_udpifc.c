@@ -58,6 +58,15 @@
 #include "pgtime.h"
 #include <netinet/in.h>
 
+/*
+ * Packets are sent and received in batches where sendmmsg() and recvmmsg()
+ * exist, see gp_interconnect_batch_packets.
+ */
+#if defined(HAVE_SENDMMSG) && defined(HAVE_RECVMMSG)
+#define USE_UDPIC_MMSG
+#include <netinet/udp.h>
+#endif
+
 #ifdef WIN32
 #define WIN32_LEAN_AND_MEAN
 #ifndef _WIN32_WINNT
@@ -136,6 +145,15 @@ int
 /* 1/4 sec in msec */
 #define RX_THREAD_POLL_TIMEOUT (250)
 
+#ifdef UDP_SEGMENT
+/*
+ * Limits of a message sent with UDP GSO: the kernel takes at most 64
+ * segments, and the message must fit the 64K of an IP packet.
+ */
+#define UDPIC_GSO_MAX_SEGMENTS (64)
+#define UDPIC_GSO_MAX_BYTES (63 * 1024)
+#endif
+
 /*
  * Flags definitions for flag-field of UDP-messages
  *
@@ -312,7 +330,8 @@ struct RxBufferPool
  * The buffer pool used for keeping data packets.
  *
  * maxCount is set to 1 to make sure there is always a buffer
- * for picking packets from OS buffer.
+ * for picking packets from OS buffer. The rx thread raises it
+ * while it receives batches of packets into more buffers.
  */
 static RxBufferPool rx_buffer_pool = {1, 0, NULL};
 
@@ -568,6 +587,11 @@ static int	ICSenderSocket = -1;
 static uint16 ICSenderPort = 0;
 static int	ICSenderFamily = 0;
 
+#if defined(USE_UDPIC_MMSG) && defined(UDP_SEGMENT)
+/* Set once the kernel refused to segment packets with UDP GSO. */
+static bool udp_gso_failed = false;
+#endif
+
 /*
  * AckSendParam
  *
@@ -583,6 +607,35 @@ typedef struct AckSendParam
 	socklen_t	peer_len;
 } AckSendParam;
 
+/*
+ * RxBatch
+ *
+ * The packets the rx thread receives with one call, and the acks it sends
+ * for them with one call. Only the rx thread uses it.
+ */
+typedef struct RxBatch
+{
+	/* the receive buffers held by the rx thread */
+	icpkthdr   *pkts[MAX_INTERCONNECT_BATCH_PACKETS];
+	int			numPkts;
+
+	/* the length and the peer of each packet received */
+	int			lens[MAX_INTERCONNECT_BATCH_PACKETS];
+	struct sockaddr_storage peers[MAX_INTERCONNECT_BATCH_PACKETS];
+	socklen_t	peerLens[MAX_INTERCONNECT_BATCH_PACKETS];
+
+	/* the acks to send, at most one plain ack per connection */
+	AckSendParam acks[MAX_INTERCONNECT_BATCH_PACKETS];
+	int			numAcks;
+
+#ifdef USE_UDPIC_MMSG
+	struct mmsghdr msgs[MAX_INTERCONNECT_BATCH_PACKETS];
+	struct iovec iov[MAX_INTERCONNECT_BATCH_PACKETS];
+#endif
+} RxBatch;
+
+static RxBatch rx_batch;
+
 /*
  * ICStatistics
  *
@@ -601,7 +654,9 @@ typedef struct AckSendParam
  * mismatchNum               - the number of mismatched packets received.
  * crcErrors                 - the number of crc errors.
  * sndPktNum                 - the number of packets sent by sender.
+ * sndSyscallNum             - the number of system calls sending those packets.
  * recvPktNum                - the number of packets received by receiver.
+ * recvSyscallNum            - the number of system calls receiving packets.
  * disorderedPktNum          - disordered packet number.
  * duplicatedPktNum          - duplicate packet number.
  * recvAckNum                - the number of Acks received.
@@ -622,7 +677,9 @@ typedef struct ICStatistics
 	int32		mismatchNum;
 	int32		crcErrors;
 	int32		sndPktNum;
+	int32		sndSyscallNum;
 	int32		recvPktNum;
+	int32		recvSyscallNum;
 	int32		disorderedPktNum;
 	int32		duplicatedPktNum;
 	int32		recvAckNum;
@@ -674,6 +731,7 @@ static void sendAck(MotionConn *conn, int32 flags, uint32 seq, uint32 extraSeq);
 static void sendDisorderAck(MotionConn *conn, uint32 seq, uint32 extraSeq, uint32 lostPktCnt);
 static void sendStatusQueryMessage(MotionConn *conn, int fd, uint32 seq);
 static inline void sendControlMessage(icpkthdr *pkt, int fd, struct sockaddr *addr, socklen_t peerLen);
+static void sendAcks(RxBatch *batch);
 
 static void putRxBufferAndSendAck(MotionConn *conn, AckSendParam *param);
 static inline void putRxBufferToFreeList(RxBufferPool *p, icpkthdr *buf);
@@ -726,6 +784,10 @@ static void checkQDConnectionAlive(void);
 
 
 static void *rxThreadFunc(void *arg);
+static int	receivePackets(RxBatch *batch, int n);
+static bool handleRxPacket(icpkthdr *pkt, int read_count, struct sockaddr_storage *peer, socklen_t peerlen,
+						   AckSendParam *param, bool *wakeup_mainthread);
+static void addRxAck(RxBatch *batch, AckSendParam *param);
 
 static bool handleMismatch(icpkthdr *pkt, struct sockaddr_storage *peer, int peer_len);
 static void handleAckedPacket(MotionConn *ackConn, ICBuffer *buf, uint64 now);
@@ -741,6 +803,9 @@ static inline void addCRC(icpkthdr *pkt);
 static inline bool checkCRC(icpkthdr *pkt);
 static void sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static void sendOnce(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer *buf, MotionConn *conn);
+static void sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn,
+					  ICBuffer **bufs, int nbufs);
+static bool checkXmitError(MotionConn *conn, const char *call);
 static inline uint64 computeExpirationPeriod(MotionConn *conn, uint32 retry);
 
 static ICBuffer *getSndBuffer(MotionConn *conn);
@@ -1840,6 +1905,75 @@ sendAckWithParam(AckSendParam *param)
 	sendControlMessage(&param->msg, UDP_listenerFd, (struct sockaddr *) &param->peer, param->peer_len);
 }
 
+/*
+ * sendAcks
+ * 		Send the acknowledgments the rx thread collected for a batch of packets.
+ *
+ * Like sendControlMessage, a failed send only loses the ack, the retransmit
+ * logic handles that.
+ */
+static void
+sendAcks(RxBatch *batch)
+{
+#ifdef USE_UDPIC_MMSG
+	int			nmsgs = 0;
+	int			sent = 0;
+	int			i;
+
+	if (batch->numAcks == 1)
+	{
+		sendAckWithParam(&batch->acks[0]);
+		return;
+	}
+
+	for (i = 0; i < batch->numAcks; i++)
+	{
+		icpkthdr   *pkt = &batch->acks[i].msg;
+		struct msghdr *hdr = &batch->msgs[nmsgs].msg_hdr;
+
+#ifdef USE_ASSERT_CHECKING
+		if (testmode_inject_fault(gp_udpic_dropacks_percent))
+			continue;
+#endif
+
+		/* Add CRC for the control message. */
+		if (gp_interconnect_full_crc)
+			addCRC(pkt);
+
+		batch->iov[nmsgs].iov_base = pkt;
+		batch->iov[nmsgs].iov_len = pkt->len;
+
+		memset(&batch->msgs[nmsgs], 0, sizeof(struct mmsghdr));
+		hdr->msg_name = &batch->acks[i].peer;
+		hdr->msg_namelen = batch->acks[i].peer_len;
+		hdr->msg_iov = &batch->iov[nmsgs];
+		hdr->msg_iovlen = 1;
+		nmsgs++;
+	}
+
+	while (sent < nmsgs)
+	{
+		int			n = sendmmsg(UDP_listenerFd, &batch->msgs[sent], nmsgs - sent, 0);
+
+		if (n > 0)
+		{
+			sent += n;
+			continue;
+		}
+
+		/* the first message not sent failed, skip it */
+		write_log("sendcontrolmessage: got error %d errno %d seq %d", n, errno,
+				  ((icpkthdr *) batch->iov[sent].iov_base)->seq);
+		sent++;
+	}
+#else
+	int			i;
+
+	for (i = 0; i < batch->numAcks; i++)
+		sendAckWithParam(&batch->acks[i]);
+#endif
+}
+
 /*
  * sendAck
  * 		Send acknowledgment to sender.
@@ -1878,6 +2012,17 @@ sendDisorderAck(MotionConn *conn, uint32 seq, uint32 extraSeq, uint32 lostPktCnt
 {
 	icpkthdr   *disorderBuffer = rx_control_info.disorderBuffer;
 
+	/*
+	 * The rx thread holds back the plain acks of a batch of packets. Send
+	 * those first, so that the sender sees the acks in the order the packets
+	 * were handled, as it would without batching.
+	 */
+	if (rx_batch.numAcks > 0)
+	{
+		sendAcks(&rx_batch);
+		rx_batch.numAcks = 0;
+	}
+
 	memcpy(disorderBuffer, (char *) &conn->conn_info, sizeof(icpkthdr));
 
 	disorderBuffer->flags |= UDPIC_FLAGS_DISORDER;
@@ -3657,8 +3802,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 "UNACK_QUEUE_RING_SLOTS_NUM %d TIMER_SPAN %lld DEFAULT_RTT %d "
 		 "hasErrors %d, ic_instance_id %d ic_id_last_teardown %d "
 		 "snd_buffer_pool.count %d snd_buffer_pool.maxCount %d snd_sock_bufsize %d recv_sock_bufsize %d "
-		 "snd_pkt_count %d retransmits %d crc_errors %d"
-		 " recv_pkt_count %d recv_ack_num %d"
+		 "snd_pkt_count %d snd_syscall_count %d retransmits %d crc_errors %d"
+		 " recv_pkt_count %d recv_syscall_count %d recv_ack_num %d"
 		 " recv_queue_size_avg %f"
 		 " capacity_avg %f"
 		 " freebuf_avg %f "
@@ -3670,8 +3815,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 UNACK_QUEUE_RING_SLOTS_NUM, TIMER_SPAN, DEFAULT_RTT,
 		 hasErrors, transportStates->sliceTable->ic_instance_id, rx_control_info.lastTornIcId,
 		 snd_buffer_pool.count, snd_buffer_pool.maxCount, ic_control_info.socketSendBufferSize, ic_control_info.socketRecvBufferSize,
-		 ic_statistics.sndPktNum, ic_statistics.retransmits, ic_statistics.crcErrors,
-		 ic_statistics.recvPktNum, ic_statistics.recvAckNum,
+		 ic_statistics.sndPktNum, ic_statistics.sndSyscallNum, ic_statistics.retransmits, ic_statistics.crcErrors,
+		 ic_statistics.recvPktNum, ic_statistics.recvSyscallNum, ic_statistics.recvAckNum,
 		 (double) ((double) ic_statistics.totalRecvQueueSize) / ((double) ic_statistics.recvQueueSizeCountingTime),
 		 (double) ((double) ic_statistics.totalCapacity) / ((double) ic_statistics.capacityCountingTime),
 		 (double) ((double) ic_statistics.totalBuffers) / ((double) ic_statistics.bufferCountingTime),
@@ -4602,34 +4747,9 @@ xmit_retry:
 			   (struct sockaddr *) &conn->peer, conn->peer_len);
 	if (n < 0)
 	{
-		if (errno == EINTR)
+		if (checkXmitError(conn, "sendto()"))
 			goto xmit_retry;
-
-		if (errno == EAGAIN)	/* no space ? not an error. */
-			return;
-
-		/*
-		 * If Linux iptables (nf_conntrack?) drops an outgoing packet, it may
-		 * return an EPERM to the application. This might be simply because of
-		 * traffic shaping or congestion, so ignore it.
-		 */
-		if (errno == EPERM)
-		{
-			ereport(LOG,
-					(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-					 errmsg("Interconnect error writing an outgoing packet: %m"),
-					 errdetail("error during sendto() for Remote Connection: contentId=%d at %s",
-							   conn->remoteContentId, conn->remoteHostAndPort)));
-			return;
-		}
-
-		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-						errmsg("Interconnect error writing an outgoing packet: %m"),
-						errdetail("error during sendto() call (error:%d).\n"
-								  "For Remote Connection: contentId=%d at %s",
-								  errno, conn->remoteContentId,
-								  conn->remoteHostAndPort)));
-		/* not reached */
+		return;
 	}
 
 	if (n != buf->pkt->len)
@@ -4648,6 +4768,217 @@ xmit_retry:
 }
 
 
+/*
+ * checkXmitError
+ * 		Check an error of sending packets to a connection, errno tells which.
+ *
+ * Returns true if the call should be retried. Errors that only lose the
+ * packets return false, the retransmit logic sends them again. Others are
+ * reported as ERROR.
+ */
+static bool
+checkXmitError(MotionConn *conn, const char *call)
+{
+	if (errno == EINTR)
+		return true;
+
+	if (errno == EAGAIN)	/* no space ? not an error. */
+		return false;
+
+	/*
+	 * If Linux iptables (nf_conntrack?) drops an outgoing packet, it may
+	 * return an EPERM to the application. This might be simply because of
+	 * traffic shaping or congestion, so ignore it.
+	 */
+	if (errno == EPERM)
+	{
+		ereport(LOG,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("Interconnect error writing an outgoing packet: %m"),
+				 errdetail("error during %s for Remote Connection: contentId=%d at %s",
+						   call, conn->remoteContentId, conn->remoteHostAndPort)));
+		return false;
+	}
+
+	ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+					errmsg("Interconnect error writing an outgoing packet: %m"),
+					errdetail("error during %s call (error:%d).\n"
+							  "For Remote Connection: contentId=%d at %s",
+							  call, errno, conn->remoteContentId,
+							  conn->remoteHostAndPort)));
+	return false;				/* not reached */
+}
+
+/*
+ * sendBatch
+ * 		Send packets of a connection with as few system calls as possible.
+ *
+ * Where sendmmsg() exists, the packets go out with one call. With
+ * gp_interconnect_udp_gso, a run of packets of the same length, and a
+ * shorter last one, is also sent as one message that the kernel cuts into
+ * packets of that length.
+ */
+static void
+sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn,
+		  ICBuffer **bufs, int nbufs)
+{
+#ifdef USE_UDPIC_MMSG
+	struct mmsghdr msgs[MAX_INTERCONNECT_BATCH_PACKETS];
+	struct iovec iov[MAX_INTERCONNECT_BATCH_PACKETS];
+	int			first[MAX_INTERCONNECT_BATCH_PACKETS];
+#ifdef UDP_SEGMENT
+	union
+	{
+		char		buf[CMSG_SPACE(sizeof(uint16))];
+		struct cmsghdr align;
+	}			control[MAX_INTERCONNECT_BATCH_PACKETS];
+#endif
+	int			nmsgs = 0;
+	int			sent = 0;
+	int			i = 0;
+	int			j;
+
+	if (nbufs == 1)
+	{
+		sendOnce(transportStates, pEntry, bufs[0], conn);
+		ic_statistics.sndSyscallNum++;
+		return;
+	}
+
+	while (i < nbufs)
+	{
+		struct msghdr *hdr = &msgs[nmsgs].msg_hdr;
+		int			len = bufs[i]->pkt->len;
+
+#ifdef USE_ASSERT_CHECKING
+		if (testmode_inject_fault(gp_udpic_dropxmit_percent))
+		{
+#ifdef AMS_VERBOSE_LOGGING
+			write_log("THROW PKT with seq %d srcpid %d despid %d", bufs[i]->pkt->seq, bufs[i]->pkt->srcPid, bufs[i]->pkt->dstPid);
+#endif
+			i++;
+			continue;
+		}
+#endif
+
+		iov[i].iov_base = bufs[i]->pkt;
+		iov[i].iov_len = len;
+
+		memset(&msgs[nmsgs], 0, sizeof(struct mmsghdr));
+		hdr->msg_name = &conn->peer;
+		hdr->msg_namelen = conn->peer_len;
+		hdr->msg_iov = &iov[i];
+		hdr->msg_iovlen = 1;
+		first[nmsgs] = i++;
+
+#ifdef UDP_SEGMENT
+		if (gp_interconnect_udp_gso && !udp_gso_failed)
+		{
+			int			total = len;
+
+			while (i < nbufs &&
+				   hdr->msg_iovlen < UDPIC_GSO_MAX_SEGMENTS &&
+				   iov[i - 1].iov_len == len &&
+				   bufs[i]->pkt->len <= len &&
+				   total + bufs[i]->pkt->len <= UDPIC_GSO_MAX_BYTES)
+			{
+				iov[i].iov_base = bufs[i]->pkt;
+				iov[i].iov_len = bufs[i]->pkt->len;
+				total += bufs[i]->pkt->len;
+				hdr->msg_iovlen++;
+				i++;
+			}
+
+			if (hdr->msg_iovlen > 1)
+			{
+				struct cmsghdr *cmsg;
+
+				hdr->msg_control = control[nmsgs].buf;
+				hdr->msg_controllen = sizeof(control[nmsgs].buf);
+				cmsg = CMSG_FIRSTHDR(hdr);
+				cmsg->cmsg_level = IPPROTO_UDP;
+				cmsg->cmsg_type = UDP_SEGMENT;
+				cmsg->cmsg_len = CMSG_LEN(sizeof(uint16));
+				*(uint16 *) CMSG_DATA(cmsg) = len;
+			}
+		}
+#endif
+
+		nmsgs++;
+	}
+
+	while (sent < nmsgs)
+	{
+		int			n = sendmmsg(pEntry->txfd, &msgs[sent], nmsgs - sent, 0);
+		int			save_errno = errno;
+
+		ic_statistics.sndSyscallNum++;
+
+		if (n > 0)
+		{
+			for (j = sent; j < sent + n; j++)
+			{
+				int			k;
+				int			len = 0;
+
+				for (k = 0; k < (int) msgs[j].msg_hdr.msg_iovlen; k++)
+					len += msgs[j].msg_hdr.msg_iov[k].iov_len;
+
+				if ((int) msgs[j].msg_len != len && DEBUG1 >= log_min_messages)
+					write_log("Interconnect error writing an outgoing packet [seq %d]: short transmit (given %d sent %d) during sendmmsg() call."
+							  "For Remote Connection: contentId=%d at %s", bufs[first[j]]->pkt->seq, len, msgs[j].msg_len,
+							  conn->remoteContentId,
+							  conn->remoteHostAndPort);
+			}
+			sent += n;
+			continue;
+		}
+
+#ifdef UDP_SEGMENT
+		if (msgs[sent].msg_hdr.msg_controllen != 0 &&
+			(save_errno == EINVAL || save_errno == EIO || save_errno == EMSGSIZE))
+		{
+			/*
+			 * The kernel cannot segment these packets, because they do not
+			 * fit the MTU or the device has no checksum offload. Send them
+			 * one by one, and do not try GSO again.
+			 */
+			udp_gso_failed = true;
+			ereport(LOG,
+					(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+					 errmsg("Interconnect cannot send packets with UDP segmentation offload: %m"),
+					 errdetail("Sending every packet on its own from now on, packet size %d.",
+							   Gp_max_packet_size)));
+
+			for (j = first[sent]; j < first[sent] + msgs[sent].msg_hdr.msg_iovlen; j++)
+			{
+				sendOnce(transportStates, pEntry, bufs[j], conn);
+				ic_statistics.sndSyscallNum++;
+			}
+			sent++;
+			continue;
+		}
+#endif
+
+		if (checkXmitError(conn, "sendmmsg()"))
+			continue;
+
+		/* no space: the rest would fail too, leave them to retransmits */
+		if (save_errno == EAGAIN)
+			return;
+		sent++;
+	}
+#else
+	int			i;
+
+	for (i = 0; i < nbufs; i++)
+	{
+		sendOnce(transportStates, pEntry, bufs[i], conn);
+		ic_statistics.sndSyscallNum++;
+	}
+#endif
+}
+
 /*
  * handleStopMsgs
  *		handle stop messages.
@@ -4752,10 +5083,21 @@ handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *p
  *
  * After sending a buffer, the buffer will be placed into both the unack queue and
  * the corresponding queue in the unack queue ring.
+ *
+ * The buffers are sent in batches of up to gp_interconnect_batch_packets, see
+ * sendBatch.
  */
 static void
 sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn)
 {
+	ICBuffer   *batch[MAX_INTERCONNECT_BATCH_PACKETS];
+	int			numBatched = 0;
+	int			batchSize = 1;
+
+#ifdef USE_UDPIC_MMSG
+	batchSize = Min(Gp_interconnect_batch_packets, MAX_INTERCONNECT_BATCH_PACKETS);
+#endif
+
 	while (conn->capacity > 0 && icBufferListLength(&conn->sndQueue) > 0)
 	{
 		ICBuffer   *buf = NULL;
@@ -4794,9 +5136,9 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		}
 
 		/*
-		 * Note the place of sendOnce here. If we send before appending it to
+		 * Note the place of sendBatch here. If we send before appending it to
 		 * the unack queue and putting it into unack queue ring, and there is
-		 * a network error occurred in the sendOnce function, error message
+		 * a network error occurred in the sendBatch function, error message
 		 * will be output. In the time of error message output, interrupts is
 		 * potentially checked, if there is a pending query cancel, it will
 		 * lead to a dangled buffer (memory leak).
@@ -4805,7 +5147,12 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		updateStats(TPE_DATA_PKT_SEND, conn, buf->pkt);
 #endif
 
-		sendOnce(transportStates, pEntry, buf, conn);
+		batch[numBatched++] = buf;
+		if (numBatched == batchSize)
+		{
+			sendBatch(transportStates, pEntry, conn, batch, numBatched);
+			numBatched = 0;
+		}
 		ic_statistics.sndPktNum++;
 
 #ifdef AMS_VERBOSE_LOGGING
@@ -4814,6 +5161,9 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 
 		buf->conn->sentSeq = buf->pkt->seq;
 	}
+
+	if (numBatched > 0)
+		sendBatch(transportStates, pEntry, conn, batch, numBatched);
 }
 
 /*
@@ -6165,13 +6515,23 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
 static void *
 rxThreadFunc(void *arg)
 {
-	icpkthdr   *pkt = NULL;
+	RxBatch    *batch = &rx_batch;
 	bool		skip_poll = false;
 
+	/*
+	 * The number of buffers to receive into. It starts at one, and doubles
+	 * while a receive fills all of them, up to gp_interconnect_batch_packets.
+	 * The buffers are accounted in rx_buffer_pool.maxCount.
+	 */
+	int			batchSize = 1;
+
+	batch->numPkts = 0;
+
 	for (;;)
 	{
 		struct pollfd nfd;
 		int			n;
+		int			maxBatchSize = 1;
 
 		/* check shutdown condition */
 		if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
@@ -6183,14 +6543,36 @@ rxThreadFunc(void *arg)
 			break;
 		}
 
-		/* Try to get a buffer */
-		if (pkt == NULL)
+#ifdef USE_UDPIC_MMSG
+		maxBatchSize = Max(1, Min(Gp_interconnect_batch_packets, MAX_INTERCONNECT_BATCH_PACKETS));
+#endif
+
+		/* Try to get buffers, or return the ones of a smaller batch size */
+		if (batch->numPkts != Min(batchSize, maxBatchSize))
 		{
 			pthread_mutex_lock(&ic_control_info.lock);
-			pkt = getRxBuffer(&rx_buffer_pool);
+
+			if (batchSize > maxBatchSize)
+			{
+				rx_buffer_pool.maxCount -= batchSize - maxBatchSize;
+				batchSize = maxBatchSize;
+			}
+
+			while (batch->numPkts > batchSize)
+				putRxBufferToFreeList(&rx_buffer_pool, batch->pkts[--batch->numPkts]);
+
+			while (batch->numPkts < batchSize)
+			{
+				icpkthdr   *pkt = getRxBuffer(&rx_buffer_pool);
+
+				if (pkt == NULL)
+					break;
+				batch->pkts[batch->numPkts++] = pkt;
+			}
+
 			pthread_mutex_unlock(&ic_control_info.lock);
 
-			if (pkt == NULL)
+			if (batch->numPkts == 0)
 			{
 				setRxThreadError(ENOMEM);
 				continue;
@@ -6240,15 +6622,12 @@ rxThreadFunc(void *arg)
 			/* we've got something interesting to read */
 			/* handle incoming */
 			/* ready to read on our socket */
-			MotionConn *conn = NULL;
-			int			read_count = 0;
-
-			struct sockaddr_storage peer;
-			socklen_t	peerlen;
+			bool		wakeup_mainthread = false;
+			int			received;
+			int			kept;
+			int			i;
 
-			peerlen = sizeof(peer);
-			read_count = recvfrom(UDP_listenerFd, (char *) pkt, Gp_max_packet_size, 0,
-								  (struct sockaddr *) &peer, &peerlen);
+			received = receivePackets(batch, batch->numPkts);
 
 			if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
 			{
@@ -6259,10 +6638,7 @@ rxThreadFunc(void *arg)
 				break;
 			}
 
-			if (DEBUG5 >= log_min_messages)
-				write_log("received inbound len %d", read_count);
-
-			if (read_count < 0)
+			if (received < 0)
 			{
 				skip_poll = false;
 
@@ -6283,126 +6659,267 @@ rxThreadFunc(void *arg)
 				continue;
 			}
 
-			if (read_count < sizeof(icpkthdr))
-			{
-				if (DEBUG1 >= log_min_messages)
-					write_log("Interconnect error: short conn receive (%d)", read_count);
-				continue;
-			}
-
 			/*
 			 * when we get a "good" recvfrom() result, we can skip poll()
 			 * until we get a bad one.
 			 */
 			skip_poll = true;
 
-			/* length must be >= 0 */
-			if (pkt->len < 0)
+			batch->numAcks = 0;
+			for (i = 0; i < received; i++)
 			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound with negative length");
-				continue;
-			}
+				AckSendParam param;
 
-			if (pkt->len != read_count)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
-				continue;
+				memset(&param, 0, sizeof(AckSendParam));
+
+				if (handleRxPacket(batch->pkts[i], batch->lens[i], &batch->peers[i], batch->peerLens[i],
+								   &param, &wakeup_mainthread))
+					batch->pkts[i] = NULL;
+
+				if (param.msg.len != 0)
+					addRxAck(batch, &param);
 			}
 
+			if (wakeup_mainthread)
+				SetLatch(&ic_control_info.latch);
+
 			/*
-			 * check the CRC of the payload.
+			 * real ack sending is after lock release to decrease the lock
+			 * holding time.
 			 */
-			if (gp_interconnect_full_crc)
+			if (batch->numAcks > 0)
+				sendAcks(batch);
+
+			/* keep the buffers the packets were not kept in */
+			for (i = 0, kept = 0; i < batch->numPkts; i++)
 			{
-				if (!checkCRC(pkt))
-				{
-					pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
-					if (DEBUG2 >= log_min_messages)
-						write_log("received network data error, dropping bad packet, user data unaffected.");
-					continue;
-				}
+				if (batch->pkts[i] != NULL)
+					batch->pkts[kept++] = batch->pkts[i];
 			}
 
-#ifdef AMS_VERBOSE_LOGGING
-			logPkt("GOT MESSAGE", pkt);
+			/* more packets may be waiting if all the buffers were filled */
+			if (received == batchSize && batchSize < maxBatchSize)
+			{
+				int			grown = Min(batchSize * 2, maxBatchSize);
+
+				pthread_mutex_lock(&ic_control_info.lock);
+				rx_buffer_pool.maxCount += grown - batchSize;
+				pthread_mutex_unlock(&ic_control_info.lock);
+				batchSize = grown;
+			}
+			batch->numPkts = kept;
+		}
+
+		/* pthread_yield(); */
+	}
+
+	/* Before return, we release the packets. */
+	pthread_mutex_lock(&ic_control_info.lock);
+	while (batch->numPkts > 0)
+		freeRxBuffer(&rx_buffer_pool, batch->pkts[--batch->numPkts]);
+	rx_buffer_pool.maxCount -= batchSize - 1;
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	/* nothing to return */
+	return NULL;
+}
+
+/*
+ * receivePackets
+ * 		Receive up to n packets into the buffers of the batch.
+ *
+ * Returns the number of packets received, with their lengths and peers set
+ * in the batch, or -1 with errno set.
+ */
+static int
+receivePackets(RxBatch *batch, int n)
+{
+	int			read_count;
+
+#ifdef USE_UDPIC_MMSG
+	if (n > 1)
+	{
+		int			received;
+		int			i;
+
+		for (i = 0; i < n; i++)
+		{
+			struct msghdr *hdr = &batch->msgs[i].msg_hdr;
+
+			batch->iov[i].iov_base = batch->pkts[i];
+			batch->iov[i].iov_len = Gp_max_packet_size;
+
+			memset(&batch->msgs[i], 0, sizeof(struct mmsghdr));
+			hdr->msg_name = &batch->peers[i];
+			hdr->msg_namelen = sizeof(batch->peers[i]);
+			hdr->msg_iov = &batch->iov[i];
+			hdr->msg_iovlen = 1;
+		}
+
+		received = recvmmsg(UDP_listenerFd, batch->msgs, n, MSG_WAITFORONE, NULL);
+		ic_statistics.recvSyscallNum++;
+
+		for (i = 0; i < received; i++)
+		{
+			batch->lens[i] = batch->msgs[i].msg_len;
+			batch->peerLens[i] = batch->msgs[i].msg_hdr.msg_namelen;
+		}
+
+		return received;
+	}
 #endif
 
-			bool		wakeup_mainthread = false;
-			AckSendParam param;
+	batch->peerLens[0] = sizeof(batch->peers[0]);
+	read_count = recvfrom(UDP_listenerFd, (char *) batch->pkts[0], Gp_max_packet_size, 0,
+						  (struct sockaddr *) &batch->peers[0], &batch->peerLens[0]);
+	ic_statistics.recvSyscallNum++;
 
-			memset(&param, 0, sizeof(AckSendParam));
+	if (read_count < 0)
+		return -1;
 
-			/*
-			 * Get the connection for the pkt.
-			 *
-			 * The connection hash table should be locked until finishing the
-			 * processing of the packet to avoid the connection
-			 * addition/removal from the hash table during the mean time.
-			 */
+	batch->lens[0] = read_count;
+	return 1;
+}
 
-			pthread_mutex_lock(&ic_control_info.lock);
-			conn = findConnByHeader(&ic_control_info.connHtab, pkt);
+/*
+ * handleRxPacket
+ * 		Handle a packet received by the rx thread.
+ *
+ * Returns true if the packet was kept, by its connection or the startup
+ * cache. Sets *param if the packet is to be acknowledged, and
+ * *wakeup_mainthread if the main thread is to be woken up.
+ */
+static bool
+handleRxPacket(icpkthdr *pkt, int read_count, struct sockaddr_storage *peer, socklen_t peerlen,
+			   AckSendParam *param, bool *wakeup_mainthread)
+{
+	MotionConn *conn = NULL;
+	bool		kept = false;
 
-			if (conn != NULL)
-			{
-				/* Handling a regular packet */
-				if (handleDataPacket(conn, pkt, &peer, &peerlen, &param, &wakeup_mainthread))
-					pkt = NULL;
-				ic_statistics.recvPktNum++;
-			}
-			else
-			{
-				/*
-				 * There may have two kinds of Mismatched packets: a) Past
-				 * packets from previous command after I was torn down b)
-				 * Future packets from current command before my connections
-				 * are built.
-				 *
-				 * The handling logic is to "Ack the past and Nak the future".
-				 */
-				if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
-				{
-					if (DEBUG1 >= log_min_messages)
-						write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+	if (DEBUG5 >= log_min_messages)
+		write_log("received inbound len %d", read_count);
+
+	if (read_count < sizeof(icpkthdr))
+	{
+		if (DEBUG1 >= log_min_messages)
+			write_log("Interconnect error: short conn receive (%d)", read_count);
+		return false;
+	}
+
+	/* length must be >= 0 */
+	if (pkt->len < 0)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound with negative length");
+		return false;
+	}
+
+	if (pkt->len != read_count)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
+		return false;
+	}
+
+	/*
+	 * check the CRC of the payload.
+	 */
+	if (gp_interconnect_full_crc)
+	{
+		if (!checkCRC(pkt))
+		{
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
+			if (DEBUG2 >= log_min_messages)
+				write_log("received network data error, dropping bad packet, user data unaffected.");
+			return false;
+		}
+	}
 
 #ifdef AMS_VERBOSE_LOGGING
-					logPkt("Got a Mismatched Packet", pkt);
+	logPkt("GOT MESSAGE", pkt);
 #endif
 
-					if (handleMismatch(pkt, &peer, peerlen))
-						pkt = NULL;
-					ic_statistics.mismatchNum++;
-				}
-			}
-			pthread_mutex_unlock(&ic_control_info.lock);
+	/*
+	 * Get the connection for the pkt.
+	 *
+	 * The connection hash table should be locked until finishing the
+	 * processing of the packet to avoid the connection addition/removal from
+	 * the hash table during the mean time.
+	 */
 
-			if (wakeup_mainthread)
-				SetLatch(&ic_control_info.latch);
+	pthread_mutex_lock(&ic_control_info.lock);
+	conn = findConnByHeader(&ic_control_info.connHtab, pkt);
 
-			/*
-			 * real ack sending is after lock release to decrease the lock
-			 * holding time.
-			 */
-			if (param.msg.len != 0)
-				sendAckWithParam(&param);
-		}
+	if (conn != NULL)
+	{
+		/* Handling a regular packet */
+		if (handleDataPacket(conn, pkt, peer, &peerlen, param, wakeup_mainthread))
+			kept = true;
+		ic_statistics.recvPktNum++;
+	}
+	else
+	{
+		/*
+		 * There may have two kinds of Mismatched packets: a) Past packets
+		 * from previous command after I was torn down b) Future packets from
+		 * current command before my connections are built.
+		 *
+		 * The handling logic is to "Ack the past and Nak the future".
+		 */
+		if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
+		{
+			if (DEBUG1 >= log_min_messages)
+				write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
 
-		/* pthread_yield(); */
+#ifdef AMS_VERBOSE_LOGGING
+			logPkt("Got a Mismatched Packet", pkt);
+#endif
+
+			if (handleMismatch(pkt, peer, peerlen))
+				kept = true;
+			ic_statistics.mismatchNum++;
+		}
 	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	return kept;
+}
 
-	/* Before return, we release the packet. */
-	if (pkt)
+/*
+ * addRxAck
+ * 		Add an ack to the batch's acks.
+ *
+ * A plain ack of a connection replaces the one added for it earlier in the
+ * batch: acks are cumulative, the later one acknowledges every packet the
+ * earlier one did, and reports at least as many consumed.
+ */
+#define IS_PLAIN_ACK(pkt) \
+	(((pkt)->flags & (UDPIC_FLAGS_ACK | UDPIC_FLAGS_CAPACITY)) == (UDPIC_FLAGS_ACK | UDPIC_FLAGS_CAPACITY) && \
+	 ((pkt)->flags & (UDPIC_FLAGS_STOP | UDPIC_FLAGS_NAK | UDPIC_FLAGS_DISORDER | UDPIC_FLAGS_DUPLICATE)) == 0)
+
+static void
+addRxAck(RxBatch *batch, AckSendParam *param)
+{
+	int			i;
+
+	if (IS_PLAIN_ACK(&param->msg))
 	{
-		pthread_mutex_lock(&ic_control_info.lock);
-		freeRxBuffer(&rx_buffer_pool, pkt);
-		pkt = NULL;
-		pthread_mutex_unlock(&ic_control_info.lock);
+		for (i = 0; i < batch->numAcks; i++)
+		{
+			AckSendParam *prev = &batch->acks[i];
+
+			if (IS_PLAIN_ACK(&prev->msg) &&
+				CONN_HASH_MATCH(&prev->msg, &param->msg) &&
+				prev->msg.seq <= param->msg.seq &&
+				prev->msg.extraSeq <= param->msg.extraSeq)
+			{
+				memcpy(prev, param, sizeof(AckSendParam));
+				return;
+			}
+		}
 	}
 
-	/* nothing to return */
-	return NULL;
+	memcpy(&batch->acks[batch->numAcks++], param, sizeof(AckSendParam));
 }
 
 /*
@@ -15,10 +15,17 @@
 #include "postgres.h"
 #include "miscadmin.h"
 
+#include "access/nbtree.h"
+#include "catalog/pg_collation.h"
 #include "cdb/partitionselection.h"
 #include "cdb/cdbpartition.h"
 #include "executor/executor.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
 #include "parser/parse_expr.h"
+#include "utils/datum.h"
+#include "utils/hsearch.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
 
 /*
@@ -33,6 +40,70 @@ typedef struct AttrMapContext
 	Index		varno;			/* Which rte's varattno to re-map */
 } AttrMapContext;
 
+/*
+ * How a conjunct of the general predicate of a level depends on the range
+ * rule it is evaluated for.
+ *
+ * The rules of a range partitioned level are sorted and don't overlap, so
+ * both their lower and their upper bounds increase from one rule to the
+ * next. A comparison of a bound with a value that doesn't depend on the rule
+ * therefore holds for a prefix ("bound < value") or a suffix
+ * ("bound > value") of the rules. This only holds for the inner rules: the
+ * first and the last rule may be open-ended, and are always evaluated.
+ */
+typedef enum PartQualShape
+{
+	PART_QUAL_CONST,			/* same result for all inner rules */
+	PART_QUAL_PREFIX,			/* holds for a prefix of the inner rules */
+	PART_QUAL_SUFFIX,			/* holds for a suffix of the inner rules */
+	PART_QUAL_UNKNOWN			/* anything else */
+} PartQualShape;
+
+/*
+ * Rule search state of a partitioning level, set up the first time the
+ * level is processed.
+ */
+typedef struct PartitionLevelIndex
+{
+	bool		analyzed;		/* has the general predicate been analyzed */
+
+	/*
+	 * If the general predicate is a conjunction of PART_QUAL_CONST,
+	 * PART_QUAL_PREFIX and PART_QUAL_SUFFIX conjuncts, the inner rules that
+	 * satisfy it are found by binary search, using the conjuncts of each
+	 * shape.
+	 */
+	bool		searchable;
+	Oid			parclass;		/* operator class the analysis assumed */
+	List	   *constQual;
+	List	   *prefixQual;
+	List	   *suffixQual;
+
+	/*
+	 * Last value looked up by the equality predicate, and the rule it
+	 * selected. Join keys tend to come in runs, so this saves repeating the
+	 * search for every tuple.
+	 */
+	PartitionNode *memoNode;	/* NULL if there is no last value */
+	Oid			memoTypid;
+	int16		memoTyplen;
+	bool		memoTypbyval;
+	Datum		memoValue;
+	bool		memoIsNull;
+	PartitionRule *memoRule;
+} PartitionLevelIndex;
+
+/*
+ * Rules of a range partitioned PartitionNode, as an array.
+ */
+typedef struct PartitionRuleArray
+{
+	PartitionNode *partnode;	/* hash key */
+	bool		searchable;		/* are all inner rules bounded on both ends */
+	int			nrules;
+	PartitionRule **rules;
+} PartitionRuleArray;
+
 static bool change_varattnos_varno_walker(Node *node, const AttrMapContext *attrMapCxt);
 
 /* ----------------------------------------------------------------
@@ -137,6 +208,526 @@ partition_selection(PartitionNode *pn, PartitionAccessMethods *accessMethods, Da
 	return result;
 }
 
+/*
+ * Does the expression reference the rule of the given level?
+ */
+static bool
+contain_level_part_expr_walker(Node *node, int *level)
+{
+	if (node == NULL)
+		return false;
+
+	switch (nodeTag(node))
+	{
+		case T_PartDefaultExpr:
+			return ((PartDefaultExpr *) node)->level == *level;
+		case T_PartBoundExpr:
+			return ((PartBoundExpr *) node)->level == *level;
+		case T_PartBoundInclusionExpr:
+			return ((PartBoundInclusionExpr *) node)->level == *level;
+		case T_PartBoundOpenExpr:
+			return ((PartBoundOpenExpr *) node)->level == *level;
+		case T_PartListRuleExpr:
+			return ((PartListRuleExpr *) node)->level == *level;
+		case T_PartListNullTestExpr:
+			return ((PartListNullTestExpr *) node)->level == *level;
+		default:
+			break;
+	}
+
+	return expression_tree_walker(node, contain_level_part_expr_walker, (void *) level);
+}
+
+static bool
+contain_level_part_expr(Node *node, int level)
+{
+	return contain_level_part_expr_walker(node, &level);
+}
+
+/*
+ * If the given node is a btree comparison of a bound of the rule of the given
+ * level with a value that doesn't depend on that rule, return the operator's
+ * strategy, with the bound on the left-hand side, and the two operands.
+ * Otherwise return 0.
+ *
+ * A comparison built by ORCA is ORed with a test of whether the bound is
+ * open; that is false for the inner rules, so it is looked through.
+ */
+static int
+part_bound_comparison(Node *node, int level, Oid opfamily,
+					  PartBoundExpr **bound, Node **value)
+{
+	OpExpr	   *opexpr = NULL;
+	Node	   *left;
+	Node	   *right;
+	int			strategy;
+
+	if (and_clause(node) || not_clause(node))
+		return 0;
+
+	if (or_clause(node))
+	{
+		ListCell   *lc;
+
+		foreach(lc, ((BoolExpr *) node)->args)
+		{
+			Node	   *arg = (Node *) lfirst(lc);
+
+			if (IsA(arg, PartBoundOpenExpr))
+				continue;
+			if (opexpr != NULL || !IsA(arg, OpExpr))
+				return 0;
+			opexpr = (OpExpr *) arg;
+		}
+	}
+	else if (IsA(node, OpExpr))
+		opexpr = (OpExpr *) node;
+
+	if (opexpr == NULL || list_length(opexpr->args) != 2)
+		return 0;
+
+	/* the rules are sorted by the default collation */
+	if (OidIsValid(opexpr->inputcollid) &&
+		opexpr->inputcollid != DEFAULT_COLLATION_OID)
+		return 0;
+
+	strategy = get_op_opfamily_strategy(opexpr->opno, opfamily);
+	if (strategy == 0 || strategy == BTEqualStrategyNumber)
+		return 0;
+
+	left = (Node *) linitial(opexpr->args);
+	right = (Node *) lsecond(opexpr->args);
+	if (IsA(left, RelabelType))
+		left = (Node *) ((RelabelType *) left)->arg;
+	if (IsA(right, RelabelType))
+		right = (Node *) ((RelabelType *) right)->arg;
+
+	if (IsA(right, PartBoundExpr) && !IsA(left, PartBoundExpr))
+	{
+		Node	   *tmp = left;
+
+		left = right;
+		right = tmp;
+		strategy = BTCommuteStrategyNumber(strategy);
+	}
+
+	if (!IsA(left, PartBoundExpr) ||
+		((PartBoundExpr *) left)->level != level ||
+		contain_level_part_expr(right, level))
+		return 0;
+
+	*bound = (PartBoundExpr *) left;
+	*value = right;
+	return strategy;
+}
+
+/*
+ * If the given node is "cmp AND included", as built by ORCA for inclusive
+ * comparisons, return "cmp".
+ */
+static Node *
+part_inclusion_branch(Node *node, int level)
+{
+	BoolExpr   *andexpr;
+	Node	   *incl;
+
+	if (!and_clause(node) || list_length(((BoolExpr *) node)->args) != 2)
+		return NULL;
+
+	andexpr = (BoolExpr *) node;
+	incl = (Node *) lsecond(andexpr->args);
+	if (not_clause(incl))
+		incl = (Node *) get_notclausearg((Expr *) incl);
+
+	if (!IsA(incl, PartBoundInclusionExpr) ||
+		((PartBoundInclusionExpr *) incl)->level != level)
+		return NULL;
+
+	return (Node *) linitial(andexpr->args);
+}
+
+static PartQualShape classify_part_qual(Node *node, int level, Oid opfamily);
+
+/*
+ * Combine the shapes of the arguments of an AND or an OR. Both preserve
+ * prefixes and suffixes, and a rule-independent argument doesn't change the
+ * shape of the others.
+ */
+static PartQualShape
+combine_part_qual_shapes(PartQualShape shape1, PartQualShape shape2)
+{
+	if (shape1 == PART_QUAL_CONST)
+		return shape2;
+	if (shape2 == PART_QUAL_CONST || shape1 == shape2)
+		return shape1;
+	return PART_QUAL_UNKNOWN;
+}
+
+/*
+ * Shape of an OR. ORCA tests a bound against an inclusive comparison as
+ * "(bound <= value AND included) OR bound < value". The first branch can
+ * only add the rule whose bound equals the value, which is next to the rules
+ * satisfying the second branch, so the OR has the shape of the second branch.
+ */
+static PartQualShape
+classify_part_or(BoolExpr *orexpr, int level, Oid opfamily)
+{
+	PartQualShape shape = PART_QUAL_CONST;
+	ListCell   *lc;
+
+	foreach(lc, orexpr->args)
+	{
+		Node	   *arg = (Node *) lfirst(lc);
+		Node	   *inclCmp = part_inclusion_branch(arg, level);
+		PartQualShape argShape = PART_QUAL_UNKNOWN;
+
+		if (inclCmp != NULL)
+		{
+			PartBoundExpr *inclBound;
+			Node	   *inclValue;
+			int			inclStrategy;
+			ListCell   *lc2;
+
+			inclStrategy = part_bound_comparison(inclCmp, level, opfamily,
+												 &inclBound, &inclValue);
+
+			foreach(lc2, orexpr->args)
+			{
+				Node	   *other = (Node *) lfirst(lc2);
+				PartBoundExpr *bound;
+				Node	   *value;
+				int			strategy;
+
+				strategy = part_bound_comparison(other, level, opfamily,
+												 &bound, &value);
+				if (strategy == 0 ||
+					!((inclStrategy == BTLessEqualStrategyNumber &&
+					   strategy == BTLessStrategyNumber) ||
+					  (inclStrategy == BTGreaterEqualStrategyNumber &&
+					   strategy == BTGreaterStrategyNumber)) ||
+					!equal(inclBound, bound) || !equal(inclValue, value))
+					continue;
+
+				argShape = classify_part_qual(other, level, opfamily);
+				break;
+			}
+		}
+		else
+			argShape = classify_part_qual(arg, level, opfamily);
+
+		shape = combine_part_qual_shapes(shape, argShape);
+		if (shape == PART_QUAL_UNKNOWN)
+			break;
+	}
+
+	return shape;
+}
+
+/*
+ * Shape of the given expression, evaluated for the inner rules of the given
+ * level, whose operator class is in the given family.
+ */
+static PartQualShape
+classify_part_qual(Node *node, int level, Oid opfamily)
+{
+	if (!contain_level_part_expr(node, level))
+		return PART_QUAL_CONST;
+
+	/* the inner rules are bounded, and none of them is the default part */
+	if (IsA(node, PartBoundOpenExpr) || IsA(node, PartDefaultExpr))
+		return PART_QUAL_CONST;
+
+	if (not_clause(node))
+	{
+		Node	   *arg = (Node *) get_notclausearg((Expr *) node);
+
+		if (classify_part_qual(arg, level, opfamily) == PART_QUAL_CONST)
+			return PART_QUAL_CONST;
+		return PART_QUAL_UNKNOWN;
+	}
+
+	if (and_clause(node))
+	{
+		PartQualShape shape = PART_QUAL_CONST;
+		ListCell   *lc;
+
+		foreach(lc, ((BoolExpr *) node)->args)
+		{
+			shape = combine_part_qual_shapes(shape,
+											 classify_part_qual((Node *) lfirst(lc), level, opfamily));
+			if (shape == PART_QUAL_UNKNOWN)
+				break;
+		}
+		return shape;
+	}
+
+	if (or_clause(node))
+		return classify_part_or((BoolExpr *) node, level, opfamily);
+
+	if (IsA(node, OpExpr))
+	{
+		PartBoundExpr *bound;
+		Node	   *value;
+
+		switch (part_bound_comparison(node, level, opfamily, &bound, &value))
+		{
+			case BTLessStrategyNumber:
+			case BTLessEqualStrategyNumber:
+				return PART_QUAL_PREFIX;
+			case BTGreaterStrategyNumber:
+			case BTGreaterEqualStrategyNumber:
+				return PART_QUAL_SUFFIX;
+			default:
+				break;
+		}
+	}
+
+	return PART_QUAL_UNKNOWN;
+}
+
+/*
+ * Append the conjuncts of the given expression to the given list.
+ */
+static List *
+flatten_part_conjuncts(List *conjuncts, Node *node)
+{
+	if (and_clause(node))
+	{
+		ListCell   *lc;
+
+		foreach(lc, ((BoolExpr *) node)->args)
+			conjuncts = flatten_part_conjuncts(conjuncts, (Node *) lfirst(lc));
+		return conjuncts;
+	}
+
+	return lappend(conjuncts, node);
+}
+
+/* ----------------------------------------------------------------
+ *		analyze_general_predicate
+ *
+ *		Split the general predicate of the given level into conjuncts
+ *		that the inner rules can be binary searched for. The PartitionNode
+ *		is any node of the level; all of them share its partitioning key.
+ *
+ * ----------------------------------------------------------------
+ */
+static void
+analyze_general_predicate(PartitionSelectorState *node, int level, PartitionNode *parentNode)
+{
+	PartitionSelector *ps = (PartitionSelector *) node->ps.plan;
+	PartitionLevelIndex *index = &node->levelIndexes[level];
+	Node	   *generalPredicate = (Node *) list_nth(ps->levelExpressions, level);
+	Partition  *part = parentNode->part;
+	List	   *conjuncts;
+	List	   *shapes = NIL;
+	ListCell   *lc;
+	ListCell   *lcShape;
+	Oid			opfamily;
+	MemoryContext oldcxt;
+
+	index->analyzed = true;
+
+	if (part->parkind != 'r' || part->parnatts != 1 ||
+		contain_volatile_functions(generalPredicate) ||
+		contain_subplans(generalPredicate))
+		return;
+
+	opfamily = get_opclass_family(part->parclass[0]);
+	conjuncts = flatten_part_conjuncts(NIL, generalPredicate);
+
+	foreach(lc, conjuncts)
+	{
+		PartQualShape shape = classify_part_qual((Node *) lfirst(lc), level, opfamily);
+
+		if (shape == PART_QUAL_UNKNOWN)
+		{
+			list_free(shapes);
+			list_free(conjuncts);
+			return;
+		}
+		shapes = lappend_int(shapes, shape);
+	}
+
+	oldcxt = MemoryContextSwitchTo(node->ps.state->es_query_cxt);
+
+	forboth(lc, conjuncts, lcShape, shapes)
+	{
+		ExprState  *exprState = ExecInitExpr((Expr *) lfirst(lc), (PlanState *) node);
+
+		switch ((PartQualShape) lfirst_int(lcShape))
+		{
+			case PART_QUAL_CONST:
+				index->constQual = lappend(index->constQual, exprState);
+				break;
+			case PART_QUAL_PREFIX:
+				index->prefixQual = lappend(index->prefixQual, exprState);
+				break;
+			case PART_QUAL_SUFFIX:
+				index->suffixQual = lappend(index->suffixQual, exprState);
+				break;
+			default:
+				Assert(false);
+		}
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+
+	index->parclass = part->parclass[0];
+	index->searchable = true;
+
+	list_free(shapes);
+	list_free(conjuncts);
+}
+
+/* ----------------------------------------------------------------
+ *		get_rule_array
+ *
+ *		Return the rules of the given range PartitionNode as an array,
+ *		building it the first time the node is seen.
+ *
+ * ----------------------------------------------------------------
+ */
+static PartitionRuleArray *
+get_rule_array(PartitionSelectorState *node, PartitionNode *partnode)
+{
+	PartitionRuleArray *ruleArray;
+	bool		found;
+
+	if (node->ruleArrays == NULL)
+	{
+		HASHCTL		hash_ctl;
+
+		MemSet(&hash_ctl, 0, sizeof(hash_ctl));
+		hash_ctl.keysize = sizeof(PartitionNode *);
+		hash_ctl.entrysize = sizeof(PartitionRuleArray);
+		hash_ctl.hash = tag_hash;
+		hash_ctl.hcxt = node->ps.state->es_query_cxt;
+		node->ruleArrays = hash_create("PartitionSelector rule arrays", 16, &hash_ctl,
+									   HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+	}
+
+	ruleArray = (PartitionRuleArray *) hash_search(node->ruleArrays, &partnode,
+												   HASH_ENTER, &found);
+	if (!found)
+	{
+		int			nrules = list_length(partnode->rules);
+		int			i = 0;
+		ListCell   *lc;
+
+		ruleArray->searchable = (partnode->part->parkind == 'r' &&
+								 partnode->part->parnatts == 1);
+		ruleArray->nrules = nrules;
+		ruleArray->rules = (PartitionRule **)
+			MemoryContextAlloc(node->ps.state->es_query_cxt,
+							   Max(nrules, 1) * sizeof(PartitionRule *));
+
+		foreach(lc, partnode->rules)
+		{
+			PartitionRule *rule = (PartitionRule *) lfirst(lc);
+
+			if (i > 0 && i < nrules - 1 &&
+				(rule->parrangestart == NULL || rule->parrangeend == NULL))
+				ruleArray->searchable = false;
+
+			ruleArray->rules[i++] = rule;
+		}
+	}
+
+	return ruleArray;
+}
+
+/*
+ * Evaluate the given qual for the given rule of the given level.
+ */
+static bool
+eval_part_qual_for_rule(PartitionSelectorState *node, int level, PartitionRule *rule,
+						TupleTableSlot *inputTuple, List *qualList)
+{
+	node->levelPartRules[level] = rule;
+
+	return eval_part_qual(node->ps.ps_ExprContext, inputTuple, qualList);
+}
+
+/* ----------------------------------------------------------------
+ *		search_range_rules
+ *
+ *		Returns the list of rules of the given array that satisfy the
+ *		general predicate of the given level. The first and the last rule
+ *		are tested with the whole predicate, the inner ones are binary
+ *		searched for: the ones satisfying the predicate are the last ones
+ *		satisfying the prefix conjuncts, that also satisfy the suffix
+ *		conjuncts.
+ *
+ * ----------------------------------------------------------------
+ */
+static List *
+search_range_rules(PartitionSelectorState *node, int level,
+				   TupleTableSlot *inputTuple, PartitionRuleArray *ruleArray)
+{
+	PartitionLevelIndex *index = &node->levelIndexes[level];
+	List	   *qualList = (List *) list_nth(node->levelExprStateLists, level);
+	PartitionRule **rules = ruleArray->rules;
+	int			nrules = ruleArray->nrules;
+	List	   *result = NIL;
+
+	if (nrules == 0)
+		return NIL;
+
+	if (eval_part_qual_for_rule(node, level, rules[0], inputTuple, qualList))
+		result = lappend(result, rules[0]);
+
+	if (nrules > 2 &&
+		eval_part_qual_for_rule(node, level, rules[1], inputTuple, index->constQual))
+	{
+		int			low = 1;
+		int			high = nrules - 2;
+		int			first;
+		int			last = 0;
+		int			i;
+
+		/* find the last inner rule that satisfies the prefix conjuncts */
+		while (low <= high)
+		{
+			int			mid = low + (high - low) / 2;
+
+			if (eval_part_qual_for_rule(node, level, rules[mid], inputTuple, index->prefixQual))
+			{
+				last = mid;
+				low = mid + 1;
+			}
+			else
+				high = mid - 1;
+		}
+
+		/* find the first one before it that satisfies the suffix conjuncts */
+		first = last + 1;
+		low = 1;
+		high = last;
+		while (low <= high)
+		{
+			int			mid = low + (high - low) / 2;
+
+			if (eval_part_qual_for_rule(node, level, rules[mid], inputTuple, index->suffixQual))
+			{
+				first = mid;
+				high = mid - 1;
+			}
+			else
+				low = mid + 1;
+		}
+
+		for (i = first; i <= last; i++)
+			result = lappend(result, rules[i]);
+	}
+
+	if (nrules > 1 &&
+		eval_part_qual_for_rule(node, level, rules[nrules - 1], inputTuple, qualList))
+		result = lappend(result, rules[nrules - 1]);
+
+	return result;
+}
+
 /* ----------------------------------------------------------------
  *		partition_rules_for_general_predicate
  *
@@ -154,23 +745,38 @@ partition_rules_for_general_predicate(PartitionSelectorState *node, int level,
 
 	List	   *result = NIL;
 	ListCell   *lc = NULL;
+	PartitionLevelIndex *index = &node->levelIndexes[level];
+	PartitionRuleArray *ruleArray = NULL;
 
-	foreach(lc, parentNode->rules)
+	if (!index->analyzed)
+		analyze_general_predicate(node, level, parentNode);
+
+	if (index->searchable && parentNode->part->parclass[0] == index->parclass)
+		ruleArray = get_rule_array(node, parentNode);
+
+	if (ruleArray != NULL && ruleArray->searchable)
 	{
-		PartitionRule *rule = (PartitionRule *) lfirst(lc);
+		result = search_range_rules(node, level, inputTuple, ruleArray);
+	}
+	else
+	{
+		foreach(lc, parentNode->rules)
+		{
+			PartitionRule *rule = (PartitionRule *) lfirst(lc);
 
-		/*
-		 * We need to register it to allLevelParts to evaluate the current
-		 * predicate
-		 */
-		node->levelPartRules[level] = rule;
+			/*
+			 * We need to register it to allLevelParts to evaluate the current
+			 * predicate
+			 */
+			node->levelPartRules[level] = rule;
 
-		/* evaluate generalPredicate */
-		List  *qualList = (List *) lfirst(list_nth_cell(node->levelExprStateLists, level));
+			/* evaluate generalPredicate */
+			List  *qualList = (List *) lfirst(list_nth_cell(node->levelExprStateLists, level));
 
-		if (eval_part_qual(node->ps.ps_ExprContext, inputTuple, qualList))
-		{
-			result = lappend(result, rule);
+			if (eval_part_qual(node->ps.ps_ExprContext, inputTuple, qualList))
+			{
+				result = lappend(result, rule);
+			}
 		}
 	}
 
@@ -196,6 +802,57 @@ partition_rules_for_general_predicate(PartitionSelectorState *node, int level,
 	return result;
 }
 
+/* ----------------------------------------------------------------
+ *		memoized_partition_selection
+ *
+ *		Like partition_selection, but remembers the last value looked up
+ *		for the given level, and returns the same rule without searching
+ *		if it is looked up again for the same parent.
+ *
+ * ----------------------------------------------------------------
+ */
+static PartitionRule *
+memoized_partition_selection(PartitionSelectorState *node, int level, PartitionNode *parentNode,
+							 Datum value, Oid exprTypid, bool isNull)
+{
+	PartitionLevelIndex *index = &node->levelIndexes[level];
+	PartitionRule *rule;
+	MemoryContext oldcxt;
+
+	if (index->memoNode == parentNode && index->memoTypid == exprTypid &&
+		index->memoIsNull == isNull &&
+		(isNull || datumIsEqual(value, index->memoValue,
+								index->memoTypbyval, index->memoTyplen)))
+		return index->memoRule;
+
+	rule = partition_selection(parentNode, node->accessMethods, value, exprTypid, isNull);
+
+	if (index->memoTypid != exprTypid)
+	{
+		get_typlenbyval(exprTypid, &index->memoTyplen, &index->memoTypbyval);
+		index->memoTypid = exprTypid;
+	}
+	else if (index->memoNode != NULL && !index->memoIsNull && !index->memoTypbyval)
+		pfree(DatumGetPointer(index->memoValue));
+
+	index->memoNode = NULL;
+
+	/* don't hold on to toast pointers */
+	if (!isNull && index->memoTyplen == -1 &&
+		VARATT_IS_EXTERNAL(DatumGetPointer(value)))
+		return rule;
+
+	oldcxt = MemoryContextSwitchTo(node->ps.state->es_query_cxt);
+	index->memoValue = isNull ? (Datum) 0 : datumCopy(value, index->memoTypbyval, index->memoTyplen);
+	MemoryContextSwitchTo(oldcxt);
+
+	index->memoNode = parentNode;
+	index->memoIsNull = isNull;
+	index->memoRule = rule;
+
+	return rule;
+}
+
 /* ----------------------------------------------------------------
  *		partition_rules_for_equality_predicate
  *
@@ -240,7 +897,12 @@ partition_rules_for_equality_predicate(PartitionSelectorState *node, int level,
 		 */
 		Oid			exprTypid = exprType((Node *) exprState->expr);
 
-		PartitionRule *rule = partition_selection(parentNode, node->accessMethods, value, exprTypid, isNull);
+		PartitionRule *rule;
+
+		if (list_length(exprStateList) == 1)
+			rule = memoized_partition_selection(node, level, parentNode, value, exprTypid, isNull);
+		else
+			rule = partition_selection(parentNode, node->accessMethods, value, exprTypid, isNull);
 		if (rule)
 			rules = list_append_unique(rules, rule);
 	}
@@ -423,6 +1085,7 @@ initPartitionSelection(PartitionSelector *node, EState *estate)
 	psstate->ps.plan = (Plan *) node;
 	psstate->ps.state = estate;
 	psstate->levelPartRules = (PartitionRule **) palloc0(node->nLevels * sizeof(PartitionRule *));
+	psstate->levelIndexes = (PartitionLevelIndex *) palloc0(node->nLevels * sizeof(PartitionLevelIndex));
 
 	/* ExprContext initialization */
 	ExecAssignExprContext(estate, &psstate->ps);
@@ -2336,6 +2336,25 @@ gpexplain_formatSlicesOutput(struct CdbExplain_ShowStatCtx *showstatctx,
             }
         }
 
+        /* Size of the slice's part of the plan, if it was dispatched alone */
+        if (es->verbose && slice && slice->planSize > 0)
+        {
+            if (es->format == EXPLAIN_FORMAT_TEXT)
+            {
+                cdbexplain_formatMemory(maxbuf, sizeof(maxbuf), slice->planSize);
+                cdbexplain_formatMemory(avgbuf, sizeof(avgbuf), slice->planSizeCompressed);
+                appendStringInfo(es->str, "  Dispatched plan: %s, %s compressed.",
+                                 maxbuf, avgbuf);
+            }
+            else
+            {
+                ExplainOpenGroup("Dispatched Plan", "Dispatched Plan", true, es);
+                ExplainPropertyInteger("Size", slice->planSize, es);
+                ExplainPropertyInteger("Compressed Size", slice->planSizeCompressed, es);
+                ExplainCloseGroup("Dispatched Plan", "Dispatched Plan", true, es);
+            }
+        }
+
         if (es->format == EXPLAIN_FORMAT_TEXT)
             appendStringInfoChar(es->str, '\n');
 
@@ -25,18 +25,26 @@
 #include "postgres.h"
 
 #include "access/relscan.h"
+#include "catalog/pg_am.h"
+#include "commands/defrem.h"
 #include "executor/execdebug.h"
 #include "executor/nodeSeqscan.h"
+#include "miscadmin.h"
 #include "utils/rel.h"
 
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbaocsam.h"
+#include "utils/guc.h"
+#include "utils/lsyscache.h"
 #include "utils/snapmgr.h"
 
 static void InitScanRelation(SeqScanState *node, EState *estate, int eflags, Relation currentRelation);
 static TupleTableSlot *SeqNext(SeqScanState *node);
 
 static void InitAOCSScanOpaque(SeqScanState *scanState, Relation currentRelation);
+static void AOCSNextLate(SeqScanState *node, ScanDirection direction,
+						 TupleTableSlot *slot);
+static ScanKey BuildAOCSSkipKeys(List *qual, int *nkeys);
 
 /* ----------------------------------------------------------------
  *						Scan Support
@@ -73,7 +81,10 @@ SeqNext(SeqScanState *node)
 	}
 	else if (node->ss_currentScanDesc_aocs)
 	{
-		aocs_getnext(node->ss_currentScanDesc_aocs, direction, slot);
+		if (node->ss_aocs_qual)
+			AOCSNextLate(node, direction, slot);
+		else
+			aocs_getnext(node->ss_currentScanDesc_aocs, direction, slot);
 	}
 	else
 	{
@@ -102,6 +113,39 @@ SeqNext(SeqScanState *node)
 	return slot;
 }
 
+/*
+ * AOCSNextLate -- fetch the next row of an AOCS scan that passes the qual
+ *
+ * Only the columns of the qual are read for every row; the other projected
+ * columns are read for the rows that pass it.
+ */
+static void
+AOCSNextLate(SeqScanState *node, ScanDirection direction, TupleTableSlot *slot)
+{
+	ExprContext *econtext = node->ss.ps.ps_ExprContext;
+
+	while (aocs_getnext(node->ss_currentScanDesc_aocs, direction, slot))
+	{
+		econtext->ecxt_scantuple = slot;
+		if (ExecQual(node->ss_aocs_qual, econtext, false))
+		{
+			aocs_getnext_late(node->ss_currentScanDesc_aocs, slot);
+			return;
+		}
+
+		InstrCountFiltered1(node, 1);
+		ResetExprContext(econtext);
+
+		CHECK_FOR_INTERRUPTS();
+
+		if (QueryFinishPending)
+		{
+			ExecClearTuple(slot);
+			return;
+		}
+	}
+}
+
 /*
  * SeqRecheck -- access method routine to recheck a tuple in EvalPlanQual
  */
@@ -184,6 +228,36 @@ InitScanRelation(SeqScanState *node, EState *estate, int eflags, Relation curren
 						   appendOnlyMetaDataSnapshot,
 						   NULL /* relationTupleDesc */,
 						   node->ss_aocs_proj);
+
+		/*
+		 * With late materialization, the qual is evaluated by SeqNext()
+		 * before the rest of the columns are read.
+		 */
+		if (node->ss_aocs_filterproj &&
+			aocs_set_late_materialization(node->ss_currentScanDesc_aocs,
+										  node->ss_aocs_filterproj))
+		{
+			node->ss_aocs_qual = node->ss.ps.qual;
+			node->ss.ps.qual = NIL;
+		}
+
+		/*
+		 * Skip the blocks that cannot hold rows passing the qual. The qual
+		 * is still evaluated on every row that is read.
+		 */
+		if (gp_enable_aocs_block_skipping &&
+			OidIsValid(currentRelation->rd_appendonly->blkdirrelid))
+		{
+			ScanKey		keys;
+			int			nkeys;
+
+			keys = BuildAOCSSkipKeys(node->ss.ps.plan->qual, &nkeys);
+			if (nkeys > 0)
+				aocs_set_block_skipping(node->ss_currentScanDesc_aocs,
+										nkeys, keys);
+			if (keys)
+				pfree(keys);
+		}
 	}
 	else
 	{
@@ -395,4 +469,89 @@ InitAOCSScanOpaque(SeqScanState *scanstate, Relation currentRelation)
 
 	scanstate->ss_aocs_ncol = ncol;
 	scanstate->ss_aocs_proj = proj;
+
+	/* columns of the qual, for late materialization */
+	if (gp_enable_aocs_late_materialization &&
+		scanstate->ss.ps.plan->qual != NIL)
+	{
+		bool	   *filterproj = palloc0(ncol * sizeof(bool));
+
+		GetNeededColumnsForScan((Node *) scanstate->ss.ps.plan->qual,
+								filterproj, ncol);
+		scanstate->ss_aocs_filterproj = filterproj;
+	}
+}
+
+/*
+ * Build btree strategy scan keys from the clauses of the qual of the form
+ * "column op constant", for block skipping of an AOCS scan. Clauses that do
+ * not have that form are left out, so all the keys hold for the rows that
+ * pass the qual. The argument type of each key is in its sk_subtype.
+ */
+static ScanKey
+BuildAOCSSkipKeys(List *qual, int *nkeys)
+{
+	ScanKey		keys;
+	ListCell   *lc;
+
+	*nkeys = 0;
+	if (qual == NIL)
+		return NULL;
+
+	keys = (ScanKey) palloc(list_length(qual) * sizeof(ScanKeyData));
+
+	foreach(lc, qual)
+	{
+		OpExpr	   *opexpr = (OpExpr *) lfirst(lc);
+		Expr	   *leftop;
+		Expr	   *rightop;
+		Var		   *var;
+		Const	   *con;
+		Oid			opno;
+		Oid			opclass;
+		int			strategy;
+
+		if (!IsA(opexpr, OpExpr) || list_length(opexpr->args) != 2)
+			continue;
+
+		leftop = (Expr *) linitial(opexpr->args);
+		rightop = (Expr *) lsecond(opexpr->args);
+
+		if (IsA(leftop, Var) && IsA(rightop, Const))
+		{
+			var = (Var *) leftop;
+			con = (Const *) rightop;
+			opno = opexpr->opno;
+		}
+		else if (IsA(leftop, Const) && IsA(rightop, Var))
+		{
+			var = (Var *) rightop;
+			con = (Const *) leftop;
+			opno = get_commutator(opexpr->opno);
+		}
+		else
+			continue;
+
+		if (var->varattno <= 0 || con->constisnull || !OidIsValid(opno))
+			continue;
+
+		opclass = GetDefaultOpClass(var->vartype, BTREE_AM_OID);
+		if (!OidIsValid(opclass))
+			continue;
+
+		strategy = get_op_opfamily_strategy(opno, get_opclass_family(opclass));
+		if (strategy == 0)
+			continue;
+
+		ScanKeyEntryInitialize(&keys[(*nkeys)++],
+							   0,	/* flags */
+							   var->varattno,
+							   (StrategyNumber) strategy,
+							   con->consttype,	/* strategy subtype */
+							   InvalidOid,	/* collation */
+							   get_opcode(opno),
+							   con->constvalue);
+	}
+
+	return keys;
 }
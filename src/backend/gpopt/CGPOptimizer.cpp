@@ -17,6 +17,7 @@
 
 #include "gpopt/utils/CMemoryPoolPalloc.h"
 #include "gpopt/utils/CMemoryPoolPallocManager.h"
+#include "gpopt/utils/COptConfigCache.h"
 #include "gpopt/utils/COptTasks.h"
 
 // the following headers are needed to reference optimizer library initializers
@@ -194,6 +195,7 @@ CGPOptimizer::InitGPOPT()
 void
 CGPOptimizer::TerminateGPOPT()
 {
+	COptConfigCache::Shutdown();
 	gpopt_terminate();
 	gpdxl_terminate();
 	gpos_terminate();
@@ -194,6 +194,12 @@ CConfigParamMapping::SConfigMappingElem CConfigParamMapping::m_elements[] = {
 	 GPOS_WSZ_LIT(
 		 "Enable constant expression evaluation for integers in the optimizer")},
 
+	{EopttraceDisableNativeConstantExpressionEvaluation,
+	 &optimizer_enable_native_constant_expression_evaluation,
+	 true,	// m_negate_param
+	 GPOS_WSZ_LIT(
+		 "Fold comparisons and immutable built-in operators inside the optimizer")},
+
 	{EopttraceApplyLeftOuter2InnerUnionAllLeftAntiSemiJoinDisregardingStats,
 	 &optimizer_apply_left_outer_to_union_all_disregarding_stats,
 	 false,	 // m_negate_param
@@ -216,6 +222,18 @@ CConfigParamMapping::SConfigMappingElem CConfigParamMapping::m_elements[] = {
 	 GPOS_WSZ_LIT(
 		 "Discard plan alternatives where hash join has a redistribute motion child")},
 
+	{EopttraceEnableApproxCountDistinct,
+	 &optimizer_enable_approx_count_distinct,
+	 false,	 // m_negate_param
+	 GPOS_WSZ_LIT(
+		 "Estimate count(distinct) with HyperLogLog sketches instead of computing it exactly")},
+
+	{EopttraceEnableSemiJoinReduction,
+	 &optimizer_enable_semi_join_reduction,
+	 false,	 // m_negate_param
+	 GPOS_WSZ_LIT(
+		 "Enable plans that reduce the big side of a join with the keys of a filtered small side")},
+
 	{EopttraceMotionHazardHandling, &optimizer_enable_streaming_material,
 	 false,	 // m_fNegate
 	 GPOS_WSZ_LIT(
@@ -304,6 +322,90 @@ CConfigParamMapping::SConfigMappingElem CConfigParamMapping::m_elements[] = {
 
 };
 
+// config params that PackConfigParamInBitset maps to trace flags in addition
+// to m_elements and optimizer_xforms; a param used there must be listed here
+// too, or the trace flags cached by COptConfigCache go stale when it changes
+const BOOL *CConfigParamMapping::m_key_params[] = {
+	&optimizer_enable_indexjoin,
+	&optimizer_enable_bitmapscan,
+	&optimizer_enable_outerjoin_to_unionall_rewrite,
+	&optimizer_enable_assert_maxonerow,
+	&optimizer_enable_partial_index,
+	&optimizer_enable_hashjoin,
+	&optimizer_enable_dynamictablescan,
+	&optimizer_enable_tablescan,
+	&optimizer_enable_indexscan,
+	&optimizer_enable_indexonlyscan,
+	&optimizer_enable_hashagg,
+	&optimizer_enable_groupagg,
+	&optimizer_enable_mergejoin,
+	&optimizer_enable_associativity,
+};
+
+// enum config params that PackConfigParamInBitset maps to trace flags
+const INT *CConfigParamMapping::m_key_enum_params[] = {
+	&optimizer_join_order,
+	&optimizer_cost_model,
+};
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConfigParamMapping::ConfigParamKeySize
+//
+//	@doc:
+//		Size of the key built by PackConfigParamKey
+//
+//---------------------------------------------------------------------------
+ULONG
+CConfigParamMapping::ConfigParamKeySize(ULONG xform_id)
+{
+	return GPOS_ARRAY_SIZE(m_elements) + xform_id +
+		   GPOS_ARRAY_SIZE(m_key_params) +
+		   GPOS_ARRAY_SIZE(m_key_enum_params) * sizeof(INT);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConfigParamMapping::PackConfigParamKey
+//
+//	@doc:
+//		Pack the values of all GPDB config params that the result of
+//		PackConfigParamInBitset depends on into the given buffer of
+//		ConfigParamKeySize bytes. Two keys are equal iff the bitsets packed
+//		for them are equal.
+//
+//---------------------------------------------------------------------------
+void
+CConfigParamMapping::PackConfigParamKey(BYTE *key, ULONG xform_id)
+{
+	GPOS_ASSERT(NULL != key);
+
+	BYTE *pos = key;
+
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(m_elements); ul++)
+	{
+		*pos++ = (BYTE) *m_elements[ul].m_is_param;
+	}
+
+	for (ULONG ul = 0; ul < xform_id; ul++)
+	{
+		*pos++ = (BYTE) optimizer_xforms[ul];
+	}
+
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(m_key_params); ul++)
+	{
+		*pos++ = (BYTE) *m_key_params[ul];
+	}
+
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(m_key_enum_params); ul++)
+	{
+		clib::Memcpy(pos, m_key_enum_params[ul], sizeof(INT));
+		pos += sizeof(INT);
+	}
+
+	GPOS_ASSERT(pos == key + ConfigParamKeySize(xform_id));
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CConfigParamMapping::PackConfigParamInBitset
@@ -285,7 +285,8 @@ CTranslatorDXLToPlStmt::GetPlannedStmtFromDXL(const CDXLNode *dxlnode,
 	if (CMD_SELECT == m_cmd_type && NULL != dxlnode->GetDXLDirectDispatchInfo())
 	{
 		List *direct_dispatch_segids =
-			TranslateDXLDirectDispatchInfo(dxlnode->GetDXLDirectDispatchInfo());
+			TranslateDXLDirectDispatchInfo(dxlnode->GetDXLDirectDispatchInfo(),
+										   false /*allow_multiple_segments*/);
 		plan->directDispatch.contentIds = direct_dispatch_segids;
 		plan->directDispatch.isDirectDispatch = (NIL != direct_dispatch_segids);
 
@@ -4211,10 +4212,13 @@ CTranslatorDXLToPlStmt::TranslateDXLDml(
 	plan->nMotionNodes = child_plan->nMotionNodes;
 	plan->plan_node_id = m_dxl_to_plstmt_context->GetNextPlanId();
 
-	if (CMD_INSERT == m_cmd_type && 0 == plan->nMotionNodes)
+	// without motions, every row is written on the segment its distribution
+	// key hashes to, so the DML only needs the segments of the possible keys
+	if (0 == plan->nMotionNodes)
 	{
 		List *direct_dispatch_segids = TranslateDXLDirectDispatchInfo(
-			phy_dml_dxlop->GetDXLDirectDispatchInfo());
+			phy_dml_dxlop->GetDXLDirectDispatchInfo(),
+			true /*allow_multiple_segments*/);
 		plan->directDispatch.contentIds = direct_dispatch_segids;
 		plan->directDispatch.isDirectDispatch = (NIL != direct_dispatch_segids);
 	}
@@ -4240,12 +4244,14 @@ CTranslatorDXLToPlStmt::TranslateDXLDml(
 //		CTranslatorDXLToPlStmt::TranslateDXLDirectDispatchInfo
 //
 //	@doc:
-//		Translate the direct dispatch info
+//		Translate the direct dispatch info. Unless multiple segments are
+//		allowed, the values must all hash to the same segment
 //
 //---------------------------------------------------------------------------
 List *
 CTranslatorDXLToPlStmt::TranslateDXLDirectDispatchInfo(
-	CDXLDirectDispatchInfo *dxl_direct_dispatch_info)
+	CDXLDirectDispatchInfo *dxl_direct_dispatch_info,
+	BOOL allow_multiple_segments)
 {
 	if (!optimizer_enable_direct_dispatch || NULL == dxl_direct_dispatch_info)
 	{
@@ -4299,6 +4305,46 @@ CTranslatorDXLToPlStmt::TranslateDXLDirectDispatchInfo(
 		return segids_list;
 	}
 
+	if (allow_multiple_segments)
+	{
+		// collect the segments the values hash to, in order of content id
+		BOOL *is_target_segment = (BOOL *) gpdb::GPDBAlloc(
+			m_num_of_segments * sizeof(BOOL));
+		for (ULONG segid = 0; segid < m_num_of_segments; segid++)
+		{
+			is_target_segment[segid] = false;
+		}
+
+		ULONG num_target_segments = 0;
+		for (ULONG ul = 0; ul < length; ul++)
+		{
+			ULONG segid =
+				GetDXLDatumGPDBHash((*dispatch_identifier_datum_arrays)[ul]);
+			GPOS_ASSERT(segid < m_num_of_segments);
+			if (!is_target_segment[segid])
+			{
+				is_target_segment[segid] = true;
+				num_target_segments++;
+			}
+		}
+
+		List *segids_list = NIL;
+		if (num_target_segments < m_num_of_segments)
+		{
+			for (ULONG segid = 0; segid < m_num_of_segments; segid++)
+			{
+				if (is_target_segment[segid])
+				{
+					segids_list = gpdb::LAppendInt(segids_list, segid);
+				}
+			}
+		}
+		gpdb::GPDBFree(is_target_segment);
+
+		// values hashing to all segments are not worth a direct dispatch
+		return segids_list;
+	}
+
 	ULONG hash_code = GetDXLDatumGPDBHash(dxl_datum_array);
 	for (ULONG ul = 0; ul < length; ul++)
 	{
@@ -0,0 +1,407 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		COptConfigCache.cpp
+//
+//	@doc:
+//		Per-backend cache of the optimizer setup that only depends on GUCs
+//		and the search strategy file
+//
+//	@test:
+//
+//
+//---------------------------------------------------------------------------
+
+#include "gpopt/utils/COptConfigCache.h"
+
+#include <sys/stat.h>
+
+#include "gpopt/config/CConfigParamMapping.h"
+#include "gpopt/utils/gpdbdefs.h"
+
+#include "utils/fmgroids.h"
+#include "utils/guc.h"
+
+#include "gpos/common/CBitSet.h"
+#include "gpos/memory/CMemoryPoolManager.h"
+
+#include "gpopt/base/CWindowOids.h"
+#include "gpopt/engine/CCTEConfig.h"
+#include "gpopt/engine/CHint.h"
+
+using namespace gpos;
+using namespace gpopt;
+using namespace gpdxl;
+
+CMemoryPool *COptConfigCache::m_mp = NULL;
+
+CHAR *COptConfigCache::m_search_strategy_path = NULL;
+
+COptConfigCache::SFileStamp COptConfigCache::m_search_strategy_stamp;
+
+COptConfigCache::SFileStamp COptConfigCache::m_lookup_stamp;
+
+BOOL COptConfigCache::m_has_search_strategy = false;
+
+CSearchStageArray *COptConfigCache::m_search_strategy = NULL;
+
+BYTE *COptConfigCache::m_trace_flags_key = NULL;
+
+CBitSet *COptConfigCache::m_trace_flags = NULL;
+
+COptConfigCache::SConfigKey COptConfigCache::m_config_key;
+
+CHint *COptConfigCache::m_hint = NULL;
+
+CCTEConfig *COptConfigCache::m_cte_config = NULL;
+
+CWindowOids *COptConfigCache::m_window_oids = NULL;
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::Pmp
+//
+//	@doc:
+//		Return the pool for cached objects, creating it on first use
+//
+//---------------------------------------------------------------------------
+CMemoryPool *
+COptConfigCache::Pmp()
+{
+	if (NULL == m_mp)
+	{
+		m_mp = CMemoryPoolManager::GetMemoryPoolMgr()->CreateMemoryPool();
+	}
+
+	return m_mp;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::GetFileStamp
+//
+//	@doc:
+//		Get the current version of the given file
+//
+//---------------------------------------------------------------------------
+void
+COptConfigCache::GetFileStamp(const CHAR *path, SFileStamp *stamp)
+{
+	struct stat st;
+
+	clib::Memset(stamp, 0, sizeof(*stamp));
+
+	if (0 == stat(path, &st))
+	{
+		stamp->m_exists = true;
+		stamp->m_ino = st.st_ino;
+		stamp->m_size = st.st_size;
+		stamp->m_mtime = st.st_mtime;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::FEqualStamps
+//
+//	@doc:
+//		Are two versions of a file the same
+//
+//---------------------------------------------------------------------------
+BOOL
+COptConfigCache::FEqualStamps(const SFileStamp &stamp1,
+							  const SFileStamp &stamp2)
+{
+	return stamp1.m_exists == stamp2.m_exists && stamp1.m_ino == stamp2.m_ino &&
+		   stamp1.m_size == stamp2.m_size && stamp1.m_mtime == stamp2.m_mtime;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::PdrgpssCopy
+//
+//	@doc:
+//		Copy search stages into the given pool; the copies don't share
+//		anything with the originals
+//
+//---------------------------------------------------------------------------
+CSearchStageArray *
+COptConfigCache::PdrgpssCopy(CMemoryPool *mp, const CSearchStageArray *pdrgpss)
+{
+	GPOS_ASSERT(NULL != pdrgpss);
+
+	CSearchStageArray *pdrgpssCopy = GPOS_NEW(mp) CSearchStageArray(mp);
+	const ULONG size = pdrgpss->Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		CSearchStage *pss = (*pdrgpss)[ul];
+		CXformSet *xform_set =
+			GPOS_NEW(mp) CXformSet(mp, *pss->GetXformSet());
+
+		pdrgpssCopy->Append(GPOS_NEW(mp) CSearchStage(
+			xform_set, pss->TimeThreshold(), pss->CostThreshold()));
+	}
+
+	return pdrgpssCopy;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::ResetSearchStrategy
+//
+//	@doc:
+//		Release the cached search strategy
+//
+//---------------------------------------------------------------------------
+void
+COptConfigCache::ResetSearchStrategy()
+{
+	CRefCount::SafeRelease(m_search_strategy);
+	m_search_strategy = NULL;
+	GPOS_DELETE_ARRAY(m_search_strategy_path);
+	m_search_strategy_path = NULL;
+	m_has_search_strategy = false;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::FLookupSearchStrategy
+//
+//	@doc:
+//		Look up the search strategy loaded from the given file. Returns
+//		false if it was not loaded yet, or the file changed since; otherwise
+//		returns a copy of the strategy in the given pool, NULL standing for
+//		the default strategy.
+//
+//---------------------------------------------------------------------------
+BOOL
+COptConfigCache::FLookupSearchStrategy(CMemoryPool *mp, const CHAR *path,
+									   CSearchStageArray **ppdrgpss)
+{
+	GPOS_ASSERT(NULL != path);
+	GPOS_ASSERT(NULL != ppdrgpss);
+
+	// stat the file before it is parsed, so that a change made while it is
+	// being parsed is noticed by the next lookup
+	GetFileStamp(path, &m_lookup_stamp);
+
+	if (!m_has_search_strategy ||
+		0 != clib::Strcmp(path, m_search_strategy_path) ||
+		!FEqualStamps(m_lookup_stamp, m_search_strategy_stamp))
+	{
+		return false;
+	}
+
+	*ppdrgpss = NULL;
+	if (NULL != m_search_strategy)
+	{
+		*ppdrgpss = PdrgpssCopy(mp, m_search_strategy);
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::StoreSearchStrategy
+//
+//	@doc:
+//		Remember the search strategy loaded from the file passed to the
+//		preceding FLookupSearchStrategy call
+//
+//---------------------------------------------------------------------------
+void
+COptConfigCache::StoreSearchStrategy(const CHAR *path,
+									 const CSearchStageArray *pdrgpss)
+{
+	GPOS_ASSERT(NULL != path);
+
+	CMemoryPool *mp = Pmp();
+
+	ResetSearchStrategy();
+
+	const ULONG length = clib::Strlen(path);
+	CHAR *path_copy = GPOS_NEW_ARRAY(mp, CHAR, length + 1);
+	clib::Strncpy(path_copy, path, length + 1);
+
+	CSearchStageArray *pdrgpssCopy = NULL;
+	if (NULL != pdrgpss)
+	{
+		pdrgpssCopy = PdrgpssCopy(mp, pdrgpss);
+	}
+
+	m_search_strategy_path = path_copy;
+	m_search_strategy = pdrgpssCopy;
+	m_search_strategy_stamp = m_lookup_stamp;
+	m_has_search_strategy = true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::PbsTraceFlags
+//
+//	@doc:
+//		Trace flags packed from the current optimizer GUCs. The bitset is
+//		repacked only if one of the GUCs it depends on changed.
+//
+//---------------------------------------------------------------------------
+CBitSet *
+COptConfigCache::PbsTraceFlags(CMemoryPool *mp, ULONG xform_id)
+{
+	const ULONG key_size = CConfigParamMapping::ConfigParamKeySize(xform_id);
+	BYTE *key = GPOS_NEW_ARRAY(mp, BYTE, key_size);
+	CConfigParamMapping::PackConfigParamKey(key, xform_id);
+
+	if (NULL == m_trace_flags ||
+		0 != clib::Memcmp(key, m_trace_flags_key, key_size))
+	{
+		CMemoryPool *cache_mp = Pmp();
+		CBitSet *trace_flags =
+			CConfigParamMapping::PackConfigParamInBitset(cache_mp, xform_id);
+
+		if (NULL == m_trace_flags_key)
+		{
+			m_trace_flags_key = GPOS_NEW_ARRAY(cache_mp, BYTE, key_size);
+		}
+		clib::Memcpy(m_trace_flags_key, key, key_size);
+
+		CRefCount::SafeRelease(m_trace_flags);
+		m_trace_flags = trace_flags;
+	}
+
+	GPOS_DELETE_ARRAY(key);
+
+	m_trace_flags->AddRef();
+	return m_trace_flags;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::GetConfigKey
+//
+//	@doc:
+//		Read the current values of the GUCs the configuration objects are
+//		built from
+//
+//---------------------------------------------------------------------------
+void
+COptConfigCache::GetConfigKey(SConfigKey *key)
+{
+	clib::Memset(key, 0, sizeof(*key));
+
+	key->m_join_arity_for_associativity_commutativity =
+		(ULONG) optimizer_join_arity_for_associativity_commutativity;
+	key->m_array_expansion_threshold =
+		(ULONG) optimizer_array_expansion_threshold;
+	key->m_join_order_threshold = (ULONG) optimizer_join_order_threshold;
+	key->m_broadcast_threshold =
+		(ULONG) optimizer_penalize_broadcast_threshold;
+	key->m_push_group_by_below_setop_threshold =
+		(ULONG) optimizer_push_group_by_below_setop_threshold;
+	key->m_xform_bind_threshold = (ULONG) optimizer_xform_bind_threshold;
+	key->m_skew_factor = (ULONG) optimizer_skew_factor;
+	key->m_cte_inlining_cutoff = (ULONG) optimizer_cte_inlining_bound;
+	key->m_optimization_time_budget = (ULONG) optimizer_time_budget;
+	key->m_optimization_memory_budget = (ULONG) optimizer_memory_budget;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::GetStaticConfig
+//
+//	@doc:
+//		Configuration objects that are only read during optimization,
+//		rebuilt only if one of the GUCs they depend on changed. The plan
+//		enumeration and statistics configurations, and the cost model,
+//		record state of the optimization they are used for, so they are
+//		not cached.
+//
+//---------------------------------------------------------------------------
+void
+COptConfigCache::GetStaticConfig(CHint **pphint, CCTEConfig **ppcteconf,
+								 CWindowOids **ppwindowoids)
+{
+	GPOS_ASSERT(NULL != pphint);
+	GPOS_ASSERT(NULL != ppcteconf);
+	GPOS_ASSERT(NULL != ppwindowoids);
+
+	SConfigKey key;
+	GetConfigKey(&key);
+
+	if (NULL == m_hint ||
+		0 != clib::Memcmp(&key, &m_config_key, sizeof(SConfigKey)))
+	{
+		CMemoryPool *mp = Pmp();
+
+		CHint *hint = GPOS_NEW(mp)
+			CHint(key.m_join_arity_for_associativity_commutativity,
+				  key.m_array_expansion_threshold, key.m_join_order_threshold,
+				  key.m_broadcast_threshold,
+				  false, /* don't create Assert nodes for constraints, we'll
+						  * enforce them ourselves in the executor */
+				  key.m_push_group_by_below_setop_threshold,
+				  key.m_xform_bind_threshold, key.m_skew_factor,
+				  key.m_optimization_time_budget,
+				  key.m_optimization_memory_budget);
+		CCTEConfig *cte_config =
+			GPOS_NEW(mp) CCTEConfig(key.m_cte_inlining_cutoff);
+
+		CRefCount::SafeRelease(m_hint);
+		CRefCount::SafeRelease(m_cte_config);
+		m_hint = hint;
+		m_cte_config = cte_config;
+		m_config_key = key;
+	}
+
+	if (NULL == m_window_oids)
+	{
+		m_window_oids = GPOS_NEW(Pmp())
+			CWindowOids(OID(F_WINDOW_ROW_NUMBER), OID(F_WINDOW_RANK));
+	}
+
+	m_hint->AddRef();
+	m_cte_config->AddRef();
+	m_window_oids->AddRef();
+
+	*pphint = m_hint;
+	*ppcteconf = m_cte_config;
+	*ppwindowoids = m_window_oids;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptConfigCache::Shutdown
+//
+//	@doc:
+//		Release all cached objects
+//
+//---------------------------------------------------------------------------
+void
+COptConfigCache::Shutdown()
+{
+	if (NULL == m_mp)
+	{
+		return;
+	}
+
+	ResetSearchStrategy();
+
+	CRefCount::SafeRelease(m_trace_flags);
+	m_trace_flags = NULL;
+	GPOS_DELETE_ARRAY(m_trace_flags_key);
+	m_trace_flags_key = NULL;
+
+	CRefCount::SafeRelease(m_hint);
+	m_hint = NULL;
+	CRefCount::SafeRelease(m_cte_config);
+	m_cte_config = NULL;
+	CRefCount::SafeRelease(m_window_oids);
+	m_window_oids = NULL;
+
+	CMemoryPoolManager::GetMemoryPoolMgr()->Destroy(m_mp);
+	m_mp = NULL;
+}
+
+// EOF
@@ -21,6 +21,7 @@
 #include "gpopt/config/CConfigParamMapping.h"
 #include "gpopt/engine/CHint.h"
 #include "gpopt/eval/CConstExprEvaluatorDXL.h"
+#include "gpopt/eval/CConstExprEvaluatorNative.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
 #include "gpopt/translate/CContextDXLToPlStmt.h"
 #include "gpopt/translate/CTranslatorDXLToExpr.h"
@@ -30,6 +31,7 @@
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
 #include "gpopt/translate/CTranslatorUtils.h"
 #include "gpopt/utils/CConstExprEvaluatorProxy.h"
+#include "gpopt/utils/COptConfigCache.h"
 #include "gpopt/utils/gpdbdefs.h"
 
 #include "cdb/cdbvars.h"
@@ -47,6 +49,7 @@
 #include "gpdbcost/CCostModelGPDB.h"
 #include "gpopt/base/CAutoOptCtxt.h"
 #include "gpopt/engine/CCTEConfig.h"
+#include "gpopt/engine/CEngine.h"
 #include "gpopt/engine/CEnumeratorConfig.h"
 #include "gpopt/engine/CStatisticsConfig.h"
 #include "gpopt/exception.h"
@@ -316,7 +319,8 @@ COptTasks::ConvertToPlanStmtFromDXL(
 //		COptTasks::LoadSearchStrategy
 //
 //	@doc:
-//		Load search strategy from given file
+//		Load search strategy from given file. The parsed strategy is cached
+//		until the file changes.
 //
 //---------------------------------------------------------------------------
 CSearchStageArray *
@@ -325,19 +329,25 @@ COptTasks::LoadSearchStrategy(CMemoryPool *mp, char *path)
 	CSearchStageArray *search_strategy_arr = NULL;
 	CParseHandlerDXL *dxl_parse_handler = NULL;
 
+	if (NULL == path)
+	{
+		return NULL;
+	}
+
+	if (COptConfigCache::FLookupSearchStrategy(mp, path, &search_strategy_arr))
+	{
+		return search_strategy_arr;
+	}
+
 	GPOS_TRY
 	{
-		if (NULL != path)
+		dxl_parse_handler = CDXLUtils::GetParseHandlerForDXLFile(mp, path, NULL);
+		if (NULL != dxl_parse_handler)
 		{
-			dxl_parse_handler =
-				CDXLUtils::GetParseHandlerForDXLFile(mp, path, NULL);
-			if (NULL != dxl_parse_handler)
-			{
-				elog(DEBUG2, "\n[OPT]: Using search strategy in (%s)", path);
+			elog(DEBUG2, "\n[OPT]: Using search strategy in (%s)", path);
 
-				search_strategy_arr = dxl_parse_handler->GetSearchStageArray();
-				search_strategy_arr->AddRef();
-			}
+			search_strategy_arr = dxl_parse_handler->GetSearchStageArray();
+			search_strategy_arr->AddRef();
 		}
 	}
 	GPOS_CATCH_EX(ex)
@@ -353,6 +363,8 @@ COptTasks::LoadSearchStrategy(CMemoryPool *mp, char *path)
 
 	GPOS_DELETE(dxl_parse_handler);
 
+	COptConfigCache::StoreSearchStrategy(path, search_strategy_arr);
+
 	return search_strategy_arr;
 }
 
@@ -376,17 +388,12 @@ COptTasks::CreateOptimizerConfig(CMemoryPool *mp, ICostModel *cost_model)
 	DOUBLE damping_factor_join = (DOUBLE) optimizer_damping_factor_join;
 	DOUBLE damping_factor_groupby = (DOUBLE) optimizer_damping_factor_groupby;
 
-	ULONG cte_inlining_cutoff = (ULONG) optimizer_cte_inlining_bound;
-	ULONG join_arity_for_associativity_commutativity =
-		(ULONG) optimizer_join_arity_for_associativity_commutativity;
-	ULONG array_expansion_threshold =
-		(ULONG) optimizer_array_expansion_threshold;
-	ULONG join_order_threshold = (ULONG) optimizer_join_order_threshold;
-	ULONG broadcast_threshold = (ULONG) optimizer_penalize_broadcast_threshold;
-	ULONG push_group_by_below_setop_threshold =
-		(ULONG) optimizer_push_group_by_below_setop_threshold;
-	ULONG xform_bind_threshold = (ULONG) optimizer_xform_bind_threshold;
-	ULONG skew_factor = (ULONG) optimizer_skew_factor;
+	// hints, CTE config and window oids are only read during optimization,
+	// so they are shared between queries until their GUCs change
+	CHint *hint = NULL;
+	CCTEConfig *cte_config = NULL;
+	CWindowOids *window_oids = NULL;
+	COptConfigCache::GetStaticConfig(&hint, &cte_config, &window_oids);
 
 	return GPOS_NEW(mp) COptimizerConfig(
 		GPOS_NEW(mp)
@@ -394,16 +401,7 @@ COptTasks::CreateOptimizerConfig(CMemoryPool *mp, ICostModel *cost_model)
 		GPOS_NEW(mp)
 			CStatisticsConfig(mp, damping_factor_filter, damping_factor_join,
 							  damping_factor_groupby, MAX_STATS_BUCKETS),
-		GPOS_NEW(mp) CCTEConfig(cte_inlining_cutoff), cost_model,
-		GPOS_NEW(mp)
-			CHint(join_arity_for_associativity_commutativity,
-				  array_expansion_threshold, join_order_threshold,
-				  broadcast_threshold,
-				  false, /* don't create Assert nodes for constraints, we'll
-								      * enforce them ourselves in the executor */
-				  push_group_by_below_setop_threshold, xform_bind_threshold,
-				  skew_factor),
-		GPOS_NEW(mp) CWindowOids(OID(F_WINDOW_ROW_NUMBER), OID(F_WINDOW_RANK)));
+		cte_config, cost_model, hint, window_oids);
 }
 
 //---------------------------------------------------------------------------
@@ -526,8 +524,7 @@ COptTasks::OptimizeTask(void *ptr)
 	GPOS_TRY
 	{
 		// set trace flags
-		trace_flags = CConfigParamMapping::PackConfigParamInBitset(
-			mp, CXform::ExfSentinel);
+		trace_flags = COptConfigCache::PbsTraceFlags(mp, CXform::ExfSentinel);
 		SetTraceflags(mp, trace_flags, &enabled_trace_flags,
 					  &disabled_trace_flags);
 
@@ -555,8 +552,20 @@ COptTasks::OptimizeTask(void *ptr)
 			COptimizerConfig *optimizer_config =
 				CreateOptimizerConfig(mp, cost_model);
 			CConstExprEvaluatorProxy expr_eval_proxy(mp, &mda);
+
+			// fold what we can inside the optimizer, and go through the
+			// executor only for the remaining constant expressions
+#ifdef HAVE_INT64_TIMESTAMP
+			BOOL integer_datetimes = true;
+#else
+			BOOL integer_datetimes = false;
+#endif
 			IConstExprEvaluator *expr_evaluator =
-				GPOS_NEW(mp) CConstExprEvaluatorDXL(mp, &mda, &expr_eval_proxy);
+				GPOS_NEW(mp) CConstExprEvaluatorNative(
+					mp,
+					GPOS_NEW(mp)
+						CConstExprEvaluatorDXL(mp, &mda, &expr_eval_proxy),
+					integer_datetimes);
 
 			CDXLNode *query_dxl =
 				query_to_dxl_translator->TranslateQueryToDXL();
@@ -578,11 +587,21 @@ COptTasks::OptimizeTask(void *ptr)
 			CAutoTraceFlag atf2(EopttraceUseLegacyOpfamilies,
 								use_legacy_opfamilies);
 
+			ULONG budget_truncations = CEngine::UlBudgetTruncations();
 			plan_dxl = COptimizer::PdxlnOptimize(
 				mp, &mda, query_dxl, query_output_dxlnode_array,
 				cte_dxlnode_array, expr_evaluator, num_segments, gp_session_id,
 				gp_command_count, search_strategy_arr, optimizer_config);
 
+			if (budget_truncations != CEngine::UlBudgetTruncations())
+			{
+				elog(LOG,
+					 "GPORCA exhausted its optimization budget and returned "
+					 "the best plan found so far (%u truncated optimizations "
+					 "in this backend)",
+					 CEngine::UlBudgetTruncations());
+			}
+
 			if (opt_ctxt->m_should_serialize_plan_dxl)
 			{
 				// serialize DXL to xml
@@ -483,14 +483,18 @@ CCostModelGPDB::CostCTEProducer(CMemoryPool *mp, CExpressionHandle &exprhdl,
 
 	COperator::EOperatorId op_id = popChild->Eopid();
 	if (COperator::EopPhysicalSpool != op_id &&
-		COperator::EopPhysicalSort != op_id)
+		COperator::EopPhysicalSort != op_id &&
+		!GPOS_FTRACE(EopttraceExperimentalCostModel))
 	{
 		// no materialize needed
 		return cost;
 	}
 
 	// a materialize (spool) node is added during DXL->PlStmt translation,
-	// we need to add the cost of writing the tuples to disk
+	// we need to add the cost of writing the tuples to disk. The
+	// experimental cost model charges it for every producer: a child that
+	// is neither a spool nor a sort gets a materialize node on top of it,
+	// whose tuples are written all the same
 	const CDouble dMaterializeCostUnit =
 		pcmgpdb->GetCostModelParams()
 			->PcpLookup(CCostModelParamsGPDB::EcpMaterializeCostUnit)
@@ -541,6 +545,15 @@ CCostModelGPDB::CostCTEConsumer(CMemoryPool *,	// mp
 	GPOS_ASSERT(0 < dOutputTupCostUnit);
 	GPOS_ASSERT(0 < dTableScanCostUnit);
 
+	if (GPOS_FTRACE(EopttraceExperimentalCostModel))
+	{
+		// a consumer reads the tuplestore written by the producer, there is
+		// no relation to open; charging the initial scan cost would make
+		// every consumer look as expensive to start as the inlined scan
+		return CCost(pci->NumRebinds() * pci->Rows() * pci->Width() *
+					 (dTableScanCostUnit + dOutputTupCostUnit));
+	}
+
 	return CCost(pci->NumRebinds() *
 				 (dInitScan + pci->Rows() * pci->Width() *
 								  (dTableScanCostUnit + dOutputTupCostUnit)));
@@ -12,6 +12,7 @@
 #define GPOPT_CCTEInfo_H
 
 #include "gpos/base.h"
+#include "gpos/common/CBitSet.h"
 #include "gpos/common/CHashMap.h"
 #include "gpos/common/CStack.h"
 
@@ -196,6 +197,9 @@ private:
 	// whether or not to inline CTE consumers
 	BOOL m_fEnableInlining;
 
+	// CTEs whose consumers are not inlined even if inlining is enabled
+	CBitSet *m_pbsNoInlining;
+
 	// consumers inside each cte/main query
 	UlongToProducerConsumerMap *m_phmulprodconsmap;
 
@@ -275,6 +279,25 @@ public:
 		return m_fEnableInlining;
 	}
 
+	// disable inlining of the consumers of the given CTE
+	void
+	DisableInlining(ULONG ulCTEId)
+	{
+		(void) m_pbsNoInlining->ExchangeSet(ulCTEId);
+	}
+
+	// whether or not to inline the consumers of the given CTE
+	BOOL
+	FEnableInlining(ULONG ulCTEId) const
+	{
+		return m_fEnableInlining && !m_pbsNoInlining->Get(ulCTEId);
+	}
+
+	// disable inlining of CTEs, picking first the ones whose inlining
+	// contributes most, until the number of inlinable CTEs in the given
+	// query is within the given cutoff
+	void LimitInlining(CExpression *pexpr, ULONG ulCutoff);
+
 	// mark unused CTEs
 	void MarkUnusedCTEs();
 
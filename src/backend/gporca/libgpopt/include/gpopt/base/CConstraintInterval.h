@@ -18,6 +18,7 @@
 #include "gpos/task/CAutoTraceFlag.h"
 
 #include "gpopt/base/CConstraint.h"
+#include "gpopt/base/CPointSet.h"
 #include "gpopt/base/CRange.h"
 #include "gpopt/operators/CScalarArrayCmp.h"
 #include "gpopt/operators/CScalarConst.h"
@@ -26,9 +27,6 @@
 
 namespace gpopt
 {
-// range array
-typedef CDynamicPtrArray<CRange, CleanupRelease> CRangeArray;
-
 using namespace gpos;
 using namespace gpmd;
 
@@ -42,6 +40,11 @@ using namespace gpmd;
 //		If x has a CConstraintInterval C on it, this means that x is in the
 //		ranges contained in C.
 //
+//		An interval made of points only, such as one derived from an IN
+//		list, keeps them in a point set instead, and builds the equivalent
+//		[x,x] ranges only when they are asked for. Set operations between
+//		such intervals merge the point sets directly.
+//
 //---------------------------------------------------------------------------
 class CConstraintInterval : public CConstraint
 {
@@ -49,8 +52,11 @@ private:
 	// column referenced in this constraint
 	const CColRef *m_pcr;
 
-	// array of ranges
-	CRangeArray *m_pdrgprng;
+	// array of ranges, built on demand if the interval has a point set
+	mutable CRangeArray *m_pdrgprng;
+
+	// points of the interval if it contains points only, NULL otherwise
+	CPointSet *m_ppset;
 
 	// does the interval include the null value
 	BOOL m_fIncludesNull;
@@ -58,6 +64,9 @@ private:
 	// hidden copy ctor
 	CConstraintInterval(const CConstraintInterval &);
 
+	// number of ranges, or points, in the interval
+	ULONG UlRanges() const;
+
 	// adds ranges from a source array to a destination array, starting
 	// at the range with the given index
 	void AddRemainingRanges(CMemoryPool *mp, CRangeArray *pdrgprngSrc,
@@ -122,6 +131,10 @@ public:
 	CConstraintInterval(CMemoryPool *mp, const CColRef *colref,
 						CRangeArray *pdrgprng, BOOL is_null);
 
+	// ctor for an interval made of points only
+	CConstraintInterval(CMemoryPool *mp, const CColRef *colref,
+						CPointSet *ppset, BOOL is_null);
+
 	// dtor
 	virtual ~CConstraintInterval();
 
@@ -140,10 +153,13 @@ public:
 	}
 
 	// all ranges in interval
-	CRangeArray *
-	Pdrgprng() const
+	CRangeArray *Pdrgprng() const;
+
+	// points in interval, NULL unless the interval is made of points only
+	CPointSet *
+	Ppset() const
 	{
-		return m_pdrgprng;
+		return m_ppset;
 	}
 
 	// does the interval include the null value
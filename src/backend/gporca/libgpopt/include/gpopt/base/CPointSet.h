@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CPointSet.h
+//
+//	@doc:
+//		Compact representation of a sorted set of points, used by interval
+//		constraints derived from large IN lists
+//---------------------------------------------------------------------------
+#ifndef GPOPT_CPointSet_H
+#define GPOPT_CPointSet_H
+
+#include "gpos/base.h"
+#include "gpos/common/CRefCount.h"
+#include "gpos/common/DbgPrintMixin.h"
+
+#include "gpopt/base/CRange.h"
+#include "naucrates/base/IDatum.h"
+
+namespace gpopt
+{
+using namespace gpos;
+using namespace gpnaucrates;
+
+// fwd declarations
+class IComparator;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CPointSet
+//
+//	@doc:
+//		A sorted array of distinct, non-null datums. It stands in for an array
+//		of [x,x] ranges: set operations merge the sorted arrays and membership
+//		is a binary search, so neither allocates a range per point. If all
+//		points are of an integer type, their integer values are kept next to
+//		them and compared instead of the datums.
+//
+//---------------------------------------------------------------------------
+class CPointSet : public CRefCount, public DbgPrintMixin<CPointSet>
+{
+private:
+	// datum comparator
+	const IComparator *m_pcomp;
+
+	// sorted, distinct points
+	IDatumArray *m_pdrgpdatum;
+
+	// integer values of the points, NULL if not all points are integers
+	LINT *m_rglValues;
+
+	// hidden copy ctor
+	CPointSet(const CPointSet &);
+
+	// compare the given point of this set to the given point of another set
+	INT ICompare(ULONG ul, const CPointSet *pps, ULONG ulOther) const;
+
+	// compare the given point of this set to the given datum
+	INT ICompare(ULONG ul, IDatum *datum) const;
+
+	// does the given range end before the given point of this set
+	BOOL FRangeEndsBefore(const CRange *prange, ULONG ul) const;
+
+	// does the given range contain the given point of this set
+	BOOL FRangeContains(const CRange *prange, ULONG ul) const;
+
+	// append the given point of this set to the given array
+	void AppendPoint(IDatumArray *pdrgpdatum, ULONG ul) const;
+
+public:
+	// ctor; takes ownership of the array, which must be sorted and free of
+	// duplicates and nulls
+	CPointSet(CMemoryPool *mp, const IComparator *pcomp,
+			  IDatumArray *pdrgpdatum);
+
+	// dtor
+	virtual ~CPointSet();
+
+	// number of points
+	ULONG
+	Size() const
+	{
+		return m_pdrgpdatum->Size();
+	}
+
+	// point at the given position
+	IDatum *
+	operator[](ULONG ul) const
+	{
+		return (*m_pdrgpdatum)[ul];
+	}
+
+	// does the set contain the given datum
+	BOOL FContains(IDatum *datum) const;
+
+	// points in both sets
+	CPointSet *PpsIntersect(CMemoryPool *mp, const CPointSet *pps) const;
+
+	// points in either set
+	CPointSet *PpsUnion(CMemoryPool *mp, const CPointSet *pps) const;
+
+	// points in this set but not in the given one
+	CPointSet *PpsDifference(CMemoryPool *mp, const CPointSet *pps) const;
+
+	// points that fall inside (or outside) the given sorted, disjoint ranges
+	CPointSet *PpsFilter(CMemoryPool *mp, CRangeArray *pdrgprng,
+						 BOOL fInside) const;
+
+	// one [x,x] range per point
+	CRangeArray *PdrgprngPoints(CMemoryPool *mp) const;
+
+	// print
+	IOstream &OsPrint(IOstream &os) const;
+
+};	// class CPointSet
+
+}  // namespace gpopt
+
+#endif	// !GPOPT_CPointSet_H
+
+// EOF
@@ -212,6 +212,9 @@ operator<<(IOstream &os, CRange &range)
 {
 	return range.OsPrint(os);
 }
+
+// range array
+typedef CDynamicPtrArray<CRange, CleanupRelease> CRangeArray;
 }  // namespace gpopt
 
 #endif	// !GPOPT_CRange_H
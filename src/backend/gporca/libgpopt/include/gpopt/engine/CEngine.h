@@ -12,6 +12,7 @@
 #define GPOPT_CEngine_H
 
 #include "gpos/base.h"
+#include "gpos/common/CWallClock.h"
 
 #include "gpopt/search/CMemo.h"
 #include "gpopt/search/CSearchStage.h"
@@ -44,6 +45,28 @@ class CEnumeratorConfig;
 //---------------------------------------------------------------------------
 class CEngine : public DbgPrintMixin<CEngine>
 {
+public:
+	// statistics of an optimization, used for benchmarking the optimizer
+	struct SOptimizationStats
+	{
+		// number of memo groups, duplicate groups and group expressions
+		ULONG m_ulGroups;
+		ULONG m_ulDuplicateGroups;
+		ULONG m_ulGroupExprs;
+
+		// search stage the search terminated at
+		ULONG m_ulSearchStage;
+
+		// was the optimization cut short by the budget
+		BOOL m_fBudgetExhausted;
+
+		// number of applications of each xform
+		ULONG_PTR m_rgulpXformCalls[CXform::ExfSentinel];
+
+		// number of alternatives generated by each xform
+		ULONG_PTR m_rgulpXformResults[CXform::ExfSentinel];
+	};
+
 private:
 	// memory pool
 	CMemoryPool *m_mp;
@@ -80,6 +103,33 @@ private:
 	// number of alternatives generated by each xform
 	UlongPtrArray *m_pdrgpulpXformResults;
 
+	// the following variables are used for enforcing the optimization budget
+
+	// wall clock time budget in milliseconds, gpos::ulong_max if unlimited
+	ULONG m_ulTimeBudget;
+
+	// memory pool size budget in bytes, 0 if unlimited
+	ULLONG m_ullMemoryBudget;
+
+	// wall clock time elapsed since the start of optimization
+	CWallClock m_timerBudget;
+
+	// number of budget checks done so far
+	ULONG m_ulBudgetChecks;
+
+	// has the budget been exhausted
+	BOOL m_fBudgetExhausted;
+
+	// is the remainder of the memo being implemented after the budget
+	// was exhausted
+	BOOL m_fImplementingRemainder;
+
+	// number of optimizations cut short by the budget in this process
+	static ULONG m_ulBudgetTruncations;
+
+	// statistics of the last optimization run in this process
+	static SOptimizationStats m_ostatsLast;
+
 #ifdef GPOS_DEBUG
 
 	// a set of internal debugging function used for recursive
@@ -155,6 +205,27 @@ private:
 	// process trace flags after optimization is complete
 	void ProcessTraceFlags();
 
+	// is an optimization budget configured
+	BOOL
+	FBudgeted() const
+	{
+		return gpos::ulong_max != m_ulTimeBudget || 0 != m_ullMemoryBudget;
+	}
+
+	// number of search stages of the search strategy, excluding the stage
+	// reserved for implementing the memo after the budget is exhausted
+	ULONG
+	UlStrategyStages() const
+	{
+		return m_search_stage_array->Size() - (FBudgeted() ? 1 : 0);
+	}
+
+	// check if the optimization budget has been exhausted
+	BOOL FBudgetExhausted();
+
+	// run the current search stage and record the best plan it found
+	void OptimizeSearchStage(CSchedulerContext *psc);
+
 	// check if search has terminated
 	BOOL
 	FSearchTerminated() const
@@ -353,6 +424,29 @@ public:
 		return m_search_stage_array->Size();
 	}
 
+	// check if the current search stage has to stop, either because it
+	// timed out or because the optimization budget is exhausted
+	BOOL
+	FStageTerminated()
+	{
+		return PssCurrent()->FTimedOut() ||
+			   (!m_fImplementingRemainder && FBudgetExhausted());
+	}
+
+	// number of optimizations cut short by the budget in this process
+	static ULONG
+	UlBudgetTruncations()
+	{
+		return m_ulBudgetTruncations;
+	}
+
+	// statistics of the last optimization run in this process
+	static const SOptimizationStats &
+	OstatsLast()
+	{
+		return m_ostatsLast;
+	}
+
 	// set of xforms of current stage
 	CXformSet *
 	PxfsCurrentStage() const
@@ -55,13 +55,18 @@ private:
 	CHint(const CHint &);
 	ULONG m_ulSkewFactor;
 
+	ULONG m_ulOptimizationTimeBudget;
+
+	ULONG m_ulOptimizationMemoryBudget;
+
 public:
 	// ctor
 	CHint(ULONG join_arity_for_associativity_commutativity,
 		  ULONG array_expansion_threshold, ULONG ulJoinOrderDPLimit,
 		  ULONG broadcast_threshold, BOOL enforce_constraint_on_dml,
 		  ULONG push_group_by_below_setop_threshold, ULONG xform_bind_threshold,
-		  ULONG skew_factor)
+		  ULONG skew_factor, ULONG optimization_time_budget = 0,
+		  ULONG optimization_memory_budget = 0)
 		: m_ulJoinArityForAssociativityCommutativity(
 			  join_arity_for_associativity_commutativity),
 		  m_ulArrayExpansionThreshold(array_expansion_threshold),
@@ -71,7 +76,9 @@ public:
 		  m_ulPushGroupByBelowSetopThreshold(
 			  push_group_by_below_setop_threshold),
 		  m_ulXform_bind_threshold(xform_bind_threshold),
-		  m_ulSkewFactor(skew_factor)
+		  m_ulSkewFactor(skew_factor),
+		  m_ulOptimizationTimeBudget(optimization_time_budget),
+		  m_ulOptimizationMemoryBudget(optimization_memory_budget)
 	{
 	}
 
@@ -143,6 +150,22 @@ public:
 		return m_ulSkewFactor;
 	}
 
+	// Wall clock time in milliseconds the search may take before the engine
+	// stops exploring and implements what the memo holds. 0 disables.
+	ULONG
+	UlOptimizationTimeBudget() const
+	{
+		return m_ulOptimizationTimeBudget;
+	}
+
+	// Size in KB the optimizer memory pool may grow to before the engine
+	// stops exploring and implements what the memo holds. 0 disables.
+	ULONG
+	UlOptimizationMemoryBudget() const
+	{
+		return m_ulOptimizationMemoryBudget;
+	}
+
 	// generate default hint configurations, which disables sort during insert on
 	// append only row-oriented partitioned tables by default
 	static CHint *
@@ -156,7 +179,9 @@ public:
 			true,								 /* enforce_constraint_on_dml */
 			PUSH_GROUP_BY_BELOW_SETOP_THRESHOLD, /* push_group_by_below_setop_threshold */
 			XFORM_BIND_THRESHOLD,				 /* xform_bind_threshold */
-			SKEW_FACTOR							 /* skew_factor */
+			SKEW_FACTOR,						 /* skew_factor */
+			0,									 /* optimization_time_budget */
+			0									 /* optimization_memory_budget */
 		);
 	}
 
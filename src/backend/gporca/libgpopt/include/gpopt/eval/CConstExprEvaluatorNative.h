@@ -0,0 +1,201 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CConstExprEvaluatorNative.h
+//
+//	@doc:
+//		Constant expression evaluator that folds immutable built-in operators
+//		and functions over IDatum inside the optimizer, and delegates
+//		everything else to a fallback evaluator
+//
+//	@owner:
+//
+//
+//	@test:
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPOPT_CConstExprEvaluatorNative_H
+#define GPOPT_CConstExprEvaluatorNative_H
+
+#include "gpos/base.h"
+
+#include "gpopt/eval/IConstExprEvaluator.h"
+#include "gpopt/operators/CExpression.h"
+
+namespace gpopt
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CConstExprEvaluatorNative
+//
+//	@doc:
+//		Constant expression evaluator that computes comparisons and a set of
+//		immutable built-in operators/functions (integer arithmetic, date and
+//		timestamp arithmetic) directly on IDatum values. Expressions it does not
+//		understand, or whose evaluation would raise an error (e.g. overflow),
+//		are handed to the fallback evaluator, which typically goes through the
+//		executor.
+//
+//---------------------------------------------------------------------------
+class CConstExprEvaluatorNative : public IConstExprEvaluator
+{
+private:
+	// kinds of values the native evaluator can compute with
+	enum EValueKind
+	{
+		EvkInt,		   // int2, int4, int8
+		EvkBool,	   // bool
+		EvkOid,		   // oid
+		EvkFloat,	   // float4, float8
+		EvkDate,	   // date, days since 2000-01-01
+		EvkTime,	   // time of day in microseconds
+		EvkTimestamp,  // timestamp, microseconds since 2000-01-01
+		EvkTimestampTz,	 // timestamptz, microseconds since 2000-01-01 UTC
+		EvkInterval,	 // interval
+
+		EvkSentinel
+	};
+
+	// native representation of a non-null constant
+	struct SValue
+	{
+		// value kind
+		EValueKind m_evk;
+
+		// integral payload; also holds the time part of an interval
+		LINT m_lint;
+
+		// floating point payload
+		DOUBLE m_dbl;
+
+		// day and month parts of an interval
+		INT m_day;
+		INT m_month;
+	};
+
+	// built-in operators and functions the evaluator can fold
+	enum ENativeOp
+	{
+		EnopIntPlus,
+		EnopIntMinus,
+		EnopIntMult,
+		EnopDatePlusInt,
+		EnopDateMinusInt,
+		EnopDateMinusDate,
+		EnopDatePlusInterval,
+		EnopDateMinusInterval,
+		EnopTimestampPlusInterval,
+		EnopTimestampMinusInterval,
+
+		EnopSentinel
+	};
+
+	// mapping of a catalog operator or function to a native operation
+	struct SNativeOpMapping
+	{
+		// operator oid
+		OID m_op_oid;
+
+		// oid of the function implementing the operator
+		OID m_func_oid;
+
+		// native operation
+		ENativeOp m_enop;
+	};
+
+	// table of foldable operators and functions
+	static const SNativeOpMapping m_rgnopmap[];
+
+	// memory pool
+	CMemoryPool *m_mp;
+
+	// evaluator for expressions that cannot be folded natively, owned
+	IConstExprEvaluator *m_pceevalFallback;
+
+	// are date/time values 64-bit integers on the target database
+	BOOL m_fIntegerDatetimes;
+
+	// private copy ctor
+	CConstExprEvaluatorNative(const CConstExprEvaluatorNative &);
+
+	// is native evaluation enabled for the current optimization
+	static BOOL FNativeEvalEnabled();
+
+	// decode the given datum; returns false if its type is not supported
+	BOOL FDecode(const IDatum *datum, SValue *pval) const;
+
+	// compare two decoded values of the same kind; returns -1, 0 or 1
+	static INT ICompare(const SValue &valLeft, const SValue &valRight);
+
+	// evaluate a comparison on decoded values
+	static BOOL FCompare(const SValue &valLeft, const SValue &valRight,
+						 IMDType::ECmpType cmp_type);
+
+	// look up the native operation for an operator or function oid
+	static ENativeOp EnopFromOid(OID oid, BOOL fFunc);
+
+	// compute a native operation; returns false if the result cannot be
+	// computed natively
+	static BOOL FApply(ENativeOp enop, const SValue &valLeft,
+					   const SValue &valRight, SValue *pvalResult);
+
+	// add an interval to a timestamp the way timestamp_pl_interval does
+	static BOOL FTimestampPlusInterval(LINT lTimestamp, LINT lTime, INT iDay,
+									   INT iMonth, LINT *plResult);
+
+	// convert a gregorian date to a julian day number
+	static INT IDate2Julian(INT iYear, INT iMonth, INT iDay);
+
+	// convert a julian day number to a gregorian date
+	static void Julian2Date(INT iJulian, INT *piYear, INT *piMonth,
+							INT *piDay);
+
+	// fold a scalar constant or a foldable expression into a decoded value
+	BOOL FEvalArg(CExpression *pexpr, const IDatum **ppdatum, SValue *pval,
+				  CExpression **ppexprFolded);
+
+	// evaluate a comparison natively
+	CExpression *PexprEvalCmp(CExpression *pexpr);
+
+	// evaluate an operator or function natively
+	CExpression *PexprEvalOp(CExpression *pexpr);
+
+	// construct a constant expression from a decoded value
+	CExpression *PexprConst(IMDId *mdid_type, const SValue &val) const;
+
+public:
+	// ctor, takes ownership of the fallback evaluator
+	CConstExprEvaluatorNative(CMemoryPool *mp,
+							  IConstExprEvaluator *pceevalFallback,
+							  BOOL fIntegerDatetimes);
+
+	// dtor
+	virtual ~CConstExprEvaluatorNative();
+
+	// evaluate the given expression natively; returns NULL if the expression
+	// cannot be folded inside the optimizer
+	CExpression *PexprEvalNative(CExpression *pexpr);
+
+	// evaluate the given expression and return the result as a new expression
+	// caller takes ownership of returned expression
+	virtual CExpression *PexprEval(CExpression *pexpr);
+
+	// returns true iff the evaluator can evaluate expressions
+	virtual BOOL FCanEvalExpressions();
+
+	// compare two datums natively
+	virtual BOOL FEvalDatumComparison(const IDatum *datum1,
+									  const IDatum *datum2,
+									  IMDType::ECmpType cmp_type,
+									  BOOL *pfResult);
+};
+}  // namespace gpopt
+
+#endif	// !GPOPT_CConstExprEvaluatorNative_H
+
+// EOF
@@ -21,9 +21,18 @@
 #include "gpos/base.h"
 #include "gpos/common/CRefCount.h"
 
+#include "naucrates/md/IMDType.h"
+
+namespace gpnaucrates
+{
+class IDatum;  // forward declaration
+}
+
 namespace gpopt
 {
 using namespace gpos;
+using gpmd::IMDType;
+using gpnaucrates::IDatum;
 
 class CExpression;	// forward declaration
 
@@ -51,6 +60,19 @@ public:
 
 	// returns true iff the evaluator can evaluate constant expressions without subqueries
 	virtual BOOL FCanEvalExpressions() = 0;
+
+	// compare two datums without constructing a comparison expression;
+	// returns false if the evaluator cannot decide the comparison this way,
+	// otherwise stores the outcome in the given output argument
+	virtual BOOL
+	FEvalDatumComparison(const IDatum *,  // datum1
+						 const IDatum *,  // datum2
+						 IMDType::ECmpType,	 // cmp_type
+						 BOOL *				 // pfResult
+	)
+	{
+		return false;
+	}
 };
 }  // namespace gpopt
 
@@ -106,6 +106,10 @@ private:
 	static CExpression *PexprRemoveSuperfluousDistinctInDQA(CMemoryPool *mp,
 															CExpression *pexpr);
 
+	// estimate count(distinct) aggregates with HyperLogLog sketches
+	static CExpression *PexprApproxCountDistinct(CMemoryPool *mp,
+												 CExpression *pexpr);
+
 	// remove superfluous outer references from limit, group by and window operators
 	static CExpression *PexprRemoveSuperfluousOuterRefs(CMemoryPool *mp,
 														CExpression *pexpr);
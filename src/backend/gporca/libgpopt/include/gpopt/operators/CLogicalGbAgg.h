@@ -248,11 +248,12 @@ public:
 	// debug print
 	virtual IOstream &OsPrint(IOstream &os) const;
 
-	// derive statistics
+	// derive statistics; if the number of segments is given, the groups
+	// are computed on each segment separately
 	static IStatistics *PstatsDerive(CMemoryPool *mp, IStatistics *child_stats,
 									 CColRefArray *pdrgpcrGroupingCols,
 									 ULongPtrArray *pdrgpulComputedCols,
-									 CBitSet *keys);
+									 CBitSet *keys, ULONG num_segments = 1);
 
 	// print group by aggregate type
 	static IOstream &OsPrintGbAggType(IOstream &os,
@@ -39,6 +39,8 @@ namespace gpdxl
 {
 class CDXLTableDescr;
 class CDXLLogicalCTAS;
+class CDXLLogicalWindow;
+class CDXLWindowSpec;
 }  // namespace gpdxl
 
 class CColumnFactory;
@@ -140,6 +142,19 @@ private:
 	// translate a DXL logical window into an expr logical project
 	CExpression *PexprLogicalSeqPr(const CDXLNode *pdxlnLgProject);
 
+	// order the used window specifications of a window operator, bottom
+	// first, so that specifications sharing a redistribution and a sort
+	// prefix are stacked next to each other; for each of them, return the
+	// specification whose partition by column order it uses
+	void OrderWindowSpecs(const CDXLLogicalWindow *pdxlopWindow,
+						  UlongToExprArrayMap *phmulpdrgpexpr,
+						  ULongPtrArray **ppdrgpulSpecPos,
+						  ULongPtrArray **ppdrgpulPartitionByPos);
+
+	// do two window specifications partition by the same set of columns
+	static BOOL FSamePartitionBy(const CDXLWindowSpec *pdxlwsFst,
+								 const CDXLWindowSpec *pdxlwsSnd);
+
 	// create the array of column reference used in the partition by column
 	// list of a window specification
 	CColRefArray *PdrgpcrPartitionByCol(
@@ -345,6 +345,13 @@ public:
 		CMemoryPool *mp, CMDAccessor *md_accessor, CDXLNode *dxlnode,
 		CExpression *pexpr, CDistributionSpecArray *pdrgpdsBaseTables);
 
+	// compute the direct dispatch info from the sets of constants the
+	// constraint allows for each of the given distribution columns
+	static CDXLDirectDispatchInfo *PdxlddinfoDistrKeyValues(
+		CMemoryPool *mp, CMDAccessor *md_accessor,
+		const CColRefArray *pdrgpcrDistr, CConstraint *pcnstr,
+		ULONG ulMaxValues);
+
 	// is the aggregate a local hash aggregate that is safe to stream
 	static BOOL FLocalHashAggStreamSafe(CExpression *pexprAgg);
 
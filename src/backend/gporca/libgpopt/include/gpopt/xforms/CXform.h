@@ -224,6 +224,8 @@ public:
 		ExfLeftJoin2RightJoin,
 		ExfRightOuterJoin2HashJoin,
 		ExfImplementInnerJoin,
+		ExfEagerAggNAryJoin,
+		ExfInnerJoinSemiJoinReduction,
 		ExfInvalid,
 		ExfSentinel = ExfInvalid
 	};
@@ -25,7 +25,11 @@ using namespace gpos;
 //		CXformEagerAgg
 //
 //	@doc:
-//		Eagerly push aggregates below join
+//		Eagerly push aggregates below join. Each child of the join that all
+//		aggregate arguments come from gets a partial aggregate. Aggregates
+//		over the other children are computed above the join: min and max
+//		are not affected by the pre-aggregation, and counts are scaled by
+//		the number of rows each pre-aggregated row stands for.
 //
 //---------------------------------------------------------------------------
 class CXformEagerAgg : public CXformExploration
@@ -60,6 +64,7 @@ public:
 	FCompatible(CXform::EXformId exfid)
 	{
 		return (CXform::ExfEagerAgg != exfid) &&
+			   (CXform::ExfEagerAggNAryJoin != exfid) &&
 			   (CXform::ExfSplitGbAgg != exfid) &&
 			   (CXform::ExfSplitDQA != exfid);
 	}
@@ -82,17 +87,25 @@ private:
 	// private copy ctor
 	CXformEagerAgg(const CXformEagerAgg &);
 
-	// check if transform can be applied
-	BOOL CanApplyTransform(CExpression *agg_expr) const;
+	// push the aggregate below the given child of the join, return NULL if
+	// that is not possible
+	CExpression *PexprPushAggBelowJoinChild(CMemoryPool *mp,
+											CExpression *agg_expr,
+											ULONG child_index) const;
 
 	// is this aggregate supported for push down?
 	BOOL CanPushAggBelowJoin(CExpression *scalar_agg_func_expr) const;
 
+	// can this aggregate be computed above the join from the rows of the
+	// children it isn't pushed to?
+	BOOL CanScaleAggAboveJoin(CExpression *scalar_agg_func_expr) const;
+
 	// generate project lists for the lower and upper aggregates
 	// from all the original aggregates
 	void PopulateLowerUpperProjectList(
 		CMemoryPool *mp,			  // memory pool
 		CExpression *orig_proj_list,  // project list of the original aggregate
+		CColRefSet *child_cols,		  // columns of the child pushed down to
 		CExpression *
 			*lower_proj_list,  // output project list of the new lower aggregate
 		CExpression *
@@ -109,6 +122,12 @@ private:
 			lower_proj_elem_expr  // output project element of the new lower aggregate
 	) const;
 
+	// generate project element for upper aggregate of an aggregate that is
+	// not pushed down, given the count of rows each lower row stands for
+	CExpression *PexprScaledProjectElement(CMemoryPool *mp,
+										   CExpression *orig_proj_elem_expr,
+										   CColRef *count_colref) const;
+
 	// generate project element for upper aggregate
 	void PopulateUpperProjectElement(
 		CMemoryPool *mp,  // memory pool
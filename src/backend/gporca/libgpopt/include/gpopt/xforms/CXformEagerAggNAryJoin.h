@@ -0,0 +1,64 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CXformEagerAggNAryJoin.h
+//
+//	@doc:
+//		Eagerly push aggregates below an n-ary join
+//---------------------------------------------------------------------------
+#ifndef GPOPT_CXformEagerAggNAryJoin_H
+#define GPOPT_CXformEagerAggNAryJoin_H
+
+#include "gpos/base.h"
+
+#include "gpopt/xforms/CXformEagerAgg.h"
+
+namespace gpopt
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CXformEagerAggNAryJoin
+//
+//	@doc:
+//		Eagerly push aggregates below one of the children of an n-ary join,
+//		so that the join order search sees the pre-aggregated child
+//
+//---------------------------------------------------------------------------
+class CXformEagerAggNAryJoin : public CXformEagerAgg
+{
+private:
+	// private copy ctor
+	CXformEagerAggNAryJoin(const CXformEagerAggNAryJoin &);
+
+public:
+	// ctor
+	explicit CXformEagerAggNAryJoin(CMemoryPool *mp);
+
+	// dtor
+	virtual ~CXformEagerAggNAryJoin()
+	{
+	}
+
+	// ident accessors
+	virtual EXformId
+	Exfid() const
+	{
+		return ExfEagerAggNAryJoin;
+	}
+
+	virtual const CHAR *
+	SzId() const
+	{
+		return "CXformEagerAggNAryJoin";
+	}
+
+};	// class CXformEagerAggNAryJoin
+}  // namespace gpopt
+
+#endif	// !GPOPT_CXformEagerAggNAryJoin_H
+
+// EOF
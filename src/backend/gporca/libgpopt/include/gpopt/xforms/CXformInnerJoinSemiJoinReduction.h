@@ -0,0 +1,114 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CXformInnerJoinSemiJoinReduction.h
+//
+//	@doc:
+//		Reduce the big side of an inner join with the join keys of a filtered
+//		small side before the join
+//---------------------------------------------------------------------------
+#ifndef GPOPT_CXformInnerJoinSemiJoinReduction_H
+#define GPOPT_CXformInnerJoinSemiJoinReduction_H
+
+#include "gpos/base.h"
+
+#include "gpopt/xforms/CXformExploration.h"
+
+namespace gpopt
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CXformInnerJoinSemiJoinReduction
+//
+//	@doc:
+//		Transform
+//
+//		InnerJoin
+//		  |--Big
+//		  +--Select(Small)
+//
+//		to
+//
+//		CTEAnchor(A)
+//		  +--InnerJoin
+//			   |--LeftSemiJoin
+//			   |	|--Big
+//			   |	+--Gb(keys(Small))
+//			   |		 +--CTEConsumer(A)
+//			   +--CTEConsumer(A)
+//
+//		where A is the CTE that produces the filtered small side. The
+//		distinct join keys of the small side are cheap to broadcast, and the
+//		semi join discards the big side rows that have no match before they
+//		are redistributed for the join. The cost model decides whether the
+//		reduction pays off, based on the selectivity of the semi join.
+//
+//---------------------------------------------------------------------------
+class CXformInnerJoinSemiJoinReduction : public CXformExploration
+{
+private:
+	// the xform is only applied if the outer side has at least this many
+	// times the rows of the inner side
+	static const DOUBLE m_dOuterInnerRatioThreshold;
+
+	// disable copy ctor
+	CXformInnerJoinSemiJoinReduction(const CXformInnerJoinSemiJoinReduction &);
+
+	// is the given child group a filtered relation
+	static BOOL FFilteredChild(CGroup *pgroup);
+
+public:
+	// ctor
+	explicit CXformInnerJoinSemiJoinReduction(CMemoryPool *mp);
+
+	// dtor
+	virtual ~CXformInnerJoinSemiJoinReduction()
+	{
+	}
+
+	// identifier
+	virtual EXformId
+	Exfid() const
+	{
+		return ExfInnerJoinSemiJoinReduction;
+	}
+
+	// return a string for the xform name
+	virtual const CHAR *
+	SzId() const
+	{
+		return "CXformInnerJoinSemiJoinReduction";
+	}
+
+	// compute xform promise for a given expression handle
+	virtual EXformPromise Exfp(CExpressionHandle &exprhdl) const;
+
+	// do stats need to be computed before applying xform?
+	virtual BOOL
+	FNeedsStats() const
+	{
+		return true;
+	}
+
+	// actual transform
+	virtual void Transform(CXformContext *pxfctxt, CXformResult *pxfres,
+						   CExpression *pexpr) const;
+
+	// return true if xform should be applied only once
+	virtual BOOL
+	IsApplyOnce()
+	{
+		return true;
+	}
+
+};	// class CXformInnerJoinSemiJoinReduction
+
+}  // namespace gpopt
+
+#endif	// !GPOPT_CXformInnerJoinSemiJoinReduction_H
+
+// EOF
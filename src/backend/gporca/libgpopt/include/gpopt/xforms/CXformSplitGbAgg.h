@@ -81,7 +81,8 @@ public:
 	{
 		return ((CXform::ExfSplitDQA != exfid) &&
 				(CXform::ExfSplitGbAgg != exfid) &&
-				(CXform::ExfEagerAgg != exfid));
+				(CXform::ExfEagerAgg != exfid) &&
+				(CXform::ExfEagerAggNAryJoin != exfid));
 	}
 
 	// compute xform promise for a given expression handle
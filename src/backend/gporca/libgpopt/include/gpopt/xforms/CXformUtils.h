@@ -698,6 +698,9 @@ public:
 	// check if given xform is an Agg splitting xform
 	static BOOL FSplitAggXform(CXform::EXformId exfid);
 
+	// check if given xform is an eager aggregation xform
+	static BOOL FEagerAggXform(CXform::EXformId exfid);
+
 	// check if given xform is an Agg CXformSplitDQA
 	static BOOL FAggGenBySplitDQAXform(CExpression *pexprAgg);
 
@@ -31,6 +31,7 @@
 #include "gpopt/xforms/CXformDynamicGet2DynamicTableScan.h"
 #include "gpopt/xforms/CXformDynamicIndexGet2DynamicIndexScan.h"
 #include "gpopt/xforms/CXformEagerAgg.h"
+#include "gpopt/xforms/CXformEagerAggNAryJoin.h"
 #include "gpopt/xforms/CXformExpandDynamicGetWithExternalPartitions.h"
 #include "gpopt/xforms/CXformExpandFullOuterJoin.h"
 #include "gpopt/xforms/CXformExpandNAryJoin.h"
@@ -85,6 +86,7 @@
 #include "gpopt/xforms/CXformInnerJoin2PartialDynamicIndexGetApply.h"
 #include "gpopt/xforms/CXformInnerJoinAntiSemiJoinNotInSwap.h"
 #include "gpopt/xforms/CXformInnerJoinAntiSemiJoinSwap.h"
+#include "gpopt/xforms/CXformInnerJoinSemiJoinReduction.h"
 #include "gpopt/xforms/CXformInnerJoinSemiJoinSwap.h"
 #include "gpopt/xforms/CXformInnerJoinWithInnerSelect2PartialDynamicIndexGetApply.h"
 #include "gpopt/xforms/CXformInsert2DML.h"
@@ -16,6 +16,7 @@
 #include "gpopt/base/CCTEReq.h"
 #include "gpopt/base/CColRefSetIter.h"
 #include "gpopt/base/CQueryContext.h"
+#include "gpopt/base/CUtils.h"
 #include "gpopt/operators/CExpressionPreprocessor.h"
 #include "gpopt/operators/CLogicalCTEConsumer.h"
 #include "gpopt/operators/CLogicalCTEProducer.h"
@@ -164,11 +165,13 @@ CCTEInfo::CCTEInfo(CMemoryPool *mp)
 	: m_mp(mp),
 	  m_phmulcteinfoentry(NULL),
 	  m_ulNextCTEId(0),
-	  m_fEnableInlining(true)
+	  m_fEnableInlining(true),
+	  m_pbsNoInlining(NULL)
 {
 	GPOS_ASSERT(NULL != mp);
 	m_phmulcteinfoentry = GPOS_NEW(m_mp) UlongToCTEInfoEntryMap(m_mp);
 	m_phmulprodconsmap = GPOS_NEW(m_mp) UlongToProducerConsumerMap(m_mp);
+	m_pbsNoInlining = GPOS_NEW(m_mp) CBitSet(m_mp);
 }
 
 //---------------------------------------------------------------------------
@@ -183,6 +186,7 @@ CCTEInfo::~CCTEInfo()
 {
 	CRefCount::SafeRelease(m_phmulcteinfoentry);
 	CRefCount::SafeRelease(m_phmulprodconsmap);
+	CRefCount::SafeRelease(m_pbsNoInlining);
 }
 
 
@@ -536,6 +540,66 @@ CCTEInfo::PdrgPexpr(CMemoryPool *mp) const
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CCTEInfo::LimitInlining
+//
+//	@doc:
+//		Disable inlining of CTEs until the number of inlinable CTEs in the
+//		given query is within the given cutoff. The search space grows with
+//		every inlined consumer, so the CTE whose consumers contribute most
+//		to that number is disabled first; the remaining CTEs keep both the
+//		inlined and the shared alternative, and the cost model picks one.
+//
+//---------------------------------------------------------------------------
+void
+CCTEInfo::LimitInlining(CExpression *pexpr, ULONG ulCutoff)
+{
+	GPOS_ASSERT(NULL != pexpr);
+
+	ULONG ulInlinable = CUtils::UlInlinableCTEs(pexpr);
+	while (ulInlinable > ulCutoff)
+	{
+		ULONG ulCTEIdBest = gpos::ulong_max;
+		ULONG ulInlinableBest = ulInlinable;
+
+		UlongToCTEInfoEntryMapIter hmulei(m_phmulcteinfoentry);
+		while (hmulei.Advance())
+		{
+			const CCTEInfoEntry *pcteinfoentry = hmulei.Value();
+			const ULONG ulCTEId = pcteinfoentry->UlCTEId();
+			if (!pcteinfoentry->FUsed() || !FEnableInlining(ulCTEId) ||
+				1 == UlConsumers(ulCTEId))
+			{
+				// a CTE with a single consumer is always inlined
+				continue;
+			}
+
+			DisableInlining(ulCTEId);
+			const ULONG ulInlinableWithout = CUtils::UlInlinableCTEs(pexpr);
+			(void) m_pbsNoInlining->ExchangeClear(ulCTEId);
+
+			if (ulInlinableWithout < ulInlinableBest)
+			{
+				ulCTEIdBest = ulCTEId;
+				ulInlinableBest = ulInlinableWithout;
+			}
+		}
+
+		if (gpos::ulong_max == ulCTEIdBest)
+		{
+			// no single CTE brings the number down, fall back to sharing
+			// all CTEs
+			DisableInlining();
+			return;
+		}
+
+		DisableInlining(ulCTEIdBest);
+		ulInlinable = ulInlinableBest;
+	}
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CCTEInfo::MapComputedToUsedCols
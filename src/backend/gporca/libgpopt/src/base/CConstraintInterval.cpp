@@ -42,6 +42,7 @@ CConstraintInterval::CConstraintInterval(CMemoryPool *mp, const CColRef *colref,
 	: CConstraint(mp),
 	  m_pcr(colref),
 	  m_pdrgprng(pdrgprng),
+	  m_ppset(NULL),
 	  m_fIncludesNull(fIncludesNull)
 {
 	GPOS_ASSERT(NULL != colref);
@@ -50,6 +51,29 @@ CConstraintInterval::CConstraintInterval(CMemoryPool *mp, const CColRef *colref,
 	m_pcrsUsed->Include(colref);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstraintInterval::CConstraintInterval
+//
+//	@doc:
+//		Ctor for an interval made of points only; the ranges are built
+//		from the points when first asked for
+//
+//---------------------------------------------------------------------------
+CConstraintInterval::CConstraintInterval(CMemoryPool *mp, const CColRef *colref,
+										 CPointSet *ppset, BOOL fIncludesNull)
+	: CConstraint(mp),
+	  m_pcr(colref),
+	  m_pdrgprng(NULL),
+	  m_ppset(ppset),
+	  m_fIncludesNull(fIncludesNull)
+{
+	GPOS_ASSERT(NULL != colref);
+	GPOS_ASSERT(NULL != ppset);
+	m_pcrsUsed = GPOS_NEW(mp) CColRefSet(mp);
+	m_pcrsUsed->Include(colref);
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CConstraintInterval::~CConstraintInterval
@@ -60,10 +84,51 @@ CConstraintInterval::CConstraintInterval(CMemoryPool *mp, const CColRef *colref,
 //---------------------------------------------------------------------------
 CConstraintInterval::~CConstraintInterval()
 {
-	m_pdrgprng->Release();
+	CRefCount::SafeRelease(m_pdrgprng);
+	CRefCount::SafeRelease(m_ppset);
 	m_pcrsUsed->Release();
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstraintInterval::Pdrgprng
+//
+//	@doc:
+//		All ranges in the interval; an interval made of points builds its
+//		[x,x] ranges on first use
+//
+//---------------------------------------------------------------------------
+CRangeArray *
+CConstraintInterval::Pdrgprng() const
+{
+	if (NULL == m_pdrgprng)
+	{
+		GPOS_ASSERT(NULL != m_ppset);
+		m_pdrgprng = m_ppset->PdrgprngPoints(m_mp);
+	}
+
+	return m_pdrgprng;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstraintInterval::UlRanges
+//
+//	@doc:
+//		Number of ranges in the interval, without building them
+//
+//---------------------------------------------------------------------------
+ULONG
+CConstraintInterval::UlRanges() const
+{
+	if (NULL != m_ppset)
+	{
+		return m_ppset->Size();
+	}
+
+	return m_pdrgprng->Size();
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CConstraintInterval::FContradiction
@@ -76,7 +141,7 @@ CConstraintInterval::~CConstraintInterval()
 BOOL
 CConstraintInterval::FContradiction() const
 {
-	return (!m_fIncludesNull && 0 == m_pdrgprng->Size());
+	return (!m_fIncludesNull && 0 == UlRanges());
 }
 
 //---------------------------------------------------------------------------
@@ -91,7 +156,7 @@ CConstraintInterval::FContradiction() const
 BOOL
 CConstraintInterval::IsConstraintUnbounded() const
 {
-	return (m_fIncludesNull && 1 == m_pdrgprng->Size() &&
+	return (m_fIncludesNull && NULL == m_ppset && 1 == m_pdrgprng->Size() &&
 			(*m_pdrgprng)[0]->IsConstraintUnbounded());
 }
 
@@ -275,15 +340,14 @@ CConstraintInterval::PcnstrIntervalFromScalarArrayCmp(CMemoryPool *mp,
 	{
 		case IMDType::EcmptEq:
 		{
-			// IN case, create ranges [X, X] [Y, Y] [Z, Z]
-			for (ULONG ul = 0; ul < apdatumsortedset->Size(); ul++)
-			{
-				(*apdatumsortedset)[ul]->AddRef();
-				CRange *prng = GPOS_NEW(mp)
-					CRange(pcomp, IMDType::EcmptEq, (*apdatumsortedset)[ul]);
-				prgrng->Append(prng);
-			}
-			break;
+			// IN case, keep the sorted constants as a point set instead of
+			// ranges [X, X] [Y, Y] [Z, Z]
+			prgrng->Release();
+			apdatumsortedset->AddRef();
+			CPointSet *ppset =
+				GPOS_NEW(mp) CPointSet(mp, pcomp, apdatumsortedset.Value());
+			return GPOS_NEW(mp)
+				CConstraintInterval(mp, colref, ppset, infer_nulls_as);
 		}
 		case IMDType::EcmptNEq:
 		{
@@ -795,10 +859,11 @@ CConstraintInterval::PexprConstructDisjunctionScalar(CMemoryPool *mp) const
 {
 	CExpressionArray *pdrgpexpr = GPOS_NEW(mp) CExpressionArray(mp);
 
-	const ULONG length = m_pdrgprng->Size();
+	CRangeArray *pdrgprng = Pdrgprng();
+	const ULONG length = pdrgprng->Size();
 	for (ULONG ul = 0; ul < length; ul++)
 	{
-		CRange *prange = (*m_pdrgprng)[ul];
+		CRange *prange = (*pdrgprng)[ul];
 		CExpression *pexprChild = prange->PexprScalar(mp, m_pcr);
 		pdrgpexpr->Append(pexprChild);
 	}
@@ -840,11 +905,16 @@ CConstraintInterval::PexprConstructDisjunctionScalar(CMemoryPool *mp) const
 bool
 CConstraintInterval::FConvertsToIn() const
 {
-	if (1 >= m_pdrgprng->Size())
+	if (1 >= UlRanges())
 	{
 		return false;
 	}
 
+	if (NULL != m_ppset)
+	{
+		return true;
+	}
+
 	bool isIN = true;
 	const ULONG length = m_pdrgprng->Size();
 	for (ULONG ul = 0; ul < length && isIN; ul++)
@@ -867,7 +937,7 @@ CConstraintInterval::FConvertsToIn() const
 bool
 CConstraintInterval::FConvertsToNotIn() const
 {
-	if (1 >= m_pdrgprng->Size())
+	if (1 >= UlRanges() || NULL != m_ppset)
 	{
 		return false;
 	}
@@ -914,7 +984,7 @@ CConstraintInterval::PexprConstructArrayScalar(CMemoryPool *mp, bool fIn) const
 {
 	GPOS_ASSERT(FConvertsToIn() || FConvertsToNotIn());
 
-	ULONG ulRngs = m_pdrgprng->Size();
+	ULONG ulRngs = UlRanges();
 	IMDType::ECmpType ecmptype = IMDType::EcmptEq;
 	CScalarArrayCmp::EArrCmpType earraycmptype = CScalarArrayCmp::EarrcmpAny;
 
@@ -932,9 +1002,11 @@ CConstraintInterval::PexprConstructArrayScalar(CMemoryPool *mp, bool fIn) const
 
 	// this method assumes IN or NOT IN which means that the ranges stored will look like either
 	// [x,x], ... ,[y,y] or the NOT IN case (-inf, x),(x,y), ... ,(z,inf).
+	// a point set holds the constants of an IN directly
 	for (ULONG ul = 0; ul < ulRngs; ul++)
 	{
-		IDatum *datum = (*m_pdrgprng)[ul]->PdatumRight();
+		IDatum *datum = (NULL != m_ppset) ? (*m_ppset)[ul]
+										  : (*m_pdrgprng)[ul]->PdatumRight();
 		datum->AddRef();
 		CScalarConst *popScConst = GPOS_NEW(mp) CScalarConst(mp, datum);
 		CExpression *pexpr = GPOS_NEW(mp) CExpression(mp, popScConst);
@@ -971,7 +1043,7 @@ CConstraintInterval::PexprConstructArrayScalar(CMemoryPool *mp, bool fIn) const
 CExpression *
 CConstraintInterval::PexprConstructArrayScalar(CMemoryPool *mp) const
 {
-	if (1 >= m_pdrgprng->Size())
+	if (1 >= UlRanges())
 	{
 		return NULL;
 	}
@@ -1046,6 +1118,13 @@ CConstraintInterval::PcnstrRemapForColumn(CMemoryPool *mp,
 										  CColRef *colref) const
 {
 	GPOS_ASSERT(NULL != colref);
+	if (NULL != m_ppset)
+	{
+		m_ppset->AddRef();
+		return GPOS_NEW(mp)
+			CConstraintInterval(mp, colref, m_ppset, m_fIncludesNull);
+	}
+
 	m_pdrgprng->AddRef();
 	return GPOS_NEW(mp)
 		CConstraintInterval(mp, colref, m_pdrgprng, m_fIncludesNull);
@@ -1065,6 +1144,30 @@ CConstraintInterval::PciIntersect(CMemoryPool *mp, CConstraintInterval *pci)
 	GPOS_ASSERT(NULL != pci);
 	GPOS_ASSERT(m_pcr == pci->Pcr());
 
+	BOOL fIncludesNull = m_fIncludesNull && pci->FIncludesNull();
+
+	// the intersection with a point set is made of points, found by
+	// merging the points with the other interval
+	if (NULL != m_ppset || NULL != pci->Ppset())
+	{
+		CPointSet *ppset = NULL;
+		if (NULL != m_ppset && NULL != pci->Ppset())
+		{
+			ppset = m_ppset->PpsIntersect(mp, pci->Ppset());
+		}
+		else if (NULL != m_ppset)
+		{
+			ppset = m_ppset->PpsFilter(mp, pci->Pdrgprng(), true /*fInside*/);
+		}
+		else
+		{
+			ppset = pci->Ppset()->PpsFilter(mp, m_pdrgprng, true /*fInside*/);
+		}
+
+		return GPOS_NEW(mp)
+			CConstraintInterval(mp, m_pcr, ppset, fIncludesNull);
+	}
+
 	CRangeArray *pdrgprngOther = pci->Pdrgprng();
 
 	CRangeArray *pdrgprngNew = GPOS_NEW(mp) CRangeArray(mp);
@@ -1096,8 +1199,8 @@ CConstraintInterval::PciIntersect(CMemoryPool *mp, CConstraintInterval *pci)
 		}
 	}
 
-	return GPOS_NEW(mp) CConstraintInterval(
-		mp, m_pcr, pdrgprngNew, m_fIncludesNull && pci->FIncludesNull());
+	return GPOS_NEW(mp)
+		CConstraintInterval(mp, m_pcr, pdrgprngNew, fIncludesNull);
 }
 
 //---------------------------------------------------------------------------
@@ -1114,17 +1217,26 @@ CConstraintInterval::PciUnion(CMemoryPool *mp, CConstraintInterval *pci)
 	GPOS_ASSERT(NULL != pci);
 	GPOS_ASSERT(m_pcr == pci->Pcr());
 
+	BOOL fIncludesNull = m_fIncludesNull || pci->FIncludesNull();
+
+	if (NULL != m_ppset && NULL != pci->Ppset())
+	{
+		return GPOS_NEW(mp) CConstraintInterval(
+			mp, m_pcr, m_ppset->PpsUnion(mp, pci->Ppset()), fIncludesNull);
+	}
+
+	CRangeArray *pdrgprngThis = Pdrgprng();
 	CRangeArray *pdrgprngOther = pci->Pdrgprng();
 
 	CRangeArray *pdrgprngNew = GPOS_NEW(mp) CRangeArray(mp);
 
 	ULONG ulFst = 0;
 	ULONG ulSnd = 0;
-	const ULONG ulNumRangesFst = m_pdrgprng->Size();
+	const ULONG ulNumRangesFst = pdrgprngThis->Size();
 	const ULONG ulNumRangesSnd = pdrgprngOther->Size();
 	while (ulFst < ulNumRangesFst && ulSnd < ulNumRangesSnd)
 	{
-		CRange *prangeThis = (*m_pdrgprng)[ulFst];
+		CRange *prangeThis = (*pdrgprngThis)[ulFst];
 		CRange *prangeOther = (*pdrgprngOther)[ulSnd];
 
 		CRange *prangeNew = NULL;
@@ -1142,11 +1254,11 @@ CConstraintInterval::PciUnion(CMemoryPool *mp, CConstraintInterval *pci)
 		AppendOrExtend(mp, pdrgprngNew, prangeNew);
 	}
 
-	AddRemainingRanges(mp, m_pdrgprng, ulFst, pdrgprngNew);
+	AddRemainingRanges(mp, pdrgprngThis, ulFst, pdrgprngNew);
 	AddRemainingRanges(mp, pdrgprngOther, ulSnd, pdrgprngNew);
 
-	return GPOS_NEW(mp) CConstraintInterval(
-		mp, m_pcr, pdrgprngNew, m_fIncludesNull || pci->FIncludesNull());
+	return GPOS_NEW(mp)
+		CConstraintInterval(mp, m_pcr, pdrgprngNew, fIncludesNull);
 }
 
 //---------------------------------------------------------------------------
@@ -1163,6 +1275,25 @@ CConstraintInterval::PciDifference(CMemoryPool *mp, CConstraintInterval *pci)
 	GPOS_ASSERT(NULL != pci);
 	GPOS_ASSERT(m_pcr == pci->Pcr());
 
+	BOOL fIncludesNull = m_fIncludesNull && !pci->FIncludesNull();
+
+	// removing anything from a point set leaves a subset of its points
+	if (NULL != m_ppset)
+	{
+		CPointSet *ppset = NULL;
+		if (NULL != pci->Ppset())
+		{
+			ppset = m_ppset->PpsDifference(mp, pci->Ppset());
+		}
+		else
+		{
+			ppset = m_ppset->PpsFilter(mp, pci->Pdrgprng(), false /*fInside*/);
+		}
+
+		return GPOS_NEW(mp)
+			CConstraintInterval(mp, m_pcr, ppset, fIncludesNull);
+	}
+
 	CRangeArray *pdrgprngOther = pci->Pdrgprng();
 
 	CRangeArray *pdrgprngNew = GPOS_NEW(mp) CRangeArray(mp);
@@ -1208,8 +1339,8 @@ CConstraintInterval::PciDifference(CMemoryPool *mp, CConstraintInterval *pci)
 	pdrgprngResidual->Release();
 	AddRemainingRanges(mp, m_pdrgprng, ulFst, pdrgprngNew);
 
-	return GPOS_NEW(mp) CConstraintInterval(
-		mp, m_pcr, pdrgprngNew, m_fIncludesNull && !pci->FIncludesNull());
+	return GPOS_NEW(mp)
+		CConstraintInterval(mp, m_pcr, pdrgprngNew, fIncludesNull);
 }
 
 //---------------------------------------------------------------------------
@@ -1315,8 +1446,14 @@ CConstraintInterval::PciUnbounded(CMemoryPool *mp, const CColRefSet *pcrs,
 IMDId *
 CConstraintInterval::MdidType()
 {
+	// if there is at least one point, return its type
+	if (NULL != m_ppset && 0 < m_ppset->Size())
+	{
+		return (*m_ppset)[0]->MDId();
+	}
+
 	// if there is at least one range, return range type
-	if (0 < m_pdrgprng->Size())
+	if (NULL == m_ppset && 0 < m_pdrgprng->Size())
 	{
 		CRange *prange = (*m_pdrgprng)[0];
 		return prange->MDId();
@@ -1466,11 +1603,12 @@ CConstraintInterval::OsPrint(IOstream &os) const
 {
 	os << "{";
 	m_pcr->OsPrint(os);
-	const ULONG length = m_pdrgprng->Size();
+	CRangeArray *pdrgprng = Pdrgprng();
+	const ULONG length = pdrgprng->Size();
 	os << ", ranges: ";
 	for (ULONG ul = 0; ul < length; ul++)
 	{
-		CRange *prange = (*m_pdrgprng)[ul];
+		CRange *prange = (*pdrgprng)[ul];
 		os << *prange << " ";
 	}
 
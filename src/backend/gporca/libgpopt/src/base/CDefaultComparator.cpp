@@ -54,7 +54,8 @@ CDefaultComparator::CDefaultComparator(IConstExprEvaluator *pceeval)
 //
 //	@doc:
 //		Constructs a comparison expression of type cmp_type between the two given
-//		data and evaluates it.
+//		data and evaluates it, unless the evaluator can compare the data
+//		directly.
 //
 //---------------------------------------------------------------------------
 BOOL
@@ -64,6 +65,12 @@ CDefaultComparator::FEvalComparison(CMemoryPool *mp, const IDatum *datum1,
 {
 	GPOS_ASSERT(m_pceeval->FCanEvalExpressions());
 
+	BOOL result = false;
+	if (m_pceeval->FEvalDatumComparison(datum1, datum2, cmp_type, &result))
+	{
+		return result;
+	}
+
 	IDatum *pdatum1Copy = datum1->MakeCopy(mp);
 	CExpression *pexpr1 = GPOS_NEW(mp)
 		CExpression(mp, GPOS_NEW(mp) CScalarConst(mp, pdatum1Copy));
@@ -80,7 +87,7 @@ CDefaultComparator::FEvalComparison(CMemoryPool *mp, const IDatum *datum1,
 
 	GPOS_ASSERT(IMDType::EtiBool == datum->GetDatumType());
 	IDatumBool *pdatumBool = dynamic_cast<IDatumBool *>(datum);
-	BOOL result = pdatumBool->GetValue();
+	result = pdatumBool->GetValue();
 	pexprResult->Release();
 
 	return result;
@@ -0,0 +1,450 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CPointSet.cpp
+//
+//	@doc:
+//		Implementation of sorted point sets
+//---------------------------------------------------------------------------
+
+#include "gpopt/base/CPointSet.h"
+
+#include "gpos/base.h"
+
+#include "gpopt/base/IComparator.h"
+
+using namespace gpopt;
+
+FORCE_GENERATE_DBGSTR(CPointSet);
+
+// is the datum an integer whose integer mapping preserves its order
+static BOOL
+FOrderedIntDatum(IDatum *datum)
+{
+	IMDType::ETypeInfo type_info = datum->GetDatumType();
+	return (IMDType::EtiInt2 == type_info || IMDType::EtiInt4 == type_info ||
+			IMDType::EtiInt8 == type_info) &&
+		   datum->IsDatumMappableToLINT();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::CPointSet
+//
+//	@doc:
+//		Ctor
+//		Does not take ownership of 'pcomp'.
+//
+//---------------------------------------------------------------------------
+CPointSet::CPointSet(CMemoryPool *mp, const IComparator *pcomp,
+					 IDatumArray *pdrgpdatum)
+	: m_pcomp(pcomp), m_pdrgpdatum(pdrgpdatum), m_rglValues(NULL)
+{
+	GPOS_ASSERT(NULL != pcomp);
+	GPOS_ASSERT(NULL != pdrgpdatum);
+
+	const ULONG size = pdrgpdatum->Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		GPOS_ASSERT(!(*pdrgpdatum)[ul]->IsNull());
+		GPOS_ASSERT_IMP(0 < ul, pcomp->IsLessThan((*pdrgpdatum)[ul - 1],
+												  (*pdrgpdatum)[ul]));
+
+		if (!FOrderedIntDatum((*pdrgpdatum)[ul]))
+		{
+			return;
+		}
+	}
+
+	if (0 < size)
+	{
+		m_rglValues = GPOS_NEW_ARRAY(mp, LINT, size);
+		for (ULONG ul = 0; ul < size; ul++)
+		{
+			m_rglValues[ul] = (*pdrgpdatum)[ul]->GetLINTMapping();
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::~CPointSet
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CPointSet::~CPointSet()
+{
+	m_pdrgpdatum->Release();
+	GPOS_DELETE_ARRAY(m_rglValues);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::ICompare
+//
+//	@doc:
+//		Compare the given point of this set to the given point of another
+//		set; returns a negative number, zero or a positive number if the
+//		first is smaller, equal or larger
+//
+//---------------------------------------------------------------------------
+INT
+CPointSet::ICompare(ULONG ul, const CPointSet *pps, ULONG ulOther) const
+{
+	if (NULL != m_rglValues && NULL != pps->m_rglValues)
+	{
+		LINT lValue = m_rglValues[ul];
+		LINT lValueOther = pps->m_rglValues[ulOther];
+		return (lValue < lValueOther) ? -1 : (lValue > lValueOther ? 1 : 0);
+	}
+
+	return ICompare(ul, (*pps)[ulOther]);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::ICompare
+//
+//	@doc:
+//		Compare the given point of this set to the given datum
+//
+//---------------------------------------------------------------------------
+INT
+CPointSet::ICompare(ULONG ul, IDatum *datum) const
+{
+	if (NULL != m_rglValues && FOrderedIntDatum(datum))
+	{
+		LINT lValue = m_rglValues[ul];
+		LINT lValueOther = datum->GetLINTMapping();
+		return (lValue < lValueOther) ? -1 : (lValue > lValueOther ? 1 : 0);
+	}
+
+	IDatum *pdatumPoint = (*m_pdrgpdatum)[ul];
+	if (m_pcomp->Equals(pdatumPoint, datum))
+	{
+		return 0;
+	}
+
+	return m_pcomp->IsLessThan(pdatumPoint, datum) ? -1 : 1;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::FRangeEndsBefore
+//
+//	@doc:
+//		Does the given range end before the given point of this set
+//
+//---------------------------------------------------------------------------
+BOOL
+CPointSet::FRangeEndsBefore(const CRange *prange, ULONG ul) const
+{
+	IDatum *pdatumRight = prange->PdatumRight();
+	if (NULL == pdatumRight)
+	{
+		return false;
+	}
+
+	INT iCmp = ICompare(ul, pdatumRight);
+	return 0 < iCmp || (0 == iCmp && CRange::EriExcluded == prange->EriRight());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::FRangeContains
+//
+//	@doc:
+//		Does the given range contain the given point of this set
+//
+//---------------------------------------------------------------------------
+BOOL
+CPointSet::FRangeContains(const CRange *prange, ULONG ul) const
+{
+	IDatum *pdatumLeft = prange->PdatumLeft();
+	if (NULL != pdatumLeft)
+	{
+		INT iCmp = ICompare(ul, pdatumLeft);
+		if (0 > iCmp ||
+			(0 == iCmp && CRange::EriExcluded == prange->EriLeft()))
+		{
+			return false;
+		}
+	}
+
+	return !FRangeEndsBefore(prange, ul);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::AppendPoint
+//
+//	@doc:
+//		Append the given point of this set to the given array
+//
+//---------------------------------------------------------------------------
+void
+CPointSet::AppendPoint(IDatumArray *pdrgpdatum, ULONG ul) const
+{
+	IDatum *datum = (*m_pdrgpdatum)[ul];
+	datum->AddRef();
+	pdrgpdatum->Append(datum);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::FContains
+//
+//	@doc:
+//		Does the set contain the given datum; binary search
+//
+//---------------------------------------------------------------------------
+BOOL
+CPointSet::FContains(IDatum *datum) const
+{
+	GPOS_ASSERT(NULL != datum);
+
+	if (datum->IsNull())
+	{
+		return false;
+	}
+
+	ULONG ulLow = 0;
+	ULONG ulHigh = Size();
+	while (ulLow < ulHigh)
+	{
+		ULONG ulMid = ulLow + (ulHigh - ulLow) / 2;
+		INT iCmp = ICompare(ulMid, datum);
+		if (0 == iCmp)
+		{
+			return true;
+		}
+
+		if (0 > iCmp)
+		{
+			ulLow = ulMid + 1;
+		}
+		else
+		{
+			ulHigh = ulMid;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::PpsIntersect
+//
+//	@doc:
+//		Points in both sets
+//
+//---------------------------------------------------------------------------
+CPointSet *
+CPointSet::PpsIntersect(CMemoryPool *mp, const CPointSet *pps) const
+{
+	GPOS_ASSERT(NULL != pps);
+
+	IDatumArray *pdrgpdatum = GPOS_NEW(mp) IDatumArray(mp);
+
+	ULONG ulFst = 0;
+	ULONG ulSnd = 0;
+	while (ulFst < Size() && ulSnd < pps->Size())
+	{
+		INT iCmp = ICompare(ulFst, pps, ulSnd);
+		if (0 == iCmp)
+		{
+			AppendPoint(pdrgpdatum, ulFst);
+			ulFst++;
+			ulSnd++;
+		}
+		else if (0 > iCmp)
+		{
+			ulFst++;
+		}
+		else
+		{
+			ulSnd++;
+		}
+	}
+
+	return GPOS_NEW(mp) CPointSet(mp, m_pcomp, pdrgpdatum);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::PpsUnion
+//
+//	@doc:
+//		Points in either set
+//
+//---------------------------------------------------------------------------
+CPointSet *
+CPointSet::PpsUnion(CMemoryPool *mp, const CPointSet *pps) const
+{
+	GPOS_ASSERT(NULL != pps);
+
+	IDatumArray *pdrgpdatum = GPOS_NEW(mp) IDatumArray(mp);
+
+	ULONG ulFst = 0;
+	ULONG ulSnd = 0;
+	while (ulFst < Size() && ulSnd < pps->Size())
+	{
+		INT iCmp = ICompare(ulFst, pps, ulSnd);
+		if (0 < iCmp)
+		{
+			pps->AppendPoint(pdrgpdatum, ulSnd);
+			ulSnd++;
+		}
+		else
+		{
+			AppendPoint(pdrgpdatum, ulFst);
+			ulFst++;
+			if (0 == iCmp)
+			{
+				ulSnd++;
+			}
+		}
+	}
+
+	for (; ulFst < Size(); ulFst++)
+	{
+		AppendPoint(pdrgpdatum, ulFst);
+	}
+
+	for (; ulSnd < pps->Size(); ulSnd++)
+	{
+		pps->AppendPoint(pdrgpdatum, ulSnd);
+	}
+
+	return GPOS_NEW(mp) CPointSet(mp, m_pcomp, pdrgpdatum);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::PpsDifference
+//
+//	@doc:
+//		Points in this set but not in the given one
+//
+//---------------------------------------------------------------------------
+CPointSet *
+CPointSet::PpsDifference(CMemoryPool *mp, const CPointSet *pps) const
+{
+	GPOS_ASSERT(NULL != pps);
+
+	IDatumArray *pdrgpdatum = GPOS_NEW(mp) IDatumArray(mp);
+
+	ULONG ulSnd = 0;
+	for (ULONG ulFst = 0; ulFst < Size(); ulFst++)
+	{
+		INT iCmp = 1;
+		while (ulSnd < pps->Size() && 0 < (iCmp = ICompare(ulFst, pps, ulSnd)))
+		{
+			ulSnd++;
+		}
+
+		if (ulSnd == pps->Size() || 0 != iCmp)
+		{
+			AppendPoint(pdrgpdatum, ulFst);
+		}
+	}
+
+	return GPOS_NEW(mp) CPointSet(mp, m_pcomp, pdrgpdatum);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::PpsFilter
+//
+//	@doc:
+//		Points that fall inside the given ranges if 'fInside' is set, or
+//		outside of them otherwise. The ranges must be sorted and disjoint,
+//		as in an interval constraint, so both arrays are walked once.
+//
+//---------------------------------------------------------------------------
+CPointSet *
+CPointSet::PpsFilter(CMemoryPool *mp, CRangeArray *pdrgprng,
+					 BOOL fInside) const
+{
+	GPOS_ASSERT(NULL != pdrgprng);
+
+	IDatumArray *pdrgpdatum = GPOS_NEW(mp) IDatumArray(mp);
+
+	const ULONG ulRanges = pdrgprng->Size();
+	ULONG ulRange = 0;
+	for (ULONG ul = 0; ul < Size(); ul++)
+	{
+		while (ulRange < ulRanges &&
+			   FRangeEndsBefore((*pdrgprng)[ulRange], ul))
+		{
+			ulRange++;
+		}
+
+		BOOL fContained =
+			ulRange < ulRanges && FRangeContains((*pdrgprng)[ulRange], ul);
+		if (fContained == fInside)
+		{
+			AppendPoint(pdrgpdatum, ul);
+		}
+	}
+
+	return GPOS_NEW(mp) CPointSet(mp, m_pcomp, pdrgpdatum);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::PdrgprngPoints
+//
+//	@doc:
+//		One [x,x] range per point
+//
+//---------------------------------------------------------------------------
+CRangeArray *
+CPointSet::PdrgprngPoints(CMemoryPool *mp) const
+{
+	CRangeArray *pdrgprng = GPOS_NEW(mp) CRangeArray(mp);
+
+	const ULONG size = Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		IDatum *datum = (*m_pdrgpdatum)[ul];
+		datum->AddRef();
+		pdrgprng->Append(GPOS_NEW(mp)
+							 CRange(m_pcomp, IMDType::EcmptEq, datum));
+	}
+
+	return pdrgprng;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPointSet::OsPrint
+//
+//	@doc:
+//		Debug print
+//
+//---------------------------------------------------------------------------
+IOstream &
+CPointSet::OsPrint(IOstream &os) const
+{
+	os << "{";
+	const ULONG size = Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		if (0 < ul)
+		{
+			os << ", ";
+		}
+		(*m_pdrgpdatum)[ul]->OsPrint(os);
+	}
+	os << "}";
+
+	return os;
+}
+
+// EOF
@@ -2873,9 +2873,16 @@ CUtils::UlInlinableCTEs(CExpression *pexpr, ULONG ulDepth)
 	if (COperator::EopLogicalCTEConsumer == pop->Eopid())
 	{
 		CLogicalCTEConsumer *popConsumer = CLogicalCTEConsumer::PopConvert(pop);
-		CExpression *pexprProducer =
-			COptCtxt::PoctxtFromTLS()->Pcteinfo()->PexprCTEProducer(
-				popConsumer->UlCTEId());
+		const ULONG ulCTEId = popConsumer->UlCTEId();
+		CCTEInfo *pcteinfo = COptCtxt::PoctxtFromTLS()->Pcteinfo();
+		if (!pcteinfo->FEnableInlining(ulCTEId) &&
+			1 < pcteinfo->UlConsumers(ulCTEId))
+		{
+			// consumer is not inlined, its producer is optimized once
+			return 0;
+		}
+
+		CExpression *pexprProducer = pcteinfo->PexprCTEProducer(ulCTEId);
 		GPOS_ASSERT(NULL != pexprProducer);
 		return ulDepth + UlInlinableCTEs(pexprProducer, ulDepth + 1);
 	}
@@ -57,6 +57,8 @@
 #define GPOPT_JOBS_CAP 5000	 // maximum number of initial optimization jobs
 #define GPOPT_JOBS_PER_GROUP \
 	20	// estimated number of needed optimization jobs per memo group
+#define GPOPT_BUDGET_CHECK_INTERVAL \
+	64	// number of budget checks between two reads of the clock and pool size
 
 // memory consumption unit in bytes -- currently MB
 #define GPOPT_MEM_UNIT (1024 * 1024)
@@ -66,6 +68,45 @@ using namespace gpopt;
 
 FORCE_GENERATE_DBGSTR(CEngine);
 
+// number of optimizations cut short by the budget in this process
+ULONG CEngine::m_ulBudgetTruncations = 0;
+
+// statistics of the last optimization run in this process
+CEngine::SOptimizationStats CEngine::m_ostatsLast;
+
+// exploration xforms applied, besides the implementation xforms, when the
+// memo is implemented after the budget is exhausted; they rewrite logical
+// operators that have no implementation into ones that do, and produce a
+// single alternative each
+static const CXform::EXformId rgexfidRemainder[] = {
+	CXform::ExfExpandNAryJoin,
+	CXform::ExfExpandNAryJoinMinCard,
+	CXform::ExfExpandFullOuterJoin,
+	CXform::ExfMaxOneRow2Assert,
+	CXform::ExfCTEAnchor2Sequence,
+	CXform::ExfCTEAnchor2TrivialSelect,
+	CXform::ExfInsert2DML,
+	CXform::ExfDelete2DML,
+	CXform::ExfUpdate2DML,
+	CXform::ExfUnion2UnionAll,
+	CXform::ExfIntersect2Join,
+	CXform::ExfIntersectAll2LeftSemiJoin,
+	CXform::ExfDifference2LeftAntiSemiJoin,
+	CXform::ExfDifferenceAll2LeftAntiSemiJoin,
+	CXform::ExfInnerApply2InnerJoin,
+	CXform::ExfInnerApply2InnerJoinNoCorrelations,
+	CXform::ExfLeftOuterApply2LeftOuterJoin,
+	CXform::ExfLeftOuterApply2LeftOuterJoinNoCorrelations,
+	CXform::ExfLeftSemiApply2LeftSemiJoin,
+	CXform::ExfLeftSemiApply2LeftSemiJoinNoCorrelations,
+	CXform::ExfLeftSemiApplyIn2LeftSemiJoin,
+	CXform::ExfLeftSemiApplyIn2LeftSemiJoinNoCorrelations,
+	CXform::ExfLeftAntiSemiApply2LeftAntiSemiJoin,
+	CXform::ExfLeftAntiSemiApply2LeftAntiSemiJoinNoCorrelations,
+	CXform::ExfLeftAntiSemiApplyNotIn2LeftAntiSemiJoinNotIn,
+	CXform::ExfLeftAntiSemiApplyNotIn2LeftAntiSemiJoinNotInNoCorrelations,
+};
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CEngine::CEngine
@@ -85,7 +126,12 @@ CEngine::CEngine(CMemoryPool *mp)
 	  m_pdrgpulpXformCalls(NULL),
 	  m_pdrgpulpXformTimes(NULL),
 	  m_pdrgpulpXformBindings(NULL),
-	  m_pdrgpulpXformResults(NULL)
+	  m_pdrgpulpXformResults(NULL),
+	  m_ulTimeBudget(gpos::ulong_max),
+	  m_ullMemoryBudget(0),
+	  m_ulBudgetChecks(0),
+	  m_fBudgetExhausted(false),
+	  m_fImplementingRemainder(false)
 {
 	m_pmemo = GPOS_NEW(mp) CMemo(mp);
 	m_pexprEnforcerPattern =
@@ -169,6 +215,28 @@ CEngine::Init(CQueryContext *pqc, CSearchStageArray *search_stage_array)
 	}
 	GPOS_ASSERT(0 < m_search_stage_array->Size());
 
+	clib::Memset(&m_ostatsLast, 0, sizeof(m_ostatsLast));
+
+	CHint *phint =
+		COptCtxt::PoctxtFromTLS()->GetOptimizerConfig()->GetHint();
+	if (0 != phint->UlOptimizationTimeBudget())
+	{
+		m_ulTimeBudget = phint->UlOptimizationTimeBudget();
+	}
+	m_ullMemoryBudget = (ULLONG) phint->UlOptimizationMemoryBudget() * 1024;
+
+	if (FBudgeted())
+	{
+		// reserve a last stage, with no time threshold, to implement the
+		// memo if the budget is exhausted
+		CXformSet *xform_set = GPOS_NEW(m_mp) CXformSet(m_mp);
+		for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(rgexfidRemainder); ul++)
+		{
+			(void) xform_set->ExchangeSet(rgexfidRemainder[ul]);
+		}
+		m_search_stage_array->Append(GPOS_NEW(m_mp) CSearchStage(xform_set));
+	}
+
 	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
 	{
 		// initialize per-stage xform calls array
@@ -363,6 +431,10 @@ CEngine::InsertXformResult(
 	GPOS_ASSERT(CXform::ExfInvalid != exfidOrigin);
 	GPOS_ASSERT(NULL != pgexprOrigin);
 
+	m_ostatsLast.m_rgulpXformCalls[exfidOrigin] += 1;
+	m_ostatsLast.m_rgulpXformResults[exfidOrigin] +=
+		pxfres->Pdrgpexpr()->Size();
+
 	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics) &&
 		0 < pxfres->Pdrgpexpr()->Size())
 	{
@@ -733,7 +805,7 @@ CEngine::ApplyTransformations(CMemoryPool *pmpLocal, CXformSet *xform_set,
 						  ulElapsedTime, ulNumberOfBindings);
 		pxfres->Release();
 
-		if (PssCurrent()->FTimedOut())
+		if (FStageTerminated())
 		{
 			break;
 		}
@@ -757,7 +829,7 @@ CEngine::TransitionGroupExpression(CMemoryPool *pmpLocal,
 	GPOS_ASSERT(CGroupExpression::estExplored == estTarget ||
 				CGroupExpression::estImplemented == estTarget);
 
-	if (PssCurrent()->FTimedOut())
+	if (FStageTerminated())
 	{
 		return;
 	}
@@ -817,7 +889,7 @@ CEngine::TransitionGroup(CMemoryPool *pmpLocal, CGroup *pgroup,
 	// check stack size
 	GPOS_CHECK_STACK_SIZE;
 
-	if (PssCurrent()->FTimedOut())
+	if (FStageTerminated())
 	{
 		return;
 	}
@@ -865,7 +937,7 @@ CEngine::TransitionGroup(CMemoryPool *pmpLocal, CGroup *pgroup,
 										  estGExprTargetState);
 			}
 
-			if (PssCurrent()->FTimedOut())
+			if (FStageTerminated())
 			{
 				break;
 			}
@@ -982,7 +1054,7 @@ CEngine::PccOptimizeChild(
 	CGroupExpression *pgexprChildBest =
 		PgexprOptimize(pgroupChild, pocChild, pgexpr);
 	pocChild->Release();
-	if (NULL == pgexprChildBest || PssCurrent()->FTimedOut())
+	if (NULL == pgexprChildBest || FStageTerminated())
 	{
 		// failed to generate a plan for the child, or search stage is timed-out
 		return NULL;
@@ -1209,7 +1281,7 @@ CEngine::PgexprOptimize(CGroup *pgroup, COptimizationContext *poc,
 				OptimizeGroupExpression(pgexprCurrent, poc);
 			}
 
-			if (PssCurrent()->FTimedOut())
+			if (FStageTerminated())
 			{
 				break;
 			}
@@ -1250,7 +1322,7 @@ CEngine::Explore()
 	GPOS_ASSERT(!PgroupRoot()->FExplored());
 
 	TransitionGroup(m_mp, PgroupRoot(), CGroup::estExplored /*estTarget*/);
-	GPOS_ASSERT_IMP(!PssCurrent()->FTimedOut(), PgroupRoot()->FExplored());
+	GPOS_ASSERT_IMP(!FStageTerminated(), PgroupRoot()->FExplored());
 }
 
 
@@ -1272,7 +1344,7 @@ CEngine::Implement()
 	GPOS_ASSERT(!PgroupRoot()->FImplemented());
 
 	TransitionGroup(m_mp, PgroupRoot(), CGroup::estImplemented /*estTarget*/);
-	GPOS_ASSERT_IMP(!PssCurrent()->FTimedOut(), PgroupRoot()->FImplemented());
+	GPOS_ASSERT_IMP(!FStageTerminated(), PgroupRoot()->FImplemented());
 }
 
 
@@ -1293,7 +1365,7 @@ CEngine::RecursiveOptimize()
 	CAutoTimer at("\n[OPT]: Total Optimization Time",
 				  GPOS_FTRACE(EopttracePrintOptimizationStatistics));
 
-	const ULONG ulSearchStages = m_search_stage_array->Size();
+	const ULONG ulSearchStages = UlStrategyStages();
 	for (ULONG ul = 0; !FSearchTerminated() && ul < ulSearchStages; ul++)
 	{
 		PssCurrent()->RestartTimer();
@@ -1666,6 +1738,83 @@ CEngine::ProcessTraceFlags()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CEngine::FBudgetExhausted
+//
+//	@doc:
+//		Check if the optimization budget has been exhausted; the clock and
+//		the size of the memory pool are only read every few calls, since
+//		this is checked by every job step
+//
+//---------------------------------------------------------------------------
+BOOL
+CEngine::FBudgetExhausted()
+{
+	if (m_fBudgetExhausted || !FBudgeted())
+	{
+		return m_fBudgetExhausted;
+	}
+
+	if (0 != (++m_ulBudgetChecks % GPOPT_BUDGET_CHECK_INTERVAL))
+	{
+		return false;
+	}
+
+	if ((gpos::ulong_max != m_ulTimeBudget &&
+		 m_timerBudget.ElapsedMS() > m_ulTimeBudget) ||
+		(0 != m_ullMemoryBudget &&
+		 m_mp->TotalAllocatedSize() > m_ullMemoryBudget))
+	{
+		m_fBudgetExhausted = true;
+	}
+
+	return m_fBudgetExhausted;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CEngine::OptimizeSearchStage
+//
+//	@doc:
+//		Optimize the root group in the current search stage, and record
+//		the best plan found at the end of the stage
+//
+//---------------------------------------------------------------------------
+void
+CEngine::OptimizeSearchStage(CSchedulerContext *psc)
+{
+	PssCurrent()->RestartTimer();
+
+	// optimize root group
+	m_pqc->Prpp()->AddRef();
+	COptimizationContext *poc = GPOS_NEW(m_mp) COptimizationContext(
+		m_mp, PgroupRoot(), m_pqc->Prpp(),
+		GPOS_NEW(m_mp) CReqdPropRelational(GPOS_NEW(m_mp) CColRefSet(
+			m_mp)),	 // pass empty required relational properties initially
+		GPOS_NEW(m_mp)
+			IStatisticsArray(m_mp),	 // pass empty stats context initially
+		m_ulCurrSearchStage);
+
+	// schedule main optimization job
+	ScheduleMainJob(psc, poc);
+
+	// run optimization job
+	CScheduler::Run(psc);
+
+	poc->Release();
+
+	// extract best plan found at the end of current search stage
+	CExpression *pexprPlan =
+		m_pmemo->PexprExtractPlan(m_mp, m_pmemo->PgroupRoot(), m_pqc->Prpp(),
+								  m_search_stage_array->Size());
+	PssCurrent()->SetBestExpr(pexprPlan);
+
+	FinalizeSearchStage();
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CEngine::Optimize
@@ -1695,39 +1844,45 @@ CEngine::Optimize()
 	CSchedulerContext sc;
 	sc.Init(m_mp, &jf, &sched, this);
 
-	const ULONG ulSearchStages = m_search_stage_array->Size();
-	for (ULONG ul = 0; !FSearchTerminated() && ul < ulSearchStages; ul++)
-	{
-		PssCurrent()->RestartTimer();
+	m_timerBudget.Restart();
 
-		// optimize root group
-		m_pqc->Prpp()->AddRef();
-		COptimizationContext *poc = GPOS_NEW(m_mp) COptimizationContext(
-			m_mp, PgroupRoot(), m_pqc->Prpp(),
-			GPOS_NEW(m_mp) CReqdPropRelational(GPOS_NEW(m_mp) CColRefSet(
-				m_mp)),	 // pass empty required relational properties initially
-			GPOS_NEW(m_mp)
-				IStatisticsArray(m_mp),	 // pass empty stats context initially
-			m_ulCurrSearchStage);
-
-		// schedule main optimization job
-		ScheduleMainJob(&sc, poc);
+	const ULONG ulSearchStages = UlStrategyStages();
+	for (ULONG ul = 0;
+		 !FSearchTerminated() && !m_fBudgetExhausted && ul < ulSearchStages;
+		 ul++)
+	{
+		OptimizeSearchStage(&sc);
+	}
 
-		// run optimization job
-		CScheduler::Run(&sc);
+	if (m_fBudgetExhausted && !FSearchTerminated())
+	{
+		// the budget ran out in the middle of a stage, skip the remaining
+		// stages of the strategy and implement what the memo holds so far
+		// in the reserved last stage, to return the best plan found instead
+		// of failing the optimization
+		m_ulBudgetTruncations++;
+		m_fImplementingRemainder = true;
+		m_ulCurrSearchStage = m_search_stage_array->Size() - 1;
 
-		poc->Release();
+		OptimizeSearchStage(&sc);
 
-		// extract best plan found at the end of current search stage
-		CExpression *pexprPlan = m_pmemo->PexprExtractPlan(
-			m_mp, m_pmemo->PgroupRoot(), m_pqc->Prpp(),
-			m_search_stage_array->Size());
-		PssCurrent()->SetBestExpr(pexprPlan);
-
-		FinalizeSearchStage();
+		if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
+		{
+			CAutoTrace atBudget(m_mp);
+			atBudget.Os() << "[OPT]: Optimization budget exhausted after "
+						  << m_timerBudget.ElapsedMS() << " msec, "
+						  << m_ulBudgetTruncations
+						  << " optimizations truncated so far";
+		}
 	}
 
 
+	m_ostatsLast.m_ulGroups = (ULONG) m_pmemo->UlpGroups();
+	m_ostatsLast.m_ulDuplicateGroups = m_pmemo->UlDuplicateGroups();
+	m_ostatsLast.m_ulGroupExprs = m_pmemo->UlGrpExprs();
+	m_ostatsLast.m_ulSearchStage = m_ulCurrSearchStage;
+	m_ostatsLast.m_fBudgetExhausted = m_fBudgetExhausted;
+
 	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
 	{
 		CAutoTrace atSearch(m_mp);
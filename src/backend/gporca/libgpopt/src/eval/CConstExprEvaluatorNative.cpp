@@ -0,0 +1,1099 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CConstExprEvaluatorNative.cpp
+//
+//	@doc:
+//		Constant expression evaluator that folds immutable built-in operators
+//		and functions inside the optimizer
+//
+//	@owner:
+//
+//
+//	@test:
+//
+//---------------------------------------------------------------------------
+
+#include "gpopt/eval/CConstExprEvaluatorNative.h"
+
+#include "gpopt/base/COptCtxt.h"
+#include "gpopt/base/CUtils.h"
+#include "gpopt/mdcache/CMDAccessor.h"
+#include "gpopt/operators/CScalarCmp.h"
+#include "gpopt/operators/CScalarConst.h"
+#include "gpopt/operators/CScalarFunc.h"
+#include "gpopt/operators/CScalarOp.h"
+#include "naucrates/base/CDatumGenericGPDB.h"
+#include "naucrates/base/IDatumBool.h"
+#include "naucrates/base/IDatumInt2.h"
+#include "naucrates/base/IDatumInt4.h"
+#include "naucrates/base/IDatumInt8.h"
+#include "naucrates/base/IDatumOid.h"
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/IMDTypeInt2.h"
+#include "naucrates/md/IMDTypeInt4.h"
+#include "naucrates/md/IMDTypeInt8.h"
+#include "naucrates/traceflags/traceflags.h"
+
+using namespace gpopt;
+using namespace gpmd;
+using namespace gpnaucrates;
+
+// microseconds per day
+static const LINT lUsecsPerDay = LINT(86400) * LINT(1000000);
+
+// julian day number of 2000-01-01, the epoch of date and timestamp values
+static const INT iEpochJulian = 2451545;
+
+// number of days in each month, for non-leap and leap years
+static const INT rgrgiDaysInMonth[2][12] = {
+	{31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
+	{31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}};
+
+// table of foldable operators and the functions implementing them; all of
+// them are immutable and strict
+const CConstExprEvaluatorNative::SNativeOpMapping
+	CConstExprEvaluatorNative::m_rgnopmap[] = {
+		// int2pl, int4pl, int8pl
+		{OID(550), OID(176), EnopIntPlus},
+		{OID(551), OID(177), EnopIntPlus},
+		{OID(684), OID(463), EnopIntPlus},
+		// int2mi, int4mi, int8mi
+		{OID(554), OID(180), EnopIntMinus},
+		{OID(555), OID(181), EnopIntMinus},
+		{OID(685), OID(464), EnopIntMinus},
+		// int2mul, int4mul, int8mul
+		{OID(526), OID(152), EnopIntMult},
+		{OID(514), OID(141), EnopIntMult},
+		{OID(686), OID(465), EnopIntMult},
+		// date_pli, date_mii, date_mi
+		{OID(1100), OID(1141), EnopDatePlusInt},
+		{OID(1101), OID(1142), EnopDateMinusInt},
+		{OID(1099), OID(1140), EnopDateMinusDate},
+		// date_pl_interval, date_mi_interval
+		{OID(1076), OID(2071), EnopDatePlusInterval},
+		{OID(1077), OID(2072), EnopDateMinusInterval},
+		// timestamp_pl_interval, timestamp_mi_interval
+		{OID(2066), OID(2032), EnopTimestampPlusInterval},
+		{OID(2068), OID(2033), EnopTimestampMinusInterval},
+};
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::CConstExprEvaluatorNative
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CConstExprEvaluatorNative::CConstExprEvaluatorNative(
+	CMemoryPool *mp, IConstExprEvaluator *pceevalFallback,
+	BOOL fIntegerDatetimes)
+	: m_mp(mp),
+	  m_pceevalFallback(pceevalFallback),
+	  m_fIntegerDatetimes(fIntegerDatetimes)
+{
+	GPOS_ASSERT(NULL != mp);
+	GPOS_ASSERT(NULL != pceevalFallback);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::~CConstExprEvaluatorNative
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CConstExprEvaluatorNative::~CConstExprEvaluatorNative()
+{
+	m_pceevalFallback->Release();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FNativeEvalEnabled
+//
+//	@doc:
+//		Is native evaluation enabled for the current optimization
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FNativeEvalEnabled()
+{
+	return !GPOS_FTRACE(EopttraceDisableNativeConstantExpressionEvaluation);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FDecode
+//
+//	@doc:
+//		Decode a non-null datum into its native representation. Returns false
+//		if the type of the datum is not supported.
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FDecode(const IDatum *datum, SValue *pval) const
+{
+	GPOS_ASSERT(NULL != pval);
+
+	if (datum->IsNull())
+	{
+		return false;
+	}
+
+	pval->m_lint = 0;
+	pval->m_dbl = 0;
+	pval->m_day = 0;
+	pval->m_month = 0;
+
+	IMDId *mdid = datum->MDId();
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_int2))
+	{
+		pval->m_evk = EvkInt;
+		pval->m_lint = dynamic_cast<const IDatumInt2 *>(datum)->Value();
+		return true;
+	}
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_int4))
+	{
+		pval->m_evk = EvkInt;
+		pval->m_lint = dynamic_cast<const IDatumInt4 *>(datum)->Value();
+		return true;
+	}
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_int8))
+	{
+		pval->m_evk = EvkInt;
+		pval->m_lint = dynamic_cast<const IDatumInt8 *>(datum)->Value();
+		return true;
+	}
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_bool))
+	{
+		pval->m_evk = EvkBool;
+		pval->m_lint =
+			dynamic_cast<const IDatumBool *>(datum)->GetValue() ? 1 : 0;
+		return true;
+	}
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_oid))
+	{
+		pval->m_evk = EvkOid;
+		pval->m_lint = dynamic_cast<const IDatumOid *>(datum)->OidValue();
+		return true;
+	}
+
+	// remaining types are stored as the raw bytes of the backend datum
+	const BYTE *pba = datum->GetByteArrayValue();
+	ULONG ulSize = datum->Size();
+	if (NULL == pba)
+	{
+		return false;
+	}
+
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_date) && sizeof(INT) == ulSize)
+	{
+		INT iDate = 0;
+		(void) clib::Memcpy(&iDate, pba, sizeof(iDate));
+		pval->m_evk = EvkDate;
+		pval->m_lint = iDate;
+		return true;
+	}
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_float8) && sizeof(DOUBLE) == ulSize)
+	{
+		DOUBLE d = 0;
+		(void) clib::Memcpy(&d, pba, sizeof(d));
+		pval->m_evk = EvkFloat;
+		pval->m_dbl = d;
+		return true;
+	}
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_float4) && sizeof(float) == ulSize)
+	{
+		float f = 0;
+		(void) clib::Memcpy(&f, pba, sizeof(f));
+		pval->m_evk = EvkFloat;
+		pval->m_dbl = f;
+		return true;
+	}
+
+	// time, timestamp and interval values are only understood when the
+	// server represents them as 64-bit integers
+	if (!m_fIntegerDatetimes)
+	{
+		return false;
+	}
+
+	EValueKind evk = EvkSentinel;
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_time))
+	{
+		evk = EvkTime;
+	}
+	else if (mdid->Equals(&CMDIdGPDB::m_mdid_timestamp))
+	{
+		evk = EvkTimestamp;
+	}
+	else if (mdid->Equals(&CMDIdGPDB::m_mdid_timestampTz))
+	{
+		evk = EvkTimestampTz;
+	}
+
+	if (EvkSentinel != evk && sizeof(LINT) == ulSize)
+	{
+		LINT l = 0;
+		(void) clib::Memcpy(&l, pba, sizeof(l));
+		pval->m_evk = evk;
+		pval->m_lint = l;
+		return true;
+	}
+
+	// an interval is laid out as int64 time, int32 day, int32 month
+	if (mdid->Equals(&CMDIdGPDB::m_mdid_interval) &&
+		sizeof(LINT) + 2 * sizeof(INT) == ulSize)
+	{
+		pval->m_evk = EvkInterval;
+		(void) clib::Memcpy(&pval->m_lint, pba, sizeof(LINT));
+		(void) clib::Memcpy(&pval->m_day, pba + sizeof(LINT), sizeof(INT));
+		(void) clib::Memcpy(&pval->m_month, pba + sizeof(LINT) + sizeof(INT),
+							sizeof(INT));
+		return true;
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::ICompare
+//
+//	@doc:
+//		Three-way comparison of two decoded values of the same kind, following
+//		the semantics of the corresponding btree support functions
+//
+//---------------------------------------------------------------------------
+INT
+CConstExprEvaluatorNative::ICompare(const SValue &valLeft,
+									const SValue &valRight)
+{
+	GPOS_ASSERT(valLeft.m_evk == valRight.m_evk);
+
+	switch (valLeft.m_evk)
+	{
+		case EvkFloat:
+		{
+			// NaN is equal to NaN and greater than any other value
+			BOOL fLeftNaN = valLeft.m_dbl != valLeft.m_dbl;
+			BOOL fRightNaN = valRight.m_dbl != valRight.m_dbl;
+			if (fLeftNaN || fRightNaN)
+			{
+				return (fLeftNaN && fRightNaN) ? 0 : (fLeftNaN ? 1 : -1);
+			}
+			if (valLeft.m_dbl == valRight.m_dbl)
+			{
+				return 0;
+			}
+			return valLeft.m_dbl < valRight.m_dbl ? -1 : 1;
+		}
+
+		case EvkInterval:
+		{
+			// intervals compare by their span with a month counted as 30
+			// days; compare whole days first and then the remaining fraction
+			// of a day, normalized to be non-negative, to avoid overflow
+			LINT rglDays[2];
+			LINT rglFrac[2];
+			const SValue *rgpval[2] = {&valLeft, &valRight};
+			for (ULONG ul = 0; ul < 2; ul++)
+			{
+				rglDays[ul] = rgpval[ul]->m_lint / lUsecsPerDay +
+							  LINT(rgpval[ul]->m_month) * 30 +
+							  rgpval[ul]->m_day;
+				rglFrac[ul] = rgpval[ul]->m_lint % lUsecsPerDay;
+				if (0 > rglFrac[ul])
+				{
+					rglFrac[ul] += lUsecsPerDay;
+					rglDays[ul]--;
+				}
+			}
+			if (rglDays[0] != rglDays[1])
+			{
+				return rglDays[0] < rglDays[1] ? -1 : 1;
+			}
+			if (rglFrac[0] != rglFrac[1])
+			{
+				return rglFrac[0] < rglFrac[1] ? -1 : 1;
+			}
+			return 0;
+		}
+
+		case EvkOid:
+		{
+			// oids are unsigned
+			ULONG ulLeft = (ULONG) valLeft.m_lint;
+			ULONG ulRight = (ULONG) valRight.m_lint;
+			if (ulLeft == ulRight)
+			{
+				return 0;
+			}
+			return ulLeft < ulRight ? -1 : 1;
+		}
+
+		default:
+		{
+			if (valLeft.m_lint == valRight.m_lint)
+			{
+				return 0;
+			}
+			return valLeft.m_lint < valRight.m_lint ? -1 : 1;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FCompare
+//
+//	@doc:
+//		Evaluate a comparison on decoded values
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FCompare(const SValue &valLeft,
+									const SValue &valRight,
+									IMDType::ECmpType cmp_type)
+{
+	INT iCmp = ICompare(valLeft, valRight);
+	switch (cmp_type)
+	{
+		case IMDType::EcmptEq:
+			return 0 == iCmp;
+		case IMDType::EcmptNEq:
+			return 0 != iCmp;
+		case IMDType::EcmptL:
+			return 0 > iCmp;
+		case IMDType::EcmptLEq:
+			return 0 >= iCmp;
+		case IMDType::EcmptG:
+			return 0 < iCmp;
+		case IMDType::EcmptGEq:
+			return 0 <= iCmp;
+		default:
+			GPOS_ASSERT(!"Unsupported comparison");
+			return false;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::EnopFromOid
+//
+//	@doc:
+//		Look up the native operation for an operator or function oid
+//
+//---------------------------------------------------------------------------
+CConstExprEvaluatorNative::ENativeOp
+CConstExprEvaluatorNative::EnopFromOid(OID oid, BOOL fFunc)
+{
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(m_rgnopmap); ul++)
+	{
+		const SNativeOpMapping &nopmap = m_rgnopmap[ul];
+		if ((fFunc ? nopmap.m_func_oid : nopmap.m_op_oid) == oid)
+		{
+			return nopmap.m_enop;
+		}
+	}
+
+	return EnopSentinel;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::IDate2Julian
+//
+//	@doc:
+//		Convert a gregorian date to a julian day number, as date2j does
+//
+//---------------------------------------------------------------------------
+INT
+CConstExprEvaluatorNative::IDate2Julian(INT iYear, INT iMonth, INT iDay)
+{
+	if (iMonth > 2)
+	{
+		iMonth += 1;
+		iYear += 4800;
+	}
+	else
+	{
+		iMonth += 13;
+		iYear += 4799;
+	}
+
+	INT iCentury = iYear / 100;
+	INT iJulian = iYear * 365 - 32167;
+	iJulian += iYear / 4 - iCentury + iCentury / 4;
+	iJulian += 7834 * iMonth / 256 + iDay;
+
+	return iJulian;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::Julian2Date
+//
+//	@doc:
+//		Convert a julian day number to a gregorian date, as j2date does
+//
+//---------------------------------------------------------------------------
+void
+CConstExprEvaluatorNative::Julian2Date(INT iJulian, INT *piYear, INT *piMonth,
+									   INT *piDay)
+{
+	ULONG ulJulian = iJulian + 32044;
+	ULONG ulQuad = ulJulian / 146097;
+	ULONG ulExtra = (ulJulian - ulQuad * 146097) * 4 + 3;
+	ulJulian += 60 + ulQuad * 3 + ulExtra / 146097;
+	ulQuad = ulJulian / 1461;
+	ulJulian -= ulQuad * 1461;
+	INT iYear = ulJulian * 4 / 1461;
+	ulJulian = ((0 != iYear) ? ((ulJulian + 305) % 365)
+							 : ((ulJulian + 306) % 366)) +
+			   123;
+	iYear += ulQuad * 4;
+	*piYear = iYear - 4800;
+	ulQuad = ulJulian * 2141 / 65536;
+	*piDay = ulJulian - 7834 * ulQuad / 256;
+	*piMonth = (ulQuad + 10) % 12 + 1;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FTimestampPlusInterval
+//
+//	@doc:
+//		Add an interval to a finite timestamp, applying the month, day and
+//		time parts in that order like timestamp_pl_interval. Returns false
+//		whenever the executor would raise an out of range error, so that the
+//		error is reported by the fallback evaluator.
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FTimestampPlusInterval(LINT lTimestamp, LINT lTime,
+												  INT iDay, INT iMonth,
+												  LINT *plResult)
+{
+	// infinite timestamps are left alone by the executor; do not bother
+	if (gpos::lint_max == lTimestamp || gpos::lint_min == lTimestamp)
+	{
+		return false;
+	}
+
+	// split into a julian day and the time of day
+	LINT lDays = lTimestamp / lUsecsPerDay;
+	LINT lTimeOfDay = lTimestamp % lUsecsPerDay;
+	if (0 > lTimeOfDay)
+	{
+		lTimeOfDay += lUsecsPerDay;
+		lDays--;
+	}
+	LINT lJulian = lDays + iEpochJulian;
+	if (0 > lJulian || gpos::int_max < lJulian)
+	{
+		return false;
+	}
+
+	INT iYear = 0;
+	INT iMon = 0;
+	INT iMday = 0;
+	Julian2Date((INT) lJulian, &iYear, &iMon, &iMday);
+
+	if (0 != iMonth)
+	{
+		LINT lMon = LINT(iMon) + iMonth;
+		LINT lYear = iYear;
+		if (12 < lMon)
+		{
+			lYear += (lMon - 1) / 12;
+			lMon = ((lMon - 1) % 12) + 1;
+		}
+		else if (1 > lMon)
+		{
+			lYear += lMon / 12 - 1;
+			lMon = lMon % 12 + 12;
+		}
+
+		// stay well inside the range where the julian arithmetic is valid
+		if (-4713 > lYear || 294276 < lYear)
+		{
+			return false;
+		}
+		iYear = (INT) lYear;
+		iMon = (INT) lMon;
+
+		BOOL fLeap =
+			(0 == iYear % 4) && ((0 != iYear % 100) || (0 == iYear % 400));
+		if (iMday > rgrgiDaysInMonth[fLeap][iMon - 1])
+		{
+			iMday = rgrgiDaysInMonth[fLeap][iMon - 1];
+		}
+	}
+
+	lJulian = LINT(IDate2Julian(iYear, iMon, iMday)) + iDay;
+	if (0 > lJulian || gpos::int_max < lJulian)
+	{
+		return false;
+	}
+
+	// the day count is bounded by the check above, so this does not overflow
+	LINT lResult = (lJulian - iEpochJulian) * lUsecsPerDay + lTimeOfDay;
+
+	// guard against overflow when adding the time part
+	if ((0 < lTime && gpos::lint_max - lTime < lResult) ||
+		(0 > lTime && gpos::lint_min - lTime > lResult))
+	{
+		return false;
+	}
+	lResult += lTime;
+
+	// do not produce values that collide with the infinity markers
+	if (gpos::lint_max == lResult || gpos::lint_min == lResult)
+	{
+		return false;
+	}
+
+	*plResult = lResult;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FApply
+//
+//	@doc:
+//		Compute a native operation on decoded arguments. Returns false if the
+//		arguments do not match the operation or if the executor would raise
+//		an error, e.g. on integer overflow.
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FApply(ENativeOp enop, const SValue &valLeft,
+								  const SValue &valRight, SValue *pvalResult)
+{
+	pvalResult->m_dbl = 0;
+	pvalResult->m_day = 0;
+	pvalResult->m_month = 0;
+
+	switch (enop)
+	{
+		case EnopIntPlus:
+		case EnopIntMinus:
+		case EnopIntMult:
+		{
+			if (EvkInt != valLeft.m_evk || EvkInt != valRight.m_evk)
+			{
+				return false;
+			}
+
+			// compute in 64 bits; results that do not fit the narrower
+			// result types are rejected when the constant is built
+			LINT lLeft = valLeft.m_lint;
+			LINT lRight = valRight.m_lint;
+			LINT lResult = 0;
+			if (EnopIntPlus == enop)
+			{
+				if ((0 < lRight && gpos::lint_max - lRight < lLeft) ||
+					(0 > lRight && gpos::lint_min - lRight > lLeft))
+				{
+					return false;
+				}
+				lResult = lLeft + lRight;
+			}
+			else if (EnopIntMinus == enop)
+			{
+				if ((0 > lRight && gpos::lint_max + lRight < lLeft) ||
+					(0 < lRight && gpos::lint_min + lRight > lLeft))
+				{
+					return false;
+				}
+				lResult = lLeft - lRight;
+			}
+			else
+			{
+				// multiply in unsigned arithmetic to keep wraparound defined,
+				// then detect overflow the way int8mul does
+				if ((-1 == lLeft && gpos::lint_min == lRight) ||
+					(-1 == lRight && gpos::lint_min == lLeft))
+				{
+					return false;
+				}
+				lResult = (LINT)((ULLONG) lLeft * (ULLONG) lRight);
+				if (0 != lLeft && lResult / lLeft != lRight)
+				{
+					return false;
+				}
+			}
+			pvalResult->m_evk = EvkInt;
+			pvalResult->m_lint = lResult;
+			return true;
+		}
+
+		case EnopDatePlusInt:
+		case EnopDateMinusInt:
+		{
+			if (EvkDate != valLeft.m_evk || EvkInt != valRight.m_evk)
+			{
+				return false;
+			}
+
+			// leave infinite dates and anything near the int32 limits to the
+			// executor
+			LINT lResult = EnopDatePlusInt == enop
+							   ? valLeft.m_lint + valRight.m_lint
+							   : valLeft.m_lint - valRight.m_lint;
+			if (gpos::int_max == valLeft.m_lint ||
+				gpos::int_min == valLeft.m_lint || gpos::int_max <= lResult ||
+				gpos::int_min >= lResult)
+			{
+				return false;
+			}
+			pvalResult->m_evk = EvkDate;
+			pvalResult->m_lint = lResult;
+			return true;
+		}
+
+		case EnopDateMinusDate:
+		{
+			if (EvkDate != valLeft.m_evk || EvkDate != valRight.m_evk)
+			{
+				return false;
+			}
+
+			// subtracting infinite dates is an error in the executor
+			if (gpos::int_max == valLeft.m_lint ||
+				gpos::int_min == valLeft.m_lint ||
+				gpos::int_max == valRight.m_lint ||
+				gpos::int_min == valRight.m_lint)
+			{
+				return false;
+			}
+			LINT lResult = valLeft.m_lint - valRight.m_lint;
+			if (gpos::int_max < lResult || gpos::int_min > lResult)
+			{
+				return false;
+			}
+			pvalResult->m_evk = EvkInt;
+			pvalResult->m_lint = lResult;
+			return true;
+		}
+
+		case EnopDatePlusInterval:
+		case EnopDateMinusInterval:
+		case EnopTimestampPlusInterval:
+		case EnopTimestampMinusInterval:
+		{
+			BOOL fDate = (EnopDatePlusInterval == enop ||
+						  EnopDateMinusInterval == enop);
+			if ((fDate ? EvkDate : EvkTimestamp) != valLeft.m_evk ||
+				EvkInterval != valRight.m_evk)
+			{
+				return false;
+			}
+
+			LINT lTimestamp = valLeft.m_lint;
+			if (fDate)
+			{
+				if (gpos::int_max == valLeft.m_lint ||
+					gpos::int_min == valLeft.m_lint)
+				{
+					return false;
+				}
+				// a date always fits into a timestamp when multiplied out in
+				// 64 bits; the range check happens when adding the interval
+				lTimestamp = valLeft.m_lint * lUsecsPerDay;
+			}
+
+			LINT lTime = valRight.m_lint;
+			INT iDay = valRight.m_day;
+			INT iMonth = valRight.m_month;
+			if (EnopDateMinusInterval == enop ||
+				EnopTimestampMinusInterval == enop)
+			{
+				if (gpos::lint_min == lTime || gpos::int_min == iDay ||
+					gpos::int_min == iMonth)
+				{
+					return false;
+				}
+				lTime = -lTime;
+				iDay = -iDay;
+				iMonth = -iMonth;
+			}
+
+			LINT lResult = 0;
+			if (!FTimestampPlusInterval(lTimestamp, lTime, iDay, iMonth,
+										&lResult))
+			{
+				return false;
+			}
+			pvalResult->m_evk = EvkTimestamp;
+			pvalResult->m_lint = lResult;
+			return true;
+		}
+
+		default:
+			return false;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::PexprConst
+//
+//	@doc:
+//		Construct a constant of the given type from a decoded value. Returns
+//		NULL if the value does not fit the type.
+//
+//---------------------------------------------------------------------------
+CExpression *
+CConstExprEvaluatorNative::PexprConst(IMDId *mdid_type, const SValue &val) const
+{
+	CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
+	IDatum *datum = NULL;
+
+	if (mdid_type->Equals(&CMDIdGPDB::m_mdid_int2))
+	{
+		if (gpos::sint_max < val.m_lint || gpos::sint_min > val.m_lint)
+		{
+			return NULL;
+		}
+		const IMDTypeInt2 *pmdtype = md_accessor->PtMDType<IMDTypeInt2>();
+		datum = pmdtype->CreateInt2Datum(m_mp, (SINT) val.m_lint, false);
+	}
+	else if (mdid_type->Equals(&CMDIdGPDB::m_mdid_int4))
+	{
+		if (gpos::int_max < val.m_lint || gpos::int_min > val.m_lint)
+		{
+			return NULL;
+		}
+		const IMDTypeInt4 *pmdtype = md_accessor->PtMDType<IMDTypeInt4>();
+		datum = pmdtype->CreateInt4Datum(m_mp, (INT) val.m_lint, false);
+	}
+	else if (mdid_type->Equals(&CMDIdGPDB::m_mdid_int8))
+	{
+		const IMDTypeInt8 *pmdtype = md_accessor->PtMDType<IMDTypeInt8>();
+		datum = pmdtype->CreateInt8Datum(m_mp, val.m_lint, false);
+	}
+	else if (mdid_type->Equals(&CMDIdGPDB::m_mdid_date) &&
+			 EvkDate == val.m_evk)
+	{
+		// dates map to their day number for statistics
+		INT iDate = (INT) val.m_lint;
+		mdid_type->AddRef();
+		datum = GPOS_NEW(m_mp)
+			CDatumGenericGPDB(m_mp, mdid_type, default_type_modifier, &iDate,
+							  sizeof(iDate), false /*is_null*/,
+							  val.m_lint /*stats_comp_val_int*/,
+							  CDouble(0.0) /*stats_comp_val_double*/);
+	}
+	else if (mdid_type->Equals(&CMDIdGPDB::m_mdid_timestamp) &&
+			 EvkTimestamp == val.m_evk)
+	{
+		// timestamps map to their microsecond count for statistics
+		LINT lTimestamp = val.m_lint;
+		mdid_type->AddRef();
+		datum = GPOS_NEW(m_mp) CDatumGenericGPDB(
+			m_mp, mdid_type, default_type_modifier, &lTimestamp,
+			sizeof(lTimestamp), false /*is_null*/, 0 /*stats_comp_val_int*/,
+			CDouble((DOUBLE) lTimestamp) /*stats_comp_val_double*/);
+	}
+	else
+	{
+		return NULL;
+	}
+
+	return GPOS_NEW(m_mp)
+		CExpression(m_mp, GPOS_NEW(m_mp) CScalarConst(m_mp, datum));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FEvalArg
+//
+//	@doc:
+//		Obtain the value of an argument of a comparison or operator. The
+//		argument is either a constant or an expression that can be folded
+//		natively; in the latter case the folded expression is returned in
+//		ppexprFolded and must be released by the caller. Sets *ppdatum to
+//		NULL for a NULL argument.
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FEvalArg(CExpression *pexpr, const IDatum **ppdatum,
+									SValue *pval, CExpression **ppexprFolded)
+{
+	*ppexprFolded = NULL;
+	CExpression *pexprConst = pexpr;
+	if (COperator::EopScalarConst != pexpr->Pop()->Eopid())
+	{
+		*ppexprFolded = PexprEvalNative(pexpr);
+		if (NULL == *ppexprFolded)
+		{
+			return false;
+		}
+		pexprConst = *ppexprFolded;
+	}
+
+	const IDatum *datum =
+		CScalarConst::PopConvert(pexprConst->Pop())->GetDatum();
+	if (datum->IsNull())
+	{
+		*ppdatum = NULL;
+		return true;
+	}
+
+	*ppdatum = datum;
+	if (!FDecode(datum, pval))
+	{
+		CRefCount::SafeRelease(*ppexprFolded);
+		*ppexprFolded = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::PexprEvalCmp
+//
+//	@doc:
+//		Evaluate a comparison between two natively evaluable arguments
+//
+//---------------------------------------------------------------------------
+CExpression *
+CConstExprEvaluatorNative::PexprEvalCmp(CExpression *pexpr)
+{
+	CScalarCmp *popCmp = CScalarCmp::PopConvert(pexpr->Pop());
+	IMDType::ECmpType cmp_type = popCmp->ParseCmpType();
+	if (IMDType::EcmptOther == cmp_type || IMDType::EcmptIDF == cmp_type)
+	{
+		return NULL;
+	}
+
+	const IDatum *rgpdatum[2];
+	SValue rgval[2];
+	CExpression *rgpexprFolded[2] = {NULL, NULL};
+	BOOL fSuccess = true;
+	for (ULONG ul = 0; fSuccess && ul < 2; ul++)
+	{
+		fSuccess = FEvalArg((*pexpr)[ul], &rgpdatum[ul], &rgval[ul],
+							&rgpexprFolded[ul]);
+	}
+
+	CExpression *pexprResult = NULL;
+	if (fSuccess)
+	{
+		if (NULL == rgpdatum[0] || NULL == rgpdatum[1])
+		{
+			// comparison operators are strict
+			pexprResult = CUtils::PexprScalarConstBool(m_mp, false /*fval*/,
+													   true /*is_null*/);
+		}
+		else if (rgval[0].m_evk == rgval[1].m_evk &&
+				 (EvkInt == rgval[0].m_evk ||
+				  rgpdatum[0]->MDId()->Equals(rgpdatum[1]->MDId())))
+		{
+			// integers of different widths compare by value; everything else
+			// is only folded when both sides are of the same type
+			pexprResult = CUtils::PexprScalarConstBool(
+				m_mp, FCompare(rgval[0], rgval[1], cmp_type));
+		}
+	}
+
+	CRefCount::SafeRelease(rgpexprFolded[0]);
+	CRefCount::SafeRelease(rgpexprFolded[1]);
+
+	return pexprResult;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::PexprEvalOp
+//
+//	@doc:
+//		Evaluate a foldable built-in operator or function
+//
+//---------------------------------------------------------------------------
+CExpression *
+CConstExprEvaluatorNative::PexprEvalOp(CExpression *pexpr)
+{
+	COperator *pop = pexpr->Pop();
+	BOOL fFunc = (COperator::EopScalarFunc == pop->Eopid());
+	IMDId *mdid = NULL;
+	IMDId *mdid_type = NULL;
+	if (fFunc)
+	{
+		CScalarFunc *popFunc = CScalarFunc::PopConvert(pop);
+		mdid = popFunc->FuncMdId();
+		mdid_type = popFunc->MdidType();
+	}
+	else
+	{
+		CScalarOp *popOp = CScalarOp::PopConvert(pop);
+		mdid = popOp->MdIdOp();
+		mdid_type = popOp->MdidType();
+	}
+
+	if (2 != pexpr->Arity() || IMDId::EmdidGeneral != mdid->MdidType() ||
+		NULL == mdid_type || IMDId::EmdidGeneral != mdid_type->MdidType())
+	{
+		return NULL;
+	}
+
+	ENativeOp enop = EnopFromOid(CMDIdGPDB::CastMdid(mdid)->Oid(), fFunc);
+	if (EnopSentinel == enop)
+	{
+		return NULL;
+	}
+
+	const IDatum *rgpdatum[2];
+	SValue rgval[2];
+	CExpression *rgpexprFolded[2] = {NULL, NULL};
+	BOOL fSuccess = true;
+	for (ULONG ul = 0; fSuccess && ul < 2; ul++)
+	{
+		fSuccess = FEvalArg((*pexpr)[ul], &rgpdatum[ul], &rgval[ul],
+							&rgpexprFolded[ul]);
+	}
+
+	CExpression *pexprResult = NULL;
+	if (fSuccess)
+	{
+		if (NULL == rgpdatum[0] || NULL == rgpdatum[1])
+		{
+			// all supported operators are strict
+			CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
+			pexprResult = CUtils::PexprScalarConstNull(
+				m_mp, md_accessor->RetrieveType(mdid_type),
+				default_type_modifier);
+		}
+		else
+		{
+			SValue valResult;
+			if (FApply(enop, rgval[0], rgval[1], &valResult))
+			{
+				pexprResult = PexprConst(mdid_type, valResult);
+			}
+		}
+	}
+
+	CRefCount::SafeRelease(rgpexprFolded[0]);
+	CRefCount::SafeRelease(rgpexprFolded[1]);
+
+	return pexprResult;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::PexprEvalNative
+//
+//	@doc:
+//		Evaluate the given expression inside the optimizer. Returns NULL if
+//		the expression cannot be folded natively.
+//
+//---------------------------------------------------------------------------
+CExpression *
+CConstExprEvaluatorNative::PexprEvalNative(CExpression *pexpr)
+{
+	GPOS_ASSERT(NULL != pexpr);
+
+	if (!FNativeEvalEnabled())
+	{
+		return NULL;
+	}
+
+	switch (pexpr->Pop()->Eopid())
+	{
+		case COperator::EopScalarConst:
+			pexpr->AddRef();
+			return pexpr;
+
+		case COperator::EopScalarCmp:
+			return PexprEvalCmp(pexpr);
+
+		case COperator::EopScalarOp:
+		case COperator::EopScalarFunc:
+			return PexprEvalOp(pexpr);
+
+		default:
+			return NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::PexprEval
+//
+//	@doc:
+//		Evaluate the given expression and return the result as a new
+//		expression. Caller takes ownership of returned expression.
+//
+//---------------------------------------------------------------------------
+CExpression *
+CConstExprEvaluatorNative::PexprEval(CExpression *pexpr)
+{
+	CExpression *pexprResult = PexprEvalNative(pexpr);
+	if (NULL != pexprResult)
+	{
+		return pexprResult;
+	}
+
+	return m_pceevalFallback->PexprEval(pexpr);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FCanEvalExpressions
+//
+//	@doc:
+//		Returns true iff the fallback evaluator can evaluate expressions; the
+//		native evaluator alone covers only a subset of them
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FCanEvalExpressions()
+{
+	return m_pceevalFallback->FCanEvalExpressions();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNative::FEvalDatumComparison
+//
+//	@doc:
+//		Compare two non-null datums of the same natively supported type
+//		without constructing a comparison expression
+//
+//---------------------------------------------------------------------------
+BOOL
+CConstExprEvaluatorNative::FEvalDatumComparison(const IDatum *datum1,
+												const IDatum *datum2,
+												IMDType::ECmpType cmp_type,
+												BOOL *pfResult)
+{
+	GPOS_ASSERT(NULL != pfResult);
+
+	if (!FNativeEvalEnabled() || !datum1->MDId()->Equals(datum2->MDId()))
+	{
+		return false;
+	}
+
+	SValue val1;
+	SValue val2;
+	if (!FDecode(datum1, &val1) || !FDecode(datum2, &val2))
+	{
+		return false;
+	}
+
+	*pfResult = FCompare(val1, val2, cmp_type);
+	return true;
+}
+
+// EOF
@@ -42,8 +42,11 @@
 #include "gpopt/operators/CNormalizer.h"
 #include "gpopt/operators/COrderedAggPreprocessor.h"
 #include "gpopt/operators/CPredicateUtils.h"
+#include "gpopt/operators/CScalarAggFunc.h"
 #include "gpopt/operators/CScalarCmp.h"
+#include "gpopt/operators/CScalarCoalesce.h"
 #include "gpopt/operators/CScalarNAryJoinPredList.h"
+#include "gpopt/operators/CScalarFunc.h"
 #include "gpopt/operators/CScalarProjectElement.h"
 #include "gpopt/operators/CScalarProjectList.h"
 #include "gpopt/operators/CScalarSubquery.h"
@@ -54,6 +57,8 @@
 #include "gpopt/operators/CWindowPreprocessor.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
 #include "gpopt/xforms/CXform.h"
+#include "naucrates/dxl/gpdb_types.h"
+#include "naucrates/md/IMDFunction.h"
 #include "naucrates/md/IMDScalarOp.h"
 #include "naucrates/md/IMDType.h"
 #include "naucrates/statistics/CStatistics.h"
@@ -484,6 +489,144 @@ CExpressionPreprocessor::PexprRemoveSuperfluousDistinctInDQA(CMemoryPool *mp,
 	return GPOS_NEW(mp) CExpression(mp, pop, pdrgpexprChildren);
 }
 
+// replace count(distinct) aggregates with a HyperLogLog estimate
+// e.g. select count(distinct a) from tbl ->
+//		select coalesce(gp_hyperloglog_get_estimate(s)::int8, 0)
+//		from (select gp_hyperloglog_accum(a) s from tbl)
+// the sketch aggregate has a combine function, so the global aggregate can
+// be split into a local and a global stage without redistributing on a
+CExpression *
+CExpressionPreprocessor::PexprApproxCountDistinct(CMemoryPool *mp,
+												  CExpression *pexpr)
+{
+	// protect against stack overflow during recursion
+	GPOS_CHECK_STACK_SIZE;
+	GPOS_ASSERT(NULL != mp);
+	GPOS_ASSERT(NULL != pexpr);
+
+	COperator *pop = pexpr->Pop();
+
+	// recursively process children
+	const ULONG arity = pexpr->Arity();
+	CExpressionArray *pdrgpexprChildren = GPOS_NEW(mp) CExpressionArray(mp);
+	for (ULONG ul = 0; ul < arity; ul++)
+	{
+		pdrgpexprChildren->Append(
+			PexprApproxCountDistinct(mp, (*pexpr)[ul]));
+	}
+
+	if (COperator::EopLogicalGbAgg != pop->Eopid() ||
+		COperator::EgbaggtypeGlobal !=
+			CLogicalGbAgg::PopConvert(pop)->Egbaggtype())
+	{
+		pop->AddRef();
+		return GPOS_NEW(mp) CExpression(mp, pop, pdrgpexprChildren);
+	}
+
+	CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
+	CColumnFactory *col_factory = COptCtxt::PoctxtFromTLS()->Pcf();
+
+	CExpression *pexprProjectList = (*pdrgpexprChildren)[1];
+	CExpressionArray *pdrgpexprAggPrjElems = GPOS_NEW(mp) CExpressionArray(mp);
+	CExpressionArray *pdrgpexprEstimatePrjElems =
+		GPOS_NEW(mp) CExpressionArray(mp);
+
+	const ULONG ulPrjElems = pexprProjectList->Arity();
+	for (ULONG ul = 0; ul < ulPrjElems; ul++)
+	{
+		CExpression *pexprPrjElem = (*pexprProjectList)[ul];
+		CExpression *pexprAggFunc = (*pexprPrjElem)[0];
+		if (COperator::EopScalarAggFunc != pexprAggFunc->Pop()->Eopid() ||
+			!CScalarAggFunc::PopConvert(pexprAggFunc->Pop())->FCountAny() ||
+			!CScalarAggFunc::PopConvert(pexprAggFunc->Pop())->IsDistinct() ||
+			1 != (*pexprAggFunc)[EaggfuncIndexArgs]->Arity() ||
+			0 != (*pexprAggFunc)[EaggfuncIndexOrder]->Arity())
+		{
+			pexprPrjElem->AddRef();
+			pdrgpexprAggPrjElems->Append(pexprPrjElem);
+			continue;
+		}
+
+		// sketch of the distinct values, computed by the aggregate
+		CMDIdGPDB *pmdidSketchType = GPOS_NEW(mp)
+			CMDIdGPDB(IMDId::EmdidGeneral, GPDB_HYPERLOGLOG_ESTIMATOR);
+		CColRef *pcrSketch = col_factory->PcrCreate(
+			md_accessor->RetrieveType(pmdidSketchType), default_type_modifier);
+		pmdidSketchType->Release();
+
+		CExpression *pexprArg = (*(*pexprAggFunc)[EaggfuncIndexArgs])[0];
+		pexprArg->AddRef();
+		CExpressionArray *pdrgpexprArgs = GPOS_NEW(mp) CExpressionArray(mp);
+		pdrgpexprArgs->Append(pexprArg);
+
+		CScalarAggFunc *popAccum = CUtils::PopAggFunc(
+			mp,
+			GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, GPDB_HYPERLOGLOG_ACCUM),
+			GPOS_NEW(mp) CWStringConst(GPOS_WSZ_LIT("gp_hyperloglog_accum")),
+			false /*is_distinct*/, EaggfuncstageGlobal, false /*fSplit*/,
+			NULL /*pmdidResolvedReturnType*/, EaggfunckindNormal);
+		pdrgpexprAggPrjElems->Append(CUtils::PexprScalarProjectElement(
+			mp, pcrSketch,
+			GPOS_NEW(mp) CExpression(
+				mp, popAccum, CUtils::PexprAggFuncArgs(mp, pdrgpexprArgs))));
+
+		// estimate of the sketch, as a count; the sketch of no values is null
+		CMDIdGPDB *pmdidEstimate = GPOS_NEW(mp)
+			CMDIdGPDB(IMDId::EmdidGeneral, GPDB_HYPERLOGLOG_GET_ESTIMATE);
+		IMDId *pmdidEstimateType =
+			md_accessor->RetrieveFunc(pmdidEstimate)->GetResultTypeMdid();
+		pmdidEstimateType->AddRef();
+		CExpression *pexprEstimate = GPOS_NEW(mp) CExpression(
+			mp,
+			GPOS_NEW(mp) CScalarFunc(
+				mp, pmdidEstimate, pmdidEstimateType, default_type_modifier,
+				GPOS_NEW(mp) CWStringConst(
+					GPOS_WSZ_LIT("gp_hyperloglog_get_estimate")),
+				false /*funcvariadic*/),
+			CUtils::PexprScalarIdent(mp, pcrSketch));
+
+		CMDIdGPDB *pmdidInt8 =
+			GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, GPDB_INT8);
+		CExpressionArray *pdrgpexprCoalesce = GPOS_NEW(mp) CExpressionArray(mp);
+		pdrgpexprCoalesce->Append(
+			CUtils::PexprCast(mp, md_accessor, pexprEstimate, pmdidInt8));
+		pdrgpexprCoalesce->Append(CUtils::PexprScalarConstInt8(mp, 0 /*val*/));
+
+		CColRef *colref =
+			CScalarProjectElement::PopConvert(pexprPrjElem->Pop())->Pcr();
+		pdrgpexprEstimatePrjElems->Append(CUtils::PexprScalarProjectElement(
+			mp, colref,
+			GPOS_NEW(mp) CExpression(
+				mp, GPOS_NEW(mp) CScalarCoalesce(mp, pmdidInt8),
+				pdrgpexprCoalesce)));
+	}
+
+	if (0 == pdrgpexprEstimatePrjElems->Size())
+	{
+		pdrgpexprAggPrjElems->Release();
+		pdrgpexprEstimatePrjElems->Release();
+
+		pop->AddRef();
+		return GPOS_NEW(mp) CExpression(mp, pop, pdrgpexprChildren);
+	}
+
+	CExpression *pexprRelational = (*pdrgpexprChildren)[0];
+	pexprRelational->AddRef();
+	pdrgpexprChildren->Release();
+
+	pop->AddRef();
+	CExpression *pexprGbAgg = GPOS_NEW(mp) CExpression(
+		mp, pop, pexprRelational,
+		GPOS_NEW(mp) CExpression(mp, GPOS_NEW(mp) CScalarProjectList(mp),
+								 pdrgpexprAggPrjElems));
+
+	return CUtils::PexprLogicalProject(
+		mp, pexprGbAgg,
+		GPOS_NEW(mp) CExpression(mp, GPOS_NEW(mp) CScalarProjectList(mp),
+								 pdrgpexprEstimatePrjElems),
+		false /*fNewComputedCol*/);
+}
+
 //	Remove outer references from order spec inside limit, grouping columns
 //	in GbAgg, and Partition/Order columns in window operators. Also handle
 //	cases where we would end up with an empty groupby list and project list,
@@ -3087,11 +3230,21 @@ CExpressionPreprocessor::PexprPreprocess(
 	GPOS_CHECK_ABORT;
 	pexprSimplifiedLimit->Release();
 
+	// (2.c) estimate count(distinct) aggregates, if requested
+	CExpression *pexprApproxCountDistinct = pexprSimplifiedDistinct;
+	if (GPOS_FTRACE(EopttraceEnableApproxCountDistinct))
+	{
+		pexprApproxCountDistinct =
+			PexprApproxCountDistinct(mp, pexprSimplifiedDistinct);
+		GPOS_CHECK_ABORT;
+		pexprSimplifiedDistinct->Release();
+	}
+
 	// (3) trim unnecessary existential subqueries
 	CExpression *pexprTrimmed =
-		PexprTrimExistentialSubqueries(mp, pexprSimplifiedDistinct);
+		PexprTrimExistentialSubqueries(mp, pexprApproxCountDistinct);
 	GPOS_CHECK_ABORT;
-	pexprSimplifiedDistinct->Release();
+	pexprApproxCountDistinct->Release();
 
 	// (4) collapse cascaded union / union all
 	CExpression *pexprNaryUnionUnionAll =
@@ -20,6 +20,8 @@
 #include "gpopt/base/CUtils.h"
 #include "gpopt/operators/CExpression.h"
 #include "gpopt/operators/CExpressionHandle.h"
+#include "gpopt/search/CGroupExpression.h"
+#include "gpopt/xforms/CXformUtils.h"
 #include "naucrates/statistics/CGroupByStatsProcessor.h"
 
 using namespace gpopt;
@@ -597,6 +599,7 @@ CLogicalGbAgg::PxfsCandidates(CMemoryPool *mp) const
 	(void) xform_set->ExchangeSet(CXform::ExfGbAgg2StreamAgg);
 	(void) xform_set->ExchangeSet(CXform::ExfGbAgg2ScalarAgg);
 	(void) xform_set->ExchangeSet(CXform::ExfEagerAgg);
+	(void) xform_set->ExchangeSet(CXform::ExfEagerAggNAryJoin);
 	return xform_set;
 }
 
@@ -612,7 +615,8 @@ CLogicalGbAgg::PxfsCandidates(CMemoryPool *mp) const
 IStatistics *
 CLogicalGbAgg::PstatsDerive(CMemoryPool *mp, IStatistics *child_stats,
 							CColRefArray *pdrgpcrGroupingCols,
-							ULongPtrArray *pdrgpulComputedCols, CBitSet *keys)
+							ULongPtrArray *pdrgpulComputedCols, CBitSet *keys,
+							ULONG num_segments)
 {
 	const ULONG ulGroupingCols = pdrgpcrGroupingCols->Size();
 
@@ -624,9 +628,19 @@ CLogicalGbAgg::PstatsDerive(CMemoryPool *mp, IStatistics *child_stats,
 		pdrgpulGroupingCols->Append(GPOS_NEW(mp) ULONG(colref->Id()));
 	}
 
-	IStatistics *stats = CGroupByStatsProcessor::CalcGroupByStats(
-		mp, dynamic_cast<CStatistics *>(child_stats), pdrgpulGroupingCols,
-		pdrgpulComputedCols, keys);
+	IStatistics *stats = NULL;
+	if (1 < num_segments)
+	{
+		stats = CGroupByStatsProcessor::CalcLocalGroupByStats(
+			mp, dynamic_cast<CStatistics *>(child_stats), pdrgpulGroupingCols,
+			pdrgpulComputedCols, keys, num_segments);
+	}
+	else
+	{
+		stats = CGroupByStatsProcessor::CalcGroupByStats(
+			mp, dynamic_cast<CStatistics *>(child_stats), pdrgpulGroupingCols,
+			pdrgpulComputedCols, keys);
+	}
 
 	// clean up
 	pdrgpulGroupingCols->Release();
@@ -655,8 +669,27 @@ CLogicalGbAgg::PstatsDerive(CMemoryPool *mp, CExpressionHandle &exprhdl,
 	ULongPtrArray *pdrgpulComputedCols = GPOS_NEW(mp) ULongPtrArray(mp);
 	exprhdl.DeriveDefinedColumns(1)->ExtractColIds(mp, pdrgpulComputedCols);
 
-	IStatistics *stats = PstatsDerive(mp, child_stats, Pdrgpcr(),
-									  pdrgpulComputedCols, NULL /*keys*/);
+	// the partial aggregates created by eager aggregation are computed
+	// below the join, before their input is redistributed on the grouping
+	// columns, so each group may be produced by several segments
+	ULONG num_segments = 1;
+	if (EgbaggtypeLocal == m_egbaggtype)
+	{
+		CGroupExpression *pgexprOrigin = exprhdl.Pgexpr();
+		while (NULL != pgexprOrigin && 1 == num_segments)
+		{
+			if (CXformUtils::FEagerAggXform(pgexprOrigin->ExfidOrigin()))
+			{
+				num_segments =
+					COptCtxt::PoctxtFromTLS()->GetCostModel()->UlHosts();
+			}
+			pgexprOrigin = pgexprOrigin->PgexprOrigin();
+		}
+	}
+
+	IStatistics *stats =
+		PstatsDerive(mp, child_stats, Pdrgpcr(), pdrgpulComputedCols,
+					 NULL /*keys*/, num_segments);
 
 	pdrgpulComputedCols->Release();
 
@@ -80,6 +80,7 @@ CLogicalInnerJoin::PxfsCandidates(CMemoryPool *mp) const
 	(void) xform_set->ExchangeSet(CXform::ExfJoinCommutativity);
 	(void) xform_set->ExchangeSet(CXform::ExfJoinAssociativity);
 	(void) xform_set->ExchangeSet(CXform::ExfInnerJoinSemiJoinSwap);
+	(void) xform_set->ExchangeSet(CXform::ExfInnerJoinSemiJoinReduction);
 	(void) xform_set->ExchangeSet(CXform::ExfInnerJoinAntiSemiJoinSwap);
 	(void) xform_set->ExchangeSet(CXform::ExfInnerJoinAntiSemiJoinNotInSwap);
 
@@ -304,13 +304,19 @@ COptimizer::PdxlnOptimize(
 			COstreamString oss(&strTrace);
 
 			// if the number of inlinable CTEs is greater than the cutoff, then
-			// disable inlining for this query
-			if (!GPOS_FTRACE(EopttraceEnableCTEInlining) ||
-				CUtils::UlInlinableCTEs(pexprTranslated) >
-					optimizer_config->GetCteConf()->UlCTEInliningCutoff())
+			// disable inlining of as few CTEs as needed to get within it; the
+			// memo holds both the inlined and the shared alternative of the
+			// other CTEs
+			if (!GPOS_FTRACE(EopttraceEnableCTEInlining))
 			{
 				COptCtxt::PoctxtFromTLS()->Pcteinfo()->DisableInlining();
 			}
+			else
+			{
+				COptCtxt::PoctxtFromTLS()->Pcteinfo()->LimitInlining(
+					pexprTranslated,
+					optimizer_config->GetCteConf()->UlCTEInliningCutoff());
+			}
 
 			GPOS_CHECK_ABORT;
 			// optimize logical expression tree into physical expression tree.
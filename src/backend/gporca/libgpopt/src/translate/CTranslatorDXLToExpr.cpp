@@ -13,6 +13,7 @@
 
 #include "gpopt/translate/CTranslatorDXLToExpr.h"
 
+#include "gpos/common/CAutoRg.h"
 #include "gpos/common/CAutoTimer.h"
 
 #include "gpopt/base/CAutoOptCtxt.h"
@@ -1746,21 +1747,29 @@ CTranslatorDXLToExpr::PexprLogicalSeqPr(const CDXLNode *dxlnode)
 
 	// create the window operators (or when applicable a tree of window operators)
 	CExpression *pexprLgSequence = NULL;
-	UlongToExprArrayMapIter hmiterulpdrgexpr(phmulpdrgpexpr);
+	ULongPtrArray *pdrgpulSpecPos = NULL;
+	ULongPtrArray *pdrgpulPartitionByPos = NULL;
+	OrderWindowSpecs(pdxlopWindow, phmulpdrgpexpr, &pdrgpulSpecPos,
+					 &pdrgpulPartitionByPos);
 
-	while (hmiterulpdrgexpr.Advance())
+	const ULONG ulSpecs = pdrgpulSpecPos->Size();
+	for (ULONG ulSpec = 0; ulSpec < ulSpecs; ulSpec++)
 	{
-		ULONG ulPos = *(hmiterulpdrgexpr.Key());
+		ULONG ulPos = *(*pdrgpulSpecPos)[ulSpec];
 		CDXLWindowSpec *pdxlws = pdxlopWindow->GetWindowKeyAt(ulPos);
 
-		const CExpressionArray *pdrgpexpr = hmiterulpdrgexpr.Value();
+		const CExpressionArray *pdrgpexpr = phmulpdrgpexpr->Find(&ulPos);
 		GPOS_ASSERT(NULL != pdrgpexpr);
 		CScalarProjectList *popPrL = GPOS_NEW(m_mp) CScalarProjectList(m_mp);
 		CExpression *pexprProjList = GPOS_NEW(m_mp) CExpression(
 			m_mp, popPrL, const_cast<CExpressionArray *>(pdrgpexpr));
 
-		CColRefArray *colref_array =
-			PdrgpcrPartitionByCol(pdxlws->GetPartitionByColIdArray());
+		// use the partition by column order of the first specification
+		// partitioning by the same columns, so that their sorts agree
+		CDXLWindowSpec *pdxlwsPartitionBy =
+			pdxlopWindow->GetWindowKeyAt(*(*pdrgpulPartitionByPos)[ulSpec]);
+		CColRefArray *colref_array = PdrgpcrPartitionByCol(
+			pdxlwsPartitionBy->GetPartitionByColIdArray());
 		CDistributionSpec *pds = NULL;
 		if (0 < colref_array->Size())
 		{
@@ -1824,11 +1833,178 @@ CTranslatorDXLToExpr::PexprLogicalSeqPr(const CDXLNode *dxlnode)
 	GPOS_ASSERT(NULL != pexprLgSequence);
 
 	// clean up
+	pdrgpulSpecPos->Release();
+	pdrgpulPartitionByPos->Release();
 	phmulpdrgpexpr->Release();
 
 	return pexprLgSequence;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorDXLToExpr::OrderWindowSpecs
+//
+//	@doc:
+// 		Order the window specifications used by the project list of a
+//		window operator in which their window operators are stacked,
+//		bottom first. A window operator requires its input to be hashed
+//		on its partition by columns and sorted on them followed by its
+//		order by columns; the input is already hashed right if the operator
+//		below it partitions by a subset of the columns, and already sorted
+//		right if its sort is a prefix of the one below. So:
+//			- specifications partitioning by fewer columns go first, and
+//			  the ones partitioning by the same columns are kept together,
+//			- within those, longer sorts go first,
+//			- specifications without partition by, which need all rows on
+//			  a single node, go last.
+//		Specifications partitioning by the same set of columns use the
+//		column order of the first of them, so that their sorts match.
+//		Specifications the order does not tell apart keep the order of the
+//		project list map.
+//
+//---------------------------------------------------------------------------
+void
+CTranslatorDXLToExpr::OrderWindowSpecs(const CDXLLogicalWindow *pdxlopWindow,
+									   UlongToExprArrayMap *phmulpdrgpexpr,
+									   ULongPtrArray **ppdrgpulSpecPos,
+									   ULongPtrArray **ppdrgpulPartitionByPos)
+{
+	GPOS_ASSERT(NULL != ppdrgpulSpecPos);
+	GPOS_ASSERT(NULL != ppdrgpulPartitionByPos);
+
+	// collect used specifications, in the order they used to be stacked in
+	CAutoRg<ULONG> argulSpecPos;
+	argulSpecPos =
+		GPOS_NEW_ARRAY(m_mp, ULONG, pdxlopWindow->NumOfWindowSpecs());
+	ULONG ulSpecs = 0;
+	UlongToExprArrayMapIter hmiterulpdrgexpr(phmulpdrgpexpr);
+	while (hmiterulpdrgexpr.Advance())
+	{
+		argulSpecPos.Rgt()[ulSpecs++] = *(hmiterulpdrgexpr.Key());
+	}
+	GPOS_ASSERT(0 < ulSpecs);
+
+	// for each specification, the first one partitioning by the same columns
+	CAutoRg<ULONG> argulGroup;
+	argulGroup = GPOS_NEW_ARRAY(m_mp, ULONG, ulSpecs);
+	for (ULONG ul = 0; ul < ulSpecs; ul++)
+	{
+		CDXLWindowSpec *pdxlws =
+			pdxlopWindow->GetWindowKeyAt(argulSpecPos.Rgt()[ul]);
+		ULONG ulGroup = 0;
+		while (!FSamePartitionBy(
+			pdxlws,
+			pdxlopWindow->GetWindowKeyAt(argulSpecPos.Rgt()[ulGroup])))
+		{
+			ulGroup++;
+		}
+		argulGroup.Rgt()[ul] = ulGroup;
+	}
+
+	// insertion sort by the stacking order described above
+	CAutoRg<ULONG> argulOrder;
+	argulOrder = GPOS_NEW_ARRAY(m_mp, ULONG, ulSpecs);
+	for (ULONG ul = 0; ul < ulSpecs; ul++)
+	{
+		ULONG ulPos = ul;
+		while (0 < ulPos)
+		{
+			const ULONG ulPrev = argulOrder.Rgt()[ulPos - 1];
+			CDXLWindowSpec *pdxlws =
+				pdxlopWindow->GetWindowKeyAt(argulSpecPos.Rgt()[ul]);
+			CDXLWindowSpec *pdxlwsPrev =
+				pdxlopWindow->GetWindowKeyAt(argulSpecPos.Rgt()[ulPrev]);
+
+			const ULONG ulPartitionBy =
+				pdxlws->GetPartitionByColIdArray()->Size();
+			const ULONG ulPartitionByPrev =
+				pdxlwsPrev->GetPartitionByColIdArray()->Size();
+			const ULONG ulSortCols = NULL == pdxlws->GetSortColListDXL()
+										 ? 0
+										 : pdxlws->GetSortColListDXL()->Arity();
+			const ULONG ulSortColsPrev =
+				NULL == pdxlwsPrev->GetSortColListDXL()
+					? 0
+					: pdxlwsPrev->GetSortColListDXL()->Arity();
+
+			BOOL fBefore = false;
+			if ((0 == ulPartitionBy) != (0 == ulPartitionByPrev))
+			{
+				fBefore = (0 != ulPartitionBy);
+			}
+			else if (ulPartitionBy != ulPartitionByPrev)
+			{
+				fBefore = (ulPartitionBy < ulPartitionByPrev);
+			}
+			else if (argulGroup.Rgt()[ul] != argulGroup.Rgt()[ulPrev])
+			{
+				fBefore = (argulGroup.Rgt()[ul] < argulGroup.Rgt()[ulPrev]);
+			}
+			else
+			{
+				fBefore = (ulSortCols > ulSortColsPrev);
+			}
+
+			if (!fBefore)
+			{
+				break;
+			}
+			argulOrder.Rgt()[ulPos] = ulPrev;
+			ulPos--;
+		}
+		argulOrder.Rgt()[ulPos] = ul;
+	}
+
+	*ppdrgpulSpecPos = GPOS_NEW(m_mp) ULongPtrArray(m_mp);
+	*ppdrgpulPartitionByPos = GPOS_NEW(m_mp) ULongPtrArray(m_mp);
+	for (ULONG ul = 0; ul < ulSpecs; ul++)
+	{
+		const ULONG ulSpec = argulOrder.Rgt()[ul];
+		(*ppdrgpulSpecPos)
+			->Append(GPOS_NEW(m_mp) ULONG(argulSpecPos.Rgt()[ulSpec]));
+		(*ppdrgpulPartitionByPos)
+			->Append(GPOS_NEW(m_mp) ULONG(
+				argulSpecPos.Rgt()[argulGroup.Rgt()[ulSpec]]));
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorDXLToExpr::FSamePartitionBy
+//
+//	@doc:
+// 		Do two window specifications partition by the same set of columns
+//
+//---------------------------------------------------------------------------
+BOOL
+CTranslatorDXLToExpr::FSamePartitionBy(const CDXLWindowSpec *pdxlwsFst,
+									   const CDXLWindowSpec *pdxlwsSnd)
+{
+	const ULongPtrArray *pdrgpulFst = pdxlwsFst->GetPartitionByColIdArray();
+	const ULongPtrArray *pdrgpulSnd = pdxlwsSnd->GetPartitionByColIdArray();
+	const ULONG size = pdrgpulFst->Size();
+	if (size != pdrgpulSnd->Size())
+	{
+		return false;
+	}
+
+	for (ULONG ulFst = 0; ulFst < size; ulFst++)
+	{
+		BOOL fFound = false;
+		for (ULONG ulSnd = 0; !fFound && ulSnd < size; ulSnd++)
+		{
+			fFound = (*(*pdrgpulFst)[ulFst] == *(*pdrgpulSnd)[ulSnd]);
+		}
+
+		if (!fFound)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorDXLToExpr::PdrgpcrPartitionByCol
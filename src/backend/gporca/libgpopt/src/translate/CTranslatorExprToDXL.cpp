@@ -56,6 +56,10 @@ using namespace gpnaucrates;
 
 #define GPOPT_MASTER_SEGMENT_ID (-1)
 
+// max number of distribution key values per segment for which a DML
+// statement is direct dispatched
+#define GPOPT_DIRECT_DISPATCH_VALUES_PER_SEGMENT 3
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorExprToDXL::CTranslatorExprToDXL
@@ -5927,8 +5931,9 @@ CTranslatorExprToDXL::PdxlnCTAS(CExpression *pexpr,
 //		CTranslatorExprToDXL::GetDXLDirectDispatchInfo
 //
 //	@doc:
-//		Return the direct dispatch info spec for the possible values of the distribution
-//		key in a DML insert statement. Returns NULL if values are not constant.
+//		Return the direct dispatch info spec for the possible values of the
+//		distribution key of the rows a DML statement writes. Returns NULL if
+//		any distribution column is not restricted to a small set of constants.
 //
 //---------------------------------------------------------------------------
 CDXLDirectDispatchInfo *
@@ -5941,64 +5946,54 @@ CTranslatorExprToDXL::GetDXLDirectDispatchInfo(CExpression *pexprDML)
 	const CColumnDescriptorArray *pdrgpcoldescDist =
 		ptabdesc->PdrgpcoldescDist();
 
-	if (CLogicalDML::EdmlInsert != popDML->Edmlop() ||
-		IMDRelation::EreldistrHash != ptabdesc->GetRelDistribution() ||
-		1 < pdrgpcoldescDist->Size())
+	if (IMDRelation::EreldistrHash != ptabdesc->GetRelDistribution())
 	{
-		// directed dispatch only supported for insert statements on hash-distributed tables
-		// with a single distribution column
+		// directed dispatch only supported for hash-distributed tables
 		return NULL;
 	}
 
-
-	GPOS_ASSERT(1 == pdrgpcoldescDist->Size());
-	CColumnDescriptor *pcoldesc = (*pdrgpcoldescDist)[0];
-	ULONG ulPos = ptabdesc->UlPos(pcoldesc, ptabdesc->Pdrgpcoldesc());
-	GPOS_ASSERT(ulPos < ptabdesc->Pdrgpcoldesc()->Size() && "Column not found");
-
-	CColRef *pcrDistrCol = (*popDML->PdrgpcrSource())[ulPos];
-	CPropConstraint *ppc = (*pexprDML)[0]->DerivePropertyConstraint();
-
-	if (NULL == ppc->Pcnstr())
+	COperator::EOperatorId rgeopidSplit[] = {COperator::EopPhysicalSplit};
+	if (CUtils::FHasOp(pexprDML, rgeopidSplit, GPOS_ARRAY_SIZE(rgeopidSplit)))
 	{
+		// an update of the distribution key writes the split rows with their
+		// new key values, which the constraints of its input do not describe
 		return NULL;
 	}
 
-	CConstraint *pcnstrDistrCol = ppc->Pcnstr()->Pcnstr(m_mp, pcrDistrCol);
-	if (!CPredicateUtils::FConstColumn(pcnstrDistrCol, pcrDistrCol))
+	CPropConstraint *ppc = (*pexprDML)[0]->DerivePropertyConstraint();
+	if (NULL == ppc->Pcnstr())
 	{
-		CRefCount::SafeRelease(pcnstrDistrCol);
 		return NULL;
 	}
 
-	GPOS_ASSERT(CConstraint::EctInterval == pcnstrDistrCol->Ect());
-
-	CConstraintInterval *pci =
-		dynamic_cast<CConstraintInterval *>(pcnstrDistrCol);
-	GPOS_ASSERT(1 >= pci->Pdrgprng()->Size());
-
-	CDXLDatumArray *pdrgpdxldatum = GPOS_NEW(m_mp) CDXLDatumArray(m_mp);
-	CDXLDatum *dxl_datum = NULL;
-
-	if (1 == pci->Pdrgprng()->Size())
+	// source columns holding the distribution key of the written rows; for
+	// an update these are the new values, and a plan that does not move the
+	// rows writes the old row on the segment of the new one
+	CColRefArray *pdrgpcrDistr = GPOS_NEW(m_mp) CColRefArray(m_mp);
+	const ULONG ulDistrCols = pdrgpcoldescDist->Size();
+	for (ULONG ul = 0; ul < ulDistrCols; ul++)
 	{
-		const CRange *prng = (*pci->Pdrgprng())[0];
-		dxl_datum = CTranslatorExprToDXLUtils::GetDatumVal(m_mp, m_pmda,
-														   prng->PdatumLeft());
+		CColumnDescriptor *pcoldesc = (*pdrgpcoldescDist)[ul];
+		ULONG ulPos = ptabdesc->UlPos(pcoldesc, ptabdesc->Pdrgpcoldesc());
+		GPOS_ASSERT(ulPos < ptabdesc->Pdrgpcoldesc()->Size() &&
+					"Column not found");
+
+		pdrgpcrDistr->Append((*popDML->PdrgpcrSource())[ulPos]);
 	}
-	else
+
+	// don't bother for sets of values that likely hash to all segments
+	ULONG ulSegments = 1;
+	if (NULL != m_pdrgpiSegments)
 	{
-		GPOS_ASSERT(pci->FIncludesNull());
-		dxl_datum = pcrDistrCol->RetrieveType()->GetDXLDatumNull(m_mp);
+		ulSegments = m_pdrgpiSegments->Size();
 	}
+	CDXLDirectDispatchInfo *dxl_direct_dispatch_info =
+		CTranslatorExprToDXLUtils::PdxlddinfoDistrKeyValues(
+			m_mp, m_pmda, pdrgpcrDistr, ppc->Pcnstr(),
+			GPOPT_DIRECT_DISPATCH_VALUES_PER_SEGMENT * ulSegments);
+	pdrgpcrDistr->Release();
 
-	pdrgpdxldatum->Append(dxl_datum);
-
-	pcnstrDistrCol->Release();
-
-	CDXLDatum2dArray *pdrgpdrgpdxldatum = GPOS_NEW(m_mp) CDXLDatum2dArray(m_mp);
-	pdrgpdrgpdxldatum->Append(pdrgpdxldatum);
-	return GPOS_NEW(m_mp) CDXLDirectDispatchInfo(pdrgpdrgpdxldatum, false);
+	return dxl_direct_dispatch_info;
 }
 
 //---------------------------------------------------------------------------
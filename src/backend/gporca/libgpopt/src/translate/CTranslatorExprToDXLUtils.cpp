@@ -2150,6 +2150,91 @@ CTranslatorExprToDXLUtils::PdxlddinfoSingleDistrKey(CMemoryPool *mp,
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorExprToDXLUtils::PdxlddinfoDistrKeyValues
+//
+//	@doc:
+//		Compute the direct dispatch info spec from the constraints on all
+//		distribution columns of a table. Each column must be restricted to a
+//		set of constants; the spec holds every combination of them, which
+//		covers all rows satisfying the constraint. Returns NULL if a column is
+//		unrestricted, or if there are more than the given number of
+//		combinations
+//
+//---------------------------------------------------------------------------
+CDXLDirectDispatchInfo *
+CTranslatorExprToDXLUtils::PdxlddinfoDistrKeyValues(
+	CMemoryPool *mp, CMDAccessor *md_accessor, const CColRefArray *pdrgpcrDistr,
+	CConstraint *pcnstr, ULONG ulMaxValues)
+{
+	GPOS_ASSERT(NULL != pdrgpcrDistr);
+	GPOS_ASSERT(0 < pdrgpcrDistr->Size());
+
+	if (NULL == pcnstr)
+	{
+		return NULL;
+	}
+
+	// combinations of the values of the columns processed so far
+	CDXLDatum2dArray *pdrgpdrgpdxldatum = GPOS_NEW(mp) CDXLDatum2dArray(mp);
+	pdrgpdrgpdxldatum->Append(GPOS_NEW(mp) CDXLDatumArray(mp));
+
+	const ULONG ulDistrCols = pdrgpcrDistr->Size();
+	for (ULONG ul = 0; ul < ulDistrCols; ul++)
+	{
+		const CColRef *pcrDistrCol = (*pdrgpcrDistr)[ul];
+		CConstraint *pcnstrDistrCol = pcnstr->Pcnstr(mp, pcrDistrCol);
+
+		CDXLDatum2dArray *pdrgpdrgpdxldatumCol = NULL;
+		if (CPredicateUtils::FColumnDisjunctionOfConst(pcnstrDistrCol,
+													   pcrDistrCol))
+		{
+			pdrgpdrgpdxldatumCol = PdrgpdrgpdxldatumFromDisjPointConstraint(
+				mp, md_accessor, pcrDistrCol, pcnstrDistrCol);
+		}
+		CRefCount::SafeRelease(pcnstrDistrCol);
+
+		if (NULL == pdrgpdrgpdxldatumCol ||
+			ulMaxValues <
+				pdrgpdrgpdxldatum->Size() * pdrgpdrgpdxldatumCol->Size())
+		{
+			CRefCount::SafeRelease(pdrgpdrgpdxldatumCol);
+			pdrgpdrgpdxldatum->Release();
+
+			return NULL;
+		}
+
+		// extend each combination with each value of this column
+		CDXLDatum2dArray *pdrgpdrgpdxldatumNew =
+			GPOS_NEW(mp) CDXLDatum2dArray(mp);
+		const ULONG ulCombinations = pdrgpdrgpdxldatum->Size();
+		const ULONG ulValues = pdrgpdrgpdxldatumCol->Size();
+		for (ULONG ulComb = 0; ulComb < ulCombinations; ulComb++)
+		{
+			CDXLDatumArray *pdrgpdxldatum = (*pdrgpdrgpdxldatum)[ulComb];
+			for (ULONG ulVal = 0; ulVal < ulValues; ulVal++)
+			{
+				CDXLDatumArray *pdrgpdxldatumNew =
+					GPOS_NEW(mp) CDXLDatumArray(mp);
+				CUtils::AddRefAppend(pdrgpdxldatumNew, pdrgpdxldatum);
+
+				CDXLDatum *dxl_datum = (*(*pdrgpdrgpdxldatumCol)[ulVal])[0];
+				dxl_datum->AddRef();
+				pdrgpdxldatumNew->Append(dxl_datum);
+
+				pdrgpdrgpdxldatumNew->Append(pdrgpdxldatumNew);
+			}
+		}
+
+		pdrgpdrgpdxldatumCol->Release();
+		pdrgpdrgpdxldatum->Release();
+		pdrgpdrgpdxldatum = pdrgpdrgpdxldatumNew;
+	}
+
+	return GPOS_NEW(mp) CDXLDirectDispatchInfo(pdrgpdrgpdxldatum, false);
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorExprToDXLUtils::FDirectDispatchable
@@ -54,7 +54,7 @@ CXformCTEAnchor2TrivialSelect::Exfp(CExpressionHandle &exprhdl) const
 	const ULONG ulConsumers = pcteinfo->UlConsumers(id);
 	GPOS_ASSERT(0 < ulConsumers);
 
-	if ((pcteinfo->FEnableInlining() || 1 == ulConsumers) &&
+	if ((pcteinfo->FEnableInlining(id) || 1 == ulConsumers) &&
 		CXformUtils::FInlinableCTE(id))
 	{
 		return CXform::ExfpHigh;
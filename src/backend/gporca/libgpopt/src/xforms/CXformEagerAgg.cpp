@@ -9,9 +9,9 @@
 //	@doc:
 //		Implementation for eagerly pushing aggregates below join
 //			(with no foreign key restriction on the join condition)
-//			The aggregate is pushed down only on the outer child
-//			(since the inner child alternative will be explored through
-//			 commutativity)
+//			One alternative is generated for each child of the join the
+//			aggregates can be pushed to; the cost model picks between them
+//			and the original aggregate
 //---------------------------------------------------------------------------
 #include "gpopt/xforms/CXformEagerAgg.h"
 
@@ -20,7 +20,9 @@
 #include "gpopt/base/CColRefSetIter.h"
 #include "gpopt/operators/CLogicalGbAgg.h"
 #include "gpopt/operators/CLogicalInnerJoin.h"
+#include "gpopt/operators/CLogicalNAryJoin.h"
 #include "gpopt/operators/CPatternLeaf.h"
+#include "gpopt/operators/CScalarIf.h"
 #include "gpopt/operators/CScalarProjectElement.h"
 #include "gpopt/operators/CScalarProjectList.h"
 #include "gpopt/operators/CScalarValuesList.h"
@@ -82,23 +84,94 @@ CXformEagerAgg::Transform(CXformContext *pxfctxt, CXformResult *pxfres,
 	GPOS_ASSERT(FPromising(pxfctxt->Pmp(), this, agg_expr));
 	GPOS_ASSERT(FCheckPattern(agg_expr));
 
-	/* no-op if the transform cannot be applied */
-	if (!CanApplyTransform(agg_expr))
+	CMemoryPool *mp = pxfctxt->Pmp();
+	CExpression *join_expr = (*agg_expr)[0];
+
+	if (COperator::EopLogicalNAryJoin == join_expr->Pop()->Eopid() &&
+		CLogicalNAryJoin::PopConvert(join_expr->Pop())->HasOuterJoinChildren())
 	{
+		// rows of an outer join's inner side may be null extended
 		return;
 	}
 
-	CMemoryPool *mp = pxfctxt->Pmp();
+	// all children but the last one, which is the join predicate, are
+	// candidates for pushing the aggregate to
+	const ULONG num_children = join_expr->Arity() - 1;
+	for (ULONG child_index = 0; child_index < num_children; child_index++)
+	{
+		CExpression *upper_agg_expr =
+			PexprPushAggBelowJoinChild(mp, agg_expr, child_index);
+		if (NULL != upper_agg_expr)
+		{
+			pxfres->Add(upper_agg_expr);
+		}
+	}
+}
+
+// push the aggregate below the given child of the join
+//	 Eager agg is applied to a child only if following is true:
+//		- Every aggregate is either pushed down or scaled
+//		- An aggregate is pushed down if all its inputs come from the child,
+//		  and it is one of min, max, sum, count, avg with a single non
+//		  distinct argument, or count(*)
+//		- An aggregate is scaled if all its inputs come from the other
+//		  children, and it is min or max, or count with a single non
+//		  distinct argument
+//		- At least one aggregate is pushed down
+CExpression *
+CXformEagerAgg::PexprPushAggBelowJoinChild(CMemoryPool *mp,
+										   CExpression *agg_expr,
+										   ULONG child_index) const
+{
 	CExpression *join_expr = (*agg_expr)[0];
-	CExpression *join_outer_child_expr = (*join_expr)[0];
-	CExpression *join_inner_child_expr = (*join_expr)[1];
-	CExpression *join_condition_expr = (*join_expr)[2];
 	CExpression *agg_proj_list_expr = (*agg_expr)[1];
+	const ULONG join_arity = join_expr->Arity();
+	CExpression *join_child_expr = (*join_expr)[child_index];
+	CExpression *join_condition_expr = (*join_expr)[join_arity - 1];
+
+	const ULONG num_aggregates = agg_proj_list_expr->Arity();
+	if (num_aggregates == 0)
+	{
+		// at least one aggregate must be present to push down
+		return NULL;
+	}
+
+	CColRefSet *join_child_cols = join_child_expr->DeriveOutputColumns();
+	BOOL has_pushed_agg = false;
+	BOOL has_scaled_agg = false;
+	for (ULONG agg_index = 0; agg_index < num_aggregates; agg_index++)
+	{
+		CExpression *scalar_agg_proj_expr = (*agg_proj_list_expr)[agg_index];
+		CExpression *scalar_agg_func_expr = (*scalar_agg_proj_expr)[0];
+		CColRefSet *agg_cols = scalar_agg_proj_expr->DeriveUsedColumns();
+
+		if (join_child_cols->ContainsAll(agg_cols) &&
+			CanPushAggBelowJoin(scalar_agg_func_expr))
+		{
+			has_pushed_agg = true;
+		}
+		else if (!join_child_cols->FIntersects(agg_cols) &&
+				 CanScaleAggAboveJoin(scalar_agg_func_expr))
+		{
+			has_scaled_agg = true;
+		}
+		else
+		{
+			// No aggregate is pushed below join if an unsupported aggregate is
+			// present in the project list
+			return NULL;
+		}
+	}
+
+	if (!has_pushed_agg)
+	{
+		return NULL;
+	}
 
 	//	'push_down_gb_crs' represents the column references that are used for
 	//	grouping in the pushed-down aggregate. This is the union of the original
 	//	grouping columns and join predicate columns, retaining only the columns
-	//	from the outer child.
+	//	from the child the aggregate is pushed to.
 	// Example:
 	//	Input query: SELECT min(a1) FROM t1, t2 WHERE t1.j1 = t2.j2 GROUP BY t1.g1;
 	//	Convert to:
@@ -114,35 +187,53 @@ CXformEagerAgg::Transform(CXformContext *pxfctxt, CXformResult *pxfres,
 		(CLogicalGbAgg::PopConvert(agg_expr->Pop()))->PcrsLocalUsed();
 	push_down_gb_cols->Union(grouping_cols);
 
-	/* only keep columns from outer child in the new grouping col set */
-	CColRefSet *outer_child_cols = join_outer_child_expr->DeriveOutputColumns();
-	push_down_gb_cols->Intersection(outer_child_cols);
+	/* only keep columns from the child in the new grouping col set */
+	push_down_gb_cols->Intersection(join_child_cols);
+
+	if (has_scaled_agg && 0 == push_down_gb_cols->Size())
+	{
+		// a scalar aggregate would produce a row for an empty child, and
+		// the scaled aggregates would then see the rows of the other
+		// children that the original join did not produce
+		push_down_gb_cols->Release();
+		return NULL;
+	}
 
 	/* create new project lists for the two new Gb aggregates */
 	CExpression *lower_expr_proj_list = NULL;
 	CExpression *upper_expr_proj_list = NULL;
-	(void) PopulateLowerUpperProjectList(
-		mp, agg_proj_list_expr, &lower_expr_proj_list, &upper_expr_proj_list);
+	(void) PopulateLowerUpperProjectList(mp, agg_proj_list_expr,
+										 join_child_cols, &lower_expr_proj_list,
+										 &upper_expr_proj_list);
 
 	/* create lower agg, join, and upper agg expressions */
 
 	// lower expression as a local aggregate
 	CColRefArray *push_down_gb_col_array = push_down_gb_cols->Pdrgpcr(mp);
-	join_outer_child_expr->AddRef();
+	join_child_expr->AddRef();
 	CExpression *lower_agg_expr = GPOS_NEW(mp)
 		CExpression(mp,
 					GPOS_NEW(mp) CLogicalGbAgg(mp, push_down_gb_col_array,
 											   COperator::EgbaggtypeLocal),
-					join_outer_child_expr, lower_expr_proj_list);
+					join_child_expr, lower_expr_proj_list);
 
-	// join expression
+	// join expression, with the child replaced by the lower aggregate
+	CExpressionArray *join_children = GPOS_NEW(mp) CExpressionArray(mp);
+	for (ULONG ul = 0; ul < join_arity; ul++)
+	{
+		if (ul == child_index)
+		{
+			join_children->Append(lower_agg_expr);
+			continue;
+		}
+		CExpression *join_child = (*join_expr)[ul];
+		join_child->AddRef();
+		join_children->Append(join_child);
+	}
 	COperator *join_op = join_expr->Pop();
 	join_op->AddRef();
-	join_inner_child_expr->AddRef();
-	join_condition_expr->AddRef();
 	CExpression *new_join_expr =
-		GPOS_NEW(mp) CExpression(mp, join_op, lower_agg_expr,
-								 join_inner_child_expr, join_condition_expr);
+		GPOS_NEW(mp) CExpression(mp, join_op, join_children);
 
 	// upper expression as a global aggregate
 	CColRefArray *grouping_col_array = grouping_cols->Pdrgpcr(mp);
@@ -152,7 +243,8 @@ CXformEagerAgg::Transform(CXformContext *pxfctxt, CXformResult *pxfres,
 			CLogicalGbAgg(mp, grouping_col_array, COperator::EgbaggtypeGlobal),
 		new_join_expr, upper_expr_proj_list);
 	push_down_gb_cols->Release();
-	pxfres->Add(upper_agg_expr);
+
+	return upper_agg_expr;
 }
 
 // check if an aggregate can be pushed below a join
@@ -163,6 +255,12 @@ CXformEagerAgg::CanPushAggBelowJoin(CExpression *scalar_agg_func_expr) const
 {
 	CScalarAggFunc *scalar_agg_func =
 		CScalarAggFunc::PopConvert(scalar_agg_func_expr->Pop());
+	if (scalar_agg_func->FCountStar())
+	{
+		// count(*) over the join sums up the counts of the groups
+		return true;
+	}
+
 	if ((*scalar_agg_func_expr)[0]->Arity() != 1)
 	{
 		/* currently only supporting single-input aggregates */
@@ -201,48 +299,41 @@ CXformEagerAgg::CanPushAggBelowJoin(CExpression *scalar_agg_func_expr) const
 	return true;
 }
 
-// Check if the transform can be applied
-//	 Eager agg is currently applied only if following is true:
-//		- Inner join of two relations
-//		- Single aggregate (MIN or MAX)
-//		- Aggregate is not a DQA
-//		- Single expression input in the agg
-//		- Input expression only part of outer child
+// check if an aggregate over the children the aggregates are not pushed to
+// can be computed above the join
+// Only following aggregates are supported:
+//	min, max: the pre-aggregation does not change the set of values they see,
+//		so they are finalized directly from their inputs
+//	count: each value is counted as many times as the pushed down child had
+//		rows in the group it is joined with
 BOOL
-CXformEagerAgg::CanApplyTransform(CExpression *gb_agg_expr) const
+CXformEagerAgg::CanScaleAggAboveJoin(CExpression *scalar_agg_func_expr) const
 {
-	CExpression *join_expr = (*gb_agg_expr)[0];
-	CExpression *agg_proj_list_expr = (*gb_agg_expr)[1];
-	CExpression *join_outer_child_expr = (*join_expr)[0];
-
-	// currently only supporting aggregate column references from outer child
-	CColRefSet *join_outer_child_cols =
-		join_outer_child_expr->DeriveOutputColumns();
-	CColRefSet *agg_proj_list_cols = agg_proj_list_expr->DeriveUsedColumns();
-	if (!join_outer_child_cols->ContainsAll(agg_proj_list_cols))
+	CScalarAggFunc *scalar_agg_func =
+		CScalarAggFunc::PopConvert(scalar_agg_func_expr->Pop());
+	if ((*scalar_agg_func_expr)[0]->Arity() != 1 ||
+		scalar_agg_func->IsDistinct())
 	{
-		// all columns used by the Gb aggregate should only be present in outer
-		// child since we only support pushing down to one of children
 		return false;
 	}
 
-	const ULONG num_aggregates = agg_proj_list_expr->Arity();
-	if (num_aggregates == 0)
+	if (scalar_agg_func->FCountAny())
 	{
-		// at least one aggregate must be present to push down
-		return false;
+		return true;
 	}
-	for (ULONG agg_index = 0; agg_index < num_aggregates; agg_index++)
-	{
-		CExpression *scalar_agg_proj_expr = (*agg_proj_list_expr)[agg_index];
-		if (!CanPushAggBelowJoin((*scalar_agg_proj_expr)[0]))
-		{
-			// No aggregate is pushed below join if an unsupported aggregate is
-			// present in the project list
-			return false;
-		}
-	}
-	return true;
+
+	CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
+	CExpression *agg_child_expr = (*(*scalar_agg_func_expr)[0])[0];
+	IMDId *agg_child_mdid =
+		CScalar::PopConvert(agg_child_expr->Pop())->MdidType();
+	const IMDType *agg_child_type = md_accessor->RetrieveType(agg_child_mdid);
+
+	// the upper aggregate combines the input values as if they were
+	// partial results, so they must be of the intermediate type
+	return scalar_agg_func->IsMinMax(agg_child_type) &&
+		   agg_child_mdid->Equals(
+			   md_accessor->RetrieveAgg(scalar_agg_func->MDId())
+				   ->GetIntermediateResultTypeMdid());
 }
 
 // populate the lower and upper aggregate's project list after
@@ -252,6 +343,7 @@ CXformEagerAgg::PopulateLowerUpperProjectList(
 	CMemoryPool *mp,  // memory pool
 	CExpression
 		*orig_proj_list,  // project list of the original global aggregate
+	CColRefSet *child_cols,	 // columns of the child pushed down to
 	CExpression **lower_proj_list,	// project list of the new lower aggregate
 	CExpression **upper_proj_list	// project list of the new upper aggregate
 ) const
@@ -261,6 +353,10 @@ CXformEagerAgg::PopulateLowerUpperProjectList(
 	CExpressionArray *upper_proj_elem_array = GPOS_NEW(mp) CExpressionArray(mp);
 	const ULONG num_proj_elements = orig_proj_list->Arity();
 
+	// count of the rows of each lower group, used to scale the aggregates
+	// that are not pushed down
+	CColRef *count_colref = NULL;
+
 	// loop over each project element
 	for (ULONG ul = 0; ul < num_proj_elements; ul++)
 	{
@@ -268,6 +364,32 @@ CXformEagerAgg::PopulateLowerUpperProjectList(
 		CScalarProjectElement *orig_proj_elem =
 			CScalarProjectElement::PopConvert(orig_proj_elem_expr->Pop());
 
+		if (!child_cols->ContainsAll(orig_proj_elem_expr->DeriveUsedColumns()))
+		{
+			if (NULL == count_colref)
+			{
+				CExpression *count_proj_elem_expr = NULL;
+				CExpression *count_star_expr = CUtils::PexprCountStar(mp);
+				CScalarAggFunc *count_star =
+					CScalarAggFunc::PopConvert(count_star_expr->Pop());
+				PopulateLowerProjectElement(
+					mp, count_star->MDId(),
+					GPOS_NEW(mp) CWStringConst(
+						mp, count_star->PstrAggFunc()->GetBuffer()),
+					count_star_expr->PdrgPexpr(), false /*is_distinct*/,
+					&count_proj_elem_expr);
+				count_star_expr->Release();
+				lower_proj_elem_array->Append(count_proj_elem_expr);
+				count_colref = CScalarProjectElement::PopConvert(
+								   count_proj_elem_expr->Pop())
+								   ->Pcr();
+			}
+
+			upper_proj_elem_array->Append(PexprScaledProjectElement(
+				mp, orig_proj_elem_expr, count_colref));
+			continue;
+		}
+
 		CExpression *orig_agg_expr = (*orig_proj_elem_expr)[0];
 		CScalarAggFunc *orig_agg_func =
 			CScalarAggFunc::PopConvert(orig_agg_expr->Pop());
@@ -340,6 +462,61 @@ CXformEagerAgg::PopulateLowerProjectElement(
 		CUtils::PexprScalarProjectElement(mp, lower_colref, lower_agg_expr);
 }
 
+// populate the upper aggregate's project element of an aggregate that is
+// computed above the join
+CExpression *
+CXformEagerAgg::PexprScaledProjectElement(CMemoryPool *mp,
+										  CExpression *orig_proj_elem_expr,
+										  CColRef *count_colref) const
+{
+	CScalarProjectElement *orig_proj_elem =
+		CScalarProjectElement::PopConvert(orig_proj_elem_expr->Pop());
+	CExpression *orig_agg_expr = (*orig_proj_elem_expr)[0];
+	CScalarAggFunc *orig_agg_func =
+		CScalarAggFunc::PopConvert(orig_agg_expr->Pop());
+	IMDId *agg_mdid = orig_agg_func->MDId();
+
+	agg_mdid->AddRef();
+	CScalarAggFunc *upper_agg_func = CUtils::PopAggFunc(
+		mp, agg_mdid,
+		GPOS_NEW(mp)
+			CWStringConst(mp, orig_agg_func->PstrAggFunc()->GetBuffer()),
+		false /*is_distinct*/, EaggfuncstageGlobal, true, NULL,
+		EaggfunckindNormal);
+
+	CExpressionArray *upper_agg_args = NULL;
+	if (orig_agg_func->FCountAny())
+	{
+		// count(x) becomes the sum of the group counts of the rows where x
+		// is not null: CASE WHEN x IS NULL THEN NULL ELSE count END
+		CExpression *arg_expr = (*(*orig_agg_expr)[0])[0];
+		IMDId *count_mdid = count_colref->RetrieveType()->MDId();
+		count_mdid->AddRef();
+		arg_expr->AddRef();
+		CExpression *scaled_arg_expr = GPOS_NEW(mp) CExpression(
+			mp, GPOS_NEW(mp) CScalarIf(mp, count_mdid),
+			CUtils::PexprIsNull(mp, arg_expr),
+			CUtils::PexprScalarConstInt8(mp, 0 /*val*/, true /*is_null*/),
+			CUtils::PexprScalarIdent(mp, count_colref));
+
+		CExpressionArray *args = GPOS_NEW(mp) CExpressionArray(mp);
+		args->Append(scaled_arg_expr);
+		upper_agg_args = CUtils::PexprAggFuncArgs(mp, args);
+	}
+	else
+	{
+		// min and max combine their inputs like partial results
+		upper_agg_args = orig_agg_expr->PdrgPexpr();
+		upper_agg_args->AddRef();
+	}
+
+	CExpression *upper_agg_expr =
+		GPOS_NEW(mp) CExpression(mp, upper_agg_func, upper_agg_args);
+
+	return CUtils::PexprScalarProjectElement(mp, orig_proj_elem->Pcr(),
+											 upper_agg_expr);
+}
+
 // populate the upper aggregate's project element
 // corresponding to a single aggregate.
 void
@@ -0,0 +1,41 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CXformEagerAggNAryJoin.cpp
+//
+//	@doc:
+//		Implementation of eagerly pushing aggregates below an n-ary join
+//---------------------------------------------------------------------------
+#include "gpopt/xforms/CXformEagerAggNAryJoin.h"
+
+#include "gpos/base.h"
+
+#include "gpopt/operators/CLogicalGbAgg.h"
+#include "gpopt/operators/CLogicalNAryJoin.h"
+#include "gpopt/operators/CPatternMultiLeaf.h"
+#include "gpopt/operators/CPatternTree.h"
+
+using namespace gpopt;
+
+// ctor
+CXformEagerAggNAryJoin::CXformEagerAggNAryJoin(CMemoryPool *mp)
+	: CXformEagerAgg(
+		  // pattern
+		  GPOS_NEW(mp) CExpression(
+			  mp, GPOS_NEW(mp) CLogicalGbAgg(mp),
+			  GPOS_NEW(mp) CExpression(
+				  mp, GPOS_NEW(mp) CLogicalNAryJoin(mp),
+				  GPOS_NEW(mp) CExpression(
+					  mp, GPOS_NEW(mp) CPatternMultiLeaf(mp)),	// join children
+				  GPOS_NEW(mp) CExpression(
+					  mp, GPOS_NEW(mp) CPatternTree(mp))  // join predicate
+				  ),
+			  GPOS_NEW(mp) CExpression(
+				  mp, GPOS_NEW(mp) CPatternTree(mp))  // scalar project list
+			  ))
+{
+}
+
+// EOF
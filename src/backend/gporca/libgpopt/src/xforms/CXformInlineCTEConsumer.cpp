@@ -48,7 +48,7 @@ CXformInlineCTEConsumer::Exfp(CExpressionHandle &exprhdl) const
 	const ULONG id = CLogicalCTEConsumer::PopConvert(exprhdl.Pop())->UlCTEId();
 	CCTEInfo *pcteinfo = COptCtxt::PoctxtFromTLS()->Pcteinfo();
 
-	if ((pcteinfo->FEnableInlining() || 1 == pcteinfo->UlConsumers(id)) &&
+	if ((pcteinfo->FEnableInlining(id) || 1 == pcteinfo->UlConsumers(id)) &&
 		CXformUtils::FInlinableCTE(id))
 	{
 		return CXform::ExfpHigh;
@@ -82,7 +82,7 @@ CXformInlineCTEConsumerUnderSelect::Transform(CXformContext *pxfctxt,
 	ULONG id = popConsumer->UlCTEId();
 	CCTEInfo *pcteinfo = COptCtxt::PoctxtFromTLS()->Pcteinfo();
 	// only continue if inlining is enabled or if this CTE has only 1 consumer
-	if (!pcteinfo->FEnableInlining() && 1 < pcteinfo->UlConsumers(id))
+	if (!pcteinfo->FEnableInlining(id) && 1 < pcteinfo->UlConsumers(id))
 	{
 		return;
 	}
@@ -0,0 +1,209 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CXformInnerJoinSemiJoinReduction.cpp
+//
+//	@doc:
+//		Implementation of semi join reduction of an inner join
+//---------------------------------------------------------------------------
+
+#include "gpopt/xforms/CXformInnerJoinSemiJoinReduction.h"
+
+#include "gpos/base.h"
+#include "gpos/memory/CAutoMemoryPool.h"
+
+#include "gpopt/base/CUtils.h"
+#include "gpopt/operators/CLogicalCTEAnchor.h"
+#include "gpopt/operators/CLogicalInnerJoin.h"
+#include "gpopt/operators/CLogicalLeftSemiJoin.h"
+#include "gpopt/operators/CPatternLeaf.h"
+#include "gpopt/operators/CPatternTree.h"
+#include "gpopt/operators/CPredicateUtils.h"
+#include "gpopt/operators/CScalarProjectList.h"
+#include "gpopt/search/CGroupExpression.h"
+#include "gpopt/search/CGroupProxy.h"
+#include "gpopt/xforms/CXformUtils.h"
+#include "naucrates/traceflags/traceflags.h"
+
+using namespace gpopt;
+
+// the xform is only applied if the outer side has at least this many times
+// the rows of the inner side
+const DOUBLE CXformInnerJoinSemiJoinReduction::m_dOuterInnerRatioThreshold =
+	10.0;
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformInnerJoinSemiJoinReduction::CXformInnerJoinSemiJoinReduction
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CXformInnerJoinSemiJoinReduction::CXformInnerJoinSemiJoinReduction(
+	CMemoryPool *mp)
+	: CXformExploration(
+		  // pattern
+		  GPOS_NEW(mp) CExpression(
+			  mp, GPOS_NEW(mp) CLogicalInnerJoin(mp),
+			  GPOS_NEW(mp)
+				  CExpression(mp, GPOS_NEW(mp) CPatternLeaf(mp)),  // left child
+			  GPOS_NEW(mp) CExpression(
+				  mp, GPOS_NEW(mp) CPatternTree(mp)),  // right child
+			  GPOS_NEW(mp)
+				  CExpression(mp, GPOS_NEW(mp) CPatternTree(mp)))  // predicate
+	  )
+{
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformInnerJoinSemiJoinReduction::FFilteredChild
+//
+//	@doc:
+//		Is the given child group a filtered relation; keys produced by a
+//		previous application of the xform are grouped CTE consumers, so
+//		this also keeps the xform from reducing the same join again
+//
+//---------------------------------------------------------------------------
+BOOL
+CXformInnerJoinSemiJoinReduction::FFilteredChild(CGroup *pgroup)
+{
+	GPOS_ASSERT(NULL != pgroup);
+
+	CGroupProxy gp(pgroup);
+	CGroupExpression *pgexprFirst = gp.PgexprFirst();
+	return NULL != pgexprFirst &&
+		   COperator::EopLogicalSelect == pgexprFirst->Pop()->Eopid();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformInnerJoinSemiJoinReduction::Exfp
+//
+//	@doc:
+//		Compute xform promise for a given expression handle
+//
+//---------------------------------------------------------------------------
+CXform::EXformPromise
+CXformInnerJoinSemiJoinReduction::Exfp(CExpressionHandle &exprhdl) const
+{
+	if (!GPOS_FTRACE(EopttraceEnableSemiJoinReduction) ||
+		exprhdl.DeriveHasSubquery(2))
+	{
+		return CXform::ExfpNone;
+	}
+
+	CColRefSet *pcrsInner = exprhdl.DeriveOutputColumns(1 /*child_index*/);
+	CExpression *pexprScalar = exprhdl.PexprScalarExactChild(2 /*child_index*/);
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	if (NULL == pexprScalar ||
+		!CPredicateUtils::FSimpleEqualityUsingCols(mp, pexprScalar, pcrsInner))
+	{
+		return CXform::ExfpNone;
+	}
+
+	// the remaining checks look at the child groups, which are not available
+	// when the promise is computed for a bound expression
+	if (NULL == exprhdl.Pgexpr())
+	{
+		return CXform::ExfpHigh;
+	}
+
+	if (!FFilteredChild((*exprhdl.Pgexpr())[1]))
+	{
+		return CXform::ExfpNone;
+	}
+
+	// stats must be derivable on every child
+	const ULONG arity = exprhdl.Arity();
+	for (ULONG ul = 0; ul < arity; ul++)
+	{
+		CGroup *pgroupChild = (*exprhdl.Pgexpr())[ul];
+		if (!pgroupChild->FScalar() && !pgroupChild->FStatsDerivable(mp))
+		{
+			return CXform::ExfpNone;
+		}
+	}
+
+	return CXform::ExfpHigh;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformInnerJoinSemiJoinReduction::Transform
+//
+//	@doc:
+//		Actual transformation
+//
+//---------------------------------------------------------------------------
+void
+CXformInnerJoinSemiJoinReduction::Transform(CXformContext *pxfctxt,
+											CXformResult *pxfres,
+											CExpression *pexpr) const
+{
+	GPOS_ASSERT(NULL != pxfctxt);
+	GPOS_ASSERT(FPromising(pxfctxt->Pmp(), this, pexpr));
+	GPOS_ASSERT(FCheckPattern(pexpr));
+
+	CMemoryPool *mp = pxfctxt->Pmp();
+
+	// extract components
+	CExpression *pexprOuter = (*pexpr)[0];
+	CExpression *pexprInner = (*pexpr)[1];
+	CExpression *pexprScalar = (*pexpr)[2];
+
+	// only reduce a side that is much bigger than the keys sent to it
+	const IStatistics *outer_stats = pexprOuter->Pstats();
+	const IStatistics *inner_stats = pexprInner->Pstats();
+	if (NULL == outer_stats || NULL == inner_stats ||
+		outer_stats->Rows() <
+			inner_stats->Rows() * CDouble(m_dOuterInnerRatioThreshold))
+	{
+		return;
+	}
+
+	// the small side is computed once, for the keys and for the join
+	CColRefArray *pdrgpcrInner = pexprInner->DeriveOutputColumns()->Pdrgpcr(mp);
+	const ULONG ulCTEId = COptCtxt::PoctxtFromTLS()->Pcteinfo()->next_id();
+	(void) CXformUtils::PexprAddCTEProducer(mp, ulCTEId, pdrgpcrInner,
+											pexprInner);
+
+	// the semi join reads the small side through its own copy of the columns
+	CColRefArray *pdrgpcrInnerCopy = CUtils::PdrgpcrCopy(mp, pdrgpcrInner);
+	UlongToColRefMap *colref_mapping =
+		CUtils::PhmulcrMapping(mp, pdrgpcrInner, pdrgpcrInnerCopy);
+	CExpression *pexprScalarCopy = pexprScalar->PexprCopyWithRemappedColumns(
+		mp, colref_mapping, false /*must_exist*/);
+	colref_mapping->Release();
+
+	// distinct join keys of the small side
+	CColRefSet *pcrsKeys = GPOS_NEW(mp) CColRefSet(mp, pdrgpcrInnerCopy);
+	pcrsKeys->Intersection(pexprScalarCopy->DeriveUsedColumns());
+	CColRefArray *pdrgpcrKeys = pcrsKeys->Pdrgpcr(mp);
+	pcrsKeys->Release();
+
+	CExpression *pexprKeys = CUtils::PexprLogicalGbAggGlobal(
+		mp, pdrgpcrKeys,
+		CXformUtils::PexprCTEConsumer(mp, ulCTEId, pdrgpcrInnerCopy),
+		GPOS_NEW(mp) CExpression(mp, GPOS_NEW(mp) CScalarProjectList(mp)));
+
+	pexprOuter->AddRef();
+	CExpression *pexprSemiJoin = GPOS_NEW(mp)
+		CExpression(mp, GPOS_NEW(mp) CLogicalLeftSemiJoin(mp), pexprOuter,
+					pexprKeys, pexprScalarCopy);
+
+	pexprScalar->AddRef();
+	CExpression *pexprJoin = GPOS_NEW(mp) CExpression(
+		mp, GPOS_NEW(mp) CLogicalInnerJoin(mp), pexprSemiJoin,
+		CXformUtils::PexprCTEConsumer(mp, ulCTEId, pdrgpcrInner), pexprScalar);
+
+	pxfres->Add(GPOS_NEW(mp) CExpression(
+		mp, GPOS_NEW(mp) CLogicalCTEAnchor(mp, ulCTEId), pexprJoin));
+}
+
+// EOF
@@ -1827,7 +1827,14 @@ BOOL
 CXformUtils::FSplitAggXform(CXform::EXformId exfid)
 {
 	return CXform::ExfSplitGbAgg == exfid || CXform::ExfSplitDQA == exfid ||
-		   CXform::ExfSplitGbAggDedup == exfid || CXform::ExfEagerAgg == exfid;
+		   CXform::ExfSplitGbAggDedup == exfid || FEagerAggXform(exfid);
+}
+
+// Check if given xform is an eager aggregation xform
+BOOL
+CXformUtils::FEagerAggXform(CXform::EXformId exfid)
+{
+	return CXform::ExfEagerAgg == exfid || CXform::ExfEagerAggNAryJoin == exfid;
 }
 
 BOOL
@@ -1890,8 +1897,9 @@ CXformUtils::FLocalAggCreatedByEagerAggXform(CExpression *pexprAgg)
 	BOOL is_eager_agg = false;
 	while (NULL != pgexprOrigin && !is_eager_agg)
 	{
-		// parse all expressions in group to check if any was created by CXformEagerAgg
-		is_eager_agg = CXform::ExfEagerAgg == pgexprOrigin->ExfidOrigin();
+		// parse all expressions in group to check if any was created by an
+		// eager aggregation xform
+		is_eager_agg = FEagerAggXform(pgexprOrigin->ExfidOrigin());
 		pgexprOrigin = pgexprOrigin->PgexprOrigin();
 	}
 
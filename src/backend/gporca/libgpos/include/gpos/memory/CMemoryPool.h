@@ -154,6 +154,9 @@ public:
 		return 0;
 	}
 
+	// return highest total allocated size reached so far
+	virtual ULLONG PeakAllocatedSize() const = 0;
+
 	// requested size of allocation
 	static ULONG UserSizeOfAlloc(const void *ptr);
 
@@ -84,6 +84,12 @@ typedef ULONG OID;
 #define GPDB_MEDIAN_TIMESTAMPTZ \
 	OID(6130)  // median(fraction) group within(timestamptz)
 
+// HyperLogLog
+#define GPDB_HYPERLOGLOG_ESTIMATOR OID(7157)  // gp_hyperloglog_estimator
+#define GPDB_HYPERLOGLOG_ACCUM OID(7164)	  // gp_hyperloglog_accum(anyelement)
+#define GPDB_HYPERLOGLOG_GET_ESTIMATE \
+	OID(7162)  // gp_hyperloglog_get_estimate(gp_hyperloglog_estimator)
+
 #endif	// !GPDXL_gpdb_types_H
 
 
@@ -26,6 +26,16 @@ public:
 										 const CStatistics *input_stats,
 										 ULongPtrArray *GCs,
 										 ULongPtrArray *aggs, CBitSet *keys);
+
+	// group by computed on each segment before the rows of a group are
+	// brought together, as done by the partial aggregates of eager
+	// aggregation
+	static CStatistics *CalcLocalGroupByStats(CMemoryPool *mp,
+											  const CStatistics *input_stats,
+											  ULongPtrArray *GCs,
+											  ULongPtrArray *aggs,
+											  CBitSet *keys,
+											  ULONG num_segments);
 };
 }  // namespace gpnaucrates
 
@@ -228,6 +228,12 @@ enum EOptTraceFlag
 	// Discard HashJoin with RedistributeMotion nodes
 	EopttraceDiscardRedistributeHashJoin = 103044,
 
+	// Estimate count(distinct) with HyperLogLog sketches
+	EopttraceEnableApproxCountDistinct = 103045,
+
+	// Reduce the big side of joins with filtered small sides by a semi join
+	EopttraceEnableSemiJoinReduction = 103046,
+
 	///////////////////////////////////////////////////////
 	///////////////////// statistics flags ////////////////
 	//////////////////////////////////////////////////////
@@ -267,6 +273,10 @@ enum EOptTraceFlag
 	// do not use the built-in evaluators for integers in constraint derivation
 	EopttraceUseExternalConstantExpressionEvaluationForInts = 105001,
 
+	// do not fold built-in operators and comparisons inside the optimizer,
+	// always use the external constant expression evaluator
+	EopttraceDisableNativeConstantExpressionEvaluation = 105002,
+
 	// is nestloop params enabled, it is only enabled in GPDB 6.x onwards.
 	EopttraceIndexedNLJOuterRefAsParams = 106000,
 
@@ -84,6 +84,20 @@ CDXLLogicalWindow::GetOpNameStr() const
 	return CDXLTokens::GetDXLTokenStr(EdxltokenLogicalWindow);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLLogicalWindow::NumOfWindowSpecs
+//
+//	@doc:
+//		Return the number of window specifications
+//
+//---------------------------------------------------------------------------
+ULONG
+CDXLLogicalWindow::NumOfWindowSpecs() const
+{
+	return m_window_spec_array->Size();
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CDXLLogicalWindow::GetWindowKeyAt
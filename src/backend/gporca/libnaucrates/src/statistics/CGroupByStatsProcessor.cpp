@@ -106,4 +106,45 @@ CGroupByStatsProcessor::CalcGroupByStats(CMemoryPool *mp,
 	return agg_stats;
 }
 
+// return statistics object after a Group by computed on each segment
+// separately. Rows are not distributed on the grouping columns, so each
+// group is expected to appear on every segment that got any of its rows:
+// with R rows evenly spread over G groups and S segments, that is
+// S * (1 - (1 - 1/S)^(R/G)) segments per group.
+CStatistics *
+CGroupByStatsProcessor::CalcLocalGroupByStats(CMemoryPool *mp,
+											  const CStatistics *input_stats,
+											  ULongPtrArray *GCs,
+											  ULongPtrArray *aggs,
+											  CBitSet *keys,
+											  ULONG num_segments)
+{
+	CStatistics *agg_stats =
+		CalcGroupByStats(mp, input_stats, GCs, aggs, keys);
+	if (1 >= num_segments || input_stats->IsEmpty())
+	{
+		return agg_stats;
+	}
+
+	CDouble groups = agg_stats->Rows();
+	CDouble segments = CDouble(num_segments);
+	CDouble rows_per_group = input_stats->Rows() / groups;
+	CDouble segments_per_group =
+		segments *
+		(CDouble(1.0) -
+		 (CDouble(1.0) - CDouble(1.0) / segments).Pow(rows_per_group));
+	CDouble local_rows =
+		std::min(input_stats->Rows().Get(), (groups * segments_per_group).Get());
+	if (local_rows <= groups)
+	{
+		return agg_stats;
+	}
+
+	CStatistics *local_agg_stats = dynamic_cast<CStatistics *>(
+		agg_stats->ScaleStats(mp, local_rows / groups));
+	agg_stats->Release();
+
+	return local_agg_stats;
+}
+
 // EOF
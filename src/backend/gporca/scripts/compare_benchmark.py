@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+
+import argparse
+import json
+import sys
+
+_help = """
+Compares two outputs of the gporca_benchmark executable, see server/benchmark/main.cpp,
+and prints the minidumps whose optimization time, peak memory or search space
+changed by more than the given threshold
+"""
+
+
+def load(file_name):
+	results = {}
+	with open(file_name) as f:
+		for line in f:
+			line = line.strip()
+			if line:
+				entry = json.loads(line)
+				results[entry["minidump"]] = entry
+	return results
+
+
+def change(base, new):
+	if base == 0:
+		return 0.0 if new == 0 else float("inf")
+	return 100.0 * (new - base) / base
+
+
+def main():
+	parser = argparse.ArgumentParser(description=_help)
+	parser.add_argument("base", help="benchmark output of the baseline build")
+	parser.add_argument("new", help="benchmark output of the build to compare")
+	parser.add_argument("--threshold", type=float, default=10.0,
+						help="percentage of change to report (default: 10)")
+	args = parser.parse_args()
+
+	base = load(args.base)
+	new = load(args.new)
+	regressions = 0
+
+	for minidump in sorted(base):
+		if minidump not in new:
+			print("%s: missing from %s" % (minidump, args.new))
+			continue
+		b = base[minidump]
+		n = new[minidump]
+		if "error" in b or "error" in n:
+			if "error" in n and "error" not in b:
+				print("%s: fails with error %s" % (minidump, n["error"]))
+				regressions += 1
+			continue
+
+		metrics = [("median time (us)", b["time_us"]["median"], n["time_us"]["median"]),
+				   ("peak memory (bytes)", b["peak_memory_bytes"], n["peak_memory_bytes"]),
+				   ("groups", b["groups"], n["groups"]),
+				   ("group expressions", b["group_exprs"], n["group_exprs"])]
+		for name, bv, nv in metrics:
+			pct = change(bv, nv)
+			if abs(pct) >= args.threshold:
+				print("%s: %s %d -> %d (%+.1f%%)" % (minidump, name, bv, nv, pct))
+				if pct > 0:
+					regressions += 1
+
+		if b["search_stage"] != n["search_stage"] or b["budget_exhausted"] != n["budget_exhausted"]:
+			print("%s: search stage %d -> %d, budget exhausted %s -> %s" %
+				  (minidump, b["search_stage"], n["search_stage"],
+				   b["budget_exhausted"], n["budget_exhausted"]))
+
+		for xform in sorted(set(b["xforms"]) | set(n["xforms"])):
+			bc = b["xforms"].get(xform, {}).get("calls", 0)
+			nc = n["xforms"].get(xform, {}).get("calls", 0)
+			if abs(change(bc, nc)) >= args.threshold:
+				print("%s: %s calls %d -> %d" % (minidump, xform, bc, nc))
+
+	return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
@@ -0,0 +1,359 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		main.cpp
+//
+//	@doc:
+//		Optimizer benchmark; replays minidumps and records optimization time,
+//		memory and search statistics of each of them
+//---------------------------------------------------------------------------
+
+#include "gpos/_api.h"
+#include "gpos/common/CAutoRg.h"
+#include "gpos/common/CMainArgs.h"
+#include "gpos/common/CWallClock.h"
+#include "gpos/common/clibwrapper.h"
+#include "gpos/io/COstreamString.h"
+#include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/string/CWStringDynamic.h"
+#include "gpos/test/CUnittest.h"
+#include "gpos/types.h"
+
+#include "gpopt/base/CIOUtils.h"
+#include "gpopt/engine/CEngine.h"
+#include "gpopt/init.h"
+#include "gpopt/mdcache/CMDCache.h"
+#include "gpopt/minidump/CDXLMinidump.h"
+#include "gpopt/minidump/CMinidumperUtils.h"
+#include "gpopt/optimizer/COptimizerConfig.h"
+#include "gpopt/xforms/CXformFactory.h"
+#include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/init.h"
+
+using namespace gpos;
+using namespace gpopt;
+using namespace gpdxl;
+
+// default number of times each minidump is optimized
+#define GPOPT_BENCHMARK_ITERATIONS 5
+
+// number of segments used if the minidump does not configure more
+#define GPOPT_BENCHMARK_SEGMENTS 2
+
+// default output file
+#define GPOPT_BENCHMARK_OUTPUT "gporca_benchmark.json"
+
+// command line of the benchmark
+struct SBenchmarkArgs
+{
+	// parsed options
+	CMainArgs *m_pma;
+
+	// raw arguments, minidump files follow the options
+	INT m_argc;
+	const CHAR **m_argv;
+};
+
+// static variable set when the benchmark could not run, or a minidump failed
+// to optimize
+static BOOL benchmark_failed = false;
+
+//---------------------------------------------------------------------------
+//	@function:
+//		UlSegments
+//
+//	@doc:
+//		Number of segments to optimize the minidump for
+//
+//---------------------------------------------------------------------------
+static ULONG
+UlSegments(COptimizerConfig *optimizer_config)
+{
+	ULONG ulSegments = GPOPT_BENCHMARK_SEGMENTS;
+	if (NULL != optimizer_config->GetCostModel() &&
+		ulSegments < optimizer_config->GetCostModel()->UlHosts())
+	{
+		ulSegments = optimizer_config->GetCostModel()->UlHosts();
+	}
+
+	return ulSegments;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		SortTimes
+//
+//	@doc:
+//		Sort the measured times in ascending order
+//
+//---------------------------------------------------------------------------
+static void
+SortTimes(ULONG *rgulTimes, ULONG ulTimes)
+{
+	for (ULONG ul = 1; ul < ulTimes; ul++)
+	{
+		ULONG ulTime = rgulTimes[ul];
+		ULONG ulPos = ul;
+		while (0 < ulPos && rgulTimes[ulPos - 1] > ulTime)
+		{
+			rgulTimes[ulPos] = rgulTimes[ulPos - 1];
+			ulPos--;
+		}
+		rgulTimes[ulPos] = ulTime;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		UlOptimizeMinidump
+//
+//	@doc:
+//		Optimize the given minidump once; return the time it took in
+//		microseconds and the peak size of the memory pool used
+//
+//---------------------------------------------------------------------------
+static ULONG
+UlOptimizeMinidump(const CHAR *file_name, ULLONG *pullPeakMemory)
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	CDXLMinidump *pdxlmd = CMinidumperUtils::PdxlmdLoad(mp, file_name);
+	COptimizerConfig *optimizer_config = pdxlmd->GetOptimizerConfig();
+	if (NULL == optimizer_config)
+	{
+		optimizer_config = COptimizerConfig::PoconfDefault(mp);
+	}
+	else
+	{
+		optimizer_config->AddRef();
+	}
+
+	CWallClock clock;
+	CDXLNode *pdxlnPlan = CMinidumperUtils::PdxlnExecuteMinidump(
+		mp, pdxlmd, file_name, UlSegments(optimizer_config), 1 /*ulSessionId*/,
+		1 /*ulCmdId*/, optimizer_config, NULL /*pceeval*/);
+	ULONG ulTime = clock.ElapsedUS();
+
+	*pullPeakMemory = mp->PeakAllocatedSize();
+
+	pdxlnPlan->Release();
+	optimizer_config->Release();
+	GPOS_DELETE(pdxlmd);
+
+	return ulTime;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		SerializeStats
+//
+//	@doc:
+//		Serialize the measurements of a minidump as a single line of JSON
+//
+//---------------------------------------------------------------------------
+static void
+SerializeStats(IOstream &os, const CHAR *file_name, ULONG *rgulTimes,
+			   ULONG ulIterations, ULLONG ullPeakMemory)
+{
+	const CEngine::SOptimizationStats &ostats = CEngine::OstatsLast();
+
+	SortTimes(rgulTimes, ulIterations);
+
+	os << "{\"minidump\": \"" << file_name << "\""
+	   << ", \"iterations\": " << ulIterations
+	   << ", \"time_us\": {\"min\": " << rgulTimes[0]
+	   << ", \"median\": " << rgulTimes[ulIterations / 2]
+	   << ", \"max\": " << rgulTimes[ulIterations - 1] << "}"
+	   << ", \"peak_memory_bytes\": " << ullPeakMemory
+	   << ", \"groups\": " << ostats.m_ulGroups
+	   << ", \"duplicate_groups\": " << ostats.m_ulDuplicateGroups
+	   << ", \"group_exprs\": " << ostats.m_ulGroupExprs
+	   << ", \"search_stage\": " << ostats.m_ulSearchStage
+	   << ", \"budget_exhausted\": "
+	   << (ostats.m_fBudgetExhausted ? "true" : "false") << ", \"xforms\": {";
+
+	BOOL fFirst = true;
+	for (ULONG ul = 0; ul < CXform::ExfSentinel; ul++)
+	{
+		CXform::EXformId exfid = (CXform::EXformId) ul;
+		if (0 == ostats.m_rgulpXformCalls[ul] ||
+			!CXformFactory::Pxff()->IsXformIdUsed(exfid))
+		{
+			continue;
+		}
+
+		os << (fFirst ? "" : ", ") << "\""
+		   << CXformFactory::Pxff()->Pxf(exfid)->SzId() << "\": {\"calls\": "
+		   << ostats.m_rgulpXformCalls[ul]
+		   << ", \"results\": " << ostats.m_rgulpXformResults[ul] << "}";
+		fFirst = false;
+	}
+
+	os << "}}" << std::endl;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		SerializeError
+//
+//	@doc:
+//		Serialize the failure of a minidump as a single line of JSON
+//
+//---------------------------------------------------------------------------
+static void
+SerializeError(IOstream &os, const CHAR *file_name, CException &ex)
+{
+	os << "{\"minidump\": \"" << file_name << "\""
+	   << ", \"error\": {\"major\": " << ex.Major()
+	   << ", \"minor\": " << ex.Minor() << "}}" << std::endl;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		PvExec
+//
+//	@doc:
+//		Function driving execution.
+//
+//---------------------------------------------------------------------------
+static void *
+PvExec(void *pv)
+{
+	SBenchmarkArgs *pba = (SBenchmarkArgs *) pv;
+	CMemoryPool *mp = ITask::Self()->Pmp();
+
+	ULONG ulIterations = GPOPT_BENCHMARK_ITERATIONS;
+	const CHAR *szOutput = GPOPT_BENCHMARK_OUTPUT;
+
+	CHAR ch = '\0';
+	while (pba->m_pma->Getopt(&ch))
+	{
+		switch (ch)
+		{
+			case 'n':
+				ulIterations = (ULONG) clib::Strtol(optarg, NULL, 10);
+				break;
+
+			case 'o':
+				szOutput = optarg;
+				break;
+
+			case 'T':
+				CUnittest::SetTraceFlag(optarg);
+				break;
+
+			default:
+				// ignore other parameters
+				break;
+		}
+	}
+
+	if (0 == ulIterations || optind >= pba->m_argc)
+	{
+		GPOS_TRACE(GPOS_WSZ_LIT(
+			"Usage: gporca_benchmark [-n iterations] [-o output] "
+			"[-T traceflag] minidump..."));
+		benchmark_failed = true;
+		return NULL;
+	}
+
+	// initialize DXL support
+	InitDXL();
+
+	CMDCache::Init();
+
+	CWStringDynamic str(mp);
+	COstreamString oss(&str);
+
+	CAutoRg<ULONG> argTimes;
+	argTimes = GPOS_NEW_ARRAY(mp, ULONG, ulIterations);
+
+	for (INT i = optind; i < pba->m_argc; i++)
+	{
+		const CHAR *file_name = pba->m_argv[i];
+
+		GPOS_TRY
+		{
+			ULLONG ullPeakMemory = 0;
+			for (ULONG ul = 0; ul < ulIterations; ul++)
+			{
+				ULLONG ullMemory = 0;
+				argTimes.Rgt()[ul] = UlOptimizeMinidump(file_name, &ullMemory);
+				ullPeakMemory = std::max(ullPeakMemory, ullMemory);
+			}
+
+			SerializeStats(oss, file_name, argTimes.Rgt(), ulIterations,
+						   ullPeakMemory);
+		}
+		GPOS_CATCH_EX(ex)
+		{
+			SerializeError(oss, file_name, ex);
+			benchmark_failed = true;
+			GPOS_RESET_EX;
+		}
+		GPOS_CATCH_END;
+	}
+
+	CHAR *sz = CDXLUtils::CreateMultiByteCharStringFromWCString(
+		mp, str.GetBuffer());
+	CIOUtils::Dump(const_cast<CHAR *>(szOutput), sz);
+	GPOS_DELETE_ARRAY(sz);
+
+	CMDCache::Shutdown();
+
+	return NULL;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		main
+//
+//	@doc:
+//		Entry point for the optimizer benchmark; optimizes each minidump given
+//		on the command line a number of times and writes one line of JSON
+//		per minidump to the output file, for comparison between builds
+//
+//---------------------------------------------------------------------------
+INT
+main(INT iArgs, const CHAR **rgszArgs)
+{
+	// Use default allocator
+	struct gpos_init_params gpos_params = {NULL};
+
+	gpos_init(&gpos_params);
+	gpdxl_init();
+	gpopt_init();
+
+	GPOS_ASSERT(iArgs >= 0);
+
+	CMainArgs ma(iArgs, rgszArgs, "n:o:T:");
+
+	SBenchmarkArgs ba;
+	ba.m_pma = &ma;
+	ba.m_argc = iArgs;
+	ba.m_argv = rgszArgs;
+
+	gpos_exec_params params;
+	params.func = PvExec;
+	params.arg = &ba;
+	params.stack_start = &params;
+	params.error_buffer = NULL;
+	params.error_buffer_size = -1;
+	params.abort_requested = NULL;
+
+	if (gpos_exec(&params) || benchmark_failed)
+	{
+		return 1;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+
+// EOF
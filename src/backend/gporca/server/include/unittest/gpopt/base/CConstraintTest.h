@@ -118,6 +118,7 @@ public:
 	static GPOS_RESULT EresUnittest_CConstraintIntervalConvertsTo();
 	static GPOS_RESULT EresUnittest_CConstraintIntervalPexpr();
 	static GPOS_RESULT EresUnittest_CConstraintIntervalFromArrayExpr();
+	static GPOS_RESULT EresUnittest_CConstraintIntervalPointSet();
 
 #ifdef GPOS_DEBUG
 	// tests for unconstrainable types
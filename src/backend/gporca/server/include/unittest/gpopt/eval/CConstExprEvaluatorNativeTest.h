@@ -0,0 +1,54 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CConstExprEvaluatorNativeTest.h
+//
+//	@doc:
+//		Unit tests for CConstExprEvaluatorNative
+//
+//	@owner:
+//
+//
+//	@test:
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPOPT_CConstExprEvaluatorNativeTest_H
+#define GPOPT_CConstExprEvaluatorNativeTest_H
+
+#include "gpos/base.h"
+
+namespace gpopt
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CConstExprEvaluatorNativeTest
+//
+//	@doc:
+//		Unit tests for CConstExprEvaluatorNative
+//
+//---------------------------------------------------------------------------
+class CConstExprEvaluatorNativeTest
+{
+public:
+	// run unittests
+	static GPOS_RESULT EresUnittest();
+
+	// test folding of integer arithmetic
+	static GPOS_RESULT EresUnittest_IntArithmetic();
+
+	// test folding of comparisons
+	static GPOS_RESULT EresUnittest_Comparison();
+
+	// test comparison of date datums
+	static GPOS_RESULT EresUnittest_DatumComparison();
+};
+}  // namespace gpopt
+
+#endif	// !GPOPT_CConstExprEvaluatorNativeTest_H
+
+// EOF
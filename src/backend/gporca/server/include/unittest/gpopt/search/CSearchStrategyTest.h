@@ -65,6 +65,9 @@ public:
 	// test search strategy that times out
 	static GPOS_RESULT EresUnittest_Timeout();
 
+	// test search that exhausts the optimization budget
+	static GPOS_RESULT EresUnittest_Budget();
+
 	// test exception handling when parsing search strategy
 	static GPOS_RESULT EresUnittest_ParsingWithException();
 
@@ -64,6 +64,7 @@
 #include "unittest/gpopt/engine/CEnumeratorTest.h"
 #include "unittest/gpopt/eval/CConstExprEvaluatorDXLTest.h"
 #include "unittest/gpopt/eval/CConstExprEvaluatorDefaultTest.h"
+#include "unittest/gpopt/eval/CConstExprEvaluatorNativeTest.h"
 #include "unittest/gpopt/mdcache/CMDAccessorTest.h"
 #include "unittest/gpopt/mdcache/CMDProviderTest.h"
 #include "unittest/gpopt/metadata/CColumnDescriptorTest.h"
@@ -207,6 +208,7 @@ static gpos::CUnittest rgut[] = {
 	GPOS_UNITTEST_STD(CXformTest),
 	GPOS_UNITTEST_STD(CConstExprEvaluatorDefaultTest),
 	GPOS_UNITTEST_STD(CConstExprEvaluatorDXLTest),
+	GPOS_UNITTEST_STD(CConstExprEvaluatorNativeTest),
 // disable CEnumeratorTest until it is fixed
 //	GPOS_UNITTEST_STD(CEnumeratorTest),
 // extended tests
@@ -96,6 +96,8 @@ CConstraintTest::EresUnittest()
 			CConstraintTest::EresUnittest_CConstraintIntervalPexpr),
 		GPOS_UNITTEST_FUNC(
 			CConstraintTest::EresUnittest_CConstraintIntervalFromArrayExpr),
+		GPOS_UNITTEST_FUNC(
+			CConstraintTest::EresUnittest_CConstraintIntervalPointSet),
 #ifdef GPOS_DEBUG
 		GPOS_UNITTEST_FUNC_THROW(CConstraintTest::EresUnittest_NegativeTests,
 								 gpos::CException::ExmaSystem,
@@ -927,6 +929,120 @@ CConstraintTest::EresUnittest_CConstraintIntervalFromArrayExpr()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstraintTest::EresUnittest_CConstraintIntervalPointSet
+//
+//	@doc:
+//		Tests set operations on intervals built from IN lists, which keep
+//		their constants as point sets
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CConstraintTest::EresUnittest_CConstraintIntervalPointSet()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// setup a file-based provider
+	CMDProviderMemory *pmdp = CTestUtils::m_pmdpf;
+	pmdp->AddRef();
+	CMDAccessor mda(mp, CMDCache::Pcache(), CTestUtils::m_sysidDefault, pmdp);
+
+	CConstExprEvaluatorForDates *pceeval =
+		GPOS_NEW(mp) CConstExprEvaluatorForDates(mp);
+
+	// install opt context in TLS
+	CAutoOptCtxt aoc(mp, &mda, pceeval, CTestUtils::GetCostModel(mp));
+	GPOS_RTL_ASSERT(NULL != COptCtxt::PoctxtFromTLS()->Pcomp());
+
+	CAutoTraceFlag atf(EopttraceArrayConstraints, true);
+
+	// col IN (0, 1, 2, 3, 4)
+	CExpression *pexprFst = CTestUtils::PexprLogicalSelectArrayCmp(mp);
+	CColRef *colref = pexprFst->DeriveOutputColumns()->PcrAny();
+	CConstraintInterval *pciFst = CConstraintInterval::PciIntervalFromScalarExpr(
+		mp, (*pexprFst)[1], colref);
+
+	// col IN (3, 4, 5, 3)
+	IntPtrArray *pdrgpi = GPOS_NEW(mp) IntPtrArray(mp);
+	INT rgiVals[] = {3, 4, 5, 3};
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(rgiVals); ul++)
+	{
+		pdrgpi->Append(GPOS_NEW(mp) INT(rgiVals[ul]));
+	}
+	CExpression *pexprSnd = CTestUtils::PexprLogicalSelectArrayCmp(
+		mp, CScalarArrayCmp::EarrcmpAny, IMDType::EcmptEq, pdrgpi);
+	pdrgpi->Release();
+	CConstraintInterval *pciSndOther =
+		CConstraintInterval::PciIntervalFromScalarExpr(
+			mp, (*pexprSnd)[1], pexprSnd->DeriveOutputColumns()->PcrAny());
+	CConstraintInterval *pciSnd = dynamic_cast<CConstraintInterval *>(
+		pciSndOther->PcnstrRemapForColumn(mp, colref));
+	pciSndOther->Release();
+
+	GPOS_RTL_ASSERT(NULL != pciFst->Ppset() && 5 == pciFst->Ppset()->Size());
+	GPOS_RTL_ASSERT(NULL != pciSnd->Ppset() && 3 == pciSnd->Ppset()->Size());
+	PrintConstraint(mp, pciFst);
+
+	// set operations between point sets keep them as point sets
+	CConstraintInterval *pciIntersect = pciFst->PciIntersect(mp, pciSnd);
+	CConstraintInterval *pciUnion = pciFst->PciUnion(mp, pciSnd);
+	CConstraintInterval *pciDiff = pciFst->PciDifference(mp, pciSnd);
+	GPOS_RTL_ASSERT(NULL != pciIntersect->Ppset() &&
+					2 == pciIntersect->Ppset()->Size());
+	GPOS_RTL_ASSERT(NULL != pciUnion->Ppset() &&
+					6 == pciUnion->Ppset()->Size());
+	GPOS_RTL_ASSERT(NULL != pciDiff->Ppset() && 3 == pciDiff->Ppset()->Size());
+	GPOS_RTL_ASSERT(pciFst->FContainsInterval(mp, pciIntersect));
+	GPOS_RTL_ASSERT(!pciFst->FContainsInterval(mp, pciUnion));
+
+	// the ranges built from a point set are [x,x] ranges
+	GPOS_RTL_ASSERT(6 == pciUnion->Pdrgprng()->Size());
+	GPOS_RTL_ASSERT(pciUnion->FConvertsToIn());
+
+	// the scalar expression of a point set is an IN list
+	CExpression *pexpr = pciUnion->PexprScalar(mp);
+	GPOS_RTL_ASSERT(CUtils::FScalarArrayCmp(pexpr));
+	GPOS_RTL_ASSERT(6 ==
+					CUtils::UlCountOperator(pexpr, COperator::EopScalarConst));
+
+	// col < 2
+	CExpression *pexprConst = CUtils::PexprScalarConstInt4(mp, 2 /*val*/);
+	CConstraintInterval *pciLess = CConstraintInterval::PciIntervalFromColConstCmp(
+		mp, colref, IMDType::EcmptL,
+		CScalarConst::PopConvert(pexprConst->Pop()));
+
+	// points are filtered through ranges in both directions
+	CConstraintInterval *pciLessIntersect = pciLess->PciIntersect(mp, pciFst);
+	CConstraintInterval *pciDiffLess = pciFst->PciDifference(mp, pciLess);
+	GPOS_RTL_ASSERT(NULL != pciLessIntersect->Ppset() &&
+					2 == pciLessIntersect->Ppset()->Size());
+	GPOS_RTL_ASSERT(NULL != pciDiffLess->Ppset() &&
+					3 == pciDiffLess->Ppset()->Size());
+
+	// a mixed union falls back to ranges: (-inf, 2], [3,3], [4,4]
+	CConstraintInterval *pciLessUnion = pciLess->PciUnion(mp, pciFst);
+	GPOS_RTL_ASSERT(NULL == pciLessUnion->Ppset());
+	PrintConstraint(mp, pciLessUnion);
+
+	pciLessUnion->Release();
+	pciDiffLess->Release();
+	pciLessIntersect->Release();
+	pciLess->Release();
+	pexprConst->Release();
+	pciDiff->Release();
+	pciUnion->Release();
+	pciIntersect->Release();
+	pciSnd->Release();
+	pciFst->Release();
+	pexprSnd->Release();
+	pexprFst->Release();
+
+	return GPOS_OK;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CConstraintTest::EresUnittest_CConstraintIntervalFromArrayExprIncludesNull
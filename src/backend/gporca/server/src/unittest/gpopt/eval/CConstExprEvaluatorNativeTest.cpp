@@ -0,0 +1,303 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CConstExprEvaluatorNativeTest.cpp
+//
+//	@doc:
+//		Unit tests for CConstExprEvaluatorNative
+//
+//	@owner:
+//
+//
+//	@test:
+//
+//---------------------------------------------------------------------------
+
+#include "unittest/gpopt/eval/CConstExprEvaluatorNativeTest.h"
+
+#include "gpos/string/CWStringDynamic.h"
+
+#include "gpopt/base/CUtils.h"
+#include "gpopt/eval/CConstExprEvaluatorDefault.h"
+#include "gpopt/eval/CConstExprEvaluatorNative.h"
+#include "gpopt/mdcache/CMDAccessor.h"
+#include "gpopt/operators/ops.h"
+#include "naucrates/base/IDatumBool.h"
+#include "naucrates/base/IDatumInt4.h"
+#include "naucrates/dxl/gpdb_types.h"
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/IMDTypeInt4.h"
+
+#include "unittest/base.h"
+#include "unittest/gpopt/CTestUtils.h"
+
+using namespace gpos;
+using namespace gpopt;
+
+// byte representation of date '2012-01-01'
+static const WCHAR *wszDate2012_01_01 = GPOS_WSZ_LIT("HxEAAA==");
+
+// byte representation of date '2012-01-02'
+static const WCHAR *wszDate2012_01_02 = GPOS_WSZ_LIT("IBEAAA==");
+
+//---------------------------------------------------------------------------
+//	@function:
+//		PexprInt4Plus
+//
+//	@doc:
+//		Generate an int4pl expression over two int4 constants
+//
+//---------------------------------------------------------------------------
+static CExpression *
+PexprInt4Plus(CMemoryPool *mp, INT iLeft, INT iRight)
+{
+	return GPOS_NEW(mp) CExpression(
+		mp,
+		GPOS_NEW(mp) CScalarOp(
+			mp, GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, OID(551)),
+			GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, GPDB_INT4),
+			GPOS_NEW(mp) CWStringConst(mp, GPOS_WSZ_LIT("+"))),
+		CUtils::PexprScalarConstInt4(mp, iLeft),
+		CUtils::PexprScalarConstInt4(mp, iRight));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		FInt4Const
+//
+//	@doc:
+//		Check that the given expression is a non-null int4 constant with the
+//		given value
+//
+//---------------------------------------------------------------------------
+static BOOL
+FInt4Const(CExpression *pexpr, INT iExpected)
+{
+	if (COperator::EopScalarConst != pexpr->Pop()->Eopid())
+	{
+		return false;
+	}
+
+	IDatum *datum = CScalarConst::PopConvert(pexpr->Pop())->GetDatum();
+	return !datum->IsNull() &&
+		   IMDType::EtiInt4 == datum->GetDatumType() &&
+		   iExpected == dynamic_cast<IDatumInt4 *>(datum)->Value();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		FBoolConst
+//
+//	@doc:
+//		Check that the given expression is a non-null bool constant with the
+//		given value
+//
+//---------------------------------------------------------------------------
+static BOOL
+FBoolConst(CExpression *pexpr, BOOL fExpected)
+{
+	if (COperator::EopScalarConst != pexpr->Pop()->Eopid())
+	{
+		return false;
+	}
+
+	IDatum *datum = CScalarConst::PopConvert(pexpr->Pop())->GetDatum();
+	return !datum->IsNull() && IMDType::EtiBool == datum->GetDatumType() &&
+		   fExpected == dynamic_cast<IDatumBool *>(datum)->GetValue();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNativeTest::EresUnittest
+//
+//	@doc:
+//		Executes all unit tests for CConstExprEvaluatorNative
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CConstExprEvaluatorNativeTest::EresUnittest()
+{
+	CUnittest rgut[] = {
+		GPOS_UNITTEST_FUNC(
+			CConstExprEvaluatorNativeTest::EresUnittest_IntArithmetic),
+		GPOS_UNITTEST_FUNC(CConstExprEvaluatorNativeTest::EresUnittest_Comparison),
+		GPOS_UNITTEST_FUNC(
+			CConstExprEvaluatorNativeTest::EresUnittest_DatumComparison),
+	};
+
+	return CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNativeTest::EresUnittest_IntArithmetic
+//
+//	@doc:
+//		Integer arithmetic is folded natively; overflowing expressions are
+//		handed to the fallback evaluator untouched
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CConstExprEvaluatorNativeTest::EresUnittest_IntArithmetic()
+{
+	CTestUtils::CTestSetup testsetup;
+	CMemoryPool *mp = testsetup.Pmp();
+	CConstExprEvaluatorNative *pceeval = GPOS_NEW(mp)
+		CConstExprEvaluatorNative(mp, GPOS_NEW(mp) CConstExprEvaluatorDefault(),
+								  true /*fIntegerDatetimes*/);
+	GPOS_RESULT eres = GPOS_OK;
+
+	// 2 + 3 folds to 5
+	CExpression *pexpr = PexprInt4Plus(mp, 2, 3);
+	CExpression *pexprResult = pceeval->PexprEval(pexpr);
+	if (!FInt4Const(pexprResult, 5))
+	{
+		eres = GPOS_FAILED;
+	}
+	pexprResult->Release();
+	pexpr->Release();
+
+	// int4 overflow is left to the fallback, which returns its input
+	pexpr = PexprInt4Plus(mp, gpos::int_max, 1);
+	GPOS_ASSERT(NULL == pceeval->PexprEvalNative(pexpr));
+	pexprResult = pceeval->PexprEval(pexpr);
+	if (pexprResult != pexpr)
+	{
+		eres = GPOS_FAILED;
+	}
+	pexprResult->Release();
+	pexpr->Release();
+
+	// NULL operands yield a NULL result of the operator's return type
+	pexpr = GPOS_NEW(mp) CExpression(
+		mp,
+		GPOS_NEW(mp)
+			CScalarOp(mp, GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, OID(551)),
+					  GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, GPDB_INT4),
+					  GPOS_NEW(mp) CWStringConst(mp, GPOS_WSZ_LIT("+"))),
+		CUtils::PexprScalarConstInt4(mp, 1),
+		CUtils::PexprScalarConstNull(
+			mp, testsetup.Pmda()->PtMDType<IMDTypeInt4>(),
+			default_type_modifier));
+	pexprResult = pceeval->PexprEval(pexpr);
+	if (COperator::EopScalarConst != pexprResult->Pop()->Eopid() ||
+		!CScalarConst::PopConvert(pexprResult->Pop())->GetDatum()->IsNull())
+	{
+		eres = GPOS_FAILED;
+	}
+	pexprResult->Release();
+	pexpr->Release();
+
+	pceeval->Release();
+
+	return eres;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNativeTest::EresUnittest_Comparison
+//
+//	@doc:
+//		Comparisons over constants and foldable operators are folded natively
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CConstExprEvaluatorNativeTest::EresUnittest_Comparison()
+{
+	CTestUtils::CTestSetup testsetup;
+	CMemoryPool *mp = testsetup.Pmp();
+	CConstExprEvaluatorNative *pceeval = GPOS_NEW(mp)
+		CConstExprEvaluatorNative(mp, GPOS_NEW(mp) CConstExprEvaluatorDefault(),
+								  true /*fIntegerDatetimes*/);
+	GPOS_RESULT eres = GPOS_OK;
+
+	// (1 + 2) < 4 is true
+	CExpression *pexpr =
+		CUtils::PexprScalarCmp(mp, PexprInt4Plus(mp, 1, 2),
+							   CUtils::PexprScalarConstInt4(mp, 4),
+							   IMDType::EcmptL);
+	CExpression *pexprResult = pceeval->PexprEval(pexpr);
+	if (!FBoolConst(pexprResult, true))
+	{
+		eres = GPOS_FAILED;
+	}
+	pexprResult->Release();
+	pexpr->Release();
+
+	// 7 = 8 is false
+	pexpr = CUtils::PexprScalarEqCmp(mp, CUtils::PexprScalarConstInt4(mp, 7),
+									 CUtils::PexprScalarConstInt4(mp, 8));
+	pexprResult = pceeval->PexprEval(pexpr);
+	if (!FBoolConst(pexprResult, false))
+	{
+		eres = GPOS_FAILED;
+	}
+	pexprResult->Release();
+	pexpr->Release();
+
+	pceeval->Release();
+
+	return eres;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CConstExprEvaluatorNativeTest::EresUnittest_DatumComparison
+//
+//	@doc:
+//		Date datums are compared natively, without the fallback evaluator
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CConstExprEvaluatorNativeTest::EresUnittest_DatumComparison()
+{
+	CTestUtils::CTestSetup testsetup;
+	CMemoryPool *mp = testsetup.Pmp();
+	CConstExprEvaluatorNative *pceeval = GPOS_NEW(mp)
+		CConstExprEvaluatorNative(mp, GPOS_NEW(mp) CConstExprEvaluatorDefault(),
+								  true /*fIntegerDatetimes*/);
+	GPOS_RESULT eres = GPOS_OK;
+
+	CWStringDynamic strFirst(mp, wszDate2012_01_01);
+	CWStringDynamic strSecond(mp, wszDate2012_01_02);
+	IDatum *datumFirst =
+		CTestUtils::CreateGenericDatum(mp, testsetup.Pmda(),
+									   GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, GPDB_DATE),
+									   &strFirst, 4383 /*value*/);
+	IDatum *datumSecond =
+		CTestUtils::CreateGenericDatum(mp, testsetup.Pmda(),
+									   GPOS_NEW(mp) CMDIdGPDB(IMDId::EmdidGeneral, GPDB_DATE),
+									   &strSecond, 4384 /*value*/);
+
+	BOOL fResult = false;
+	if (!pceeval->FEvalDatumComparison(datumFirst, datumSecond,
+									   IMDType::EcmptL, &fResult) ||
+		!fResult)
+	{
+		eres = GPOS_FAILED;
+	}
+
+	if (!pceeval->FEvalDatumComparison(datumSecond, datumFirst,
+									   IMDType::EcmptLEq, &fResult) ||
+		fResult)
+	{
+		eres = GPOS_FAILED;
+	}
+
+	if (!pceeval->FEvalDatumComparison(datumFirst, datumFirst,
+									   IMDType::EcmptEq, &fResult) ||
+		!fResult)
+	{
+		eres = GPOS_FAILED;
+	}
+
+	datumFirst->Release();
+	datumSecond->Release();
+	pceeval->Release();
+
+	return eres;
+}
+
+// EOF
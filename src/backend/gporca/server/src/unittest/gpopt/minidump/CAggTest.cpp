@@ -38,6 +38,7 @@ const CHAR *rgszAggFileNames[] = {
 	"../data/dxl/minidump/EagerAggUnsupportedAgg.mdp",
 	"../data/dxl/minidump/EagerAggGroupColumnInJoin.mdp",
 	"../data/dxl/minidump/EagerAggSubquery.mdp",
+	"../data/dxl/minidump/EagerAggInnerChild.mdp",
 	"../data/dxl/minidump/DQA-KeepOuterReference.mdp",
 	"../data/dxl/minidump/ScalarSubqueryCountStarInJoin.mdp",
 	"../data/dxl/minidump/ScalarCorrelatedSubqueryCountStar.mdp",
@@ -67,6 +68,8 @@ const CHAR *rgszAggFileNames[] = {
 	"../data/dxl/minidump/ThreeStageAgg-ScalarAgg-DistinctDistrCol.mdp",
 	"../data/dxl/minidump/ThreeStageAgg-ScalarAgg-DistinctNonDistrCol.mdp",
 	"../data/dxl/minidump/ThreeStageAgg-ScalarAgg-DistinctComputedCol.mdp",
+	"../data/dxl/minidump/ApproxCountDistinct.mdp",
+	"../data/dxl/minidump/ApproxCountDistinctDisabled.mdp",
 	"../data/dxl/minidump/CannotPullGrpColAboveAgg.mdp",
 	"../data/dxl/minidump/DQA-1-RegularAgg.mdp",
 	"../data/dxl/minidump/DQA-2-RegularAgg.mdp",
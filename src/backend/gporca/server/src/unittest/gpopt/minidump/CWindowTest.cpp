@@ -33,6 +33,7 @@ CWindowTest::EresUnittest()
 		"../data/dxl/minidump/Preds-Over-WinFunc4.mdp",
 		"../data/dxl/minidump/Preds-Over-WinFunc5.mdp",
 		"../data/dxl/minidump/window-count-gpdb6.mdp",
+		"../data/dxl/minidump/WindowSpecsShareSort.mdp",
 	};
 
 	return CTestUtils::EresUnittest_RunTestsWithoutAdditionalTraceFlags(
@@ -16,6 +16,7 @@
 #include "gpopt/engine/CEngine.h"
 #include "gpopt/eval/CConstExprEvaluatorDefault.h"
 #include "gpopt/exception.h"
+#include "gpopt/optimizer/COptimizerConfig.h"
 #include "gpopt/search/CSearchStage.h"
 #include "gpopt/xforms/CXformFactory.h"
 #include "naucrates/dxl/CDXLUtils.h"
@@ -45,6 +46,7 @@ CSearchStrategyTest::EresUnittest()
 		GPOS_UNITTEST_FUNC(CSearchStrategyTest::EresUnittest_Parsing),
 		GPOS_UNITTEST_FUNC_THROW(CSearchStrategyTest::EresUnittest_Timeout,
 								 gpopt::ExmaGPOPT, gpopt::ExmiNoPlanFound),
+		GPOS_UNITTEST_FUNC(CSearchStrategyTest::EresUnittest_Budget),
 		GPOS_UNITTEST_FUNC_THROW(
 			CSearchStrategyTest::EresUnittest_ParsingWithException,
 			gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError),
@@ -186,6 +188,65 @@ CSearchStrategyTest::EresUnittest_Timeout()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CSearchStrategyTest::EresUnittest_Budget
+//
+//	@doc:
+//		Test that exhausting the optimization budget returns the best plan
+//		found so far instead of failing
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CSearchStrategyTest::EresUnittest_Budget()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// setup a file-based provider
+	CMDProviderMemory *pmdp = CTestUtils::m_pmdpf;
+	pmdp->AddRef();
+	CMDAccessor mda(mp, CMDCache::Pcache());
+	mda.RegisterProvider(CTestUtils::m_sysidDefault, pmdp);
+
+	// a memory budget of 1KB is exhausted by the first budget check
+	CHint *phint = GPOS_NEW(mp) CHint(
+		gpos::int_max, /* join_arity_for_associativity_commutativity */
+		gpos::int_max, /* array_expansion_threshold */
+		JOIN_ORDER_DP_THRESHOLD,			 /*ulJoinOrderDPLimit*/
+		BROADCAST_THRESHOLD,				 /*broadcast_threshold*/
+		true,								 /* enforce_constraint_on_dml */
+		PUSH_GROUP_BY_BELOW_SETOP_THRESHOLD, /* push_group_by_below_setop_threshold */
+		XFORM_BIND_THRESHOLD,				 /* xform_bind_threshold */
+		SKEW_FACTOR,						 /* skew_factor */
+		0,									 /* optimization_time_budget */
+		1									 /* optimization_memory_budget */
+	);
+	COptimizerConfig *optimizer_config = GPOS_NEW(mp) COptimizerConfig(
+		GPOS_NEW(mp) CEnumeratorConfig(mp, 0 /*plan_id*/, 0 /*ullSamples*/),
+		CStatisticsConfig::PstatsconfDefault(mp),
+		CCTEConfig::PcteconfDefault(mp), CTestUtils::GetCostModel(mp), phint,
+		CWindowOids::GetWindowOids(mp));
+
+	const ULONG ulTruncations = CEngine::UlBudgetTruncations();
+
+	// install opt context in TLS
+	{
+		CAutoOptCtxt aoc(mp, &mda, NULL /* pceeval */, optimizer_config);
+		CExpression *pexpr = CTestUtils::PexprLogicalNAryJoin(mp);
+		BuildMemo(mp, pexpr, NULL /*search_stage_array*/);
+		pexpr->Release();
+	}
+
+	if (ulTruncations + 1 != CEngine::UlBudgetTruncations())
+	{
+		return GPOS_FAILED;
+	}
+
+	return GPOS_OK;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CSearchStrategyTest::EresUnittest_ParsingWithException
@@ -4890,6 +4890,8 @@ _copySlice(const Slice *from)
 	COPY_NODE_FIELD(children);
 	COPY_NODE_FIELD(primaryProcesses);
 	COPY_BITMAPSET_FIELD(processesMap);
+	COPY_SCALAR_FIELD(planSize);
+	COPY_SCALAR_FIELD(planSizeCompressed);
 
 	return newnode;
 }
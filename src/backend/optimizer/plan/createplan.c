@@ -69,6 +69,7 @@ static Plan *create_subplan(PlannerInfo *root, Path *best_path);		/* CDB */
 static Plan *create_scan_plan(PlannerInfo *root, Path *best_path);
 static List *build_path_tlist(PlannerInfo *root, Path *path);
 static bool use_physical_tlist(PlannerInfo *root, RelOptInfo *rel);
+static bool external_uses_custom_protocol(RelOptInfo *rel);
 static void disuse_physical_tlist(PlannerInfo *root, Plan *plan, Path *path);
 static Plan *create_gating_plan(PlannerInfo *root, Plan *plan, List *quals);
 static Plan *create_join_plan(PlannerInfo *root, JoinPath *best_path);
@@ -623,9 +624,40 @@ use_physical_tlist(PlannerInfo *root, RelOptInfo *rel)
 	if (rte->pseudocols)
 		return false;
 
+	/*
+	 * CDB: Emit only the referenced columns of external tables read by a
+	 * custom protocol. The protocol gets the projection info of the scan (see
+	 * ExternalSelectDesc), and can skip reading the other columns. The
+	 * built-in protocols and EXECUTE tables read every column anyway.
+	 */
+	if (rel->relstorage == RELSTORAGE_EXTERNAL &&
+		external_uses_custom_protocol(rel))
+		return false;
+
 	return true;
 }
 
+/*
+ * external_uses_custom_protocol
+ *		Is the external table of the rel read with a custom protocol?
+ */
+static bool
+external_uses_custom_protocol(RelOptInfo *rel)
+{
+	ExtTableEntry *ext = rel->extEntry;
+	Uri		   *uri;
+	bool		result;
+
+	if (ext == NULL || ext->urilocations == NIL)
+		return false;
+
+	uri = ParseExternalTableUri(strVal(linitial(ext->urilocations)));
+	result = (uri->protocol == URI_CUSTOM);
+	FreeExternalTableUri(uri);
+
+	return result;
+}
+
 /*
  * disuse_physical_tlist
  *		Switch a plan node back to emitting only Vars actually referenced.
@@ -303,7 +303,15 @@ datumstreamwrite_put(
 					 bool null,
 					 void **toFree)
 {
-	return DatumStreamBlockWrite_Put(&acc->blockWrite, d, null, toFree);
+	int			result;
+
+	result = DatumStreamBlockWrite_Put(&acc->blockWrite, d, null, toFree);
+
+	if (acc->summarize && result >= 0 && !null)
+		AppendOnlyBlockSummary_AddValue(&acc->blockSummary,
+										acc->typeInfo.typid, d);
+
+	return result;
 }
 
 int
@@ -571,6 +579,10 @@ create_datumstreamwrite(
 	acc->ao_write.verifyWriteCompressionState = verifyBlockCompressionState;
 	acc->title = title;
 
+	acc->summarize = gp_enable_aocs_block_summaries &&
+		AppendOnlyBlockSummary_TypeIsSupported(attr->atttypid);
+	AppendOnlyBlockSummary_Reset(&acc->blockSummary);
+
 	/*
 	 * Temporarily set the firstRowNum for the block so that we can
 	 * calculate the correct header length.
@@ -1006,7 +1018,10 @@ datumstreamwrite_block(DatumStreamWrite *acc,
 		acc->blockFirstRowNum,
 		AppendOnlyStorageWrite_LogicalBlockStartOffset(&acc->ao_write),
 		itemCount,
-		addColAction);
+		addColAction,
+		acc->summarize ? &acc->blockSummary : NULL);
+
+	AppendOnlyBlockSummary_Reset(&acc->blockSummary);
 
 	return writesz;
 }
@@ -1084,7 +1099,8 @@ datumstreamwrite_lob(DatumStreamWrite * acc,
 		acc->blockFirstRowNum,
 		AppendOnlyStorageWrite_LogicalBlockStartOffset(&acc->ao_write),
 		1, /*itemCount -- always just the lob just inserted */
-		addColAction);
+		addColAction,
+		NULL);
 
 	return varLen;
 }
@@ -1292,10 +1308,14 @@ datumstreamread_block_content(DatumStreamRead * acc)
 }
 
 
-int
-datumstreamread_block(DatumStreamRead * acc,
-					  AppendOnlyBlockDirectory *blockDirectory,
-					  int colGroupNo)
+/*
+ * Read the header of the next block and advance the block position to it.
+ * The caller reads the content of the block with
+ * datumstreamread_block_content(), or skips it with
+ * datumstreamread_block_skip_content().
+ */
+bool
+datumstreamread_block_header(DatumStreamRead * acc)
 {
 	bool		readOK = false;
 
@@ -1311,7 +1331,7 @@ datumstreamread_block(DatumStreamRead * acc,
 												&acc->getBlockInfo.isLarge,
 											&acc->getBlockInfo.isCompressed);
 	if (!readOK)
-		return -1;
+		return false;
 
 	if (Debug_appendonly_print_datumstream)
 		elog(LOG,
@@ -1353,21 +1373,121 @@ datumstreamread_block(DatumStreamRead * acc,
 			 acc->blockFileOffset,
 			 acc->blockRowCount);
 
+	return true;
+}
+
+/*
+ * Summarize the values of the current block, and rewind to its first row.
+ */
+static void
+datumstreamread_summarize_block(DatumStreamRead * acc,
+								MinipageEntrySummary *summary)
+{
+	Datum		d;
+	bool		null;
+
+	AppendOnlyBlockSummary_Reset(summary);
+
+	while (datumstreamread_advance(acc))
+	{
+		datumstreamread_get(acc, &d, &null);
+		if (!null)
+			AppendOnlyBlockSummary_AddValue(summary, acc->typeInfo.typid, d);
+	}
+
+	datumstreamread_rewind_block(acc);
+}
+
+int
+datumstreamread_block(DatumStreamRead * acc,
+					  AppendOnlyBlockDirectory *blockDirectory,
+					  int colGroupNo)
+{
+	Assert(acc);
+
+	if (!datumstreamread_block_header(acc))
+		return -1;
+
 	datumstreamread_block_content(acc);
 
 	if (blockDirectory)
 	{
+		MinipageEntrySummary summary;
+		bool		summarize;
+
+		/*
+		 * The block directory is being built for an existing table, so
+		 * summarize the values of the block as the writer would have.
+		 */
+		summarize = gp_enable_aocs_block_summaries &&
+			acc->getBlockInfo.execBlockKind == AOCSBK_BLOCK &&
+			AppendOnlyBlockSummary_TypeIsSupported(acc->typeInfo.typid);
+
+		/* the summary is written to disk as is, padding included */
+		MemSet(&summary, 0, sizeof(MinipageEntrySummary));
+		if (summarize)
+			datumstreamread_summarize_block(acc, &summary);
+
 		AppendOnlyBlockDirectory_InsertEntry(blockDirectory,
 											 colGroupNo,
 											 acc->blockFirstRowNum,
 											 acc->blockFileOffset,
 											 acc->blockRowCount,
-											 false);
+											 false,
+											 summarize ? &summary : NULL);
 	}
 
 	return 0;
 }
 
+/*
+ * Like datumstreamread_block(), but first skip over the blocks that end
+ * within the next *skipRows rows, without reading or decompressing their
+ * content. On return, *skipRows has been reduced by the number of rows in
+ * the skipped blocks.
+ *
+ * Used by column scans that read a column only for some of the rows.
+ */
+int
+datumstreamread_block_skip(DatumStreamRead * acc, int64 *skipRows)
+{
+	Assert(acc);
+	Assert(*skipRows >= 0);
+
+	while (true)
+	{
+		if (!datumstreamread_block_header(acc))
+			return -1;
+
+		/*
+		 * The row count in the header of pre-4.0 blocks may be wrong, so
+		 * always read those.
+		 */
+		if (acc->getBlockInfo.firstRow < 0 ||
+			acc->getBlockInfo.rowCnt > *skipRows)
+			break;
+
+		*skipRows -= acc->getBlockInfo.rowCnt;
+		datumstreamread_block_skip_content(acc);
+	}
+
+	datumstreamread_block_content(acc);
+
+	return 0;
+}
+
+/*
+ * Skip the content of the block whose header was just read by
+ * datumstreamread_block_header().
+ */
+void
+datumstreamread_block_skip_content(DatumStreamRead * acc)
+{
+	Assert(acc);
+
+	AppendOnlyStorageRead_SkipCurrentBlock(&acc->ao_read);
+}
+
 void
 datumstreamread_rewind_block(DatumStreamRead * datumStream)
 {
@@ -140,6 +140,9 @@ int			gp_max_local_distributed_cache = 1024;
 bool		gp_appendonly_verify_block_checksums = true;
 bool		gp_appendonly_verify_write_block = false;
 bool		gp_appendonly_compaction = true;
+bool		gp_enable_aocs_late_materialization = true;
+bool		gp_enable_aocs_block_skipping = true;
+bool		gp_enable_aocs_block_summaries = false;
 int			gp_appendonly_compaction_threshold = 0;
 bool		gp_heap_require_relhasoids_match = true;
 bool		gp_local_distributed_cache_stats = false;
@@ -343,6 +346,8 @@ bool		optimizer_enable_direct_dispatch;
 bool		optimizer_enable_hashjoin_redistribute_broadcast_children;
 bool		optimizer_enable_broadcast_nestloop_outer_child;
 bool		optimizer_discard_redistribute_hashjoin;
+bool		optimizer_enable_approx_count_distinct;
+bool		optimizer_enable_semi_join_reduction;
 bool		optimizer_enable_streaming_material;
 bool		optimizer_enable_gather_on_segment_for_dml;
 bool		optimizer_enable_assert_maxonerow;
@@ -401,6 +406,8 @@ int			optimizer_cte_inlining_bound;
 int			optimizer_push_group_by_below_setop_threshold;
 int			optimizer_xform_bind_threshold;
 int			optimizer_skew_factor;
+int			optimizer_time_budget;
+int			optimizer_memory_budget;
 bool		optimizer_force_multistage_agg;
 bool		optimizer_force_three_stage_scalar_dqa;
 bool		optimizer_force_expanded_distinct_aggs;
@@ -410,6 +417,7 @@ bool		optimizer_prune_computed_columns;
 bool		optimizer_push_requirements_from_consumer_to_producer;
 bool		optimizer_enforce_subplans;
 bool		optimizer_use_external_constant_expression_evaluation_for_ints;
+bool		optimizer_enable_native_constant_expression_evaluation;
 bool		optimizer_apply_left_outer_to_union_all_disregarding_stats;
 bool		optimizer_remove_order_below_dml;
 bool		optimizer_multilevel_partitioning;
@@ -699,6 +707,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"gp_enable_slice_plan_dispatch", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Dispatch to each gang only the part of the plan executed by its slice."),
+			gettext_noop("Has no effect unless execute_pruned_plan is on."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_enable_slice_plan_dispatch,
+		true,
+		NULL, NULL, NULL
+	},
 	{
 		{"gp_enable_predicate_propagation", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("When two expressions are equivalent (such as with "
@@ -1071,6 +1089,39 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_enable_aocs_late_materialization", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Enables late materialization in scans of append-only columnar tables."),
+			gettext_noop("Only the columns of the scan filter are read for every row; the "
+						 "other columns are read only for the rows that pass the filter.")
+		},
+		&gp_enable_aocs_late_materialization,
+		true,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_enable_aocs_block_skipping", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Enables skipping blocks of append-only columnar tables by their min/max summaries."),
+			gettext_noop("Scans skip the blocks whose value ranges, kept in the block directory, "
+						 "show that no row passes the scan filter.")
+		},
+		&gp_enable_aocs_block_skipping,
+		true,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_enable_aocs_block_summaries", PGC_SUSET, APPENDONLY_TABLES,
+			gettext_noop("Enables keeping min/max summaries of the blocks of append-only columnar tables."),
+			gettext_noop("The summaries are kept in the block directory, in a minipage layout "
+						 "that servers without block skipping cannot read.")
+		},
+		&gp_enable_aocs_block_summaries,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_heap_require_relhasoids_match", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Issue an error on discovery of a mismatch between relhasoids and a tuple header."),
@@ -1211,6 +1262,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_udp_gso", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sends runs of same-size UDP interconnect packets with segmentation offload."),
+			gettext_noop("Needs Linux and packets that fit the MTU, the interconnect falls "
+						 "back to sending every packet if the kernel refuses.")
+		},
+		&gp_interconnect_udp_gso,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_cache_future_packets", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Control whether future packets are cached."),
@@ -2650,6 +2712,28 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false,
 		NULL, NULL, NULL
 	},
+	{
+		{"optimizer_enable_approx_count_distinct", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Estimate count(distinct) with HyperLogLog sketches in the optimizer."),
+			gettext_noop("The estimate is computed in two stages, without redistributing "
+						 "the rows on the distinct argument, and is typically within a few "
+						 "percent of the exact count.")
+		},
+		&optimizer_enable_approx_count_distinct,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"optimizer_enable_semi_join_reduction", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable plans that filter the big side of a join by the keys of a filtered small side."),
+			gettext_noop("The optimizer chooses such a plan only if its cost estimate shows "
+						 "that the rows discarded before the motion of the big side pay for "
+						 "the extra scan of the small side.")
+		},
+		&optimizer_enable_semi_join_reduction,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"optimizer_expand_fulljoin", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Enables the optimizer's support of expanding full outer joins using union all."),
@@ -2797,6 +2881,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_enable_native_constant_expression_evaluation", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Fold comparisons and immutable built-in operators inside the optimizer instead of calling the executor"),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_enable_native_constant_expression_evaluation,
+		true,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_enable_bitmapscan", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Enable bitmap plans in the optimizer"),
@@ -3693,6 +3788,17 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_batch_packets", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the maximum number of packets the UDP interconnect sends or receives with one system call"),
+			gettext_noop("Only takes effect on platforms with sendmmsg() and recvmmsg(). "
+						 "A value of 1 sends and receives every packet with its own call.")
+		},
+		&Gp_interconnect_batch_packets,
+		16, 1, MAX_INTERCONNECT_BATCH_PACKETS,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_cursor_ic_table_size", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Sets the size of Cursor Table in the UDP interconnect"),
@@ -4491,6 +4597,28 @@ struct config_int ConfigureNamesInt_gp[] =
             NULL, NULL, NULL
     },
 
+	{
+		{"optimizer_time_budget", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the time GPORCA may spend searching for a plan before it returns the best plan found so far."),
+			gettext_noop("A value of 0 disables the budget."),
+			GUC_UNIT_MS
+		},
+		&optimizer_time_budget,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_memory_budget", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the memory GPORCA may use searching for a plan before it returns the best plan found so far."),
+			gettext_noop("A value of 0 disables the budget."),
+			GUC_UNIT_KB
+		},
+		&optimizer_memory_budget,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_join_order_threshold", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Maximum number of join children to use dynamic programming based join ordering algorithm."),
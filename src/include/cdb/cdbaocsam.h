@@ -110,6 +110,34 @@ typedef struct AOCSScanDescData
 	int		   *proj_atts;
 	int			num_proj_atts;
 
+	/*
+	 * Late materialization. aocs_getnext() only reads the first
+	 * num_filter_atts columns of proj_atts; the others are read by
+	 * aocs_getnext_late() for the rows that pass the filter of the scan.
+	 * late_seg_row holds the row of the segment file that the stream of
+	 * each late column is positioned at. Without late materialization,
+	 * num_filter_atts is num_proj_atts.
+	 */
+	int			num_filter_atts;
+	int64	   *late_seg_row;
+
+	/*
+	 * Block skipping. Only the first num_seq_atts columns of proj_atts are
+	 * read row by row; with block skipping, that is just the column that
+	 * has skip_keys, and its blocks whose summaries in the block directory
+	 * exclude all rows are not read. The other filter columns are then
+	 * positioned at the rows that are read, like the late columns are.
+	 * Without block skipping, num_seq_atts is num_filter_atts.
+	 */
+	int			num_seq_atts;
+	int			num_skip_keys;
+	struct AOCSSkipKey *skip_keys;
+
+	/* summaries of the blocks of the current segment file */
+	AppendOnlyBlockSummary *summaries;
+	int			num_summaries;
+	int			cur_summary;
+
 	/* synthetic system attributes */
 	ItemPointerData cdb_fake_ctid;
 	int64 total_row;
@@ -212,7 +240,10 @@ extern void aocs_afterscan(AOCSScanDesc scan);
 extern void aocs_rescan(AOCSScanDesc scan);
 extern void aocs_endscan(AOCSScanDesc scan);
 
+extern bool aocs_set_late_materialization(AOCSScanDesc scan, bool *filterproj);
+extern bool aocs_set_block_skipping(AOCSScanDesc scan, int nkeys, ScanKey keys);
 extern bool aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot);
+extern void aocs_getnext_late(AOCSScanDesc scan, TupleTableSlot *slot);
 extern AOCSInsertDesc aocs_insert_init(Relation rel, int segno, bool update_mode);
 extern Oid aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool *null, AOTupleId *aoTupleId);
 static inline Oid aocs_insert(AOCSInsertDesc idesc, TupleTableSlot *slot)
@@ -48,6 +48,40 @@ typedef struct MinipageEntry
 	int64 rowCount;
 } MinipageEntry;
 
+/*
+ * The summary of the values of a column in the rows covered by a minipage
+ * entry. A scan can skip the block of the entry if no value in the summary
+ * range satisfies its quals. Only columns of integer and date/time types are
+ * summarized, as int64 values; null values are not summarized, so the range
+ * is empty (minValue > maxValue) if all the values are null.
+ */
+typedef struct MinipageEntrySummary
+{
+	int64 minValue;
+	int64 maxValue;
+	bool isValid;				/* false if the values are not summarized */
+} MinipageEntrySummary;
+
+/*
+ * The summary of the block that starts at the given file offset, as returned
+ * to scans by AppendOnlyBlockDirectory_GetSummaries.
+ */
+typedef struct AppendOnlyBlockSummary
+{
+	int64 fileOffset;
+	int64 minValue;
+	int64 maxValue;
+} AppendOnlyBlockSummary;
+
+/*
+ * Minipages of version MINIPAGE_VERSION_SUMMARY store one MinipageEntrySummary
+ * per entry after the array of entries. Older versions of the server cannot
+ * read them, so they are only written while gp_enable_aocs_block_summaries
+ * is on. Readers reject versions newer than MINIPAGE_VERSION_LATEST.
+ */
+#define MINIPAGE_VERSION_SUMMARY 1
+#define MINIPAGE_VERSION_LATEST MINIPAGE_VERSION_SUMMARY
+
 /*
  * Define a varlena type for a minipage.
  */
@@ -69,6 +103,7 @@ typedef struct Minipage
 typedef struct MinipagePerColumnGroup
 {
 	Minipage *minipage;
+	MinipageEntrySummary *summaries;	/* one per entry of the minipage */
 	uint32 numMinipageEntries;
 	ItemPointerData tupleTid;
 } MinipagePerColumnGroup;
@@ -198,7 +233,8 @@ extern bool AppendOnlyBlockDirectory_InsertEntry(
 	int64 firstRowNum,
 	int64 fileOffset,
 	int64 rowCount,
-	bool addColAction);
+	bool addColAction,
+	const MinipageEntrySummary *summary);
 extern bool AppendOnlyBlockDirectory_addCol_InsertEntry(
 	AppendOnlyBlockDirectory *blockDirectory,
 	int columnGroupNo,
@@ -223,4 +259,18 @@ extern void AppendOnlyBlockDirectory_DeleteSegmentFile(
 		Snapshot snapshot,
 		int segno,
 		int columnGroupNo);
+extern AppendOnlyBlockSummary *AppendOnlyBlockDirectory_GetSummaries(
+	Relation aoRel,
+	Snapshot appendOnlyMetaDataSnapshot,
+	int segno,
+	int columnGroupNo,
+	int64 eof,
+	int *numSummaries);
+extern bool AppendOnlyBlockSummary_TypeIsSupported(Oid typid);
+extern int64 AppendOnlyBlockSummary_DatumGetInt64(Oid typid, Datum value);
+extern void AppendOnlyBlockSummary_Reset(MinipageEntrySummary *summary);
+extern void AppendOnlyBlockSummary_AddValue(
+	MinipageEntrySummary *summary,
+	Oid typid,
+	Datum value);
 #endif
@@ -41,6 +41,8 @@ typedef struct PartitionRangeState
 	FmgrInfo *ltfuncs_inverse; /* comparator partRule < expr */
 	FmgrInfo *lefuncs_inverse; /* comparator partRule <= expr */
 	int last_rule; /* cache offset to the last rule and test if it matches */
+	PartitionNode *rulesnode; /* node whose rules are unrolled into rules */
+	int maxrules; /* allocated length of rules */
 	PartitionRule **rules;
 } PartitionRangeState;
 
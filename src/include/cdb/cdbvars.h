@@ -421,6 +421,19 @@ extern int	Gp_interconnect_queue_depth;
  */
 extern int	Gp_interconnect_snd_queue_depth;
 
+/*
+ * Parameter Gp_interconnect_batch_packets
+ *
+ * The run-time parameter Gp_interconnect_batch_packets controls the
+ * maximum number of packets sent or received with one system call,
+ * on platforms that have sendmmsg() and recvmmsg().
+ *
+ * This guc is specific to the UDP-interconnect.
+ *
+ */
+#define MAX_INTERCONNECT_BATCH_PACKETS 64
+extern int	Gp_interconnect_batch_packets;
+
 /*
  * Cursor IC table size.
  *
@@ -457,6 +470,14 @@ extern bool gp_interconnect_aggressive_retry; /* fast-track app-level retry */
  */
 extern bool gp_interconnect_full_crc;
 
+/*
+ * Parameter gp_interconnect_udp_gso
+ *
+ * Send runs of packets of the same size to a peer as one message, that the
+ * kernel segments into packets (UDP GSO, Linux only).
+ */
+extern bool gp_interconnect_udp_gso;
+
 /*
  * Parameter gp_interconnect_log_stats
  *
@@ -806,6 +827,9 @@ extern int gp_segworker_relative_priority;
 /*  Max size of dispatched plans; 0 if no limit */
 extern int gp_max_plan_size;
 
+/* Dispatch to each gang only the part of the plan its slice executes */
+extern bool gp_enable_slice_plan_dispatch;
+
 /* If we use two stage hashagg, we can stream the bottom half */
 extern bool gp_hashagg_streambottom;
 
@@ -106,6 +106,15 @@ typedef struct Slice
 	Bitmapset	*processesMap;
 	/* A list of segment ids who will execute this slice */
 	List		*segments;
+
+	/*
+	 * Size in bytes of the plan dispatched to the gang of this slice, before
+	 * and after compression, when the gang was sent only its part of the
+	 * plan (gp_enable_slice_plan_dispatch). Only set on the QD, for EXPLAIN
+	 * ANALYZE VERBOSE.
+	 */
+	int			planSize;
+	int			planSizeCompressed;
 } Slice;
 
 /*
@@ -63,12 +63,24 @@ private:
 	// array of mapping elements
 	static SConfigMappingElem m_elements[];
 
+	// other boolean config params the packed trace flags depend on
+	static const BOOL *m_key_params[];
+
+	// enum config params the packed trace flags depend on
+	static const INT *m_key_enum_params[];
+
 	// private ctor
 	CConfigParamMapping(const CConfigParamMapping &);
 
 public:
 	// pack enabled optimizer config params in a traceflag bitset
 	static CBitSet *PackConfigParamInBitset(CMemoryPool *mp, ULONG xform_id);
+
+	// size of the key built by PackConfigParamKey
+	static ULONG ConfigParamKeySize(ULONG xform_id);
+
+	// pack the values of the config params the traceflag bitset depends on
+	static void PackConfigParamKey(BYTE *key, ULONG xform_id);
 };
 }  // namespace gpdxl
 
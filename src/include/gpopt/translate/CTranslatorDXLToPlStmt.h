@@ -604,7 +604,8 @@ private:
 
 	// compute directed dispatch segment ids
 	List *TranslateDXLDirectDispatchInfo(
-		CDXLDirectDispatchInfo *dxl_direct_dispatch_info);
+		CDXLDirectDispatchInfo *dxl_direct_dispatch_info,
+		BOOL allow_multiple_segments);
 
 	// hash a DXL datum with GPDB's hash function
 	ULONG GetDXLDatumGPDBHash(CDXLDatumArray *dxl_datum_array);
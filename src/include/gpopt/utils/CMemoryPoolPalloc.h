@@ -51,6 +51,9 @@ public:
 	// return total allocated size include management overhead
 	ULLONG TotalAllocatedSize() const;
 
+	// return highest total allocated size reached so far
+	ULLONG PeakAllocatedSize() const;
+
 	// get user requested size of allocation
 	static ULONG UserSizeOfAlloc(const void *ptr);
 };
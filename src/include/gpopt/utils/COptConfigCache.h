@@ -0,0 +1,171 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		COptConfigCache.h
+//
+//	@doc:
+//		Per-backend cache of the optimizer setup that only depends on GUCs
+//		and the search strategy file
+//
+//	@test:
+//
+//
+//---------------------------------------------------------------------------
+#ifndef COptConfigCache_H
+#define COptConfigCache_H
+
+#include <sys/types.h>
+
+#include "gpos/base.h"
+
+#include "gpopt/search/CSearchStage.h"
+
+// fwd decl
+namespace gpos
+{
+class CMemoryPool;
+class CBitSet;
+}  // namespace gpos
+
+namespace gpopt
+{
+class CHint;
+class CCTEConfig;
+class CWindowOids;
+}  // namespace gpopt
+
+using namespace gpos;
+using namespace gpopt;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		COptConfigCache
+//
+//	@doc:
+//		Caches, across the queries optimized by a backend, the products of
+//		the optimizer setup that are expensive to rebuild: the search
+//		strategy parsed from optimizer_search_strategy_path, the trace flags
+//		packed from the optimizer GUCs, and the parts of the optimizer
+//		configuration that are not modified during optimization.
+//
+//		Every entry is rebuilt when the GUCs it was built from, or the
+//		modification time of the search strategy file, change. The cached
+//		objects live in a memory pool of their own and are never handed out
+//		for modification: search stages are copied into the caller's pool,
+//		because the engine records the best plan of every stage in them.
+//
+//---------------------------------------------------------------------------
+class COptConfigCache
+{
+private:
+	// identity of a version of a file
+	struct SFileStamp
+	{
+		// does the file exist
+		BOOL m_exists;
+
+		// inode, size and modification time of the file
+		ino_t m_ino;
+		off_t m_size;
+		time_t m_mtime;
+	};
+
+	// values of the GUCs the cached configuration objects are built from
+	struct SConfigKey
+	{
+		ULONG m_join_arity_for_associativity_commutativity;
+		ULONG m_array_expansion_threshold;
+		ULONG m_join_order_threshold;
+		ULONG m_broadcast_threshold;
+		ULONG m_push_group_by_below_setop_threshold;
+		ULONG m_xform_bind_threshold;
+		ULONG m_skew_factor;
+		ULONG m_cte_inlining_cutoff;
+		ULONG m_optimization_time_budget;
+		ULONG m_optimization_memory_budget;
+	};
+
+	// pool holding all cached objects
+	static CMemoryPool *m_mp;
+
+	// search strategy file the cached strategy was loaded from
+	static CHAR *m_search_strategy_path;
+
+	// version of the file the cached strategy was loaded from
+	static SFileStamp m_search_strategy_stamp;
+
+	// version of the file seen by the last lookup
+	static SFileStamp m_lookup_stamp;
+
+	// is there a cached search strategy
+	static BOOL m_has_search_strategy;
+
+	// cached search strategy, NULL if the default strategy is used
+	static CSearchStageArray *m_search_strategy;
+
+	// values of the config params the cached trace flags were packed from
+	static BYTE *m_trace_flags_key;
+
+	// cached trace flags
+	static CBitSet *m_trace_flags;
+
+	// values of the GUCs the cached configuration objects were built from
+	static SConfigKey m_config_key;
+
+	// cached configuration objects
+	static CHint *m_hint;
+	static CCTEConfig *m_cte_config;
+	static CWindowOids *m_window_oids;
+
+	// private ctor
+	COptConfigCache();
+
+	// return the pool for cached objects, creating it on first use
+	static CMemoryPool *Pmp();
+
+	// get the current version of the given file
+	static void GetFileStamp(const CHAR *path, SFileStamp *stamp);
+
+	// are two versions of a file the same
+	static BOOL FEqualStamps(const SFileStamp &stamp1,
+							 const SFileStamp &stamp2);
+
+	// copy search stages into the given pool
+	static CSearchStageArray *PdrgpssCopy(CMemoryPool *mp,
+										  const CSearchStageArray *pdrgpss);
+
+	// read the current values of the GUCs the configuration is built from
+	static void GetConfigKey(SConfigKey *key);
+
+	// release the cached search strategy
+	static void ResetSearchStrategy();
+
+public:
+	// look up the search strategy loaded from the given file; returns
+	// false if it was not loaded yet, or the file changed since
+	static BOOL FLookupSearchStrategy(CMemoryPool *mp, const CHAR *path,
+									  CSearchStageArray **ppdrgpss);
+
+	// remember the search strategy loaded from the file passed to the
+	// preceding FLookupSearchStrategy call; NULL means the default strategy
+	static void StoreSearchStrategy(const CHAR *path,
+									const CSearchStageArray *pdrgpss);
+
+	// trace flags packed from the current optimizer GUCs; caller must
+	// release the returned bitset and must not modify it
+	static CBitSet *PbsTraceFlags(CMemoryPool *mp, ULONG xform_id);
+
+	// configuration objects that don't change during optimization, built
+	// from the current GUCs; caller owns a reference to each of them
+	static void GetStaticConfig(CHint **pphint, CCTEConfig **ppcteconf,
+								CWindowOids **ppwindowoids);
+
+	// release all cached objects
+	static void Shutdown();
+};
+
+#endif	// COptConfigCache_H
+
+// EOF
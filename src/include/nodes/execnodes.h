@@ -1702,6 +1702,14 @@ typedef struct SeqScanState
 	/* extra state for AOCS scans */
 	bool	   *ss_aocs_proj;
 	int			ss_aocs_ncol;
+
+	/*
+	 * Columns needed by the qual of an AOCS scan that uses late
+	 * materialization, NULL if it does not. The qual is then evaluated by
+	 * SeqNext() instead of ExecScan(), from ss_aocs_qual.
+	 */
+	bool	   *ss_aocs_filterproj;
+	List	   *ss_aocs_qual;
 } SeqScanState;
 
 /*
@@ -2948,6 +2956,8 @@ typedef struct PartitionSelectorState
 	List *levelExprStateLists;                          /* ExprState list for general expressions for all levels */
 	List *residualPredicateExprStateList;               /* ExprState list for evaluating residual predicate */
 	ExprState *propagationExprState;                    /* ExprState for evaluating propagation expression */
+	struct PartitionLevelIndex *levelIndexes;           /* rule search state for all levels */
+	struct HTAB *ruleArrays;                            /* sorted rules of range PartitionNodes, by node */
 
 	TupleDesc	partTabDesc;
 	TupleTableSlot *partTabSlot;
@@ -16,6 +16,7 @@
 #define DATUMSTREAM_H
 
 #include "catalog/pg_attribute.h"
+#include "cdb/cdbappendonlyblockdirectory.h"
 #include "utils/datumstreamblock.h"
 
 /*
@@ -65,6 +66,13 @@ typedef struct DatumStreamWrite
 
 	DatumStreamBlockWrite blockWrite;
 
+	/*
+	 * Summary of the values in the current block, for the block directory.
+	 * Only kept if the values of the column's type are summarized.
+	 */
+	bool		summarize;
+	MinipageEntrySummary blockSummary;
+
 	/*
 	 * EOFs of current segment file.
 	 */
@@ -309,6 +317,9 @@ extern int64 datumstreamwrite_lob(DatumStreamWrite *ds,
 extern int	datumstreamread_block(DatumStreamRead * ds,
 								  AppendOnlyBlockDirectory *blockDirectory,
 								  int colGroupNo);
+extern int	datumstreamread_block_skip(DatumStreamRead * ds, int64 *skipRows);
+extern bool datumstreamread_block_header(DatumStreamRead * ds);
+extern void datumstreamread_block_skip_content(DatumStreamRead * ds);
 extern void datumstreamread_find(DatumStreamRead * datumStream,
 					 int32 rowNumInBlock);
 extern void datumstreamread_rewind_block(DatumStreamRead * datumStream);
@@ -271,6 +271,9 @@ extern bool gp_local_distributed_cache_stats;
 extern bool gp_appendonly_verify_block_checksums;
 extern bool gp_appendonly_verify_write_block;
 extern bool gp_appendonly_compaction;
+extern bool gp_enable_aocs_late_materialization;
+extern bool gp_enable_aocs_block_skipping;
+extern bool gp_enable_aocs_block_summaries;
 extern bool enable_implicit_timeformat_YYYYMMDDHH24MISS;
 
 /*
@@ -470,6 +473,8 @@ extern bool optimizer_enable_multiple_distinct_aggs;
 extern bool optimizer_enable_hashjoin_redistribute_broadcast_children;
 extern bool optimizer_enable_broadcast_nestloop_outer_child;
 extern bool optimizer_discard_redistribute_hashjoin;
+extern bool optimizer_enable_approx_count_distinct;
+extern bool optimizer_enable_semi_join_reduction;
 extern bool optimizer_enable_streaming_material;
 extern bool optimizer_enable_gather_on_segment_for_dml;
 extern bool optimizer_enable_assert_maxonerow;
@@ -531,6 +536,8 @@ extern int optimizer_cte_inlining_bound;
 extern int optimizer_push_group_by_below_setop_threshold;
 extern int optimizer_xform_bind_threshold;
 extern int optimizer_skew_factor;
+extern int optimizer_time_budget;
+extern int optimizer_memory_budget;
 extern bool optimizer_force_multistage_agg;
 extern bool optimizer_force_three_stage_scalar_dqa;
 extern bool optimizer_force_expanded_distinct_aggs;
@@ -541,6 +548,7 @@ extern bool optimizer_push_requirements_from_consumer_to_producer;
 extern bool optimizer_enforce_subplans;
 extern bool optimizer_apply_left_outer_to_union_all_disregarding_stats;
 extern bool optimizer_use_external_constant_expression_evaluation_for_ints;
+extern bool optimizer_enable_native_constant_expression_evaluation;
 extern bool optimizer_remove_order_below_dml;
 extern bool optimizer_multilevel_partitioning;
 extern bool optimizer_parallel_union;
@@ -20,6 +20,9 @@
 		"gp_default_storage_options",
 		"gp_detect_data_correctness",
 		"gp_disable_tuple_hints",
+		"gp_enable_aocs_block_skipping",
+		"gp_enable_aocs_block_summaries",
+		"gp_enable_aocs_late_materialization",
 		"gp_enable_mk_sort",
 		"gp_enable_motion_mk_sort",
 		"gp_enable_segment_copy_checking",
@@ -32,6 +35,7 @@
 		"gp_indexcheck_insert",
 		"gp_indexcheck_vacuum",
 		"gp_initial_bad_row_limit",
+		"gp_interconnect_batch_packets",
 		"gp_interconnect_cursor_ic_table_size",
 		"gp_interconnect_debug_retry_interval",
 		"gp_interconnect_default_rtt",
@@ -49,6 +53,7 @@
 		"gp_interconnect_timer_period",
 		"gp_interconnect_transmit_timeout",
 		"gp_interconnect_type",
+		"gp_interconnect_udp_gso",
 		"gp_interconnect_address_type",
 		"gp_log_endpoints",
 		"gp_log_interconnect",
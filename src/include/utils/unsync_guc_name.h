@@ -190,6 +190,7 @@
 		"gp_enable_preunique",
 		"gp_enable_query_metrics",
 		"gp_enable_relsize_collection",
+		"gp_enable_slice_plan_dispatch",
 		"gp_enable_slow_writer_testmode",
 		"gp_enable_sort_distinct",
 		"gp_enable_sort_limit",
@@ -358,6 +359,7 @@
 		"optimizer_damping_factor_groupby",
 		"optimizer_damping_factor_join",
 		"optimizer_dpe_stats",
+		"optimizer_enable_approx_count_distinct",
 		"optimizer_enable_assert_maxonerow",
 		"optimizer_enable_associativity",
 		"optimizer_enable_bitmapscan",
@@ -390,12 +392,14 @@
 		"optimizer_enable_motions",
 		"optimizer_enable_motions_masteronly_queries",
 		"optimizer_enable_multiple_distinct_aggs",
+		"optimizer_enable_native_constant_expression_evaluation",
 		"optimizer_enable_outerjoin_rewrite",
 		"optimizer_enable_outerjoin_to_unionall_rewrite",
 		"optimizer_enable_partial_index",
 		"optimizer_enable_partition_propagation",
 		"optimizer_enable_partition_selection",
 		"optimizer_enable_range_predicate_dpe",
+		"optimizer_enable_semi_join_reduction",
 		"optimizer_enable_sort",
 		"optimizer_enable_space_pruning",
 		"optimizer_enable_streaming_material",
@@ -417,6 +421,7 @@
 		"optimizer_join_order_threshold",
 		"optimizer_log",
 		"optimizer_log_failure",
+		"optimizer_memory_budget",
 		"optimizer_metadata_caching",
 		"optimizer_minidump",
 		"optimizer_multilevel_partitioning",
@@ -447,6 +452,7 @@
 		"optimizer_search_strategy_path",
 		"optimizer_segments",
 		"optimizer_sort_factor",
+		"optimizer_time_budget",
 		"optimizer_trace_fallback",
 		"optimizer_skew_factor",
 		"optimizer_use_external_constant_expression_evaluation_for_ints",
@@ -0,0 +1,10 @@
+SET gp_enable_aocs_block_skipping = off;
+-- a day
+SELECT count(*) FROM aoskip_events WHERE ts >= timestamp '2020-06-01' AND ts < timestamp '2020-06-02';
+-- an hour
+SELECT count(*) FROM aoskip_events WHERE ts BETWEEN timestamp '2020-12-31 12:00' AND timestamp '2020-12-31 13:00';
+-- the last week
+SELECT count(DISTINCT device) FROM aoskip_events WHERE ts >= timestamp '2020-12-25';
+-- a single event, by a column that is also loaded in order
+SELECT count(*) FROM aoskip_events WHERE id = 1234567;
+RESET gp_enable_aocs_block_skipping;
@@ -0,0 +1,12 @@
+DROP TABLE IF EXISTS aoskip_events;
+-- block summaries are only written when enabled
+SET gp_enable_aocs_block_summaries = on;
+-- a year of events loaded in time order, ten thousand a day
+CREATE TABLE aoskip_events (id bigint, ts timestamp, device int, reading float8)
+WITH (appendonly = true, orientation = column, compresstype = zlib)
+DISTRIBUTED BY (id);
+INSERT INTO aoskip_events SELECT i, timestamp '2020-01-01' + i * interval '8.64 seconds', i % 1000, i % 97 FROM generate_series(0, 3659999) i;
+-- an index gives the table the block directory that keeps the block summaries
+CREATE INDEX aoskip_events_device ON aoskip_events (device);
+ANALYZE aoskip_events;
+RESET gp_enable_aocs_block_summaries;
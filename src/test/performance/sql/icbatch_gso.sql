@@ -0,0 +1,13 @@
+SET gp_interconnect_batch_packets = 64;
+SET gp_interconnect_udp_gso = on;
+-- the segment logs get the packets and system calls of each statement
+SET gp_interconnect_log_stats = on;
+DROP TABLE IF EXISTS icbatch_copy;
+-- redistribute every row
+CREATE TABLE icbatch_copy AS SELECT * FROM icbatch_rows DISTRIBUTED BY (grp);
+-- gather every row on the coordinator
+COPY (SELECT * FROM icbatch_rows) TO '/dev/null';
+DROP TABLE icbatch_copy;
+RESET gp_interconnect_log_stats;
+RESET gp_interconnect_batch_packets;
+RESET gp_interconnect_udp_gso;
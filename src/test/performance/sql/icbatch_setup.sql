@@ -0,0 +1,5 @@
+DROP TABLE IF EXISTS icbatch_rows;
+-- ten million rows of about a hundred bytes each
+CREATE TABLE icbatch_rows (id bigint, grp int, payload text) DISTRIBUTED BY (id);
+INSERT INTO icbatch_rows SELECT i, i % 1000, repeat('x', 80) FROM generate_series(1, 10000000) i;
+ANALYZE icbatch_rows;
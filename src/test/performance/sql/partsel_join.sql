@@ -0,0 +1,8 @@
+SET optimizer = on;
+-- equality on the first level
+SELECT count(*) FROM partsel_fact f JOIN partsel_dim d ON f.day = d.day WHERE d.flag;
+-- equality on both levels
+SELECT count(*) FROM partsel_fact f JOIN partsel_dim d ON f.day = d.day AND f.region = d.region WHERE d.flag;
+-- every row of the driving table selects a partition
+SELECT count(*) FROM partsel_fact f JOIN partsel_dim d ON f.day = d.day AND f.region = d.region;
+RESET optimizer;
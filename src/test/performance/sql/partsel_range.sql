@@ -0,0 +1,8 @@
+SET optimizer = on;
+-- a week of daily partitions per row of the driving table
+SELECT count(*) FROM partsel_fact f JOIN partsel_dim d ON f.day >= d.day AND f.day < d.day + 7 WHERE d.flag;
+-- ranges on both levels
+SELECT count(*) FROM partsel_fact WHERE day BETWEEN date '2020-03-01' AND date '2020-03-31' AND region < 20;
+-- range on a value only known at run time
+SELECT count(*) FROM partsel_fact WHERE day > (SELECT max(day) FROM partsel_dim) - 10;
+RESET optimizer;
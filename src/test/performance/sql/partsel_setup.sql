@@ -0,0 +1,14 @@
+DROP TABLE IF EXISTS partsel_fact;
+DROP TABLE IF EXISTS partsel_dim;
+-- 366 daily partitions, each with 10 range subpartitions
+CREATE TABLE partsel_fact (id int, day date, region int, amount numeric)
+DISTRIBUTED BY (id)
+PARTITION BY RANGE (day)
+SUBPARTITION BY RANGE (region)
+SUBPARTITION TEMPLATE (START (0) END (100) EVERY (10))
+(START (date '2020-01-01') INCLUSIVE END (date '2021-01-01') EXCLUSIVE EVERY (interval '1 day'));
+INSERT INTO partsel_fact SELECT i, date '2020-01-01' + i % 366, i % 100, i FROM generate_series(0, 365999) i;
+CREATE TABLE partsel_dim (day date, region int, flag bool) DISTRIBUTED BY (day);
+INSERT INTO partsel_dim SELECT date '2020-01-01' + d, d % 100, d % 30 = 0 FROM generate_series(0, 365) d;
+ANALYZE partsel_fact;
+ANALYZE partsel_dim;
@@ -3570,6 +3570,44 @@ WITH e AS (
 
 DROP TABLE d, r;
 
+-- With optimizer_enable_approx_count_distinct, ORCA estimates count(distinct)
+-- with a HyperLogLog sketch. The estimate must stay within a few percent of
+-- the exact count, and the rewrite must not happen when the GUC is off.
+create table orca.hll_t (a int, b int) distributed by (a);
+insert into orca.hll_t select i, i % 5000 from generate_series(1, 20000) i;
+analyze orca.hll_t;
+
+create function orca.hll_plan_has(query text, node text) returns bool as
+$$
+declare
+  explainrow text;
+begin
+  for explainrow in execute 'EXPLAIN VERBOSE ' || query
+  loop
+    if explainrow like '%' || node || '%' then
+      return true;
+    end if;
+  end loop;
+  return false;
+end;
+$$ language plpgsql;
+
+select orca.hll_plan_has('select count(distinct b) from orca.hll_t', 'gp_hyperloglog');
+select count(distinct b) from orca.hll_t;
+
+set optimizer_enable_approx_count_distinct = on;
+select orca.hll_plan_has('select count(distinct b) from orca.hll_t', 'gp_hyperloglog');
+select abs(count(distinct b) - 5000) <= 5000 * 0.05 as within_bound from orca.hll_t;
+select a % 2 as parity, abs(count(distinct b) - 2500) <= 2500 * 0.05 as within_bound
+from orca.hll_t group by a % 2 order by 1;
+-- no rows: the count is 0, not null
+select count(distinct b) from orca.hll_t where a < 0;
+reset optimizer_enable_approx_count_distinct;
+
+select orca.hll_plan_has('select count(distinct b) from orca.hll_t', 'gp_hyperloglog');
+drop function orca.hll_plan_has(text, text);
+drop table orca.hll_t;
+
 reset optimizer_trace_fallback;
 
 -- start_ignore
@@ -0,0 +1,73 @@
+--
+-- ORCA caches its search strategy, trace flags and static configuration per
+-- backend. Changing the GUCs they are built from must still take effect on
+-- the next query, and undoing the change must bring the old plan back.
+--
+create schema orca_config_cache;
+set search_path = orca_config_cache;
+set optimizer = on;
+set optimizer_trace_fallback = on;
+
+create table occ_t1 (a int, b int) distributed by (a);
+create table occ_t2 (a int, b int) distributed by (a);
+insert into occ_t1 select i, i % 10 from generate_series(1, 100) i;
+insert into occ_t2 select i, i % 10 from generate_series(1, 100) i;
+analyze occ_t1;
+analyze occ_t2;
+
+-- Does the plan of the query contain the given node?
+create function occ_plan_has(query text, node text) returns bool as
+$$
+declare
+  explainrow text;
+begin
+  for explainrow in execute 'EXPLAIN ' || query
+  loop
+    if explainrow like '%' || node || '%' then
+      return true;
+    end if;
+  end loop;
+  return false;
+end;
+$$ language plpgsql;
+
+-- Trace flags: optimizer_enable_hashjoin disables the hash join xforms.
+select occ_plan_has('select * from occ_t1 join occ_t2 on occ_t1.b = occ_t2.b', 'Hash Join');
+set optimizer_enable_hashjoin = off;
+select occ_plan_has('select * from occ_t1 join occ_t2 on occ_t1.b = occ_t2.b', 'Hash Join');
+reset optimizer_enable_hashjoin;
+select occ_plan_has('select * from occ_t1 join occ_t2 on occ_t1.b = occ_t2.b', 'Hash Join');
+
+-- Same, for a setting that is undone by a rollback.
+select occ_plan_has('select b, count(*) from occ_t1 group by b', 'HashAggregate');
+begin;
+set local optimizer_enable_hashagg = off;
+select occ_plan_has('select b, count(*) from occ_t1 group by b', 'HashAggregate');
+rollback;
+select occ_plan_has('select b, count(*) from occ_t1 group by b', 'HashAggregate');
+
+-- Static configuration: with an inlining bound of 0, no CTE is inlined.
+set optimizer_cte_inlining = on;
+set optimizer_cte_inlining_bound = 0;
+select occ_plan_has('with c as (select b, count(*) from occ_t1 group by b)
+  select * from c c1 join c c2 on c1.b = c2.b', 'Shared Scan');
+set optimizer_cte_inlining = off;
+select occ_plan_has('with c as (select b, count(*) from occ_t1 group by b)
+  select * from c c1 join c c2 on c1.b = c2.b', 'Shared Scan');
+reset optimizer_cte_inlining_bound;
+reset optimizer_cte_inlining;
+
+-- Search strategy: a missing file means the default strategy, and so does
+-- going back to "default".
+set optimizer_search_strategy_path = '/nonexistent/orca_config_cache.xml';
+select occ_plan_has('select * from occ_t1 join occ_t2 on occ_t1.b = occ_t2.b', 'Hash Join');
+select count(*) from occ_t1 join occ_t2 on occ_t1.b = occ_t2.b;
+reset optimizer_search_strategy_path;
+select occ_plan_has('select * from occ_t1 join occ_t2 on occ_t1.b = occ_t2.b', 'Hash Join');
+select count(*) from occ_t1 join occ_t2 on occ_t1.b = occ_t2.b;
+
+reset optimizer_trace_fallback;
+reset optimizer;
+drop function occ_plan_has(text, text);
+drop table occ_t1, occ_t2;
+drop schema orca_config_cache;
@@ -1163,4 +1163,90 @@ SELECT * FROM issue_14982_t1_part_range t1, issue_14982_t2_part_range t2
 
 DROP SCHEMA issue_14982 CASCADE;
 
+-- Runtime partition selection of range partitions, with values only known
+-- when the query runs. The inner rules of a level are found by binary search
+-- when the predicate only bounds the partition key from below or above; the
+-- first and last rules, which may be open-ended, and the default partition
+-- are always checked.
+SET search_path TO partition_pruning;
+
+CREATE TABLE partsel_range (a int, b int) DISTRIBUTED BY (a)
+PARTITION BY RANGE (b)
+(
+  PARTITION r0 END (10),
+  PARTITION r1 START (10) END (20) INCLUSIVE,
+  PARTITION r2 START (20) EXCLUSIVE END (30),
+  PARTITION r3 START (30) END (40),
+  PARTITION r4 START (40)
+);
+CREATE TABLE partsel_default (a int, b int) DISTRIBUTED BY (a)
+PARTITION BY RANGE (b)
+(
+  START (0) END (40) EVERY (10),
+  DEFAULT PARTITION other
+);
+CREATE TABLE partsel_multi (a int, b int, c int) DISTRIBUTED BY (a)
+PARTITION BY RANGE (b)
+  SUBPARTITION BY RANGE (c)
+  SUBPARTITION TEMPLATE
+  (
+    START (0) END (30) EVERY (10),
+    DEFAULT SUBPARTITION other
+  )
+(
+  START (0) END (40) EVERY (10)
+);
+CREATE TABLE partsel_vals (v int) DISTRIBUTED BY (v);
+
+INSERT INTO partsel_range SELECT i, i FROM generate_series(-10, 60) i;
+INSERT INTO partsel_default SELECT i, i FROM generate_series(-10, 60) i;
+INSERT INTO partsel_default VALUES (100, NULL);
+INSERT INTO partsel_multi SELECT i, i % 40, i % 37 FROM generate_series(0, 199) i;
+INSERT INTO partsel_vals VALUES (-5), (10), (20), (25), (30), (40), (55);
+ANALYZE partsel_range;
+ANALYZE partsel_default;
+ANALYZE partsel_multi;
+ANALYZE partsel_vals;
+
+-- Inclusive and exclusive bounds, and the open-ended first and last rules.
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_range p ON p.b < t.v GROUP BY t.v ORDER BY t.v;
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_range p ON p.b <= t.v GROUP BY t.v ORDER BY t.v;
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_range p ON p.b > t.v GROUP BY t.v ORDER BY t.v;
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_range p ON p.b >= t.v GROUP BY t.v ORDER BY t.v;
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_range p ON p.b BETWEEN t.v AND t.v + 10
+GROUP BY t.v ORDER BY t.v;
+SELECT count(*), min(b), max(b) FROM partsel_range
+WHERE b > (SELECT min(v) FROM partsel_vals WHERE v >= 20)
+  AND b <= (SELECT max(v) FROM partsel_vals WHERE v <= 30);
+-- Not a prefix or a suffix of the rules: every rule is checked.
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_range p ON p.b < t.v - 20 OR p.b > t.v + 20
+GROUP BY t.v ORDER BY t.v;
+
+-- The default partition is always selected.
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_default p ON p.b < t.v GROUP BY t.v ORDER BY t.v;
+SELECT t.v, count(p.b), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_default p ON p.b >= t.v GROUP BY t.v ORDER BY t.v;
+
+-- Two levels. The predicate on the second level is not a prefix or a suffix
+-- of its rules, so that level falls back to checking every rule.
+SELECT t.v, count(*), min(p.c), max(p.c)
+FROM partsel_vals t JOIN partsel_multi p
+  ON p.b >= t.v AND (p.c < t.v - 10 OR p.c > t.v + 10)
+GROUP BY t.v ORDER BY t.v;
+SELECT t.v, count(*), min(p.c), max(p.c)
+FROM partsel_vals t JOIN partsel_multi p ON p.b < t.v AND p.c <> t.v
+GROUP BY t.v ORDER BY t.v;
+SELECT t.v, count(*), min(p.b), max(p.b)
+FROM partsel_vals t JOIN partsel_multi p ON p.b > t.v AND p.c >= t.v
+GROUP BY t.v ORDER BY t.v;
+
+DROP TABLE partsel_range, partsel_default, partsel_multi, partsel_vals;
+
 RESET ALL;
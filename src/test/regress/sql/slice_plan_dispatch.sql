@@ -0,0 +1,109 @@
+--
+-- Test dispatching only the slice's part of the plan to each gang
+-- (gp_enable_slice_plan_dispatch). Every query runs with it on and off,
+-- and must return the same rows.
+--
+create schema slice_plan_dispatch;
+set search_path = slice_plan_dispatch;
+
+create table spd_t1 (a int, b int) distributed by (a);
+create table spd_t2 (a int, b int) distributed by (a);
+create table spd_t3 (a int, b int) distributed by (b);
+create table spd_part (a int, b int) distributed by (a)
+  partition by range (b) (start (0) end (100) every (25));
+insert into spd_t1 select i, i % 10 from generate_series(1, 100) i;
+insert into spd_t2 select i, i % 7 from generate_series(1, 70) i;
+insert into spd_t3 select i, i % 20 from generate_series(1, 40) i;
+insert into spd_part select i, i % 100 from generate_series(1, 200) i;
+analyze spd_t1;
+analyze spd_t2;
+analyze spd_t3;
+analyze spd_part;
+
+-- Number of slices whose plan was dispatched on its own, per EXPLAIN
+-- ANALYZE VERBOSE.
+create function spd_dispatched_plans(query text) returns int as
+$$
+declare
+  explainrow text;
+  n int := 0;
+begin
+  for explainrow in execute 'EXPLAIN (ANALYZE, VERBOSE) ' || query
+  loop
+    if explainrow like '%Dispatched plan: %' then
+      n := n + 1;
+    end if;
+  end loop;
+  return n;
+end;
+$$ language plpgsql;
+
+-- Several slices, each of them scanning a different table. The range table
+-- entries of the other slices' tables are sent as RTE_VOID.
+set gp_enable_slice_plan_dispatch = on;
+select t1.b, count(*), sum(t3.a)
+from spd_t1 t1 join spd_t2 t2 on t1.b = t2.b join spd_t3 t3 on t2.a = t3.a
+group by t1.b order by t1.b;
+select spd_dispatched_plans($$
+select t1.b, count(*), sum(t3.a)
+from spd_t1 t1 join spd_t2 t2 on t1.b = t2.b join spd_t3 t3 on t2.a = t3.a
+group by t1.b
+$$) > 1 as sliced;
+set gp_enable_slice_plan_dispatch = off;
+select t1.b, count(*), sum(t3.a)
+from spd_t1 t1 join spd_t2 t2 on t1.b = t2.b join spd_t3 t3 on t2.a = t3.a
+group by t1.b order by t1.b;
+select spd_dispatched_plans($$
+select t1.b, count(*), sum(t3.a)
+from spd_t1 t1 join spd_t2 t2 on t1.b = t2.b join spd_t3 t3 on t2.a = t3.a
+group by t1.b
+$$) as sliced;
+
+-- An initPlan, whose param is used in another slice.
+set gp_enable_slice_plan_dispatch = on;
+select count(*) from spd_t1 where b > (select avg(b) from spd_t2);
+select count(*) from spd_t1 t1 join spd_t3 t3 on t1.a = t3.a
+where t3.b < (select max(b) from spd_t2);
+set gp_enable_slice_plan_dispatch = off;
+select count(*) from spd_t1 where b > (select avg(b) from spd_t2);
+select count(*) from spd_t1 t1 join spd_t3 t3 on t1.a = t3.a
+where t3.b < (select max(b) from spd_t2);
+
+-- A correlated subplan, and a VALUES list.
+set gp_enable_slice_plan_dispatch = on;
+select a, (select count(*) from spd_t3 where spd_t3.b = spd_t1.a) from spd_t1
+where a <= 5 order by a;
+select v.x, count(*) from (values (1), (2), (3)) v(x) join spd_t2 on v.x = spd_t2.b
+group by v.x order by v.x;
+set gp_enable_slice_plan_dispatch = off;
+select a, (select count(*) from spd_t3 where spd_t3.b = spd_t1.a) from spd_t1
+where a <= 5 order by a;
+select v.x, count(*) from (values (1), (2), (3)) v(x) join spd_t2 on v.x = spd_t2.b
+group by v.x order by v.x;
+
+-- A partitioned table, joined to a table in another slice.
+set gp_enable_slice_plan_dispatch = on;
+select count(*), sum(p.a) from spd_part p join spd_t3 t3 on p.b = t3.a
+where t3.b < 5;
+set gp_enable_slice_plan_dispatch = off;
+select count(*), sum(p.a) from spd_part p join spd_t3 t3 on p.b = t3.a
+where t3.b < 5;
+
+-- DML, the result relation is kept in every slice's range table.
+set gp_enable_slice_plan_dispatch = on;
+insert into spd_t2 select t1.a + 1000, t3.b from spd_t1 t1 join spd_t3 t3 on t1.b = t3.a;
+select count(*), sum(b) from spd_t2 where a > 1000;
+delete from spd_t2 where a > 1000 and b in (select a from spd_t3 where b = 1);
+select count(*), sum(b) from spd_t2 where a > 1000;
+delete from spd_t2 where a > 1000;
+set gp_enable_slice_plan_dispatch = off;
+insert into spd_t2 select t1.a + 1000, t3.b from spd_t1 t1 join spd_t3 t3 on t1.b = t3.a;
+select count(*), sum(b) from spd_t2 where a > 1000;
+delete from spd_t2 where a > 1000 and b in (select a from spd_t3 where b = 1);
+select count(*), sum(b) from spd_t2 where a > 1000;
+delete from spd_t2 where a > 1000;
+
+reset gp_enable_slice_plan_dispatch;
+drop function spd_dispatched_plans(text);
+drop table spd_t1, spd_t2, spd_t3, spd_part;
+drop schema slice_plan_dispatch;